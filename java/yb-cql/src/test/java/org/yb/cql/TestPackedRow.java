@@ -0,0 +1,215 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+package org.yb.cql;
+
+import java.util.*;
+
+import org.junit.BeforeClass;
+import org.junit.Test;
+
+import static org.yb.AssertionWrappers.assertEquals;
+import static org.yb.AssertionWrappers.assertTrue;
+
+import org.yb.YBTestRunner;
+
+import org.junit.runner.RunWith;
+
+// Runs CQL statements against tablet servers that write INSERTs of all the columns of a row as a
+// single packed value.
+@RunWith(value=YBTestRunner.class)
+public class TestPackedRow extends BaseCQLTest {
+
+  @BeforeClass
+  public static void SetUpBeforeClass() throws Exception {
+    BaseCQLTest.tserverArgs = Arrays.asList("--ycql_enable_packed_row=true");
+    BaseCQLTest.setUpBeforeClass();
+  }
+
+  private long writeTime(String table, String column, int h, int r) {
+    return session.execute(String.format("select writetime(%s) from %s where h = %d and r = %d;",
+                                         column, table, h, r)).one().getLong(0);
+  }
+
+  @Test
+  public void testPackedInsert() throws Exception {
+    session.execute("create table test_packed (h int, r int, v1 int, v2 text, " +
+                    "primary key ((h), r));");
+
+    // Packed row.
+    session.execute("insert into test_packed (h, r, v1, v2) values (1, 1, 10, 'a');");
+    assertQuery("select * from test_packed where h = 1;", "Row[1, 1, 10, a]");
+
+    // Columns written after the packed row override its values.
+    session.execute("update test_packed set v1 = 20 where h = 1 and r = 1;");
+    assertQuery("select * from test_packed where h = 1;", "Row[1, 1, 20, a]");
+    session.execute("delete v2 from test_packed where h = 1 and r = 1;");
+    assertQuery("select * from test_packed where h = 1;", "Row[1, 1, 20, NULL]");
+    assertQuery("select v1 from test_packed where h = 1 and r = 1;", "Row[20]");
+
+    // A new packed row hides the columns written before it.
+    session.execute("insert into test_packed (h, r, v1, v2) values (1, 1, 30, 'b');");
+    assertQuery("select * from test_packed where h = 1;", "Row[1, 1, 30, b]");
+    assertQuery("select v2 from test_packed where h = 1 and r = 1;", "Row[b]");
+
+    // An INSERT of a part of the columns is not packed and keeps the other packed values.
+    session.execute("insert into test_packed (h, r, v1) values (1, 1, 40);");
+    assertQuery("select * from test_packed where h = 1;", "Row[1, 1, 40, b]");
+
+    // Null columns of a packed row hide older values.
+    session.execute("update test_packed set v2 = 'c' where h = 1 and r = 1;");
+    session.execute("insert into test_packed (h, r, v1, v2) values (1, 1, 50, null);");
+    assertQuery("select * from test_packed where h = 1;", "Row[1, 1, 50, NULL]");
+
+    // Packed rows of several range keys, selected with and without the hash key.
+    session.execute("insert into test_packed (h, r, v1, v2) values (1, 2, 60, 'd');");
+    session.execute("insert into test_packed (h, r, v1, v2) values (2, 1, 70, 'e');");
+    assertQuery("select * from test_packed where h = 1;",
+                "Row[1, 1, 50, NULL]Row[1, 2, 60, d]");
+    assertQueryRowsUnordered("select * from test_packed;",
+                             "Row[1, 1, 50, NULL]", "Row[1, 2, 60, d]", "Row[2, 1, 70, e]");
+    assertQuery("select * from test_packed where h = 1 and v1 = 60;", "Row[1, 2, 60, d]");
+
+    // Deleting the row deletes the packed row too.
+    session.execute("delete from test_packed where h = 1 and r = 1;");
+    assertQuery("select * from test_packed where h = 1;", "Row[1, 2, 60, d]");
+    session.execute("update test_packed set v1 = 80 where h = 1 and r = 1;");
+    assertQuery("select * from test_packed where h = 1 and r = 1;", "Row[1, 1, 80, NULL]");
+
+    // Tables with columns that could not be packed.
+    session.execute("create table test_not_packed (h int, r int, s int static, v set<int>, " +
+                    "primary key ((h), r));");
+    session.execute("insert into test_not_packed (h, r, s, v) values (1, 1, 2, {3, 4});");
+    assertQuery("select * from test_not_packed;", "Row[1, 1, 2, [3, 4]]");
+  }
+
+  @Test
+  public void testUserTimestamp() throws Exception {
+    session.execute("create table test_packed_ts (h int, r int, v1 int, v2 int, " +
+                    "primary key ((h), r));");
+
+    long before = System.currentTimeMillis() * 1000;
+    session.execute("insert into test_packed_ts (h, r, v1, v2) values (1, 1, 10, 20);");
+    long after = System.currentTimeMillis() * 1000;
+    // Packed columns are reported with the write time of the packed row.
+    long packedWriteTime = writeTime("test_packed_ts", "v1", 1, 1);
+    assertEquals(packedWriteTime, writeTime("test_packed_ts", "v2", 1, 1));
+    assertTrue(packedWriteTime >= before - 1000000 && packedWriteTime <= after + 1000000);
+
+    // Writes with a lower user timestamp have no effect on the packed row.
+    session.execute("update test_packed_ts using timestamp 1000 set v1 = 11 " +
+                    "where h = 1 and r = 1;");
+    session.execute("insert into test_packed_ts (h, r, v1, v2) values (1, 1, 12, 22) " +
+                    "using timestamp 1000;");
+    assertQuery("select * from test_packed_ts;", "Row[1, 1, 10, 20]");
+
+    // Writes with a higher user timestamp override it.
+    long userTimestamp = packedWriteTime + 1000000000L;
+    session.execute(String.format("update test_packed_ts using timestamp %d set v1 = 13 " +
+                                  "where h = 1 and r = 1;", userTimestamp));
+    assertQuery("select * from test_packed_ts;", "Row[1, 1, 13, 20]");
+    assertEquals(userTimestamp, writeTime("test_packed_ts", "v1", 1, 1));
+    assertEquals(packedWriteTime, writeTime("test_packed_ts", "v2", 1, 1));
+
+    // A later write with a timestamp between the packed row and the column update only changes
+    // the column that was not overridden.
+    session.execute(String.format("insert into test_packed_ts (h, r, v1, v2) " +
+                                  "values (1, 1, 14, 24) using timestamp %d;",
+                                  userTimestamp - 1));
+    assertQuery("select * from test_packed_ts;", "Row[1, 1, 13, 24]");
+
+    // A regular packed INSERT hides values written with a very high user timestamp, as a regular
+    // INSERT of the columns does.
+    session.execute(String.format("update test_packed_ts using timestamp %d set v2 = 25 " +
+                                  "where h = 1 and r = 1;", Long.MAX_VALUE));
+    session.execute("insert into test_packed_ts (h, r, v1, v2) values (1, 1, 15, 26);");
+    assertQuery("select * from test_packed_ts;", "Row[1, 1, 15, 26]");
+  }
+
+  @Test
+  public void testIndex() throws Exception {
+    session.execute("create table test_packed_idx (h int, r int, v1 int, v2 text, " +
+                    "primary key ((h), r)) with transactions = { 'enabled' : true };");
+    session.execute("create index test_packed_idx_by_v1 on test_packed_idx (v1) include (v2);");
+
+    session.execute("insert into test_packed_idx (h, r, v1, v2) values (1, 1, 10, 'a');");
+    session.execute("insert into test_packed_idx (h, r, v1, v2) values (1, 2, 20, 'b');");
+    assertQuery("select * from test_packed_idx where v1 = 10;", "Row[1, 1, 10, a]");
+    assertQuery("select * from test_packed_idx where v1 = 20;", "Row[1, 2, 20, b]");
+    assertQueryRowsUnordered("select * from test_packed_idx_by_v1;",
+                             "Row[10, 1, 1, a]", "Row[20, 1, 2, b]");
+
+    // Overwriting the packed row removes the old index entry.
+    session.execute("insert into test_packed_idx (h, r, v1, v2) values (1, 1, 30, 'c');");
+    assertNoRow("select * from test_packed_idx where v1 = 10;");
+    assertQuery("select * from test_packed_idx where v1 = 30;", "Row[1, 1, 30, c]");
+
+    // Updating a column of the packed row updates the index using the packed values.
+    session.execute("update test_packed_idx set v1 = 40 where h = 1 and r = 1;");
+    assertNoRow("select * from test_packed_idx where v1 = 30;");
+    assertQuery("select * from test_packed_idx where v1 = 40;", "Row[1, 1, 40, c]");
+    session.execute("update test_packed_idx set v2 = 'd' where h = 1 and r = 2;");
+    assertQuery("select * from test_packed_idx where v1 = 20;", "Row[1, 2, 20, d]");
+
+    // Deleting the row removes its index entry.
+    session.execute("delete from test_packed_idx where h = 1 and r = 1;");
+    assertNoRow("select * from test_packed_idx where v1 = 40;");
+    assertQuery("select * from test_packed_idx_by_v1;", "Row[20, 1, 2, d]");
+
+    // Unique index.
+    session.execute("create table test_packed_uidx (k int primary key, v int) " +
+                    "with transactions = { 'enabled' : true };");
+    session.execute("create unique index test_packed_uidx_by_v on test_packed_uidx (v);");
+    session.execute("insert into test_packed_uidx (k, v) values (1, 1);");
+    runInvalidStmt("insert into test_packed_uidx (k, v) values (2, 1);");
+    session.execute("insert into test_packed_uidx (k, v) values (1, 2);");
+    session.execute("insert into test_packed_uidx (k, v) values (2, 1);");
+    assertQueryRowsUnordered("select * from test_packed_uidx;", "Row[1, 2]", "Row[2, 1]");
+  }
+
+  @Test
+  public void testTransaction() throws Exception {
+    session.execute("create table test_packed_txn1 (k int primary key, v1 int, v2 int) " +
+                    "with transactions = { 'enabled' : true };");
+    session.execute("create table test_packed_txn2 (k int primary key, v int) " +
+                    "with transactions = { 'enabled' : true };");
+
+    // Packed rows written as transaction intents.
+    session.execute("begin transaction" +
+                    "  insert into test_packed_txn1 (k, v1, v2) values (1, 10, 20);" +
+                    "  insert into test_packed_txn2 (k, v) values (1, 30);" +
+                    "end transaction;");
+    assertQuery("select * from test_packed_txn1;", "Row[1, 10, 20]");
+    assertQuery("select * from test_packed_txn2;", "Row[1, 30]");
+    assertEquals(session.execute("select writetime(v1) from test_packed_txn1 where k = 1;")
+                 .one().getLong(0),
+                 session.execute("select writetime(v) from test_packed_txn2 where k = 1;")
+                 .one().getLong(0));
+
+    // Column updates of a packed row and a new packed row in the same transaction.
+    session.execute("begin transaction" +
+                    "  update test_packed_txn1 set v1 = 11 where k = 1;" +
+                    "  insert into test_packed_txn1 (k, v1, v2) values (2, 12, 22);" +
+                    "  insert into test_packed_txn2 (k, v) values (1, 31);" +
+                    "end transaction;");
+    assertQueryRowsUnordered("select * from test_packed_txn1;",
+                             "Row[1, 11, 20]", "Row[2, 12, 22]");
+    assertQuery("select * from test_packed_txn2;", "Row[1, 31]");
+
+    // A packed row that replaces a row with column entries, and a delete in the same transaction.
+    session.execute("begin transaction" +
+                    "  insert into test_packed_txn1 (k, v1, v2) values (1, 13, 23);" +
+                    "  delete from test_packed_txn1 where k = 2;" +
+                    "end transaction;");
+    assertQuery("select * from test_packed_txn1;", "Row[1, 13, 23]");
+  }
+}
@@ -22,8 +22,11 @@
 #include "yb/common/wire_protocol.h"
 #include "yb/common/transaction.h"
 
+#include "yb/rpc/messenger.h"
+
 #include "yb/util/cast.h"
 #include "yb/util/debug-util.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
 
 // TODO: do we need word Redis in following two metrics? ReadRpc and WriteRpc objects emitting
@@ -44,6 +47,13 @@ METRIC_DEFINE_histogram(
     server, handler_latency_yb_client_time_to_send,
     "Time taken for a Write/Read rpc to be sent to the server", yb::MetricUnit::kMicroseconds,
     "Microseconds spent before sending the request to the server", 60000000LU, 2);
+METRIC_DEFINE_counter(
+    server, hedged_reads, "Hedged reads", yb::MetricUnit::kRequests,
+    "Number of reads duplicated to another replica because the first attempt was slow.");
+METRIC_DEFINE_counter(
+    server, hedged_reads_won, "Hedged reads won", yb::MetricUnit::kRequests,
+    "Number of hedged reads whose response was used instead of the response of the first "
+    "attempt.");
 DECLARE_bool(rpc_dump_all_traces);
 DECLARE_bool(collect_end_to_end_traces);
 
@@ -53,6 +63,20 @@ DEFINE_bool(forward_redis_requests, true, "If false, the redis op will not be se
             "part of the reply and ignores the rest. For now, if this flag is true, we will only "
             "attempt to read from leaders, so redis_allow_reads_from_followers will be ignored.");
 
+DEFINE_bool(enable_hedged_reads, false,
+            "If true, when the first attempt of a consistent prefix read to a remote replica takes "
+            "longer than --hedged_read_latency_percentile of recent reads served by that tablet "
+            "server, a duplicate read is sent to another replica and the first successful "
+            "response is used.");
+TAG_FLAG(enable_hedged_reads, evolving);
+TAG_FLAG(enable_hedged_reads, runtime);
+
+DEFINE_double(hedged_read_latency_percentile, 95.0,
+              "Percentile of recent read latencies of a tablet server after which a read to it "
+              "is hedged.");
+TAG_FLAG(hedged_read_latency_percentile, advanced);
+TAG_FLAG(hedged_read_latency_percentile, runtime);
+
 using namespace std::placeholders;
 
 namespace yb {
@@ -90,7 +114,9 @@ AsyncRpcMetrics::AsyncRpcMetrics(const scoped_refptr<yb::MetricEntity>& entity)
       remote_read_rpc_time(METRIC_handler_latency_yb_client_read_remote.Instantiate(entity)),
       local_write_rpc_time(METRIC_handler_latency_yb_client_write_local.Instantiate(entity)),
       local_read_rpc_time(METRIC_handler_latency_yb_client_read_local.Instantiate(entity)),
-      time_to_send(METRIC_handler_latency_yb_client_time_to_send.Instantiate(entity)) {
+      time_to_send(METRIC_handler_latency_yb_client_time_to_send.Instantiate(entity)),
+      hedged_reads(METRIC_hedged_reads.Instantiate(entity)),
+      hedged_reads_won(METRIC_hedged_reads_won.Instantiate(entity)) {
 }
 
 AsyncRpc::AsyncRpc(
@@ -153,13 +179,24 @@ const YBTable* AsyncRpc::table() const {
 void AsyncRpc::Finished(const Status& status) {
   Status new_status = status;
   if (tablet_invoker_.Done(&new_status)) {
-    ProcessResponseFromTserver(new_status);
-    batcher_->RemoveInFlightOpsAfterFlushing(ops_, new_status, PropagatedHybridTime());
-    batcher_->CheckForFinishedFlush();
-    retained_self_.reset();
+    if (tablet_invoker_.tablet_split()) {
+      // The ops are sent again to the tablets that replaced the split tablet.
+      RestoreRequests();
+      batcher_->RouteOpsOfSplitTablet(ops_);
+      retained_self_.reset();
+      return;
+    }
+    Completed(new_status);
   }
 }
 
+void AsyncRpc::Completed(const Status& status) {
+  ProcessResponseFromTserver(status);
+  batcher_->RemoveInFlightOpsAfterFlushing(ops_, status, PropagatedHybridTime());
+  batcher_->CheckForFinishedFlush();
+  retained_self_.reset();
+}
+
 void AsyncRpc::Failed(const Status& status) {
   std::string error_message = status.message().ToBuffer();
   auto redis_error_code = status.IsInvalidCommand() || status.IsInvalidArgument() ?
@@ -542,6 +579,16 @@ ReadRpc::ReadRpc(
   req_.set_consistency_level(yb_consistency_level);
   req_.set_proxy_uuid(batcher->proxy_uuid());
 
+  // Ops batched into the same RPC could ask for different staleness bounds, so the tightest one
+  // is sent.
+  uint64_t max_staleness_ms = 0;
+  auto update_max_staleness = [&max_staleness_ms](uint64_t op_max_staleness_ms) {
+    if (op_max_staleness_ms > 0 &&
+        (max_staleness_ms == 0 || op_max_staleness_ms < max_staleness_ms)) {
+      max_staleness_ms = op_max_staleness_ms;
+    }
+  };
+
   int ctr = 0;
   for (auto& op : ops_) {
     switch (op->yb_op->type()) {
@@ -551,6 +598,7 @@ ReadRpc::ReadRpc(
         // in ProcessResponseFromTserver.
         auto* redis_op = down_cast<YBRedisReadOp*>(op->yb_op.get());
         req_.add_redis_batch()->Swap(redis_op->mutable_request());
+        update_max_staleness(redis_op->max_staleness_ms());
         break;
       }
       case YBOperation::Type::QL_READ: {
@@ -562,6 +610,7 @@ ReadRpc::ReadRpc(
         if (ql_op->read_time()) {
           ql_op->read_time().AddToPB(&req_);
         }
+        update_max_staleness(ql_op->max_staleness_ms());
         break;
       }
       case YBOperation::Type::PGSQL_READ: {
@@ -586,6 +635,10 @@ ReadRpc::ReadRpc(
     VLOG(4) << ++ctr << ". Encoded row " << op->yb_op->ToString();
   }
 
+  if (yb_consistency_level == YBConsistencyLevel::CONSISTENT_PREFIX && max_staleness_ms > 0) {
+    req_.set_max_staleness_ms(max_staleness_ms);
+  }
+
   if (VLOG_IS_ON(3)) {
     VLOG(3) << "Created batch for " << tablet->tablet_id() << ":\n" << req_.ShortDebugString();
   }
@@ -609,10 +662,158 @@ void ReadRpc::CallRemoteMethod() {
                        // Detailed explanation in WriteRpc::SendRpcToTserver.
   TRACE_TO(trace, "SendRpcToTserver");
   ADOPT_TRACE(trace.get());
+
+  primary_ts_ = &tablet_invoker_.current_ts();
+  primary_start_ = MonoTime::Now();
+  auto hedge_delay = PrepareHedge();
+  hedged_attempt_ = hedge_delay.Initialized();
+  if (!hedged_attempt_) {
+    tablet_invoker_.proxy()->ReadAsync(
+        req_, &resp_, PrepareController(), std::bind(&ReadRpc::PrimaryFinished, this));
+    TRACE_TO(trace, "RpcDispatched Asynchronously");
+    return;
+  }
+
+  // The hedge could complete this RPC while the primary call is still in flight, so both calls
+  // retain this RPC until they complete.
+  auto self = shared_from_this();
   tablet_invoker_.proxy()->ReadAsync(
-      req_, &resp_, PrepareController(),
-      std::bind(&ReadRpc::Finished, this, Status::OK()));
-  TRACE_TO(trace, "RpcDispatched Asynchronously");
+      req_, &primary_resp_, PrepareController(), [this, self] { PrimaryFinished(); });
+  TRACE_TO(trace, "RpcDispatched Asynchronously, hedge after $0", hedge_delay.ToString());
+  retrier().messenger()->ScheduleOnReactor(
+      [this, self](const Status& status) { SendHedge(status); }, hedge_delay,
+      retrier().messenger());
+}
+
+MonoDelta ReadRpc::PrepareHedge() {
+  // Only the first attempt is hedged. It also guarantees that a read is hedged at most once, since
+  // hedge_ could still be in use by the hedge of the first attempt.
+  if (!FLAGS_enable_hedged_reads || num_attempts() != 1 ||
+      req_.consistency_level() != YBConsistencyLevel::CONSISTENT_PREFIX ||
+      tablet_invoker_.local_tserver_only() || IsLocalCall()) {
+    return MonoDelta();
+  }
+
+  auto delay = primary_ts_->ReadLatencyPercentile(FLAGS_hedged_read_latency_percentile);
+  if (!delay.Initialized()) {
+    return MonoDelta();
+  }
+
+  std::vector<RemoteTabletServer*> replicas;
+  tablet_invoker_.tablet()->GetRemoteTabletServers(&replicas, UpdateLocalTsState::kFalse);
+  for (auto* ts : replicas) {
+    if (ts != primary_ts_ && ts->InitProxy(&tablet_invoker_.client()).ok()) {
+      hedge_ = std::make_unique<HedgedCall>();
+      hedge_->ts = ts;
+      return delay;
+    }
+  }
+  return MonoDelta();
+}
+
+void ReadRpc::SendHedge(const Status& status) {
+  if (!status.ok()) {
+    // The messenger is shutting down, the primary call completes this RPC.
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(hedge_mutex_);
+    if (response_owner_ != ResponseOwner::kNone || primary_finished_) {
+      return;
+    }
+    // The request is restored to the operations once the response is claimed, so copy it while
+    // the response cannot be claimed.
+    hedge_->req = req_;
+    hedge_in_flight_ = true;
+  }
+
+  TRACE_TO(trace_, "Sending hedged read to $0", hedge_->ts->permanent_uuid());
+  if (async_rpc_metrics_) {
+    async_rpc_metrics_->hedged_reads->Increment();
+  }
+  hedge_->controller.set_deadline(deadline());
+  hedge_->start = MonoTime::Now();
+  hedge_->ts->proxy()->ReadAsync(
+      hedge_->req, &hedge_->resp, &hedge_->controller,
+      [this, self = shared_from_this()] { HedgeFinished(); });
+}
+
+void ReadRpc::PrimaryFinished() {
+  const bool succeeded = retrier().controller().status().ok() &&
+                         !(hedged_attempt_ ? primary_resp_ : resp_).has_error();
+  if (succeeded) {
+    UpdateReadLatency(primary_ts_, primary_start_);
+  }
+  if (hedged_attempt_) {
+    {
+      std::lock_guard<std::mutex> lock(hedge_mutex_);
+      primary_finished_ = true;
+      if (response_owner_ != ResponseOwner::kNone) {
+        VLOG(2) << ToString() << ": hedged read to " << hedge_->ts->permanent_uuid() << " won";
+        return;
+      }
+      // A failed primary call leaves the response to the hedge in flight, it completes this RPC
+      // with the failure of the primary call if it fails as well.
+      if (!succeeded && hedge_in_flight_) {
+        return;
+      }
+      response_owner_ = ResponseOwner::kPrimary;
+    }
+    resp_.Swap(&primary_resp_);
+  }
+  Finished(Status::OK());
+}
+
+void ReadRpc::HedgeFinished() {
+  const bool succeeded = hedge_->controller.status().ok() && !hedge_->resp.has_error();
+  if (!succeeded) {
+    VLOG(2) << ToString() << ": hedged read to " << hedge_->ts->permanent_uuid() << " failed: "
+            << (hedge_->controller.status().ok() ? StatusFromPB(hedge_->resp.error().status())
+                                                 : hedge_->controller.status());
+  } else {
+    UpdateReadLatency(hedge_->ts, hedge_->start);
+  }
+  {
+    std::lock_guard<std::mutex> lock(hedge_mutex_);
+    hedge_in_flight_ = false;
+    if (response_owner_ != ResponseOwner::kNone) {
+      return;
+    }
+    if (succeeded) {
+      response_owner_ = ResponseOwner::kHedge;
+    } else if (primary_finished_) {
+      // The primary call failed before, and waited for the hedge. Process its failure as usual.
+      response_owner_ = ResponseOwner::kPrimary;
+    } else {
+      // The primary call is still in flight and completes this RPC.
+      return;
+    }
+  }
+
+  if (!succeeded) {
+    resp_.Swap(&primary_resp_);
+    Finished(Status::OK());
+    return;
+  }
+
+  // There is no way to cancel the primary call, so its response is just ignored when it arrives.
+  TRACE_TO(trace_, "Using response of hedged read to $0", hedge_->ts->permanent_uuid());
+  if (async_rpc_metrics_) {
+    async_rpc_metrics_->hedged_reads_won->Increment();
+  }
+  hedge_won_ = true;
+  resp_.Swap(&hedge_->resp);
+  Completed(Status::OK());
+}
+
+const rpc::RpcController& ReadRpc::response_controller() const {
+  return hedge_won_ ? hedge_->controller : retrier().controller();
+}
+
+void ReadRpc::UpdateReadLatency(RemoteTabletServer* ts, MonoTime start) {
+  if (FLAGS_enable_hedged_reads && !ts->IsLocal()) {
+    ts->UpdateReadLatency(MonoTime::Now().GetDeltaSince(start));
+  }
 }
 
 void ReadRpc::SwapRequestsAndResponses(bool skip_responses) {
@@ -681,7 +882,7 @@ void ReadRpc::SwapRequestsAndResponses(bool skip_responses) {
         const auto& ql_response = ql_op->response();
         if (ql_response.has_rows_data_sidecar()) {
           Slice rows_data;
-          CHECK_OK(retrier().controller().GetSidecar(
+          CHECK_OK(response_controller().GetSidecar(
               ql_response.rows_data_sidecar(), &rows_data));
           ql_op->mutable_rows_data()->assign(util::to_char_ptr(rows_data.data()), rows_data.size());
         }
@@ -699,7 +900,7 @@ void ReadRpc::SwapRequestsAndResponses(bool skip_responses) {
         const auto& pgsql_response = pgsql_op->response();
         if (pgsql_response.has_rows_data_sidecar()) {
           Slice rows_data;
-          CHECK_OK(retrier().controller().GetSidecar(
+          CHECK_OK(response_controller().GetSidecar(
               pgsql_response.rows_data_sidecar(), &rows_data));
           down_cast<YBPgsqlReadOp*>(yb_op)->mutable_rows_data()->assign(
               util::to_char_ptr(rows_data.data()), rows_data.size());
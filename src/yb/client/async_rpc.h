@@ -14,6 +14,10 @@
 #ifndef YB_CLIENT_ASYNC_RPC_H_
 #define YB_CLIENT_ASYNC_RPC_H_
 
+#include <memory>
+#include <mutex>
+
+#include "yb/rpc/rpc_controller.h"
 #include "yb/rpc/rpc_fwd.h"
 
 #include "yb/tserver/tserver_service.proxy.h"
@@ -42,6 +46,8 @@ struct AsyncRpcMetrics {
   scoped_refptr<Histogram> local_write_rpc_time;
   scoped_refptr<Histogram> local_read_rpc_time;
   scoped_refptr<Histogram> time_to_send;
+  scoped_refptr<Counter> hedged_reads;
+  scoped_refptr<Counter> hedged_reads_won;
 };
 
 typedef std::shared_ptr<AsyncRpcMetrics> AsyncRpcMetricsPtr;
@@ -72,6 +78,9 @@ class AsyncRpc : public rpc::Rpc, public TabletRpc {
  protected:
   void Finished(const Status& status) override;
 
+  // Processes the final outcome of this RPC, once no more retries are needed.
+  void Completed(const Status& status);
+
   void SendRpcToTserver() override;
 
   virtual void CallRemoteMethod() = 0;
@@ -80,6 +89,10 @@ class AsyncRpc : public rpc::Rpc, public TabletRpc {
   // stored in batcher. If there's a callback from the user, it is done in this step.
   virtual void ProcessResponseFromTserver(const Status& status) = 0;
 
+  // Moves the requests of the ops back from the tserver request, so that the ops can be sent
+  // again in another RPC.
+  virtual void RestoreRequests() = 0;
+
   // Return latest hybrid time that was present on tserver during processing of this request.
   virtual HybridTime PropagatedHybridTime() = 0;
 
@@ -146,6 +159,7 @@ class WriteRpc : public AsyncRpcBase<tserver::WriteRequestPB, tserver::WriteResp
   void SwapRequestsAndResponses(bool skip_responses);
   void CallRemoteMethod() override;
   void ProcessResponseFromTserver(const Status& status) override;
+  void RestoreRequests() override { SwapRequestsAndResponses(true); }
 };
 
 class ReadRpc : public AsyncRpcBase<tserver::ReadRequestPB, tserver::ReadResponsePB> {
@@ -158,9 +172,55 @@ class ReadRpc : public AsyncRpcBase<tserver::ReadRequestPB, tserver::ReadRespons
   virtual ~ReadRpc();
 
  private:
+  // A duplicate of the first attempt of a consistent prefix read, sent to another replica when
+  // the original call is slower than the recent latencies of its tablet server.
+  struct HedgedCall {
+    RemoteTabletServer* ts = nullptr;
+    tserver::ReadRequestPB req;
+    tserver::ReadResponsePB resp;
+    rpc::RpcController controller;
+    MonoTime start;
+  };
+
+  enum class ResponseOwner {
+    kNone,
+    kPrimary,
+    kHedge,
+  };
+
   void SwapRequestsAndResponses(bool skip_responses);
   void CallRemoteMethod() override;
   void ProcessResponseFromTserver(const Status& status) override;
+  void RestoreRequests() override { SwapRequestsAndResponses(true); }
+
+  // Prepares hedge_ and returns the delay after which it should be sent, or uninitialized
+  // MonoDelta if the current attempt should not be hedged.
+  MonoDelta PrepareHedge();
+  void SendHedge(const Status& status);
+  void PrimaryFinished();
+  void HedgeFinished();
+
+  // Returns the controller of the call whose response is processed.
+  const rpc::RpcController& response_controller() const;
+
+  void UpdateReadLatency(RemoteTabletServer* ts, MonoTime start);
+
+  RemoteTabletServer* primary_ts_ = nullptr;
+  MonoTime primary_start_;
+
+  // Whether the current attempt is hedged. Then the response of the primary call is received to
+  // primary_resp_ and moved to resp_ only if the primary call claimed the response.
+  bool hedged_attempt_ = false;
+  tserver::ReadResponsePB primary_resp_;
+  std::unique_ptr<HedgedCall> hedge_;
+  bool hedge_won_ = false;
+
+  // The response of a hedged attempt is claimed by the first call that succeeds. A failed call
+  // claims it only when the other call has failed too or was never sent.
+  std::mutex hedge_mutex_;
+  ResponseOwner response_owner_ = ResponseOwner::kNone;
+  bool primary_finished_ = false;
+  bool hedge_in_flight_ = false;
 };
 
 }  // namespace internal
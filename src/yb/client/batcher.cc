@@ -68,6 +68,14 @@ DEFINE_bool(redis_allow_reads_from_followers, false,
 TAG_FLAG(redis_allow_reads_from_followers, evolving);
 TAG_FLAG(redis_allow_reads_from_followers, runtime);
 
+DEFINE_int32(redis_follower_read_max_staleness_ms, 0,
+             "When redis_allow_reads_from_followers is set, the maximum time in milliseconds a "
+             "follower could be behind the leader to serve a read. If set to zero, the tablet "
+             "server's max_stale_read_bound_time_ms is used. This is the default of "
+             "YBRedisReadOp::max_staleness_ms(), which can be overridden per read.");
+TAG_FLAG(redis_follower_read_max_staleness_ms, evolving);
+TAG_FLAG(redis_follower_read_max_staleness_ms, runtime);
+
 using std::pair;
 using std::set;
 using std::unique_ptr;
@@ -202,6 +210,7 @@ void Batcher::CheckForFinishedFlush() {
 }
 
 void Batcher::RunCallback(const Status& status) {
+  flush_stage_timer_.Finish();
   auto runnable = std::make_shared<yb::FunctionRunnable>(
       [ cb{std::move(flush_callback_)}, status ]() { cb(status); });
   if (!client_->callback_threadpool() || !client_->callback_threadpool()->Submit(runnable).ok()) {
@@ -227,6 +236,7 @@ void Batcher::FlushAsync(StatusFunctor callback) {
     CHECK_EQ(state_, kGatheringOps);
     state_ = kFlushing;
     flush_callback_ = std::move(callback);
+    flush_stage_timer_.Start();
     deadline_ = ComputeDeadlineUnlocked();
   }
 
@@ -580,6 +590,30 @@ void Batcher::RemoveInFlightOpsAfterFlushing(
   }
 }
 
+void Batcher::RouteOpsOfSplitTablet(const InFlightOps& ops) {
+  MonoTime deadline;
+  {
+    std::lock_guard<simple_spinlock> l(lock_);
+    deadline = deadline_;
+    outstanding_lookups_ += ops.size();
+    for (auto& op : ops) {
+      std::lock_guard<simple_spinlock> l2(op->lock_);
+      VLOG(3) << "Routing op of split tablet " << op->tablet->tablet_id() << " again: "
+              << op->yb_op->ToString();
+      op->state = InFlightOpState::kLookingUpTablet;
+      op->tablet.reset();
+    }
+  }
+
+  for (auto& op : ops) {
+    // The tablet the op was routed to explicitly has been replaced as well.
+    op->yb_op->SetTablet(nullptr);
+    client_->data_->meta_cache_->LookupTabletByKey(
+        op->yb_op->table(), op->partition_key, deadline,
+        std::bind(&Batcher::TabletLookupFinished, BatcherPtr(this), op, _1));
+  }
+}
+
 void Batcher::ProcessRpcStatus(const AsyncRpc &rpc, const Status &s) {
   // TODO: there is a potential race here -- if the Batcher gets destructed while
   // RPCs are in-flight, then accessing state_ will crash. We probably need to keep
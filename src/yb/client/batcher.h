@@ -51,6 +51,7 @@
 #include "yb/util/debug-util.h"
 #include "yb/util/locks.h"
 #include "yb/util/status.h"
+#include "yb/util/trace.h"
 
 namespace yb {
 
@@ -172,6 +173,10 @@ class Batcher : public RefCountedThreadSafe<Batcher> {
   void RemoveInFlightOpsAfterFlushing(
       const InFlightOps& ops, const Status& status, HybridTime propagated_hybrid_time);
 
+  // Looks up the tablets of ops that were sent to a tablet that has since been split, and sends
+  // them again to the tablets it was split into.
+  void RouteOpsOfSplitTablet(const InFlightOps& ops);
+
     // Return true if the batch has been aborted, and any in-flight ops should stop
   // processing wherever they are.
   bool IsAbortedUnlocked() const;
@@ -241,6 +246,9 @@ class Batcher : public RefCountedThreadSafe<Batcher> {
   // will be called exactly once (and the state changed to kFlushed).
   StatusFunctor flush_callback_;
 
+  // Measures flush of sampled requests, from FlushAsync until flush_callback_ is invoked.
+  TraceStageTimer flush_stage_timer_{TraceStage::kClientBatcher};
+
   // All buffered or in-flight ops.
   // Added to this set during apply, removed during Finished of AsyncRpc.
   std::unordered_set<InFlightOpPtr> ops_;
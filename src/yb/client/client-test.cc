@@ -79,25 +79,35 @@
 #include "yb/util/thread.h"
 #include "yb/util/tostring.h"
 
+DECLARE_bool(do_not_start_election_test_only);
 DECLARE_bool(enable_data_block_fsync);
+DECLARE_bool(enable_hedged_reads);
+DECLARE_bool(follower_reject_update_consensus_requests);
 DECLARE_bool(log_inject_latency);
+DECLARE_double(hedged_read_latency_percentile);
 DECLARE_double(leader_failure_max_missed_heartbeat_periods);
 DECLARE_int32(heartbeat_interval_ms);
 DECLARE_int32(log_inject_latency_ms_mean);
 DECLARE_int32(log_inject_latency_ms_stddev);
 DECLARE_int32(master_inject_latency_on_tablet_lookups_ms);
 DECLARE_int32(max_create_tablets_per_ts);
+DECLARE_int32(read_delay_ms_in_tests);
+DECLARE_int32(read_latency_min_samples);
 DECLARE_int32(scanner_inject_latency_on_each_batch_ms);
 DECLARE_int32(scanner_max_batch_size_bytes);
 DECLARE_int32(scanner_ttl_ms);
 DECLARE_int32(tablet_server_svc_queue_length);
 DECLARE_int32(replication_factor);
+DECLARE_string(read_delay_tserver_uuid_in_tests);
 
 DEFINE_int32(test_scan_num_rows, 1000, "Number of rows to insert and scan");
 DECLARE_int32(min_backoff_ms_exponent);
 DECLARE_int32(max_backoff_ms_exponent);
 
 METRIC_DECLARE_counter(rpcs_queue_overflow);
+METRIC_DECLARE_counter(hedged_reads);
+METRIC_DECLARE_counter(hedged_reads_won);
+METRIC_DECLARE_entity(server);
 
 using namespace std::literals; // NOLINT
 using namespace std::placeholders;
@@ -394,6 +404,31 @@ class ClientTest: public YBMiniClusterTestBase<MiniCluster> {
     return rpc::MessengerBuilder(name).Build();
   }
 
+  // Reads all columns of the tablet from the replica behind proxy with consistent prefix
+  // consistency and the given staleness bound.
+  Result<tserver::ReadResponsePB> ReadWithStalenessBound(
+      tserver::TabletServerServiceProxy* proxy, const string& tablet_id,
+      uint64_t max_staleness_ms) {
+    tserver::ReadRequestPB req;
+    tserver::ReadResponsePB resp;
+    rpc::RpcController controller;
+    req.set_tablet_id(tablet_id);
+    req.set_consistency_level(YBConsistencyLevel::CONSISTENT_PREFIX);
+    req.set_max_staleness_ms(max_staleness_ms);
+    QLReadRequestPB* ql_read = req.add_ql_batch();
+    QLRSRowDescPB* rsrow_desc = ql_read->mutable_rsrow_desc();
+    for (int i = 0; i < schema_.num_columns(); i++) {
+      ql_read->add_selected_exprs()->set_column_id(yb::kFirstColumnId + i);
+      ql_read->mutable_column_refs()->add_ids(yb::kFirstColumnId + i);
+
+      QLRSColDescPB* rscol_desc = rsrow_desc->add_rscol_descs();
+      rscol_desc->set_name(schema_.column(i).name());
+      schema_.column(i).type()->ToQLTypePB(rscol_desc->mutable_ql_type());
+    }
+    RETURN_NOT_OK(proxy->Read(req, &resp, &controller));
+    return resp;
+  }
+
   enum WhichServerToKill {
     DEAD_MASTER,
     DEAD_TSERVER
@@ -1519,6 +1554,57 @@ TEST_F(ClientTest, TestReplicatedTabletWritesWithLeaderElection) {
                                                      kNoBound, kNoBound));
 }
 
+TEST_F(ClientTest, TestHedgedReads) {
+  FLAGS_enable_hedged_reads = true;
+  FLAGS_read_latency_min_samples = 1;
+  // Hedge almost every read, so responses of both primary and hedged calls are used.
+  FLAGS_hedged_read_latency_percentile = 1;
+
+  const YBTableName kReplicatedTable("replicated_hedged_reads");
+  const int kNumRowsToWrite = 100;
+
+  TableHandle table;
+  ASSERT_NO_FATALS(CreateTable(kReplicatedTable, 1, &table));
+  ASSERT_NO_FATALS(InsertTestRows(table, kNumRowsToWrite));
+
+  // Hedging is reported through the metrics of the client.
+  MetricRegistry metric_registry;
+  auto metric_entity = METRIC_ENTITY_server.Instantiate(&metric_registry, "hedged-reads-client");
+  std::shared_ptr<YBClient> client;
+  ASSERT_OK(YBClientBuilder()
+      .add_master_server_addr(yb::ToString(cluster_->mini_master()->bound_rpc_addr()))
+      .set_metric_entity(metric_entity)
+      .Build(&client));
+  TableHandle hedged_table;
+  ASSERT_OK(hedged_table.Open(kReplicatedTable, client.get()));
+  auto hedged_reads = METRIC_hedged_reads.Instantiate(metric_entity);
+  auto hedged_reads_won = METRIC_hedged_reads_won.Instantiate(metric_entity);
+
+  // Make sure that followers have all the writes, since hedged reads are served by any replica.
+  SleepFor(MonoDelta::FromMilliseconds(1500));
+
+  for (int i = 0; i != 50; ++i) {
+    ASSERT_EQ(kNumRowsToWrite, CountRowsFromClient(hedged_table,
+                                                   YBConsistencyLevel::CONSISTENT_PREFIX,
+                                                   kNoBound, kNoBound));
+  }
+  ASSERT_GT(hedged_reads->value(), 0);
+
+  // Delay reads of one replica, much longer than its recent latencies. Reads to it should be
+  // answered by the hedge sent to another replica.
+  const auto hedges_won_before = hedged_reads_won->value();
+  FLAGS_read_delay_tserver_uuid_in_tests = cluster_->mini_tablet_server(0)->server()->
+      permanent_uuid();
+  FLAGS_read_delay_ms_in_tests = 2000;
+  for (int i = 0; i != 20; ++i) {
+    ASSERT_EQ(kNumRowsToWrite, CountRowsFromClient(hedged_table,
+                                                   YBConsistencyLevel::CONSISTENT_PREFIX,
+                                                   kNoBound, kNoBound));
+  }
+  FLAGS_read_delay_ms_in_tests = 0;
+  ASSERT_GT(hedged_reads_won->value(), hedges_won_before);
+}
+
 namespace {
 
 void CheckCorrectness(const TableHandle& table, int expected[], int nrows) {
@@ -1969,5 +2055,62 @@ TEST_F(ClientTest, TestReadFromFollower) {
   }
 }
 
+TEST_F(ClientTest, TestReadFromFollowerWithStalenessBound) {
+  const YBTableName kTableName("TestReadFromFollowerWithStalenessBound");
+  TableHandle table;
+  ASSERT_NO_FATALS(CreateTable(kTableName, 1, &table));
+  ASSERT_NO_FATALS(InsertTestRows(table, FLAGS_test_scan_num_rows));
+
+  GetTableLocationsRequestPB req;
+  GetTableLocationsResponsePB resp;
+  table->name().SetIntoTableIdentifierPB(req.mutable_table());
+  ASSERT_OK(cluster_->mini_master()->master()->catalog_manager()->GetTableLocations(&req, &resp));
+  ASSERT_EQ(1, resp.tablet_locations_size());
+  const string& tablet_id = resp.tablet_locations(0).tablet_id();
+
+  auto client_messenger = ASSERT_RESULT(CreateMessenger("client"));
+  rpc::ProxyCache proxy_cache(client_messenger);
+  std::vector<std::unique_ptr<tserver::TabletServerServiceProxy>> follower_proxies;
+  for (const auto& replica : resp.tablet_locations(0).replicas()) {
+    if (replica.role() == consensus::RaftPeerPB_Role_FOLLOWER) {
+      follower_proxies.push_back(std::make_unique<tserver::TabletServerServiceProxy>(
+          &proxy_cache, HostPortFromPB(replica.ts_info().private_rpc_addresses(0))));
+    }
+  }
+  ASSERT_FALSE(follower_proxies.empty());
+
+  // A follower that keeps hearing from the leader serves reads within a generous bound.
+  for (const auto& proxy : follower_proxies) {
+    ASSERT_OK(WaitFor([&]() -> Result<bool> {
+      auto read_resp = VERIFY_RESULT(ReadWithStalenessBound(proxy.get(), tablet_id, 10000));
+      return !read_resp.has_error();
+    }, MonoDelta::FromSeconds(30), "Waiting for follower to catch up"));
+  }
+
+  // Make the followers stop hearing from the leader without electing a new one, so they lag
+  // behind and have to reject reads with a tight bound.
+  FLAGS_do_not_start_election_test_only = true;
+  FLAGS_follower_reject_update_consensus_requests = true;
+  const uint64_t kMaxStalenessMs = 500;
+  for (const auto& proxy : follower_proxies) {
+    ASSERT_OK(WaitFor([&]() -> Result<bool> {
+      auto read_resp = VERIFY_RESULT(ReadWithStalenessBound(
+          proxy.get(), tablet_id, kMaxStalenessMs));
+      return read_resp.has_error() &&
+             read_resp.error().code() == tserver::TabletServerErrorPB::STALE_FOLLOWER;
+    }, MonoDelta::FromSeconds(30), "Waiting for follower to become stale"));
+  }
+
+  // Once the followers hear from the leader again, they serve reads within the same bound.
+  FLAGS_follower_reject_update_consensus_requests = false;
+  for (const auto& proxy : follower_proxies) {
+    ASSERT_OK(WaitFor([&]() -> Result<bool> {
+      auto read_resp = VERIFY_RESULT(ReadWithStalenessBound(
+          proxy.get(), tablet_id, kMaxStalenessMs));
+      return !read_resp.has_error();
+    }, MonoDelta::FromSeconds(30), "Waiting for follower to catch up"));
+  }
+}
+
 }  // namespace client
 }  // namespace yb
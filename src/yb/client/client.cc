@@ -1409,6 +1409,10 @@ const std::string& YBTable::FindPartitionStart(
   return data_->partitions_[idx];
 }
 
+const std::vector<std::string>& YBTable::GetPartitions() const {
+  return data_->partitions_;
+}
+
 //--------------------------------------------------------------------------------------------------
 
 YBPgsqlWriteOp* YBTable::NewPgsqlWrite() {
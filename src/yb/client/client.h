@@ -766,6 +766,9 @@ class YBTable : public std::enable_shared_from_this<YBTable> {
   const std::string& FindPartitionStart(
       const std::string& partition_key, size_t group_by = 1) const;
 
+  // Returns the sorted start partition keys of the table's tablets.
+  const std::vector<std::string>& GetPartitions() const;
+
   //------------------------------------------------------------------------------------------------
   // Postgres support
   // Create a new QL operation for this table.
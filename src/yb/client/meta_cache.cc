@@ -30,6 +30,7 @@
 // under the License.
 //
 
+#include <algorithm>
 #include <mutex>
 
 #include <boost/bind.hpp>
@@ -50,6 +51,7 @@
 #include "yb/rpc/rpc.h"
 #include "yb/tserver/tserver_service.proxy.h"
 #include "yb/util/flag_tags.h"
+#include "yb/util/hdr_histogram.h"
 #include "yb/util/net/dns_resolver.h"
 #include "yb/util/net/net_util.h"
 
@@ -65,6 +67,16 @@ DEFINE_test_flag(bool, verify_all_replicas_alive, false,
                  "If set, when a RemoteTablet object is destroyed, we will verify that all its "
                  "replicas are not marked as failed");
 
+DEFINE_int32(read_latency_window_size, 1000,
+             "Number of reads that the client tracks per tablet server to estimate the latency "
+             "percentiles used by hedged reads.");
+TAG_FLAG(read_latency_window_size, advanced);
+
+DEFINE_int32(read_latency_min_samples, 100,
+             "Minimal number of reads served by a tablet server before the client uses their "
+             "latency percentiles.");
+TAG_FLAG(read_latency_min_samples, advanced);
+
 METRIC_DEFINE_histogram(
   server, dns_resolve_latency_during_init_proxy,
   "yb.client.MetaCache.InitProxy DNS Resolve",
@@ -101,6 +113,9 @@ const size_t kPartitionGroupSize = 64;
 const size_t kPartitionGroupSize = 4;
 #endif
 
+// Read latencies above this value are recorded as this value.
+const uint64_t kMaxReadLatencyUs = 60000000;
+
 } // namespace
 
 ////////////////////////////////////////////////////////////
@@ -116,6 +131,8 @@ RemoteTabletServer::RemoteTabletServer(
     : uuid_(uuid), proxy_(proxy) {
 }
 
+RemoteTabletServer::~RemoteTabletServer() = default;
+
 Status RemoteTabletServer::InitProxy(YBClient* client) {
   std::unique_lock<simple_spinlock> l(lock_);
 
@@ -185,6 +202,48 @@ string RemoteTabletServer::ToString() const {
   return ret;
 }
 
+void RemoteTabletServer::UpdateReadLatency(MonoDelta latency) {
+  std::shared_ptr<HdrHistogram> histogram;
+  {
+    std::lock_guard<simple_spinlock> l(lock_);
+    histogram = read_latency_;
+  }
+  if (!histogram) {
+    auto new_histogram = std::make_shared<HdrHistogram>(kMaxReadLatencyUs, 2);
+    std::lock_guard<simple_spinlock> l(lock_);
+    if (!read_latency_) {
+      read_latency_ = std::move(new_histogram);
+    }
+    histogram = read_latency_;
+  }
+
+  histogram->Increment(std::min<uint64_t>(std::max<int64_t>(latency.ToMicroseconds(), 0),
+                                          kMaxReadLatencyUs));
+
+  if (histogram->TotalCount() >= static_cast<uint64_t>(FLAGS_read_latency_window_size)) {
+    auto new_histogram = std::make_shared<HdrHistogram>(kMaxReadLatencyUs, 2);
+    std::lock_guard<simple_spinlock> l(lock_);
+    // Another thread could have already started a new window.
+    if (read_latency_ == histogram) {
+      prev_read_latency_ = std::move(read_latency_);
+      read_latency_ = std::move(new_histogram);
+    }
+  }
+}
+
+MonoDelta RemoteTabletServer::ReadLatencyPercentile(double percentile) const {
+  std::shared_ptr<HdrHistogram> histogram;
+  {
+    std::lock_guard<simple_spinlock> l(lock_);
+    histogram = prev_read_latency_ ? prev_read_latency_ : read_latency_;
+  }
+  if (!histogram ||
+      histogram->TotalCount() < static_cast<uint64_t>(FLAGS_read_latency_min_samples)) {
+    return MonoDelta();
+  }
+  return MonoDelta::FromMicroseconds(histogram->ValueAtPercentile(percentile));
+}
+
 bool RemoteTabletServer::HasHostFrom(const std::unordered_set<std::string>& hosts) const {
   std::lock_guard<simple_spinlock> l(lock_);
   for (const auto& hp : private_rpc_hostports_) {
@@ -662,6 +721,7 @@ RemoteTabletPtr MetaCache::ProcessTabletLocations(
         Partition::FromPB(loc.partition(), &partition);
         remote = new RemoteTablet(tablet_id, partition);
 
+        RemoveReplacedTabletsUnlocked(partition, &tablets_by_key);
         CHECK(tablets_by_id_.emplace(tablet_id, remote).second);
         CHECK(tablets_by_key.emplace(partition.partition_key_start(), remote).second);
       }
@@ -676,12 +736,15 @@ RemoteTabletPtr MetaCache::ProcessTabletLocations(
         auto lookup_by_group_iter = table_data.tablet_lookups_by_group.find(*partition_group_start);
         if (lookup_by_group_iter != table_data.tablet_lookups_by_group.end()) {
           auto& lookups_by_partition_key = lookup_by_group_iter->second;
-          auto lookups_iter = lookups_by_partition_key.find(loc.partition().partition_key_start());
-          if (lookups_iter != lookups_by_partition_key.end()) {
+          const auto& partition_end = loc.partition().partition_key_end();
+          auto lookups_iter = lookups_by_partition_key.lower_bound(
+              loc.partition().partition_key_start());
+          while (lookups_iter != lookups_by_partition_key.end() &&
+                 (partition_end.empty() || lookups_iter->first < partition_end)) {
             for (auto& lookup : lookups_iter->second) {
               to_notify.emplace_back(std::move(lookup.callback), remote);
             }
-            lookups_by_partition_key.erase(lookups_iter);
+            lookups_iter = lookups_by_partition_key.erase(lookups_iter);
           }
           if (lookups_by_partition_key.empty()) {
             table_data.tablet_lookups_by_group.erase(lookup_by_group_iter);
@@ -699,6 +762,136 @@ RemoteTabletPtr MetaCache::ProcessTabletLocations(
   return result;
 }
 
+void MetaCache::RemoveReplacedTabletsUnlocked(
+    const Partition& partition, std::map<PartitionKey, RemoteTabletPtr>* tablets_by_key) {
+  const auto& start = partition.partition_key_start();
+  const auto& end = partition.partition_key_end();
+  auto it = tablets_by_key->upper_bound(start);
+  if (it != tablets_by_key->begin()) {
+    auto prev = std::prev(it);
+    const auto& prev_end = prev->second->partition().partition_key_end();
+    if (prev->first == start || prev_end.empty() || prev_end > start) {
+      it = prev;
+    }
+  }
+  while (it != tablets_by_key->end() && (end.empty() || it->first < end)) {
+    VLOG(1) << "Tablet " << it->second->tablet_id() << " has been replaced by split tablets";
+    it->second->MarkStale();
+    tablets_by_id_.erase(it->second->tablet_id());
+    it = tablets_by_key->erase(it);
+  }
+}
+
+bool MetaCache::GetKnownLocationsVersion(const TableId& table_id,
+                                         master::TabletLocationsVersionPB* version) {
+  boost::shared_lock<decltype(mutex_)> l(mutex_);
+  auto it = tables_.find(table_id);
+  if (it == tables_.end() || it->second.locations_epoch == 0) {
+    return false;
+  }
+  version->set_epoch(it->second.locations_epoch);
+  version->set_version(it->second.locations_version);
+  return true;
+}
+
+void MetaCache::ProcessTabletLocationsChanges(const TableId& table_id,
+                                              const GetTableLocationsRequestPB& req,
+                                              const GetTableLocationsResponsePB& resp) {
+  std::lock_guard<decltype(mutex_)> l(mutex_);
+  auto it = tables_.find(table_id);
+  if (it == tables_.end()) {
+    return;
+  }
+  auto& table_data = it->second;
+
+  if (resp.locations_changes_unavailable()) {
+    VLOG(1) << "Changes of tablet locations of " << table_id << " are not available";
+    for (const auto& partition_and_tablet : table_data.tablets_by_partition) {
+      partition_and_tablet.second->MarkStale();
+    }
+  }
+
+  for (const TabletLocationsPB& loc : resp.changed_tablet_locations()) {
+    // Tablets that are not cached yet are fetched when they are looked up.
+    RemoteTabletPtr remote = FindPtrOrNull(tablets_by_id_, loc.tablet_id());
+    if (!remote) {
+      continue;
+    }
+    VLOG(3) << "Refreshing changed tablet " << loc.tablet_id() << ": " << loc.ShortDebugString();
+    for (const TabletLocationsPB_ReplicaPB& r : loc.replicas()) {
+      UpdateTabletServerUnlocked(r.ts_info());
+    }
+    remote->Refresh(ts_cache_, loc.replicas());
+  }
+
+  for (const auto& tablet_id : resp.removed_tablet_ids()) {
+    auto tablet_it = tablets_by_id_.find(tablet_id);
+    if (tablet_it == tablets_by_id_.end()) {
+      continue;
+    }
+    VLOG(1) << "Tablet " << tablet_id << " has been removed";
+    RemoteTabletPtr remote = tablet_it->second;
+    remote->MarkStale();
+    tablets_by_id_.erase(tablet_it);
+    auto& tablets_by_key = table_data.tablets_by_partition;
+    auto key_it = tablets_by_key.find(remote->partition().partition_key_start());
+    if (key_it != tablets_by_key.end() && key_it->second == remote) {
+      tablets_by_key.erase(key_it);
+    }
+  }
+
+  if (!resp.has_locations_version()) {
+    return;
+  }
+  const auto& version = resp.locations_version();
+  if (table_data.locations_epoch == version.epoch()) {
+    table_data.locations_version = std::max(table_data.locations_version, version.version());
+  } else if (table_data.locations_epoch == 0 ||
+             (resp.locations_changes_unavailable() && req.has_known_locations_version() &&
+              req.known_locations_version().epoch() == table_data.locations_epoch)) {
+    // A new epoch is only taken from a response to the current one, after all cached tablets
+    // were marked stale, so the changes of tablets cached before are not missed.
+    table_data.locations_epoch = version.epoch();
+    table_data.locations_version = version.version();
+  }
+}
+
+void MetaCache::ContinueLookups(const YBTable* table,
+                                const std::string& partition_group_start,
+                                const std::string& covered_partition_end) {
+  if (covered_partition_end.empty()) {
+    return;
+  }
+  MonoTime max_deadline;
+  std::string partition_key_start;
+  {
+    boost::shared_lock<decltype(mutex_)> l(mutex_);
+    auto it = tables_.find(table->id());
+    if (it == tables_.end()) {
+      return;
+    }
+    auto gi = it->second.tablet_lookups_by_group.find(partition_group_start);
+    if (gi == it->second.tablet_lookups_by_group.end()) {
+      return;
+    }
+    auto& lookups = gi->second;
+    auto lookups_iter = lookups.lower_bound(covered_partition_end);
+    if (lookups_iter == lookups.end()) {
+      return;
+    }
+    partition_key_start = lookups_iter->first;
+    for (; lookups_iter != lookups.end(); ++lookups_iter) {
+      for (const auto& lookup : lookups_iter->second) {
+        max_deadline.MakeAtLeast(lookup.deadline);
+      }
+    }
+  }
+
+  rpc::StartRpc<LookupByKeyRpc>(
+      this, table, partition_group_start, partition_key_start, max_deadline,
+      client_->data_->messenger_, client_->data_->proxy_cache_.get());
+}
+
 void MetaCache::LookupFailed(
     const YBTable* table, const std::string& partition_group_start, const Status& status) {
   VLOG(1) << "Lookup for table " << table->id() << " and partition "
@@ -760,8 +953,8 @@ void MetaCache::LookupFailed(
 
   if (max_deadline) {
     rpc::StartRpc<LookupByKeyRpc>(
-        this, table, partition_group_start, max_deadline, client_->data_->messenger_,
-        client_->data_->proxy_cache_.get());
+        this, table, partition_group_start, partition_group_start, max_deadline,
+        client_->data_->messenger_, client_->data_->proxy_cache_.get());
   }
 }
 
@@ -824,19 +1017,21 @@ class LookupByKeyRpc : public LookupRpc {
   LookupByKeyRpc(const scoped_refptr<MetaCache>& meta_cache,
                  const YBTable* table,
                  MetaCache::PartitionGroupKey partition_group_start,
+                 MetaCache::PartitionKey partition_key_start,
                  const MonoTime& deadline,
                  const shared_ptr<Messenger>& messenger,
                  rpc::ProxyCache* proxy_cache)
       : LookupRpc(meta_cache, deadline, messenger, proxy_cache),
         table_(table->shared_from_this()),
-        partition_group_start_(std::move(partition_group_start)) {
+        partition_group_start_(std::move(partition_group_start)),
+        partition_key_start_(std::move(partition_key_start)) {
   }
 
   std::string ToString() const override {
     return Format("GetTableLocations($0, $1, $2)",
                   table_->name(),
                   table_->partition_schema()
-                      .PartitionKeyDebugString(partition_group_start_,
+                      .PartitionKeyDebugString(partition_key_start_,
                                                internal::GetSchema(table_->schema())),
                   num_attempts());
   }
@@ -847,8 +1042,13 @@ class LookupByKeyRpc : public LookupRpc {
   void DoSendRpc() override {
     // Fill out the request.
     req_.mutable_table()->set_table_id(table_->id());
-    req_.set_partition_key_start(partition_group_start_);
+    req_.set_partition_key_start(partition_key_start_);
     req_.set_max_returned_locations(kPartitionGroupSize);
+    // The master piggybacks the changes of the other tablets of the table on the response.
+    if (!meta_cache()->GetKnownLocationsVersion(table_->id(),
+                                                req_.mutable_known_locations_version())) {
+      req_.clear_known_locations_version();
+    }
 
     // The end partition key is left unset intentionally so that we'll prefetch
     // some additional tablets.
@@ -864,7 +1064,14 @@ class LookupByKeyRpc : public LookupRpc {
 
   void Notify(const Status& status, const RemoteTabletPtr& result) override {
     if (status.ok()) {
-      return; // This case is handled by LookupTabletByKeyFastPathUnlocked.
+      meta_cache()->ProcessTabletLocationsChanges(table_->id(), req_, resp_);
+      // The lookups covered by the response are handled by ProcessTabletLocations.
+      const auto& locations = resp_.tablet_locations();
+      meta_cache()->ContinueLookups(
+          table_.get(), partition_group_start_,
+          locations.empty() ? std::string()
+                            : locations.rbegin()->partition().partition_key_end());
+      return;
     }
     meta_cache()->LookupFailed(table_.get(), partition_group_start_, status);
   }
@@ -872,9 +1079,12 @@ class LookupByKeyRpc : public LookupRpc {
   // Table to lookup.
   std::shared_ptr<const YBTable> table_;
 
-  // Encoded partition key to lookup.
+  // Encoded partition key of the group of the lookups waiting for this rpc.
   MetaCache::PartitionGroupKey partition_group_start_;
 
+  // Encoded partition key to start the lookup at.
+  MetaCache::PartitionKey partition_key_start_;
+
   // Request body.
   GetTableLocationsRequestPB req_;
 
@@ -890,14 +1100,13 @@ RemoteTabletPtr MetaCache::LookupTabletByKeyFastPathUnlocked(const YBTable* tabl
     return nullptr;
   }
 
-  DCHECK_EQ(partition_key, table->FindPartitionStart(partition_key));
-  auto tablet_it = it->second.tablets_by_partition.find(partition_key);
-  if (PREDICT_FALSE(tablet_it == it->second.tablets_by_partition.end())) {
+  auto tablet_it = it->second.tablets_by_partition.upper_bound(partition_key);
+  if (PREDICT_FALSE(tablet_it == it->second.tablets_by_partition.begin())) {
     // No tablets with a start partition key lower than 'partition_key'.
     return nullptr;
   }
 
-  const auto& result = tablet_it->second;
+  const auto& result = std::prev(tablet_it)->second;
 
   // Stale entries must be re-fetched.
   if (result->stale()) {
@@ -916,11 +1125,11 @@ RemoteTabletPtr MetaCache::LookupTabletByKeyFastPathUnlocked(const YBTable* tabl
 template <class Lock>
 bool MetaCache::FastLookupTabletByKeyUnlocked(
     const YBTable* table,
-    const std::string& partition_start,
+    const std::string& partition_key,
     const LookupTabletCallback& callback,
     Lock* lock) {
   // Fast path: lookup in the cache.
-  auto result = LookupTabletByKeyFastPathUnlocked(table, partition_start);
+  auto result = LookupTabletByKeyFastPathUnlocked(table, partition_key);
   if (result && result->HasLeader()) {
     lock->unlock();
     VLOG(3) << "Fast lookup: found tablet " << result->tablet_id();
@@ -935,36 +1144,36 @@ void MetaCache::LookupTabletByKey(const YBTable* table,
                                   const string& partition_key,
                                   const MonoTime& deadline,
                                   LookupTabletCallback callback) {
-  const auto& partition_start = table->FindPartitionStart(partition_key);
-
   rpc::Rpcs::Handle rpc;
   {
     boost::shared_lock<boost::shared_mutex> lock(mutex_);
-    if (FastLookupTabletByKeyUnlocked(table, partition_start, callback, &lock)) {
+    if (FastLookupTabletByKeyUnlocked(table, partition_key, callback, &lock)) {
       return;
     }
   }
 
+  // The partitions of the table are the ones it had when it was opened, the tablets that some of
+  // them were split into are found by the lookup of the partition group.
   const std::string& partition_group_start =
-      table->FindPartitionStart(partition_start, kPartitionGroupSize);
+      table->FindPartitionStart(partition_key, kPartitionGroupSize);
   {
     std::unique_lock<boost::shared_mutex> lock(mutex_);
-    if (FastLookupTabletByKeyUnlocked(table, partition_start, callback, &lock)) {
+    if (FastLookupTabletByKeyUnlocked(table, partition_key, callback, &lock)) {
       return;
     }
 
     auto& table_data = tables_[table->id()];
     auto& lookup = table_data.tablet_lookups_by_group[partition_group_start];
     bool was_empty = lookup.empty();
-    lookup[partition_start].push_back({std::move(callback), deadline});
+    lookup[partition_key].push_back({std::move(callback), deadline});
     if (!was_empty) {
       return;
     }
   }
 
   rpc::StartRpc<LookupByKeyRpc>(
-      this, table, partition_group_start, deadline, client_->data_->messenger_,
-      client_->data_->proxy_cache_.get());
+      this, table, partition_group_start, partition_group_start, deadline,
+      client_->data_->messenger_, client_->data_->proxy_cache_.get());
 }
 
 RemoteTabletPtr MetaCache::LookupTabletByIdFastPath(const TabletId& tablet_id) {
@@ -65,6 +65,7 @@
 
 namespace yb {
 
+class HdrHistogram;
 class Histogram;
 class YBPartialRow;
 
@@ -73,9 +74,12 @@ class TabletServerServiceProxy;
 } // namespace tserver
 
 namespace master {
+class GetTableLocationsRequestPB;
+class GetTableLocationsResponsePB;
 class MasterServiceProxy;
 class TabletLocationsPB_ReplicaPB;
 class TabletLocationsPB;
+class TabletLocationsVersionPB;
 class TSInfoPB;
 } // namespace master
 
@@ -102,6 +106,8 @@ class RemoteTabletServer {
       const std::string& uuid, const std::shared_ptr<tserver::TabletServerServiceProxy>& proxy);
   explicit RemoteTabletServer(const master::TSInfoPB& pb);
 
+  ~RemoteTabletServer();
+
   // Initialize the RPC proxy to this tablet server, if it is not already set up.
   // This will involve a DNS lookup if there is not already an active proxy.
   // If there is an active proxy, does nothing.
@@ -127,6 +133,13 @@ class RemoteTabletServer {
 
   const CloudInfoPB& cloud_info() const;
 
+  // Records the latency of a read served by this tablet server.
+  void UpdateReadLatency(MonoDelta latency);
+
+  // Returns the given percentile of latencies of recent reads served by this tablet server, or
+  // uninitialized MonoDelta if not enough reads were recorded yet.
+  MonoDelta ReadLatencyPercentile(double percentile) const;
+
  private:
   mutable simple_spinlock lock_;
   const std::string uuid_;
@@ -137,6 +150,12 @@ class RemoteTabletServer {
   std::shared_ptr<tserver::TabletServerServiceProxy> proxy_;
   scoped_refptr<Histogram> dns_resolve_histogram_;
 
+  // Latencies of reads served by this tablet server. Reads are recorded to read_latency_, which
+  // replaces prev_read_latency_ once it has --read_latency_window_size samples, so percentiles
+  // reflect recent reads only.
+  std::shared_ptr<HdrHistogram> read_latency_;
+  std::shared_ptr<HdrHistogram> prev_read_latency_;
+
   DISALLOW_COPY_AND_ASSIGN(RemoteTabletServer);
 };
 
@@ -339,10 +358,33 @@ class MetaCache : public RefCountedThreadSafe<MetaCache> {
   void LookupFailed(
       const YBTable* table, const std::string& partition_group_start, const Status& status);
 
+  // Called when the master responded to a lookup of the specified partition group with tablets
+  // up to 'covered_partition_end'. The group has more tablets than a response returns once some
+  // of them were split, so lookups of keys after that are sent again starting at the first one.
+  void ContinueLookups(const YBTable* table,
+                       const std::string& partition_group_start,
+                       const std::string& covered_partition_end);
+
+  // Removes the cached tablets of the table that overlap 'partition'. These tablets have been
+  // split and are replaced by the tablets the master returned in their place.
+  void RemoveReplacedTabletsUnlocked(
+      const Partition& partition, std::map<PartitionKey, RemoteTabletPtr>* tablets_by_key);
+
+  // Fills the version of the master tablet locations map the cached tablets of the table are
+  // known at. Returns false if it is not known.
+  bool GetKnownLocationsVersion(const TableId& table_id, master::TabletLocationsVersionPB* version);
+
+  // Applies the changes of the table's tablet locations the master sent with the response to
+  // 'req': refreshes the cached tablets that changed, drops the removed ones and marks all of
+  // them stale if the changes were not available.
+  void ProcessTabletLocationsChanges(const TableId& table_id,
+                                     const master::GetTableLocationsRequestPB& req,
+                                     const master::GetTableLocationsResponsePB& resp);
+
   template <class Lock>
   bool FastLookupTabletByKeyUnlocked(
       const YBTable* table,
-      const std::string& partition_start,
+      const std::string& partition_key,
       const LookupTabletCallback& callback,
       Lock* lock);
 
@@ -374,13 +416,21 @@ class MetaCache : public RefCountedThreadSafe<MetaCache> {
     }
   };
 
-  typedef std::unordered_map<std::string, std::vector<LookupData>> PartitionToLookupData;
   typedef std::string PartitionKey;
   typedef std::string PartitionGroupKey;
 
+  // Lookups are keyed by the partition key being looked up rather than by the start of its
+  // partition, because the partitions of the table change when its tablets are split.
+  typedef std::map<PartitionKey, std::vector<LookupData>> PartitionToLookupData;
+
   struct TableData {
-    std::unordered_map<PartitionKey, RemoteTabletPtr> tablets_by_partition;
+    // Ordered, so that the tablet covering a partition key is the last one starting before it.
+    std::map<PartitionKey, RemoteTabletPtr> tablets_by_partition;
     std::unordered_map<PartitionGroupKey, PartitionToLookupData> tablet_lookups_by_group;
+    // Version of the master tablet locations map the cached tablets are known at. Epoch 0 means
+    // that it is not known.
+    uint64_t locations_epoch = 0;
+    uint64_t locations_version = 0;
   };
 
   std::unordered_map<TableId, TableData> tables_;
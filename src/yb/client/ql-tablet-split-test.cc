@@ -0,0 +1,230 @@
+//
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+//
+
+#include <atomic>
+#include <thread>
+
+#include "yb/client/ql-dml-test-base.h"
+#include "yb/client/table_handle.h"
+
+#include "yb/docdb/value_type.h"
+
+#include "yb/master/master.pb.h"
+
+#include "yb/rocksdb/db.h"
+
+#include "yb/tablet/tablet.h"
+#include "yb/tablet/tablet_metadata.h"
+#include "yb/tablet/tablet_peer.h"
+
+#include "yb/tserver/mini_tablet_server.h"
+#include "yb/tserver/tablet_server.h"
+#include "yb/tserver/ts_tablet_manager.h"
+
+using namespace std::literals; // NOLINT
+
+DECLARE_uint64(tablet_split_size_threshold_bytes);
+DECLARE_bool(pause_tablet_split_completion);
+
+namespace yb {
+namespace client {
+
+namespace {
+
+constexpr int kNumRows = 500;
+constexpr auto kSplitTimeout = 60s;
+
+int32_t ValueForKey(int32_t key) {
+  return key * 2 + 1;
+}
+
+} // namespace
+
+class QLTabletSplitTest : public KeyValueTableTest {
+ protected:
+  void SetUp() override {
+    KeyValueTableTest::SetUp();
+    CreateTable(Transactional::kFalse);
+  }
+
+  void WriteRows(int32_t begin, int32_t end) {
+    auto session = CreateSession();
+    for (int32_t key = begin; key != end; ++key) {
+      ASSERT_OK(WriteRow(session, key, ValueForKey(key)));
+    }
+  }
+
+  void VerifyRows(int32_t begin, int32_t end) {
+    auto session = CreateSession();
+    for (int32_t key = begin; key != end; ++key) {
+      ASSERT_EQ(ValueForKey(key), ASSERT_RESULT(SelectRow(session, key))) << "Key: " << key;
+    }
+  }
+
+  Result<size_t> NumTablets() {
+    google::protobuf::RepeatedPtrField<master::TabletLocationsPB> tablets;
+    RETURN_NOT_OK(client_->GetTablets(kTableName, /* max_tablets = */ 0, &tablets));
+    return tablets.size();
+  }
+
+  // Flushes the written rows and makes the master split every tablet that has SST files.
+  void StartSplit() {
+    ASSERT_OK(cluster_->FlushTablets());
+    FLAGS_tablet_split_size_threshold_bytes = 1;
+  }
+
+  // Waits until the master returns more tablets than before the split, and disables further
+  // splits, so the tablets created by this split are not split again.
+  void WaitForSplitCompletion(size_t num_tablets_before_split) {
+    ASSERT_OK(WaitFor([this, num_tablets_before_split]() -> Result<bool> {
+      return VERIFY_RESULT(NumTablets()) > num_tablets_before_split;
+    }, kSplitTimeout, "Wait for split completion"));
+    FLAGS_tablet_split_size_threshold_bytes = 0;
+  }
+
+  // Peers of the running tablets created by a split on all tablet servers.
+  std::vector<tablet::TabletPeerPtr> SplitChildPeers() {
+    std::vector<tablet::TabletPeerPtr> result;
+    for (int i = 0; i != cluster_->num_tablet_servers(); ++i) {
+      auto* server = cluster_->mini_tablet_server(i)->server();
+      if (!server) {
+        continue;
+      }
+      for (const auto& peer : server->tablet_manager()->GetTabletPeers()) {
+        const auto& metadata = peer->tablet_metadata();
+        if (metadata->split_op_id() && !metadata->has_been_split() && peer->CheckRunning().ok()) {
+          result.push_back(peer);
+        }
+      }
+    }
+    return result;
+  }
+
+  // Checks that the regular DB of every tablet created by a split only holds keys of its own
+  // partition.
+  void CheckChildKeyBounds() {
+    auto peers = SplitChildPeers();
+    ASSERT_FALSE(peers.empty());
+    for (const auto& peer : peers) {
+      const auto& partition = peer->tablet_metadata()->partition();
+      std::unique_ptr<rocksdb::Iterator> iter(
+          peer->tablet()->TEST_db()->NewIterator(rocksdb::ReadOptions()));
+      size_t num_keys = 0;
+      for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+        auto key = iter->key();
+        ASSERT_GE(key.size(), 3);
+        ASSERT_EQ(docdb::ValueTypeAsChar::kUInt16Hash, key[0]);
+        std::string partition_key(key.cdata() + 1, 2);
+        ASSERT_GE(partition_key, partition.partition_key_start()) << peer->tablet_id();
+        if (!partition.partition_key_end().empty()) {
+          ASSERT_LT(partition_key, partition.partition_key_end()) << peer->tablet_id();
+        }
+        ++num_keys;
+      }
+      LOG(INFO) << "Tablet " << peer->tablet_id() << " has " << num_keys << " keys";
+    }
+  }
+};
+
+// Splits the tablets by size while the client keeps reading and writing rows.
+TEST_F(QLTabletSplitTest, SplitBySize) {
+  ASSERT_NO_FATALS(WriteRows(0, kNumRows));
+  auto num_tablets = ASSERT_RESULT(NumTablets());
+
+  std::atomic<bool> stop(false);
+  std::atomic<int32_t> num_written(kNumRows);
+  std::thread writer([this, &stop, &num_written] {
+    auto session = CreateSession();
+    while (!stop.load(std::memory_order_acquire)) {
+      auto key = num_written.load(std::memory_order_acquire);
+      ASSERT_OK(WriteRow(session, key, ValueForKey(key)));
+      num_written.store(key + 1, std::memory_order_release);
+    }
+  });
+  std::thread reader([this, &stop] {
+    auto session = CreateSession();
+    int32_t key = 0;
+    while (!stop.load(std::memory_order_acquire)) {
+      ASSERT_EQ(ValueForKey(key), ASSERT_RESULT(SelectRow(session, key))) << "Key: " << key;
+      key = (key + 1) % kNumRows;
+    }
+  });
+
+  ASSERT_NO_FATALS(StartSplit());
+  ASSERT_NO_FATALS(WaitForSplitCompletion(num_tablets));
+
+  // Keep going for a while, so the client also runs into the tablets being split.
+  std::this_thread::sleep_for(5s);
+  stop.store(true, std::memory_order_release);
+  writer.join();
+  reader.join();
+
+  LOG(INFO) << "Rows written: " << num_written.load();
+  ASSERT_NO_FATALS(VerifyRows(0, num_written.load()));
+  ASSERT_NO_FATALS(WriteRows(num_written.load(), num_written.load() + kNumRows));
+  ASSERT_NO_FATALS(VerifyRows(0, num_written.load() + kNumRows));
+}
+
+// Restarts all tablet servers after they have created the tablets of a split, but before the
+// master has replaced the parent tablets with them.
+TEST_F(QLTabletSplitTest, RestartDuringSplit) {
+  ASSERT_NO_FATALS(WriteRows(0, kNumRows));
+  auto num_tablets = ASSERT_RESULT(NumTablets());
+
+  FLAGS_pause_tablet_split_completion = true;
+  ASSERT_NO_FATALS(StartSplit());
+  ASSERT_OK(WaitFor([this, num_tablets] {
+    return SplitChildPeers().size() >= 2 * num_tablets * cluster_->num_tablet_servers();
+  }, kSplitTimeout, "Wait for split tablets to be created"));
+  ASSERT_EQ(num_tablets, ASSERT_RESULT(NumTablets()));
+
+  for (int i = 0; i != cluster_->num_tablet_servers(); ++i) {
+    cluster_->mini_tablet_server(i)->Shutdown();
+  }
+  FLAGS_pause_tablet_split_completion = false;
+  for (int i = 0; i != cluster_->num_tablet_servers(); ++i) {
+    ASSERT_OK(cluster_->mini_tablet_server(i)->Start());
+  }
+
+  ASSERT_NO_FATALS(WaitForSplitCompletion(num_tablets));
+  ASSERT_NO_FATALS(VerifyRows(0, kNumRows));
+  ASSERT_NO_FATALS(WriteRows(kNumRows, 2 * kNumRows));
+  ASSERT_NO_FATALS(VerifyRows(0, 2 * kNumRows));
+}
+
+// Checks that the tablets created by a split drop the keys of the other half of the parent
+// partition once the data inherited from the parent is compacted.
+TEST_F(QLTabletSplitTest, CompactSplitTablets) {
+  ASSERT_NO_FATALS(WriteRows(0, kNumRows));
+  auto num_tablets = ASSERT_RESULT(NumTablets());
+
+  ASSERT_NO_FATALS(StartSplit());
+  ASSERT_NO_FATALS(WaitForSplitCompletion(num_tablets));
+
+  ASSERT_OK(WaitFor([this] {
+    for (const auto& peer : SplitChildPeers()) {
+      if (peer->tablet_metadata()->has_parent_data()) {
+        return false;
+      }
+    }
+    return true;
+  }, kSplitTimeout, "Wait for split tablets to be compacted"));
+
+  ASSERT_NO_FATALS(CheckChildKeyBounds());
+  ASSERT_NO_FATALS(VerifyRows(0, kNumRows));
+}
+
+} // namespace client
+} // namespace yb
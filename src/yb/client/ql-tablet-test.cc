@@ -15,6 +15,7 @@
 
 #include <shared_mutex>
 #include <thread>
+#include <unordered_map>
 
 #include <boost/optional/optional.hpp>
 
@@ -30,6 +31,7 @@
 #include "yb/master/catalog_manager.h"
 #include "yb/master/master.h"
 
+#include "yb/tablet/index_update_batcher.h"
 #include "yb/tablet/tablet.h"
 
 #include "yb/server/skewed_clock.h"
@@ -38,6 +40,7 @@
 #include "yb/tserver/tablet_server.h"
 #include "yb/tserver/tserver_service.proxy.h"
 
+#include "yb/util/countdown_latch.h"
 #include "yb/util/random_util.h"
 
 #include "yb/yql/cql/ql/util/statement_result.h"
@@ -48,6 +51,9 @@ DECLARE_uint64(initial_seqno);
 DECLARE_int32(leader_lease_duration_ms);
 DECLARE_int64(db_write_buffer_size);
 DECLARE_string(time_source);
+DECLARE_int32(index_update_max_concurrent_flushes);
+DECLARE_int32(index_update_max_batch_ops);
+DECLARE_bool(index_update_fail_apply_in_tests);
 
 namespace yb {
 namespace client {
@@ -652,5 +658,123 @@ TEST_F(QLTabletTest, SkewedClocks) {
   cluster_.reset();
 }
 
+namespace {
+
+std::vector<YBqlWriteOpPtr> InsertOps(int32_t begin, int32_t end, TableHandle* table) {
+  std::vector<YBqlWriteOpPtr> result;
+  for (auto key = begin; key != end; ++key) {
+    auto op = table->NewWriteOp(QLWriteRequestPB::QL_STMT_INSERT);
+    auto* const req = op->mutable_request();
+    QLAddInt32HashValue(req, key);
+    table->AddInt32ColumnValue(req, kValue, ValueForKey(key));
+    result.push_back(op);
+  }
+  return result;
+}
+
+// Applies updates of write operations to the batcher, each write operation inserting the next
+// ops_per_write keys of its table, and waits until all of them complete.
+std::vector<Status> ApplyIndexUpdates(
+    tablet::IndexUpdateBatcher* batcher, const std::vector<TableHandle*>& tables,
+    int32_t ops_per_write) {
+  std::vector<Status> statuses(tables.size());
+  CountDownLatch latch(tables.size());
+  std::unordered_map<TableHandle*, int32_t> next_key;
+  for (size_t i = 0; i != tables.size(); ++i) {
+    auto& key = next_key[tables[i]];
+    batcher->Apply(
+        InsertOps(key, key + ops_per_write, tables[i]),
+        [&statuses, &latch, i](const Status& status) {
+          statuses[i] = status;
+          latch.CountDown();
+        });
+    key += ops_per_write;
+  }
+  EXPECT_TRUE(latch.WaitFor(60s));
+  return statuses;
+}
+
+} // namespace
+
+TEST_F(QLTabletTest, IndexUpdateBatcherCoalesces) {
+  google::FlagSaver saver;
+  FLAGS_index_update_max_concurrent_flushes = 1;
+  constexpr size_t kWrites = 20;
+  constexpr int32_t kOpsPerWrite = 5;
+
+  CreateTable(kTable1Name, &table1_);
+  auto batcher = std::make_shared<tablet::IndexUpdateBatcher>(client_);
+
+  std::vector<TableHandle*> tables(kWrites, &table1_);
+  for (const auto& status : ApplyIndexUpdates(batcher.get(), tables, kOpsPerWrite)) {
+    ASSERT_OK(status);
+  }
+  // Updates that arrive while a flush is in progress are sent together.
+  ASSERT_LT(batcher->TEST_num_flushes(), kWrites);
+  VerifyTable(0, static_cast<int>(kWrites) * kOpsPerWrite, &table1_);
+
+  // When a flush could take the updates of one write operation only, each of them is sent
+  // separately.
+  FLAGS_index_update_max_batch_ops = kOpsPerWrite;
+  auto flushes_before = batcher->TEST_num_flushes();
+  for (const auto& status : ApplyIndexUpdates(batcher.get(), tables, kOpsPerWrite)) {
+    ASSERT_OK(status);
+  }
+  ASSERT_EQ(flushes_before + kWrites, batcher->TEST_num_flushes());
+}
+
+TEST_F(QLTabletTest, IndexUpdateBatcherPerOpErrors) {
+  google::FlagSaver saver;
+  FLAGS_index_update_max_concurrent_flushes = 1;
+  constexpr int32_t kOpsPerWrite = 5;
+
+  CreateTables(0, 0);
+  // Updates of the dropped table fail, but this should not fail updates of other write
+  // operations flushed together with them.
+  ASSERT_OK(client_->DeleteTable(kTable2Name));
+
+  auto batcher = std::make_shared<tablet::IndexUpdateBatcher>(client_);
+  auto statuses = ApplyIndexUpdates(
+      batcher.get(), {&table1_, &table2_, &table1_, &table2_, &table1_}, kOpsPerWrite);
+  for (size_t i = 0; i != statuses.size(); ++i) {
+    if (i % 2 == 0) {
+      ASSERT_OK(statuses[i]);
+    } else {
+      ASSERT_NOK(statuses[i]);
+    }
+  }
+  VerifyTable(0, 3 * kOpsPerWrite, &table1_);
+}
+
+TEST_F(QLTabletTest, IndexUpdateBatcherApplyFailure) {
+  google::FlagSaver saver;
+  FLAGS_index_update_max_concurrent_flushes = 1;
+  constexpr int32_t kOpsPerWrite = 5;
+
+  CreateTable(kTable1Name, &table1_);
+  auto batcher = std::make_shared<tablet::IndexUpdateBatcher>(client_);
+
+  FLAGS_index_update_fail_apply_in_tests = true;
+  std::atomic<int> num_callbacks(0);
+  Synchronizer synchronizer;
+  auto callback = synchronizer.AsStdStatusCallback();
+  batcher->Apply(
+      InsertOps(0, kOpsPerWrite, &table1_),
+      [&num_callbacks, callback](const Status& status) {
+        ++num_callbacks;
+        callback(status);
+      });
+  ASSERT_NOK(synchronizer.Wait());
+
+  // The batcher keeps working after the failure.
+  FLAGS_index_update_fail_apply_in_tests = false;
+  std::vector<TableHandle*> tables(3, &table1_);
+  for (const auto& status : ApplyIndexUpdates(batcher.get(), tables, kOpsPerWrite)) {
+    ASSERT_OK(status);
+  }
+  VerifyTable(0, 3 * kOpsPerWrite, &table1_);
+  ASSERT_EQ(1, num_callbacks.load());
+}
+
 } // namespace client
 } // namespace yb
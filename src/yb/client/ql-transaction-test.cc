@@ -64,6 +64,9 @@ DECLARE_uint64(aborted_intent_cleanup_ms);
 DECLARE_int32(intents_flush_max_delay_ms);
 DECLARE_int32(remote_bootstrap_max_chunk_size);
 DECLARE_int32(load_balancer_max_concurrent_adds);
+DECLARE_int32(txn_max_apply_batch_records);
+DECLARE_int32(txn_apply_stop_after_batches_in_tests);
+DECLARE_int32(transaction_conflict_wait_ms);
 
 namespace yb {
 namespace client {
@@ -625,6 +628,36 @@ TEST_F(QLTransactionTest, Cleanup) {
   CheckNoRunningTransactions();
 }
 
+// Applies transactions in batches of a single intent, including keys written several times by the
+// same transaction, so the order of writes should be preserved across batches.
+TEST_F(QLTransactionTest, ApplyInBatches) {
+  FLAGS_txn_max_apply_batch_records = 1;
+
+  ASSERT_NO_FATALS(WriteDataWithRepetition());
+  ASSERT_OK(WaitFor(
+      [this] { return CountTransactions() == 0; }, kTransactionApplyTime, "Transactions cleaned"));
+  ASSERT_NO_FATALS(VerifyData());
+  ASSERT_OK(cluster_->RestartSync());
+  ASSERT_NO_FATALS(VerifyData());
+}
+
+// Stops applying the transaction after its first batch, as if the tablet servers crashed in the
+// middle of the apply, and checks that bootstrap applies the remaining intents.
+TEST_F(QLTransactionTest, ResumeApplyAfterRestart) {
+  FLAGS_txn_max_apply_batch_records = 1;
+  FLAGS_txn_apply_stop_after_batches_in_tests = 1;
+
+  ASSERT_NO_FATALS(WriteDataWithRepetition());
+  ASSERT_OK(WaitFor(
+      [this] { return CountTransactions() == 0; }, kTransactionApplyTime, "Transactions cleaned"));
+  ASSERT_GT(CountIntents(), 0);
+
+  FLAGS_txn_apply_stop_after_batches_in_tests = 0;
+  ASSERT_OK(cluster_->RestartSync());
+  ASSERT_NO_FATALS(VerifyData());
+  ASSERT_OK(WaitFor([this] { return CountIntents() == 0; }, 15s, "Intents removed"));
+}
+
 TEST_F(QLTransactionTest, Heartbeat) {
   auto txn = CreateTransaction();
   auto session = CreateSession(txn);
@@ -763,6 +796,48 @@ TEST_F(QLTransactionTest, SimpleWriteConflict) {
   ASSERT_NOK(transaction->CommitFuture().get());
 }
 
+// Lower priority transaction should wait for the conflicting higher priority transaction instead
+// of failing, without holding locks, so the higher priority transaction could write the same row
+// again while it waits.
+TEST_F(QLTransactionTest, WaitForConflictingTransaction) {
+  google::FlagSaver flag_saver;
+  FLAGS_transaction_conflict_wait_ms = 60000;
+
+  constexpr int32_t kConflictKey = 1000;
+
+  auto txn1 = CreateTransaction();
+  auto session1 = CreateSession(txn1);
+  auto txn2 = CreateTransaction();
+  auto session2 = CreateSession(txn2);
+  // Write something, so transactions are ready and their priorities are known.
+  ASSERT_OK(WriteRow(session1, 1, 1));
+  ASSERT_OK(WriteRow(session2, 2, 2));
+
+  bool txn1_is_higher =
+      txn1->TEST_GetMetadata().get().priority > txn2->TEST_GetMetadata().get().priority;
+  auto high = txn1_is_higher ? txn1 : txn2;
+  auto high_session = txn1_is_higher ? session1 : session2;
+  auto low = txn1_is_higher ? txn2 : txn1;
+  auto low_session = txn1_is_higher ? session2 : session1;
+
+  ASSERT_OK(WriteRow(high_session, kConflictKey, 1));
+
+  ASSERT_OK(WriteRow(low_session, kConflictKey, 2, WriteOpType::INSERT, Flush::kFalse));
+  auto low_flush_future = low_session->FlushFuture();
+  ASSERT_EQ(std::future_status::timeout, low_flush_future.wait_for(1s));
+
+  // Blocker writes the same row again, it would deadlock if the waiter kept its locks.
+  ASSERT_OK(WriteRow(high_session, kConflictKey, 3));
+  ASSERT_EQ(std::future_status::timeout, low_flush_future.wait_for(0s));
+
+  high->Abort();
+
+  ASSERT_OK(low_flush_future.get());
+  ASSERT_OK(low->CommitFuture().get());
+
+  VERIFY_ROW(CreateSession(), kConflictKey, 2);
+}
+
 void QLTransactionTest::TestWriteConflicts(bool do_restarts) {
   struct ActiveTransaction {
     YBTransactionPtr transaction;
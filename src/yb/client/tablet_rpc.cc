@@ -157,8 +157,7 @@ void TabletInvoker::Execute(const std::string& tablet_id, bool leader_only) {
   // Put another way, we don't care about the lookup results at all; we're
   // just using it to fetch the latest consensus configuration information.
   //
-  // TODO: When we support tablet splits, we should let the lookup shift
-  // the write to another tablet (i.e. if it's since been split).
+  // Tablet splits are handled in Done(), see tablet_split().
   if (!current_ts_) {
     client_->LookupTabletById(tablet_id_,
                               retrier_->deadline(),
@@ -236,6 +235,27 @@ bool TabletInvoker::Done(Status* status) {
     *status = resp_error_status;
   }
 
+  // The master replaced the tablet by the tablets it was split into, routing the operation to
+  // them is up to the owner of the invoker.
+  if (tablet_split_) {
+    return true;
+  }
+
+  // The tablet has been split. It rejects operations until the master has seen the tablets it was
+  // split into running and replaced it by them, so refresh its locations and retry until then.
+  if (ErrorCode(rpc_->response_error()) == tserver::TabletServerErrorPB::TABLET_SPLIT &&
+      !status->IsTimedOut()) {
+    VLOG(1) << "Tablet " << tablet_id_ << " has been split: " << *status;
+    if (tablet_) {
+      tablet_->MarkStale();
+    }
+    client_->LookupTabletById(tablet_id_,
+                              retrier_->deadline(),
+                              std::bind(&TabletInvoker::SplitTabletLookupDone, this, *status, _1),
+                              UseCache::kFalse);
+    return false;
+  }
+
   // Oops, we failed over to a replica that wasn't a LEADER. Unlikely as
   // we're using consensus configuration information from the master, but still possible
   // (e.g. leader restarted and became a FOLLOWER). Try again.
@@ -362,6 +382,25 @@ void TabletInvoker::LookupTabletCb(const Result<RemoteTabletPtr>& result) {
   }
 }
 
+void TabletInvoker::SplitTabletLookupDone(
+    const Status& split_status, const Result<RemoteTabletPtr>& result) {
+  VLOG(1) << "SplitTabletLookupDone(" << result << ")";
+
+  if (!result.ok() && result.status().IsNotFound()) {
+    TRACE_TO(trace_, "Tablet $0 replaced by split tablets", tablet_id_);
+    tablet_split_ = true;
+    command_->Finished(split_status);
+    return;
+  }
+
+  followers_.clear();
+  last_tablet_refresh_time_ = MonoTime::Now();
+  auto retry_status = retrier_->DelayedRetry(command_, split_status);
+  if (!retry_status.ok()) {
+    command_->Finished(split_status);
+  }
+}
+
 Status ErrorStatus(const tserver::TabletServerErrorPB* error) {
   return error == nullptr ? Status::OK()
                           : StatusFromPB(error->status());
@@ -70,9 +70,14 @@ class TabletInvoker {
   const RemoteTabletPtr& tablet() const { return tablet_; }
   std::shared_ptr<tserver::TabletServerServiceProxy> proxy() const;
   YBClient& client() const { return *client_; }
-  const RemoteTabletServer& current_ts() { return *current_ts_; }
+  RemoteTabletServer& current_ts() { return *current_ts_; }
   bool local_tserver_only() const { return local_tserver_only_; }
 
+  // Whether Done() finished the rpc because its tablet was split and has been replaced by the
+  // tablets it was split into. The rpc is not failed in that case, its operations have to be
+  // routed to the new tablets by the owner of the invoker.
+  bool tablet_split() const { return tablet_split_; }
+
  private:
   void SelectTabletServer();
 
@@ -95,6 +100,10 @@ class TabletInvoker {
 
   void InitialLookupTabletDone(const Result<RemoteTabletPtr>& result);
 
+  // Called when we finish a lookup of a tablet that responded it has been split. Retries the rpc
+  // while the master still serves the tablet, otherwise finishes it with tablet_split() set.
+  void SplitTabletLookupDone(const Status& split_status, const Result<RemoteTabletPtr>& result);
+
   // If we receive TABLET_NOT_FOUND and current_ts_ is set, that means we contacted a tserver
   // with a tablet_id, but the tserver no longer has that tablet.
   bool TabletNotFoundOnTServer(const tserver::TabletServerErrorPB* error_code,
@@ -136,6 +145,8 @@ class TabletInvoker {
   RemoteTabletServer* current_ts_ = nullptr;
 
   MonoTime last_tablet_refresh_time_ = MonoTime::kUninitialized;
+
+  bool tablet_split_ = false;
 };
 
 CHECKED_STATUS ErrorStatus(const tserver::TabletServerErrorPB* error);
@@ -43,6 +43,8 @@
 #include "yb/common/ql_rowblock.h"
 #include "yb/yql/redis/redisserver/redis_constants.h"
 
+DECLARE_int32(redis_follower_read_max_staleness_ms);
+
 namespace yb {
 namespace client {
 
@@ -125,7 +127,8 @@ Status YBRedisWriteOp::GetPartitionKey(std::string *partition_key) const {
 // YBRedisReadOp -----------------------------------------------------------------
 
 YBRedisReadOp::YBRedisReadOp(const shared_ptr<YBTable>& table)
-    : YBRedisOp(table), redis_read_request_(new RedisReadRequestPB()) {
+    : YBRedisOp(table), redis_read_request_(new RedisReadRequestPB()),
+      max_staleness_ms_(std::max(FLAGS_redis_follower_read_max_staleness_ms, 0)) {
 }
 
 YBRedisReadOp::~YBRedisReadOp() {}
@@ -214,12 +214,24 @@ class YBRedisReadOp : public YBRedisOp {
 
   CHECKED_STATUS GetPartitionKey(std::string* partition_key) const override;
 
+  // Maximum staleness in milliseconds allowed for the read when it is served by a follower.
+  // Defaults to --redis_follower_read_max_staleness_ms. Zero means that the tablet server default
+  // is used.
+  uint64_t max_staleness_ms() const {
+    return max_staleness_ms_;
+  }
+
+  void set_max_staleness_ms(uint64_t max_staleness_ms) {
+    max_staleness_ms_ = max_staleness_ms;
+  }
+
  protected:
   virtual Type type() const override { return REDIS_READ; }
 
  private:
   friend class YBTable;
   std::unique_ptr<RedisReadRequestPB> redis_read_request_;
+  uint64_t max_staleness_ms_;
 };
 
 //--------------------------------------------------------------------------------------------------
@@ -347,6 +359,16 @@ class YBqlReadOp : public YBqlOp {
     yb_consistency_level_ = yb_consistency_level;
   }
 
+  // Maximum staleness in milliseconds allowed for a CONSISTENT_PREFIX read served by a follower.
+  // Zero means that the tablet server default is used.
+  uint64_t max_staleness_ms() const {
+    return max_staleness_ms_;
+  }
+
+  void set_max_staleness_ms(uint64_t max_staleness_ms) {
+    max_staleness_ms_ = max_staleness_ms;
+  }
+
   std::vector<ColumnSchema> MakeColumnSchemasFromRequest() const;
   Result<QLRowBlock> MakeRowBlock() const;
 
@@ -361,6 +383,7 @@ class YBqlReadOp : public YBqlOp {
   explicit YBqlReadOp(const std::shared_ptr<YBTable>& table);
   std::unique_ptr<QLReadRequestPB> ql_read_request_;
   YBConsistencyLevel yb_consistency_level_;
+  uint64_t max_staleness_ms_ = 0;
   ReadHybridTime read_time_;
 };
 
@@ -116,4 +116,38 @@ TEST(PartitionTest, TestRedisEncoding) {
   ASSERT_EQ(pk1, pk2);
 }
 
+TEST(PartitionTest, TestSplitHashPartition) {
+  Schema schema({ ColumnSchema("key", STRING, false, true) }, { ColumnId(0) }, 1);
+
+  PartitionSchema partition_schema;
+  ASSERT_OK(PartitionSchema::FromPB(PartitionSchemaPB(), schema, &partition_schema));
+
+  vector<Partition> partitions;
+  ASSERT_OK(partition_schema.CreatePartitions(2, &partitions));
+  ASSERT_EQ(2, partitions.size());
+
+  // Split the first partition: [<start>, 0x7fff).
+  Partition left, right;
+  ASSERT_OK(partition_schema.SplitHashPartition(partitions[0], &left, &right));
+  ASSERT_EQ("", left.partition_key_start());
+  ASSERT_EQ(PartitionSchema::EncodeMultiColumnHashValue(0x3fff), left.partition_key_end());
+  ASSERT_EQ(left.partition_key_end(), right.partition_key_start());
+  ASSERT_EQ(partitions[0].partition_key_end(), right.partition_key_end());
+
+  // Split the last partition: [0x7fff, <end>).
+  ASSERT_OK(partition_schema.SplitHashPartition(partitions[1], &left, &right));
+  ASSERT_EQ(partitions[1].partition_key_start(), left.partition_key_start());
+  ASSERT_EQ(PartitionSchema::EncodeMultiColumnHashValue(0xbfff), left.partition_key_end());
+  ASSERT_EQ(left.partition_key_end(), right.partition_key_start());
+  ASSERT_EQ("", right.partition_key_end());
+
+  // A partition covering a single hash value cannot be split any further.
+  PartitionPB single_pb;
+  single_pb.set_partition_key_start(PartitionSchema::EncodeMultiColumnHashValue(10));
+  single_pb.set_partition_key_end(PartitionSchema::EncodeMultiColumnHashValue(11));
+  Partition single;
+  Partition::FromPB(single_pb, &single);
+  ASSERT_TRUE(partition_schema.SplitHashPartition(single, &left, &right).IsIllegalState());
+}
+
 } // namespace yb
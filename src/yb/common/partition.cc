@@ -402,6 +402,35 @@ Status PartitionSchema::CreatePartitions(int32_t num_tablets,
   return Status::OK();
 }
 
+Status PartitionSchema::SplitHashPartition(const Partition& source,
+                                           Partition* left,
+                                           Partition* right,
+                                           int32_t max_partition_key) const {
+  if (!hash_bucket_schemas_.empty()) {
+    return STATUS(NotSupported, "Splitting of hash bucket partitions is not supported");
+  }
+
+  const uint32_t start = source.partition_key_start().empty()
+      ? 0 : DecodeMultiColumnHashValue(source.partition_key_start());
+  const uint32_t end = source.partition_key_end().empty()
+      ? max_partition_key + 1 : DecodeMultiColumnHashValue(source.partition_key_end());
+  if (end <= start + 1) {
+    return STATUS_SUBSTITUTE(IllegalState, "Hash range [$0, $1) is too small to be split",
+                             start, end);
+  }
+  const uint16_t middle = start + (end - start) / 2;
+
+  left->hash_buckets_ = source.hash_buckets_;
+  left->partition_key_start_ = source.partition_key_start_;
+  left->partition_key_end_ = EncodeMultiColumnHashValue(middle);
+
+  right->hash_buckets_ = source.hash_buckets_;
+  right->partition_key_start_ = left->partition_key_end_;
+  right->partition_key_end_ = source.partition_key_end_;
+
+  return Status::OK();
+}
+
 Status PartitionSchema::CreatePartitions(const vector<YBPartialRow>& split_rows,
                                          const Schema& schema,
                                          vector<Partition>* partitions) const {
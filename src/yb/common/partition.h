@@ -191,6 +191,14 @@ class PartitionSchema {
                                   std::vector<Partition>* partitions,
                                   int32_t max_partition_key = kMaxPartitionKey) const;
 
+  // Splits the hash range covered by 'source' into two partitions at its midpoint hash value.
+  // 'left' gets [start, middle) and 'right' gets [middle, end). Only partitions created using the
+  // 2-byte hash partition key scheme can be split this way.
+  CHECKED_STATUS SplitHashPartition(const Partition& source,
+                                    Partition* left,
+                                    Partition* right,
+                                    int32_t max_partition_key = kMaxPartitionKey) const;
+
   YBHashSchema hash_schema() const {
     return hash_schema_;
   }
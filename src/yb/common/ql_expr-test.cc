@@ -0,0 +1,120 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/common/ql_expr.h"
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+namespace yb {
+
+namespace {
+
+// Large enough to be kept outside of the column vector of QLTableRow.
+constexpr ColumnIdRep kLargeColumnId = 100000;
+
+QLValuePB Int32Value(int32_t value) {
+  QLValuePB result;
+  result.set_int32_value(value);
+  return result;
+}
+
+} // namespace
+
+class QLTableRowTest : public YBTest {
+};
+
+TEST_F(QLTableRowTest, ClearAndReuse) {
+  QLTableRow row;
+  for (int i = 0; i != 5; ++i) {
+    auto& column = row.AllocColumn(i, Int32Value(i));
+    column.ttl_seconds = 10 + i;
+    column.write_time = 100 + i;
+  }
+  ASSERT_EQ(5, row.ColumnCount());
+
+  row.Clear();
+  ASSERT_TRUE(row.IsEmpty());
+  for (int i = 0; i != 5; ++i) {
+    ASSERT_FALSE(row.GetValue(i));
+    QLValue value;
+    ASSERT_OK(row.ReadColumn(i, &value));
+    ASSERT_TRUE(value.IsNull());
+  }
+
+  // A column allocated again after Clear() must not see the values of the previous row.
+  const auto& column = row.AllocColumn(2);
+  ASSERT_EQ(QLValuePB::VALUE_NOT_SET, column.value.value_case());
+  ASSERT_EQ(0, column.ttl_seconds);
+  ASSERT_EQ(QLTableColumn::kUninitializedWriteTime, column.write_time);
+
+  row.AllocColumn(4, Int32Value(40));
+  ASSERT_EQ(2, row.ColumnCount());
+  ASSERT_FALSE(row.GetValue(3));
+  ASSERT_EQ(40, row.GetValue(4)->int32_value());
+}
+
+TEST_F(QLTableRowTest, LargeColumnIds) {
+  QLTableRow row;
+  row.AllocColumn(1, Int32Value(1));
+  row.AllocColumn(kLargeColumnId, Int32Value(2)).ttl_seconds = 20;
+  ASSERT_EQ(2, row.ColumnCount());
+  ASSERT_EQ(1, row.GetValue(1)->int32_value());
+  ASSERT_EQ(2, row.GetValue(kLargeColumnId)->int32_value());
+  int64_t ttl_seconds = 0;
+  ASSERT_OK(row.GetTTL(kLargeColumnId, &ttl_seconds));
+  ASSERT_EQ(20, ttl_seconds);
+
+  QLTableRow copy;
+  ASSERT_OK(copy.CopyColumn(kLargeColumnId, row));
+  ASSERT_EQ(1, copy.ColumnCount());
+  ASSERT_EQ(2, copy.GetValue(kLargeColumnId)->int32_value());
+  ASSERT_TRUE(copy.MatchColumn(kLargeColumnId, row));
+
+  row.Clear();
+  ASSERT_TRUE(row.IsEmpty());
+  ASSERT_FALSE(row.GetValue(kLargeColumnId));
+  ASSERT_NOK(row.GetTTL(kLargeColumnId, &ttl_seconds));
+  ASSERT_FALSE(copy.MatchColumn(kLargeColumnId, row));
+}
+
+TEST_F(QLTableRowTest, MatchColumnAfterPartialFill) {
+  QLTableRow row;
+  row.AllocColumn(1, Int32Value(1));
+  row.AllocColumn(2, Int32Value(2));
+  row.AllocColumn(kLargeColumnId, Int32Value(3));
+
+  // Fill only one of the columns of the previous row, the others keep their storage but must be
+  // reported as absent.
+  row.Clear();
+  row.AllocColumn(1, Int32Value(1));
+
+  QLTableRow source;
+  source.AllocColumn(1, Int32Value(1));
+  source.AllocColumn(2, Int32Value(2));
+  source.AllocColumn(kLargeColumnId, Int32Value(3));
+
+  ASSERT_TRUE(row.MatchColumn(1, source));
+  ASSERT_FALSE(row.MatchColumn(2, source));
+  ASSERT_FALSE(source.MatchColumn(2, row));
+  ASSERT_FALSE(row.MatchColumn(kLargeColumnId, source));
+  // Columns absent from both rows match.
+  ASSERT_TRUE(row.MatchColumn(3, source));
+  ASSERT_TRUE(row.MatchColumn(kLargeColumnId + 1, source));
+
+  row.AllocColumn(2, Int32Value(20));
+  ASSERT_FALSE(row.MatchColumn(2, source));
+  row.AllocColumn(2, Int32Value(2));
+  ASSERT_TRUE(row.MatchColumn(2, source));
+}
+
+} // namespace yb
@@ -7,6 +7,9 @@
 #ifndef YB_COMMON_QL_EXPR_H_
 #define YB_COMMON_QL_EXPR_H_
 
+#include <unordered_map>
+#include <vector>
+
 #include "yb/common/ql_value.h"
 #include "yb/common/schema.h"
 #include "yb/common/ql_bfunc.h"
@@ -52,16 +55,17 @@ class QLTableRow {
 
   // Check if row is empty (no column).
   bool IsEmpty() const {
-    return col_map_.empty();
+    return ColumnCount() == 0;
   }
 
   // Get column count.
   size_t ColumnCount() const {
-    return col_map_.size();
+    return num_assigned_ + other_columns_.size();
   }
 
-  // Clear the row.
-  void Clear() { col_map_.clear(); }
+  // Clear the row. The column storage is kept, so that filling the row again with the next row of
+  // a scan does not allocate.
+  void Clear();
 
   // Compare column value between two rows.
   bool MatchColumn(ColumnIdRep col_id, const QLTableRow& source) const;
@@ -118,20 +122,31 @@ class QLTableRow {
 
   // For testing only (no status check).
   const QLTableColumn& TestValue(ColumnIdRep col_id) const {
-    return col_map_.at(col_id);
+    return *CHECK_NOTNULL(FindColumn(col_id));
   }
   const QLTableColumn& TestValue(const ColumnId& col) const {
-    return col_map_.at(col.rep());
+    return TestValue(col.rep());
   }
 
-  std::string ToString() const {
-    return yb::ToString(col_map_);
-  }
+  std::string ToString() const;
 
   std::string ToString(const Schema& schema) const;
 
  private:
-  std::unordered_map<ColumnIdRep, QLTableColumn> col_map_;
+  // Column ids are assigned sequentially, so columns are kept in a vector indexed by the column id.
+  // Ids above this limit are kept in a map instead, to bound the size of the vector.
+  static constexpr ColumnIdRep kMaxIndexedColumnId = 1024;
+
+  // Return the cached column with the given id, or nullptr if it is not present in this row.
+  const QLTableColumn* FindColumn(ColumnIdRep col_id) const;
+
+  // Columns indexed by column id, and whether each of them is present in this row.
+  std::vector<QLTableColumn> columns_;
+  std::vector<bool> assigned_;
+  size_t num_assigned_ = 0;
+
+  // Columns with ids above kMaxIndexedColumnId.
+  std::unordered_map<ColumnIdRep, QLTableColumn> other_columns_;
 };
 
 class QLExprExecutor {
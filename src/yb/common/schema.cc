@@ -83,6 +83,10 @@ void TableProperties::ToTablePropertiesPB(TablePropertiesPB *pb) const {
   if (HasCopartitionTableId()) {
     pb->set_copartition_table_id(copartition_table_id_);
   }
+  pb->set_bloom_filter_key_type(bloom_filter_key_type_);
+  if (HasCompressionType()) {
+    pb->set_compression_type(*compression_type_);
+  }
 }
 
 TableProperties TableProperties::FromTablePropertiesPB(const TablePropertiesPB& pb) {
@@ -102,6 +106,12 @@ TableProperties TableProperties::FromTablePropertiesPB(const TablePropertiesPB&
   if (pb.has_copartition_table_id()) {
     table_properties.SetCopartitionTableId(pb.copartition_table_id());
   }
+  if (pb.has_bloom_filter_key_type()) {
+    table_properties.SetBloomFilterKeyType(pb.bloom_filter_key_type());
+  }
+  if (pb.has_compression_type()) {
+    table_properties.SetCompressionType(pb.compression_type());
+  }
   return table_properties;
 }
 
@@ -126,6 +136,8 @@ void TableProperties::Reset() {
   is_transactional_ = false;
   consistency_level_ = YBConsistencyLevel::STRONG;
   copartition_table_id_ = kNoCopartitionTableId;
+  bloom_filter_key_type_ = BloomFilterKeyType::HASHED_KEY_BLOOM_FILTER;
+  compression_type_ = boost::none;
 }
 
 Schema::Schema(const Schema& other)
@@ -594,6 +606,12 @@ Status SchemaBuilder::AddColumn(const ColumnSchema& column, bool is_key) {
 }
 
 Status SchemaBuilder::AlterProperties(const TablePropertiesPB& pb) {
+  // SST compression is set up when the tablets are opened.
+  if (pb.has_compression_type() &&
+      (!table_properties_.HasCompressionType() ||
+       table_properties_.compression_type() != pb.compression_type())) {
+    return STATUS(InvalidArgument, "Compression of an existing table cannot be altered");
+  }
   table_properties_.AlterFromTablePropertiesPB(pb);
   return Status::OK();
 }
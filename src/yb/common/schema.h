@@ -40,6 +40,8 @@
 #include <utility>
 #include <vector>
 
+#include <boost/optional.hpp>
+
 #include <glog/logging.h>
 
 #include "yb/common/ql_type.h"
@@ -419,6 +421,26 @@ class TableProperties {
     copartition_table_id_ = copartition_table_id;
   }
 
+  BloomFilterKeyType bloom_filter_key_type() const {
+    return bloom_filter_key_type_;
+  }
+
+  void SetBloomFilterKeyType(BloomFilterKeyType bloom_filter_key_type) {
+    bloom_filter_key_type_ = bloom_filter_key_type;
+  }
+
+  bool HasCompressionType() const {
+    return compression_type_.is_initialized();
+  }
+
+  TableCompressionType compression_type() const {
+    return *compression_type_;
+  }
+
+  void SetCompressionType(TableCompressionType compression_type) {
+    compression_type_ = compression_type;
+  }
+
   void ToTablePropertiesPB(TablePropertiesPB *pb) const;
 
   static TableProperties FromTablePropertiesPB(const TablePropertiesPB& pb);
@@ -434,6 +456,8 @@ class TableProperties {
   bool is_transactional_ = false;
   YBConsistencyLevel consistency_level_ = YBConsistencyLevel::STRONG;
   TableId copartition_table_id_ = kNoCopartitionTableId;
+  BloomFilterKeyType bloom_filter_key_type_ = BloomFilterKeyType::HASHED_KEY_BLOOM_FILTER;
+  boost::optional<TableCompressionType> compression_type_;
 };
 
 // The schema for a set of rows.
@@ -73,6 +73,68 @@ const char* kTabletId = "test-peers-tablet";
 const char* kLeaderUuid = "peer-0";
 const char* kFollowerUuid = "peer-1";
 
+// Mocked proxy that could also send heartbeats as part of a batch, like RpcPeerProxy with the
+// multi raft heartbeat batcher.
+class BatchingPeerProxy : public MockedPeerProxy {
+ public:
+  BatchingPeerProxy(ThreadPool* pool, bool batching_available)
+      : MockedPeerProxy(pool), batching_available_(batching_available) {}
+
+  void UpdateAsync(const ConsensusRequestPB* request,
+                   RequestTriggerMode trigger_mode,
+                   ConsensusResponsePB* response,
+                   rpc::RpcController* controller,
+                   const rpc::ResponseCallback& callback) override {
+    {
+      std::lock_guard<simple_spinlock> l(lock_);
+      last_committed_index_ = std::max(last_committed_index_, request->committed_index().index());
+    }
+    MockedPeerProxy::UpdateAsync(request, trigger_mode, response, controller, callback);
+  }
+
+  bool BatchHeartbeatAsync(const ConsensusRequestPB& request,
+                           ConsensusResponsePB* response,
+                           StdStatusCallback callback) override {
+    if (!batching_available_) {
+      return false;
+    }
+    {
+      std::lock_guard<simple_spinlock> l(lock_);
+      ++batched_count_;
+      if (request.ops_size() != 0 || request.committed_index().index() > last_committed_index_) {
+        ++latency_sensitive_batched_count_;
+      }
+      last_committed_index_ = std::max(last_committed_index_, request.committed_index().index());
+      *response = update_response_;
+    }
+    WARN_NOT_OK(pool_->SubmitFunc(std::bind(callback, Status::OK())), "Submit failed");
+    return true;
+  }
+
+  // Number of heartbeats sent as part of a batch.
+  int batched_count() const {
+    std::lock_guard<simple_spinlock> l(lock_);
+    return batched_count_;
+  }
+
+  // Number of batched requests that carried ops or advanced the commit index.
+  int latency_sensitive_batched_count() const {
+    std::lock_guard<simple_spinlock> l(lock_);
+    return latency_sensitive_batched_count_;
+  }
+
+  int64_t last_committed_index() const {
+    std::lock_guard<simple_spinlock> l(lock_);
+    return last_committed_index_;
+  }
+
+ private:
+  const bool batching_available_;
+  int batched_count_ = 0;
+  int latency_sensitive_batched_count_ = 0;
+  int64_t last_committed_index_ = 0;
+};
+
 class ConsensusPeersTest : public YBTest {
  public:
   ConsensusPeersTest()
@@ -409,5 +471,62 @@ TEST_F(ConsensusPeersTest, TestDontSendOneRpcPerWriteWhenPeerIsDown) {
   ASSERT_LT(mock_proxy->update_count() - initial_update_count, 5);
 }
 
+ConsensusResponsePB MakeFollowerResponse(int last_received_index) {
+  ConsensusResponsePB resp;
+  resp.set_responder_uuid(kFollowerUuid);
+  resp.set_responder_term(0);
+  auto last_received = MakeOpId(last_received_index == 0 ? 0 : 1, last_received_index);
+  resp.mutable_status()->mutable_last_received()->CopyFrom(last_received);
+  resp.mutable_status()->mutable_last_received_current_leader()->CopyFrom(last_received);
+  resp.mutable_status()->set_last_committed_idx(0);
+  return resp;
+}
+
+TEST_F(ConsensusPeersTest, TestOnlyHeartbeatsAreBatched) {
+  auto proxy = new BatchingPeerProxy(raft_pool_.get(), /* batching_available */ true);
+  auto peer = ASSERT_RESULT(Peer::NewRemotePeer(
+      FakeRaftPeerPB(kFollowerUuid), kTabletId, kLeaderUuid, message_queue_.get(),
+      raft_pool_token_.get(), PeerProxyPtr(proxy), nullptr /* consensus */, messenger_));
+
+  BOOST_SCOPE_EXIT(&peer) {
+    peer->Close();
+  } BOOST_SCOPE_EXIT_END
+
+  // Nothing to replicate, so the peer sends a heartbeat.
+  proxy->set_update_response(MakeFollowerResponse(0));
+  ASSERT_OK(peer->SignalRequest(RequestTriggerMode::kAlwaysSend));
+  ASSERT_OK(WaitFor(
+      [proxy] { return proxy->batched_count() > 0; }, 10s, "Heartbeat batched"));
+  ASSERT_EQ(0, proxy->update_count());
+
+  // Ops are sent right away, and so is the commit index advanced after they are replicated.
+  proxy->set_update_response(MakeFollowerResponse(1));
+  AppendReplicateMessagesToQueue(message_queue_.get(), clock_, 1, 1);
+  ASSERT_OK(peer->SignalRequest(RequestTriggerMode::kNonEmptyOnly));
+  WaitForMajorityReplicatedIndex(1);
+  ASSERT_OK(WaitFor(
+      [proxy] { return proxy->last_committed_index() >= 1; }, 10s, "Commit index sent"));
+  ASSERT_GT(proxy->update_count(), 0);
+  ASSERT_EQ(0, proxy->latency_sensitive_batched_count());
+}
+
+TEST_F(ConsensusPeersTest, TestHeartbeatsWithoutBatching) {
+  auto proxy = new BatchingPeerProxy(raft_pool_.get(), /* batching_available */ false);
+  auto peer = ASSERT_RESULT(Peer::NewRemotePeer(
+      FakeRaftPeerPB(kFollowerUuid), kTabletId, kLeaderUuid, message_queue_.get(),
+      raft_pool_token_.get(), PeerProxyPtr(proxy), nullptr /* consensus */, messenger_));
+
+  BOOST_SCOPE_EXIT(&peer) {
+    peer->Close();
+  } BOOST_SCOPE_EXIT_END
+
+  // When batching is not available, e.g. it is disabled, heartbeats fall back to UpdateAsync.
+  proxy->set_update_response(MakeFollowerResponse(0));
+  ASSERT_OK(peer->SignalRequest(RequestTriggerMode::kAlwaysSend));
+  ASSERT_OK(WaitFor(
+      [proxy] { return proxy->forced_update_count() > 0; }, 10s, "Heartbeat sent"));
+  ASSERT_EQ(0, proxy->batched_count());
+}
+
 }  // namespace consensus
 }  // namespace yb
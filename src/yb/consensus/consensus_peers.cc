@@ -48,6 +48,7 @@
 #include "yb/consensus/consensus_meta.h"
 #include "yb/consensus/consensus_queue.h"
 #include "yb/consensus/log.h"
+#include "yb/consensus/multi_raft_batcher.h"
 #include "yb/gutil/map-util.h"
 #include "yb/gutil/stl_util.h"
 #include "yb/gutil/strings/substitute.h"
@@ -72,6 +73,7 @@ DEFINE_int32(consensus_rpc_timeout_ms, 3000,
 TAG_FLAG(consensus_rpc_timeout_ms, advanced);
 
 DECLARE_int32(raft_heartbeat_interval_ms);
+DECLARE_bool(enable_multi_raft_heartbeat_batcher);
 
 DEFINE_test_flag(double, fault_crash_on_leader_request_fraction, 0.0,
                  "Fraction of the time when the leader will crash just before sending an "
@@ -277,7 +279,9 @@ void Peer::SendNextRequest(RequestTriggerMode trigger_mode) {
   request_.set_caller_uuid(leader_uuid_);
   request_.set_dest_uuid(peer_pb_.permanent_uuid());
 
-  const bool req_has_ops = (request_.ops_size() > 0) || (commit_index_after > commit_index_before);
+  const bool advances_commit_index = commit_index_after > commit_index_before;
+  const bool has_ops = request_.ops_size() > 0 || request_.compressed_ops_size() > 0;
+  const bool req_has_ops = has_ops || advances_commit_index;
 
   // If the queue is empty, check if we were told to send a status-only message (which is what
   // happens during heartbeats). If not, just return.
@@ -295,6 +299,14 @@ void Peer::SendNextRequest(RequestTriggerMode trigger_mode) {
 
   processing_lock.unlock();
   performing_lock.release();
+  // Only pure heartbeats wait for the batch window. Requests that carry ops or tell the follower
+  // about a new commit index are on the write path, so they are always sent right away.
+  if (!has_ops && !advances_commit_index &&
+      proxy_->BatchHeartbeatAsync(
+          request_, &response_,
+          std::bind(&Peer::HandleResponse, retain_self, std::placeholders::_1))) {
+    return;
+  }
   proxy_->UpdateAsync(&request_, trigger_mode, &response_, &controller_,
                       std::bind(&Peer::ProcessResponse, retain_self));
 }
@@ -311,6 +323,10 @@ std::unique_lock<simple_spinlock> Peer::StartProcessingUnlocked() {
 }
 
 void Peer::ProcessResponse() {
+  HandleResponse(controller_.status());
+}
+
+void Peer::HandleResponse(const Status& rpc_status) {
   // Note: This method runs on the reactor thread.
 
   DCHECK(performing_mutex_.is_locked()) << "Got a response when nothing was pending";
@@ -321,8 +337,8 @@ void Peer::ProcessResponse() {
     return;
   }
 
-  if (!controller_.status().ok()) {
-    if (controller_.status().IsRemoteError()) {
+  if (!rpc_status.ok()) {
+    if (rpc_status.IsRemoteError()) {
       // Most controller errors are caused by network issues or corner cases like shutdown and
       // failure to serialize a protobuf. Therefore, we generally consider these errors to indicate
       // an unreachable peer.  However, a RemoteError wraps some other error propagated from the
@@ -330,7 +346,7 @@ void Peer::ProcessResponse() {
       // remote is responsive.
       queue_->NotifyPeerIsResponsiveDespiteError(peer_pb_.permanent_uuid());
     }
-    ProcessResponseError(controller_.status());
+    ProcessResponseError(rpc_status);
     return;
   }
 
@@ -477,8 +493,10 @@ void Peer::ReleaseResourcesUnlocked() {
   LOG_WITH_PREFIX(INFO) << "Closed peer";
 }
 
-RpcPeerProxy::RpcPeerProxy(HostPort hostport, ConsensusServiceProxyPtr consensus_proxy)
-    : hostport_(std::move(hostport)), consensus_proxy_(std::move(consensus_proxy)) {
+RpcPeerProxy::RpcPeerProxy(HostPort hostport, ConsensusServiceProxyPtr consensus_proxy,
+                           MultiRaftHeartbeatBatcherPtr heartbeat_batcher)
+    : hostport_(std::move(hostport)), consensus_proxy_(std::move(consensus_proxy)),
+      heartbeat_batcher_(std::move(heartbeat_batcher)) {
 }
 
 void RpcPeerProxy::UpdateAsync(const ConsensusRequestPB* request,
@@ -490,6 +508,16 @@ void RpcPeerProxy::UpdateAsync(const ConsensusRequestPB* request,
   consensus_proxy_->UpdateConsensusAsync(*request, response, controller, callback);
 }
 
+bool RpcPeerProxy::BatchHeartbeatAsync(const ConsensusRequestPB& request,
+                                       ConsensusResponsePB* response,
+                                       StdStatusCallback callback) {
+  if (!heartbeat_batcher_ || !FLAGS_enable_multi_raft_heartbeat_batcher) {
+    return false;
+  }
+  heartbeat_batcher_->AddRequestToBatch(request, response, std::move(callback));
+  return true;
+}
+
 void RpcPeerProxy::RequestConsensusVoteAsync(const VoteRequestPB* request,
                                              VoteResponsePB* response,
                                              rpc::RpcController* controller,
@@ -522,13 +550,20 @@ void RpcPeerProxy::StartRemoteBootstrap(const StartRemoteBootstrapRequestPB* req
 RpcPeerProxy::~RpcPeerProxy() {}
 
 RpcPeerProxyFactory::RpcPeerProxyFactory(
-    shared_ptr<Messenger> messenger, rpc::ProxyCache* proxy_cache, CloudInfoPB from)
-    : messenger_(std::move(messenger)), proxy_cache_(proxy_cache), from_(std::move(from)) {}
+    shared_ptr<Messenger> messenger, rpc::ProxyCache* proxy_cache, CloudInfoPB from,
+    MultiRaftManager* multi_raft_manager)
+    : messenger_(std::move(messenger)), proxy_cache_(proxy_cache), from_(std::move(from)),
+      multi_raft_manager_(multi_raft_manager) {}
 
 PeerProxyPtr RpcPeerProxyFactory::NewProxy(const RaftPeerPB& peer_pb) {
   auto hostport = HostPortFromPB(DesiredHostPort(peer_pb, from_));
   auto proxy = std::make_unique<ConsensusServiceProxy>(proxy_cache_, hostport);
-  return std::make_unique<RpcPeerProxy>(std::move(hostport), std::move(proxy));
+  MultiRaftHeartbeatBatcherPtr heartbeat_batcher;
+  if (multi_raft_manager_) {
+    heartbeat_batcher = multi_raft_manager_->AddOrGetBatcher(hostport);
+  }
+  return std::make_unique<RpcPeerProxy>(
+      std::move(hostport), std::move(proxy), std::move(heartbeat_batcher));
 }
 
 RpcPeerProxyFactory::~RpcPeerProxyFactory() {}
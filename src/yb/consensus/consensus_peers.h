@@ -54,6 +54,7 @@
 #include "yb/util/net/net_util.h"
 #include "yb/util/semaphore.h"
 #include "yb/util/status.h"
+#include "yb/util/status_callback.h"
 
 namespace yb {
 class HostPort;
@@ -186,6 +187,10 @@ class Peer : public std::enable_shared_from_this<Peer> {
   // lock-taking.
   void ProcessResponse();
 
+  // Same as ProcessResponse(), but takes the status of the RPC that delivered the response, which
+  // is not stored in controller_ for batched heartbeats.
+  void HandleResponse(const Status& rpc_status);
+
   // Run on 'raft_pool_token'. Does response handling that requires IO or may block.
   void DoProcessResponse();
 
@@ -309,6 +314,15 @@ class PeerProxy {
     LOG(DFATAL) << "Not implemented";
   }
 
+  // Tries to send a heartbeat, i.e. a request without operations, as part of a batch shared with
+  // other tablets that have peers on the same server. Returns false if batching is not available,
+  // in which case the heartbeat should be sent with UpdateAsync.
+  virtual bool BatchHeartbeatAsync(const ConsensusRequestPB& request,
+                                   ConsensusResponsePB* response,
+                                   StdStatusCallback callback) {
+    return false;
+  }
+
   virtual ~PeerProxy() {}
 };
 
@@ -330,7 +344,8 @@ class PeerProxyFactory {
 // PeerProxy implementation that does RPC calls
 class RpcPeerProxy : public PeerProxy {
  public:
-  RpcPeerProxy(HostPort hostport, ConsensusServiceProxyPtr consensus_proxy);
+  RpcPeerProxy(HostPort hostport, ConsensusServiceProxyPtr consensus_proxy,
+               MultiRaftHeartbeatBatcherPtr heartbeat_batcher = nullptr);
 
   virtual void UpdateAsync(const ConsensusRequestPB* request,
                            RequestTriggerMode trigger_mode,
@@ -358,18 +373,24 @@ class RpcPeerProxy : public PeerProxy {
                                        rpc::RpcController* controller,
                                        const rpc::ResponseCallback& callback) override;
 
+  bool BatchHeartbeatAsync(const ConsensusRequestPB& request,
+                           ConsensusResponsePB* response,
+                           StdStatusCallback callback) override;
+
   virtual ~RpcPeerProxy();
 
  private:
   HostPort hostport_;
   ConsensusServiceProxyPtr consensus_proxy_;
+  MultiRaftHeartbeatBatcherPtr heartbeat_batcher_;
 };
 
 // PeerProxyFactory implementation that generates RPCPeerProxies
 class RpcPeerProxyFactory : public PeerProxyFactory {
  public:
+  // multi_raft_manager is optional, heartbeats are not batched without it.
   RpcPeerProxyFactory(std::shared_ptr<rpc::Messenger> messenger, rpc::ProxyCache* proxy_cache,
-                      CloudInfoPB from);
+                      CloudInfoPB from, MultiRaftManager* multi_raft_manager = nullptr);
 
   PeerProxyPtr NewProxy(const RaftPeerPB& peer_pb) override;
 
@@ -381,6 +402,7 @@ class RpcPeerProxyFactory : public PeerProxyFactory {
   std::shared_ptr<rpc::Messenger> messenger_;
   rpc::ProxyCache* const proxy_cache_;
   const CloudInfoPB from_;
+  MultiRaftManager* const multi_raft_manager_;
 };
 
 // Query the consensus service at last known host/port that is specified in 'remote_peer' and set
@@ -48,12 +48,14 @@
 #include "yb/fs/fs_manager.h"
 #include "yb/server/hybrid_clock.h"
 #include "yb/util/metrics.h"
+#include "yb/util/pb_util.h"
 #include "yb/util/test_macros.h"
 #include "yb/util/test_util.h"
 #include "yb/util/threadpool.h"
 
 DECLARE_bool(enable_data_block_fsync);
 DECLARE_int32(consensus_max_batch_size_bytes);
+DECLARE_string(consensus_compression_codec);
 
 METRIC_DECLARE_entity(tablet);
 
@@ -263,6 +265,49 @@ TEST_F(ConsensusQueueTest, TestStartTrackingAfterStart) {
   request.mutable_ops()->ExtractSubrange(0, request.ops_size(), nullptr);
 }
 
+// Tests that the queue sends compressed operations when --consensus_compression_codec is set.
+TEST_F(ConsensusQueueTest, TestCompressedOps) {
+  FLAGS_consensus_compression_codec = "snappy";
+  CloseAndReopenQueue();
+  queue_->RegisterObserver(consensus_.get());
+  queue_->Init(MinimumOpId());
+  queue_->SetLeaderMode(MinimumOpId(), MinimumOpId().term(), BuildRaftConfigPBForTests(2));
+  AppendReplicateMessagesToQueue(queue_.get(), clock_, 1, 20);
+
+  ConsensusRequestPB request;
+  ConsensusResponsePB response;
+  response.set_responder_uuid(kPeerUuid);
+  bool more_pending = false;
+  UpdatePeerWatermarkToOp(&request, &response, MinimumOpId(), MinimumOpId(), &more_pending);
+  ASSERT_TRUE(more_pending);
+
+  ReplicateMsgs refs;
+  bool needs_remote_bootstrap;
+  ASSERT_OK(queue_->RequestForPeer(kPeerUuid, &request, &refs, &needs_remote_bootstrap));
+  ASSERT_FALSE(needs_remote_bootstrap);
+  ASSERT_EQ(0, request.ops_size());
+  ASSERT_EQ(20, request.compressed_ops_size());
+  ASSERT_EQ(SNAPPY_LOG_COMPRESSION, request.ops_compression_codec());
+
+  faststring buffer;
+  for (int i = 0; i != request.compressed_ops_size(); ++i) {
+    ASSERT_OK(log::UncompressEntryBatch(
+        request.ops_compression_codec(), request.compressed_ops(i), &buffer));
+    ReplicateMsg msg;
+    ASSERT_OK(pb_util::ParseFromArray(&msg, buffer.data(), buffer.size()));
+    ASSERT_EQ(refs[i]->ShortDebugString(), msg.ShortDebugString());
+  }
+
+  SetLastReceivedAndLastCommitted(&response, refs.back()->id());
+  queue_->ResponseFromPeer(response.responder_uuid(), response, &more_pending);
+  ASSERT_FALSE(more_pending);
+
+  // A request without operations does not keep the compressed operations of the previous one.
+  ASSERT_OK(queue_->RequestForPeer(kPeerUuid, &request, &refs, &needs_remote_bootstrap));
+  ASSERT_EQ(0, request.compressed_ops_size());
+  ASSERT_FALSE(request.has_ops_compression_codec());
+}
+
 // Tests that the peers gets the messages pages, with the size of a page being
 // 'consensus_max_batch_size_bytes'
 TEST_F(ConsensusQueueTest, TestGetPagedMessages) {
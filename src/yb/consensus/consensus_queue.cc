@@ -96,6 +96,14 @@ DECLARE_int32(rpc_max_message_size);
 
 DEFINE_bool(propagate_safe_time, true, "Propagate safe time to read from leader to followers");
 
+DEFINE_string(consensus_compression_codec, "none",
+              "Compression applied to the operations a leader sends to its followers: none, "
+              "snappy or lz4. Each operation is compressed once and kept in the log cache. "
+              "Servers that do not support it ignore compressed operations, so only enable this "
+              "once every server of the cluster has been upgraded.");
+TAG_FLAG(consensus_compression_codec, advanced);
+DEFINE_validator(consensus_compression_codec, &yb::log::ValidateLogCompressionCodec);
+
 namespace yb {
 namespace consensus {
 
@@ -148,6 +156,7 @@ PeerMessageQueue::PeerMessageQueue(const scoped_refptr<MetricEntity>& metric_ent
       clock_(clock) {
   DCHECK(local_peer_pb_.has_permanent_uuid());
   DCHECK(!local_peer_pb_.last_known_private_addr().empty());
+  CHECK(log::ParseLogCompressionCodec(FLAGS_consensus_compression_codec, &compression_codec_));
 }
 
 void PeerMessageQueue::Init(const OpId& last_locally_replicated) {
@@ -357,6 +366,8 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
 
     // Clear the requests without deleting the entries, as they may be in use by other peers.
     request->mutable_ops()->ExtractSubrange(0, request->ops_size(), /* elements */ nullptr);
+    request->clear_compressed_ops();
+    request->clear_ops_compression_codec();
 
     // This is initialized to the queue's last appended op but gets set to the id of the
     // log entry preceding the first one in 'messages' if messages are found for the peer.
@@ -434,11 +445,19 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
       }
     }
 
-    // We use AddAllocated rather than copy, because we pin the log cache at the "all replicated"
-    // point. At some point we may want to allow partially loading (and not pinning) earlier
-    // messages. At that point we'll need to do something smarter here, like copy or ref-count.
-    for (const auto& msg : messages) {
-      request->mutable_ops()->AddAllocated(msg.get());
+    if (compression_codec_ != NO_LOG_COMPRESSION) {
+      // The compressed copies are built once per operation in the log cache and shared by all
+      // peers.
+      log_cache_.CompressOps(messages, compression_codec_, request->mutable_compressed_ops());
+      request->set_ops_compression_codec(compression_codec_);
+    } else {
+      // We use AddAllocated rather than copy, because we pin the log cache at the "all
+      // replicated" point. At some point we may want to allow partially loading (and not
+      // pinning) earlier messages. At that point we'll need to do something smarter here, like
+      // copy or ref-count.
+      for (const auto& msg : messages) {
+        request->mutable_ops()->AddAllocated(msg.get());
+      }
     }
     if (propagated_safe_time && !have_more_messages) {
       // Get the current local safe time on the leader and propagate it to the follower.
@@ -459,6 +478,10 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
           << ". Size: " << request->ops_size()
           << ". From: " << request->ops(0).id().ShortDebugString() << ". To: "
           << request->ops(request->ops_size() - 1).id().ShortDebugString();
+    } else if (request->compressed_ops_size() > 0) {
+      VLOG_WITH_PREFIX_UNLOCKED(2) << "Sending request with compressed operations to Peer: "
+          << uuid << ". Size: " << request->compressed_ops_size()
+          << ". Preceding: " << request->preceding_id().ShortDebugString();
     } else {
       VLOG_WITH_PREFIX_UNLOCKED(2) << "Sending status only request to Peer: " << uuid
           << ": " << request->DebugString();
@@ -457,6 +457,9 @@ class PeerMessageQueue {
 
   LogCache log_cache_;
 
+  // Compression of the operations sent to peers, from --consensus_compression_codec.
+  LogCompressionCodec compression_codec_ = NO_LOG_COMPRESSION;
+
   Metrics metrics_;
 
   server::ClockPtr clock_;
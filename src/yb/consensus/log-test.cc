@@ -151,6 +151,34 @@ class LogTest : public LogTestBase {
   void DoCorruptionTest(CorruptionType type, CorruptionPosition place,
                         Status expected_status, int expected_entries);
 
+  // Entry batches written to compressed segments should be read back intact, both sequentially
+  // and through the log index.
+  void DoCompressedSegmentsTest(consensus::LogCompressionCodec codec) {
+    options_.compression_codec = codec;
+    BuildLog();
+
+    const int kNumBatches = 20;
+    AppendReplicateBatchToLog(kNumBatches, kTableType);
+    ASSERT_OK(log_->AllocateSegmentAndRollOver());
+
+    SegmentSequence segments;
+    ASSERT_OK(log_->GetLogReader()->GetSegmentsSnapshot(&segments));
+    ASSERT_EQ(codec, segments[0]->header().compression_codec());
+    ASSERT_EQ(kLogCompressedMajorVersion, segments[0]->header().major_version());
+
+    LogEntries entries;
+    ASSERT_OK(segments[0]->ReadEntries(&entries));
+    ASSERT_EQ(kNumBatches, entries.size());
+    for (int i = 0; i < kNumBatches; i++) {
+      ASSERT_EQ(i + 1, entries[i]->replicate().id().index());
+    }
+
+    OpId loaded_op;
+    ASSERT_OK(log_->GetLogReader()->LookupOpId(kNumBatches / 2, &loaded_op));
+    ASSERT_EQ(kNumBatches / 2, loaded_op.index());
+
+    ASSERT_OK(log_->Close());
+  }
 };
 
 // If we write more than one entry in a batch, we should be able to
@@ -802,6 +830,38 @@ TEST_F(LogTest, TestWriteManyBatches) {
   }
 }
 
+TEST_F(LogTest, TestSnappyCompressedSegments) {
+  DoCompressedSegmentsTest(consensus::SNAPPY_LOG_COMPRESSION);
+}
+
+TEST_F(LogTest, TestLZ4CompressedSegments) {
+  DoCompressedSegmentsTest(consensus::LZ4_LOG_COMPRESSION);
+}
+
+// A segment in a format the reader does not support, like a compressed segment read by a server
+// without compression support, must be rejected when opened instead of being read as corrupted
+// entries.
+TEST_F(LogTest, TestUnsupportedSegmentVersion) {
+  const string path = GetTestPath("wal-unsupported");
+  gscoped_ptr<WritableFile> file;
+  ASSERT_OK(fs_manager_->env()->NewWritableFile(path, &file));
+  WritableLogSegment segment(path, shared_ptr<WritableFile>(file.release()));
+
+  LogSegmentHeaderPB header;
+  header.set_sequence_number(1);
+  header.set_major_version(kLogCompressedMajorVersion + 1);
+  header.set_minor_version(0);
+  header.set_tablet_id(kTestTablet);
+  SchemaToPB(GetSimpleTestSchema(), header.mutable_schema());
+  ASSERT_OK(segment.WriteHeaderAndOpen(header));
+  ASSERT_OK(segment.WriteEntryBatch(Slice("not an entry batch")));
+  ASSERT_OK(segment.Sync());
+
+  scoped_refptr<ReadableLogSegment> readable_segment;
+  Status s = ReadableLogSegment::Open(fs_manager_->env(), path, &readable_segment);
+  ASSERT_TRUE(s.IsNotSupported()) << s;
+}
+
 // This tests that querying LogReader works.
 // This sets up a reader with some segments to query which amount to the
 // following:
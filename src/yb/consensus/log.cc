@@ -992,6 +992,11 @@ Status Log::SwitchToAllocatedSegment() {
   header.set_minor_version(kLogMinorVersion);
   header.set_sequence_number(active_segment_sequence_number_);
   header.set_tablet_id(tablet_id_);
+  // Leave the codec unset for uncompressed segments, so they stay readable by older versions.
+  if (options_.compression_codec != consensus::NO_LOG_COMPRESSION) {
+    header.set_major_version(kLogCompressedMajorVersion);
+    header.set_compression_codec(options_.compression_codec);
+  }
 
   // Set up the new footer. This will be maintained as the segment is written.
   footer_builder_.Clear();
@@ -44,6 +44,7 @@
 #include "yb/consensus/consensus-test-util.h"
 #include "yb/consensus/log.h"
 #include "yb/consensus/log_cache.h"
+#include "yb/consensus/log_util.h"
 #include "yb/fs/fs_manager.h"
 #include "yb/gutil/bind_helpers.h"
 #include "yb/gutil/stl_util.h"
@@ -51,6 +52,7 @@
 #include "yb/util/mem_tracker.h"
 #include "yb/util/metrics.h"
 #include "yb/util/monotime.h"
+#include "yb/util/pb_util.h"
 #include "yb/util/test_util.h"
 
 using std::atomic;
@@ -188,6 +190,47 @@ TEST_F(LogCacheTest, TestAppendAndGetMessages) {
 }
 
 
+TEST_F(LogCacheTest, TestCompressOps) {
+  ASSERT_OK(AppendReplicateMessagesToCache(1, 10, /* payload_size = */ 4096));
+  ASSERT_OK(log_->WaitUntilAllFlushed());
+
+  ReplicateMsgs messages;
+  OpId preceding;
+  ASSERT_OK(cache_->ReadOps(0, 8 * 1024 * 1024, &messages, &preceding));
+  ASSERT_EQ(10, messages.size());
+
+  const int64_t bytes_before = cache_->BytesUsed();
+  google::protobuf::RepeatedPtrField<std::string> compressed;
+  cache_->CompressOps(messages, LZ4_LOG_COMPRESSION, &compressed);
+  ASSERT_EQ(messages.size(), compressed.size());
+  const int64_t bytes_with_compressed = cache_->BytesUsed();
+  ASSERT_GT(bytes_with_compressed, bytes_before);
+
+  faststring buffer;
+  for (int i = 0; i != compressed.size(); ++i) {
+    // The dummy payload is all zeros, so it compresses well.
+    ASSERT_LT(compressed.Get(i).size(), messages[i]->ByteSize());
+    ASSERT_OK(log::UncompressEntryBatch(LZ4_LOG_COMPRESSION, compressed.Get(i), &buffer));
+    ReplicateMsg msg;
+    ASSERT_OK(pb_util::ParseFromArray(&msg, buffer.data(), buffer.size()));
+    ASSERT_EQ(messages[i]->ShortDebugString(), msg.ShortDebugString());
+  }
+
+  // The compressed copies are kept in the cache, so sending the same operations to another peer
+  // does not compress them again.
+  google::protobuf::RepeatedPtrField<std::string> compressed_again;
+  cache_->CompressOps(messages, LZ4_LOG_COMPRESSION, &compressed_again);
+  ASSERT_EQ(bytes_with_compressed, cache_->BytesUsed());
+  for (int i = 0; i != compressed.size(); ++i) {
+    ASSERT_EQ(compressed.Get(i), compressed_again.Get(i));
+  }
+
+  // Evicting the operations also releases their compressed copies.
+  messages.clear();
+  cache_->EvictThroughOp(10);
+  ASSERT_EQ(0, cache_->BytesUsed());
+}
+
 // Ensure that the cache always yields at least one message,
 // even if that message is larger than the batch size. This ensures
 // that we don't get "stuck" in the case that a large message enters
@@ -43,6 +43,7 @@
 
 #include "yb/consensus/log.h"
 #include "yb/consensus/log_reader.h"
+#include "yb/consensus/log_util.h"
 #include "yb/consensus/ref_counted_replicate.h"
 #include "yb/gutil/bind.h"
 #include "yb/gutil/map-util.h"
@@ -52,6 +53,7 @@
 #include "yb/util/debug-util.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/mem_tracker.h"
+#include "yb/util/pb_util.h"
 #include "yb/util/metrics.h"
 #include "yb/util/locks.h"
 #include "yb/util/logging.h"
@@ -361,6 +363,55 @@ Status LogCache::ReadOps(int64_t after_op_index,
   return Status::OK();
 }
 
+void LogCache::CompressOps(const ReplicateMsgs& messages,
+                           LogCompressionCodec codec,
+                           google::protobuf::RepeatedPtrField<std::string>* compressed) {
+  faststring serialized;
+  faststring buffer;
+  for (const auto& msg : messages) {
+    auto compressed_msg = GetCompressedMsg(msg, codec);
+    if (!compressed_msg) {
+      serialized.clear();
+      CHECK(pb_util::AppendToString(*msg, &serialized));
+      log::CompressEntryBatch(codec, serialized, &buffer);
+      compressed_msg = std::make_shared<const std::string>(buffer.ToString());
+      SetCompressedMsg(msg, codec, compressed_msg);
+    }
+    compressed->Add()->assign(*compressed_msg);
+  }
+}
+
+std::shared_ptr<const std::string> LogCache::GetCompressedMsg(
+    const ReplicateMsgPtr& msg, LogCompressionCodec codec) const {
+  std::lock_guard<simple_spinlock> l(lock_);
+  auto it = cache_.find(msg->id().index());
+  if (it == cache_.end() || it->second.msg != msg || it->second.compression_codec != codec) {
+    return nullptr;
+  }
+  return it->second.compressed_msg;
+}
+
+void LogCache::SetCompressedMsg(const ReplicateMsgPtr& msg, LogCompressionCodec codec,
+                                std::shared_ptr<const std::string> compressed) {
+  std::lock_guard<simple_spinlock> l(lock_);
+  // Messages read from disk for a lagging peer, or replaced in the meantime, are not cached.
+  auto it = cache_.find(msg->id().index());
+  if (it == cache_.end() || it->second.msg != msg) {
+    return;
+  }
+  CacheEntry& entry = it->second;
+  const int64_t old_size = entry.compressed_msg ? entry.compressed_msg->size() : 0;
+  const int64_t size_delta = static_cast<int64_t>(compressed->size()) - old_size;
+  entry.compressed_msg = std::move(compressed);
+  entry.compression_codec = codec;
+  entry.mem_usage += size_delta;
+  if (size_delta >= 0) {
+    tracker_->Consume(size_delta);
+  } else {
+    tracker_->Release(-size_delta);
+  }
+  metrics_.log_cache_size->IncrementBy(size_delta);
+}
 
 void LogCache::EvictThroughOp(int64_t index) {
   std::lock_guard<simple_spinlock> lock(lock_);
@@ -101,6 +101,13 @@ class LogCache {
                  OpId* preceding_op,
                  bool* have_more_messages = nullptr);
 
+  // Appends the given messages, serialized and compressed with 'codec' as described by
+  // log::CompressEntryBatch, to 'compressed'. The compressed copy of an operation is kept in the
+  // cache along with it, so an operation sent to several peers is compressed only once.
+  void CompressOps(const ReplicateMsgs& messages,
+                   LogCompressionCodec codec,
+                   google::protobuf::RepeatedPtrField<std::string>* compressed);
+
   // Append the operations into the log and the cache.  When the messages have completed writing
   // into the on-disk log, fires 'callback'.
   //
@@ -155,10 +162,23 @@ class LogCache {
   struct CacheEntry {
     ReplicateMsgPtr msg;
     // The cached value of msg->SpaceUsedLong(). This method is expensive
-    // to compute, so we compute it only once upon insertion.
+    // to compute, so we compute it only once upon insertion. Includes the size of
+    // compressed_msg once it is built.
     int64_t mem_usage;
+    // msg serialized and compressed with compression_codec, built by the first CompressOps call
+    // that returns it.
+    std::shared_ptr<const std::string> compressed_msg;
+    LogCompressionCodec compression_codec = NO_LOG_COMPRESSION;
   };
 
+  // Returns the compressed copy of the cached 'msg', or nullptr if it was not built with 'codec'.
+  std::shared_ptr<const std::string> GetCompressedMsg(
+      const ReplicateMsgPtr& msg, LogCompressionCodec codec) const;
+
+  // Keeps 'compressed' as the compressed copy of 'msg', if it is still cached.
+  void SetCompressedMsg(const ReplicateMsgPtr& msg, LogCompressionCodec codec,
+                        std::shared_ptr<const std::string> compressed);
+
   // Try to evict the oldest operations from the queue, stopping either when
   // 'bytes_to_evict' bytes have been evicted, or the op with index
   // 'stop_after_index' has been evicted, whichever comes first.
@@ -39,6 +39,8 @@
 
 #include <gflags/gflags.h>
 #include <glog/logging.h>
+#include <lz4.h>
+#include <snappy.h>
 
 #include "yb/consensus/opid_util.h"
 #include "yb/consensus/ref_counted_replicate.h"
@@ -50,9 +52,11 @@
 #include "yb/gutil/strings/util.h"
 
 #include "yb/util/coding-inl.h"
+#include "yb/util/cast.h"
 #include "yb/util/coding.h"
 #include "yb/util/crc.h"
 #include "yb/util/debug/trace_event.h"
+#include "yb/util/enums.h"
 #include "yb/util/env_util.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/pb_util.h"
@@ -88,6 +92,15 @@ DEFINE_bool(log_async_preallocate_segments, true,
             "Whether the WAL segments preallocation should happen asynchronously");
 TAG_FLAG(log_async_preallocate_segments, advanced);
 
+DEFINE_string(log_compression_codec, "none",
+              "Compression applied to the entry batches of newly created WAL segments: "
+              "none, snappy or lz4. Compressed segments have a new log format major version "
+              "and cannot be read by servers that do not support it, so only enable this once "
+              "every server of the cluster has been upgraded.");
+TAG_FLAG(log_compression_codec, advanced);
+
+DEFINE_validator(log_compression_codec, &yb::log::ValidateLogCompressionCodec);
+
 DECLARE_string(fs_data_dirs);
 
 DEFINE_bool(require_durable_wal_write, false, "Whether durable WAL write is required."
@@ -124,6 +137,7 @@ const size_t kEntryHeaderSize = 12;
 
 const int kLogMajorVersion = 1;
 const int kLogMinorVersion = 0;
+const int kLogCompressedMajorVersion = 2;
 
 // Maximum log segment header/footer size, in bytes (8 MB).
 const uint32_t kLogSegmentMaxHeaderOrFooterSize = 8 * 1024 * 1024;
@@ -137,7 +151,9 @@ LogOptions::LogOptions()
                                          FLAGS_interval_durable_wal_write_ms) : MonoDelta()),
       bytes_durable_wal_write_mb(FLAGS_bytes_durable_wal_write_mb),
       preallocate_segments(FLAGS_log_preallocate_segments),
-      async_preallocate_segments(FLAGS_log_async_preallocate_segments) {
+      async_preallocate_segments(FLAGS_log_async_preallocate_segments),
+      compression_codec(consensus::NO_LOG_COMPRESSION) {
+  CHECK(ParseLogCompressionCodec(FLAGS_log_compression_codec, &compression_codec));
 }
 
 Status ReadableLogSegment::Open(Env* env,
@@ -310,6 +326,16 @@ Status ReadableLogSegment::ReadHeader() {
                                                 header_size),
                         "Unable to parse protobuf");
 
+  if (header.major_version() > kLogCompressedMajorVersion) {
+    return STATUS_FORMAT(NotSupported, "Log segment $0 has unsupported major version $1",
+                         path_, header.major_version());
+  }
+  if (header.compression_codec() != consensus::NO_LOG_COMPRESSION &&
+      header.major_version() < kLogCompressedMajorVersion) {
+    return STATUS_FORMAT(Corruption, "Log segment $0 of major version $1 has compressed entries",
+                         path_, header.major_version());
+  }
+
   header_.CopyFrom(header);
   first_entry_offset_ = header_size + kLogSegmentHeaderMagicAndHeaderLength;
 
@@ -351,8 +377,95 @@ bool IsAllZeros(const Slice& s) {
   }
   return true;
 }
+
 } // anonymous namespace
 
+bool ParseLogCompressionCodec(const std::string& value, consensus::LogCompressionCodec* codec) {
+  if (value == "none") {
+    *codec = consensus::NO_LOG_COMPRESSION;
+  } else if (value == "snappy") {
+    *codec = consensus::SNAPPY_LOG_COMPRESSION;
+  } else if (value == "lz4") {
+    *codec = consensus::LZ4_LOG_COMPRESSION;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+bool ValidateLogCompressionCodec(const char* flagname, const std::string& value) {
+  consensus::LogCompressionCodec codec;
+  if (!ParseLogCompressionCodec(value, &codec)) {
+    LOG(ERROR) << "Invalid value for --" << flagname << ": " << value;
+    return false;
+  }
+  return true;
+}
+
+void CompressEntryBatch(consensus::LogCompressionCodec codec, const Slice& data, faststring* out) {
+  out->clear();
+  PutFixed32(out, data.size());
+  const size_t prefix_size = out->size();
+  switch (codec) {
+    case consensus::SNAPPY_LOG_COMPRESSION: {
+      out->resize(prefix_size + snappy::MaxCompressedLength(data.size()));
+      size_t compressed_size = 0;
+      snappy::RawCompress(util::to_char_ptr(data.data()), data.size(),
+                          util::to_char_ptr(out->data() + prefix_size), &compressed_size);
+      out->resize(prefix_size + compressed_size);
+      return;
+    }
+    case consensus::LZ4_LOG_COMPRESSION: {
+      const int max_compressed_size = LZ4_compressBound(data.size());
+      out->resize(prefix_size + max_compressed_size);
+      const int compressed_size = LZ4_compress_default(
+          util::to_char_ptr(data.data()), util::to_char_ptr(out->data() + prefix_size),
+          data.size(), max_compressed_size);
+      CHECK_GT(compressed_size, 0) << "LZ4 compression failed";
+      out->resize(prefix_size + compressed_size);
+      return;
+    }
+    case consensus::NO_LOG_COMPRESSION:
+      break;
+  }
+  FATAL_INVALID_ENUM_VALUE(consensus::LogCompressionCodec, codec);
+}
+
+Status UncompressEntryBatch(consensus::LogCompressionCodec codec, Slice data, faststring* out) {
+  if (data.size() < sizeof(uint32_t)) {
+    return STATUS_FORMAT(Corruption, "Compressed entry batch too short: $0 bytes", data.size());
+  }
+  const uint32_t uncompressed_size = DecodeFixed32(data.data());
+  data.remove_prefix(sizeof(uint32_t));
+  out->clear();
+  out->resize(uncompressed_size);
+  switch (codec) {
+    case consensus::SNAPPY_LOG_COMPRESSION: {
+      size_t expected_size = 0;
+      if (!snappy::GetUncompressedLength(util::to_char_ptr(data.data()), data.size(),
+                                         &expected_size) ||
+          expected_size != uncompressed_size ||
+          !snappy::RawUncompress(util::to_char_ptr(data.data()), data.size(),
+                                 util::to_char_ptr(out->data()))) {
+        return STATUS(Corruption, "Unable to uncompress snappy entry batch");
+      }
+      return Status::OK();
+    }
+    case consensus::LZ4_LOG_COMPRESSION: {
+      const int size = LZ4_decompress_safe(
+          util::to_char_ptr(data.data()), util::to_char_ptr(out->data()), data.size(),
+          uncompressed_size);
+      if (size < 0 || static_cast<uint32_t>(size) != uncompressed_size) {
+        return STATUS(Corruption, "Unable to uncompress LZ4 entry batch");
+      }
+      return Status::OK();
+    }
+    case consensus::NO_LOG_COMPRESSION:
+      break;
+  }
+  FATAL_INVALID_ENUM_VALUE(consensus::LogCompressionCodec, codec);
+}
+
 Status ReadableLogSegment::ParseHeaderMagicAndHeaderLength(const Slice &data,
                                                            uint32_t *parsed_len) {
   RETURN_NOT_OK_PREPEND(data.check_size(kLogSegmentHeaderMagicAndHeaderLength),
@@ -719,10 +832,19 @@ Status ReadableLogSegment::ReadEntryBatch(int64_t *offset,
   }
 
 
+  Slice entry_batch_data = entry_batch_slice;
+  faststring uncompressed_buf;
+  if (header_.compression_codec() != consensus::NO_LOG_COMPRESSION) {
+    RETURN_NOT_OK_PREPEND(
+        UncompressEntryBatch(header_.compression_codec(), entry_batch_slice, &uncompressed_buf),
+        Substitute("Could not read entry at offset $0 in $1", *offset, path_));
+    entry_batch_data = Slice(uncompressed_buf);
+  }
+
   LogEntryBatchPB read_entry_batch;
   s = pb_util::ParseFromArray(&read_entry_batch,
-                              entry_batch_slice.data(),
-                              header.msg_length);
+                              entry_batch_data.data(),
+                              entry_batch_data.size());
 
   if (!s.ok()) return STATUS(Corruption, Substitute("Could parse PB. Cause: $0",
                                                     s.ToString()));
@@ -793,9 +915,14 @@ Status WritableLogSegment::WriteFooterAndClose(const LogSegmentFooterPB& footer)
 }
 
 
-Status WritableLogSegment::WriteEntryBatch(const Slice& data) {
+Status WritableLogSegment::WriteEntryBatch(const Slice& entry_batch_data) {
   DCHECK(is_header_written_);
   DCHECK(!is_footer_written_);
+  Slice data = entry_batch_data;
+  if (header_.compression_codec() != consensus::NO_LOG_COMPRESSION) {
+    CompressEntryBatch(header_.compression_codec(), entry_batch_data, &compression_buffer_);
+    data = Slice(compression_buffer_);
+  }
   uint8_t header_buf[kEntryHeaderSize];
 
   // First encode the length of the message.
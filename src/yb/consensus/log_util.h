@@ -76,6 +76,10 @@ extern const size_t kEntryHeaderSize;
 extern const int kLogMajorVersion;
 extern const int kLogMinorVersion;
 
+// Major version of segments whose entry batches are compressed. Segments with a higher major
+// version than this are rejected when opened.
+extern const int kLogCompressedMajorVersion;
+
 class ReadableLogSegment;
 
 // Options for the State Machine/Write Ahead Log
@@ -100,6 +104,9 @@ struct LogOptions {
   // Whether the allocation should happen asynchronously.
   bool async_preallocate_segments;
 
+  // Compression of the entry batches in newly created segments.
+  consensus::LogCompressionCodec compression_codec;
+
   LogOptions();
 };
 
@@ -340,7 +347,7 @@ class WritableLogSegment {
   }
 
   // Appends the provided batch of data, including a header
-  // and checksum.
+  // and checksum. The data is compressed first if the segment header specifies a compression codec.
   // Makes sure that the log segment has not been closed.
   CHECKED_STATUS WriteEntryBatch(const Slice& entry_batch_data);
 
@@ -407,6 +414,9 @@ class WritableLogSegment {
   // The offset where the last written entry ends.
   int64_t written_offset_;
 
+  // Reused for compressing entry batches when the segment header specifies a compression codec.
+  faststring compression_buffer_;
+
   DISALLOW_COPY_AND_ASSIGN(WritableLogSegment);
 };
 
@@ -418,6 +428,21 @@ using consensus::ReplicateMsgs;
 // in some hot paths.
 LogEntryBatchPB CreateBatchFromAllocatedOperations(const ReplicateMsgs& msgs);
 
+// Parses a compression codec flag value: none, snappy or lz4. Returns false for other values.
+bool ParseLogCompressionCodec(const std::string& value, consensus::LogCompressionCodec* codec);
+
+// Flag validator for compression codec flags.
+bool ValidateLogCompressionCodec(const char* flagname, const std::string& value);
+
+// Compresses 'data' with 'codec' into 'out', which is set to the fixed32 uncompressed length
+// followed by the compressed data. Used for the entry batches of compressed segments and for the
+// operations of compressed consensus requests.
+void CompressEntryBatch(consensus::LogCompressionCodec codec, const Slice& data, faststring* out);
+
+// Reverses CompressEntryBatch.
+CHECKED_STATUS UncompressEntryBatch(
+    consensus::LogCompressionCodec codec, Slice data, faststring* out);
+
 // Checks if 'fname' is a correctly formatted name of log segment file.
 bool IsLogFileName(const std::string& fname);
 
@@ -0,0 +1,177 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/consensus/multi_raft_batcher.h"
+
+#include <algorithm>
+
+#include "yb/consensus/consensus.proxy.h"
+
+#include "yb/rpc/messenger.h"
+
+#include "yb/util/flag_tags.h"
+
+DEFINE_bool(enable_multi_raft_heartbeat_batcher, false,
+            "If true, heartbeats of idle tablets sent to the same tablet server are coalesced "
+            "into a single MultiRaftUpdateConsensus RPC. Requires all servers in the cluster to "
+            "support this RPC.");
+TAG_FLAG(enable_multi_raft_heartbeat_batcher, evolving);
+TAG_FLAG(enable_multi_raft_heartbeat_batcher, runtime);
+
+DEFINE_int32(multi_raft_heartbeat_window_ms, 10,
+             "How long in milliseconds heartbeats are accumulated before the batch is sent.");
+TAG_FLAG(multi_raft_heartbeat_window_ms, advanced);
+TAG_FLAG(multi_raft_heartbeat_window_ms, runtime);
+
+DEFINE_int32(multi_raft_batch_size, 64,
+             "Maximum number of heartbeats sent in a single MultiRaftUpdateConsensus RPC. The "
+             "receiver applies them one by one on a single RPC thread, so values above 128 are "
+             "treated as 128.");
+TAG_FLAG(multi_raft_batch_size, advanced);
+TAG_FLAG(multi_raft_batch_size, runtime);
+
+DECLARE_int32(consensus_rpc_timeout_ms);
+
+namespace yb {
+namespace consensus {
+
+namespace {
+
+// Upper bound on the number of heartbeats in a batch. Keeps the time a batch occupies the RPC
+// thread of the receiver, and hence the delay of the last heartbeat in it, close to that of a
+// single UpdateConsensus.
+constexpr int kMaxBatchSize = 128;
+
+size_t MaxBatchSize() {
+  return static_cast<size_t>(std::min(std::max(FLAGS_multi_raft_batch_size, 1), kMaxBatchSize));
+}
+
+} // namespace
+
+MultiRaftHeartbeatBatcher::MultiRaftHeartbeatBatcher(
+    const HostPort& hostport, rpc::ProxyCache* proxy_cache,
+    std::shared_ptr<rpc::Messenger> messenger)
+    : hostport_(hostport),
+      consensus_proxy_(std::make_unique<ConsensusServiceProxy>(proxy_cache, hostport)),
+      messenger_(std::move(messenger)) {
+}
+
+MultiRaftHeartbeatBatcher::~MultiRaftHeartbeatBatcher() {
+  // Heartbeats could be added only by the peer proxies that own this batcher, and the scheduled
+  // send retains the batcher, so there should be nothing left at this point.
+  LOG_IF(DFATAL, current_batch_ != nullptr)
+      << "Destroying heartbeat batcher for " << hostport_ << " with "
+      << current_batch_->callbacks.size() << " pending heartbeats";
+}
+
+void MultiRaftHeartbeatBatcher::AddRequestToBatch(const ConsensusRequestPB& request,
+                                                  ConsensusResponsePB* response,
+                                                  StdStatusCallback callback) {
+  BatchDataPtr batch_to_send;
+  bool schedule_send = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!current_batch_) {
+      current_batch_ = std::make_shared<BatchData>();
+    }
+    current_batch_->request.add_consensus_request()->CopyFrom(request);
+    current_batch_->callbacks.push_back({response, std::move(callback)});
+    if (current_batch_->callbacks.size() >= MaxBatchSize()) {
+      batch_to_send = std::move(current_batch_);
+    } else if (!send_scheduled_) {
+      send_scheduled_ = true;
+      schedule_send = true;
+    }
+  }
+
+  if (batch_to_send) {
+    SendBatch(batch_to_send);
+  } else if (schedule_send) {
+    messenger_->ScheduleOnReactor(
+        std::bind(&MultiRaftHeartbeatBatcher::SendScheduledBatch, shared_from_this(),
+                  std::placeholders::_1),
+        MonoDelta::FromMilliseconds(FLAGS_multi_raft_heartbeat_window_ms),
+        messenger_);
+  }
+}
+
+void MultiRaftHeartbeatBatcher::SendScheduledBatch(const Status& status) {
+  BatchDataPtr batch;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    send_scheduled_ = false;
+    batch = std::move(current_batch_);
+  }
+  if (!batch) {
+    return;
+  }
+  if (!status.ok()) {
+    // The messenger is shutting down.
+    FailBatch(batch, status);
+    return;
+  }
+  SendBatch(batch);
+}
+
+void MultiRaftHeartbeatBatcher::SendBatch(const BatchDataPtr& batch) {
+  VLOG(3) << "Sending " << batch->callbacks.size() << " heartbeats to " << hostport_;
+  batch->controller.set_timeout(MonoDelta::FromMilliseconds(FLAGS_consensus_rpc_timeout_ms));
+  consensus_proxy_->MultiRaftUpdateConsensusAsync(
+      batch->request, &batch->response, &batch->controller,
+      std::bind(&MultiRaftHeartbeatBatcher::BatchResponseReceived, shared_from_this(), batch));
+}
+
+void MultiRaftHeartbeatBatcher::BatchResponseReceived(const BatchDataPtr& batch) {
+  Status status = batch->controller.status();
+  if (status.ok() &&
+      static_cast<size_t>(batch->response.consensus_response_size()) != batch->callbacks.size()) {
+    status = STATUS_FORMAT(IllegalState, "Expected $0 responses from $1, but got $2",
+                           batch->callbacks.size(), hostport_,
+                           batch->response.consensus_response_size());
+  }
+  if (!status.ok()) {
+    FailBatch(batch, status);
+    return;
+  }
+
+  for (size_t i = 0; i != batch->callbacks.size(); ++i) {
+    auto& entry = batch->callbacks[i];
+    entry.response->Swap(batch->response.mutable_consensus_response(static_cast<int>(i)));
+    entry.callback(Status::OK());
+  }
+}
+
+void MultiRaftHeartbeatBatcher::FailBatch(const BatchDataPtr& batch, const Status& status) {
+  for (auto& entry : batch->callbacks) {
+    entry.callback(status);
+  }
+}
+
+MultiRaftManager::MultiRaftManager(
+    std::shared_ptr<rpc::Messenger> messenger, rpc::ProxyCache* proxy_cache)
+    : messenger_(std::move(messenger)), proxy_cache_(proxy_cache) {
+}
+
+MultiRaftHeartbeatBatcherPtr MultiRaftManager::AddOrGetBatcher(const HostPort& hostport) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& weak_batcher = batchers_[hostport];
+  auto batcher = weak_batcher.lock();
+  if (!batcher) {
+    batcher = std::make_shared<MultiRaftHeartbeatBatcher>(hostport, proxy_cache_, messenger_);
+    weak_batcher = batcher;
+  }
+  return batcher;
+}
+
+} // namespace consensus
+} // namespace yb
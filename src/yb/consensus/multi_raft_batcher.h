@@ -0,0 +1,112 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_CONSENSUS_MULTI_RAFT_BATCHER_H
+#define YB_CONSENSUS_MULTI_RAFT_BATCHER_H
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "yb/consensus/consensus_fwd.h"
+#include "yb/consensus/consensus.pb.h"
+
+#include "yb/rpc/rpc_controller.h"
+
+#include "yb/util/net/net_util.h"
+#include "yb/util/status_callback.h"
+
+namespace yb {
+
+namespace rpc {
+class Messenger;
+class ProxyCache;
+}
+
+namespace consensus {
+
+// Coalesces heartbeats, i.e. consensus requests without operations, that leaders of different
+// tablets on this server send to the same remote server into a single MultiRaftUpdateConsensus RPC.
+//
+// The first heartbeat added to an empty batch schedules the batch to be sent after
+// --multi_raft_heartbeat_window_ms, heartbeats added meanwhile join the same RPC. Responses are
+// fanned back out to the peers that sent the heartbeats.
+class MultiRaftHeartbeatBatcher : public std::enable_shared_from_this<MultiRaftHeartbeatBatcher> {
+ public:
+  MultiRaftHeartbeatBatcher(const HostPort& hostport,
+                            rpc::ProxyCache* proxy_cache,
+                            std::shared_ptr<rpc::Messenger> messenger);
+
+  ~MultiRaftHeartbeatBatcher();
+
+  // Adds a copy of request to the current batch. When the batch RPC completes, response is filled
+  // with the response of the destination tablet and callback is invoked with the RPC status.
+  void AddRequestToBatch(const ConsensusRequestPB& request,
+                         ConsensusResponsePB* response,
+                         StdStatusCallback callback);
+
+ private:
+  struct ResponseCallbackData {
+    ConsensusResponsePB* response;
+    StdStatusCallback callback;
+  };
+
+  struct BatchData {
+    MultiRaftConsensusRequestPB request;
+    MultiRaftConsensusResponsePB response;
+    rpc::RpcController controller;
+    std::vector<ResponseCallbackData> callbacks;
+  };
+
+  typedef std::shared_ptr<BatchData> BatchDataPtr;
+
+  void SendScheduledBatch(const Status& status);
+  void SendBatch(const BatchDataPtr& batch);
+  void BatchResponseReceived(const BatchDataPtr& batch);
+
+  // Invokes callbacks of all heartbeats in the batch with status.
+  void FailBatch(const BatchDataPtr& batch, const Status& status);
+
+  const HostPort hostport_;
+  ConsensusServiceProxyPtr consensus_proxy_;
+  std::shared_ptr<rpc::Messenger> messenger_;
+
+  std::mutex mutex_;
+  BatchDataPtr current_batch_;
+  bool send_scheduled_ = false;
+};
+
+// Keeps a heartbeat batcher per remote server, shared by the consensus instances of all tablets on
+// this server.
+class MultiRaftManager {
+ public:
+  MultiRaftManager(std::shared_ptr<rpc::Messenger> messenger, rpc::ProxyCache* proxy_cache);
+
+  // Returns the batcher for heartbeats sent to hostport, creating it if necessary.
+  MultiRaftHeartbeatBatcherPtr AddOrGetBatcher(const HostPort& hostport);
+
+ private:
+  std::shared_ptr<rpc::Messenger> messenger_;
+  rpc::ProxyCache* const proxy_cache_;
+
+  std::mutex mutex_;
+  // Batchers are owned by the peer proxies that use them, so the batcher for a remote server is
+  // destroyed once no tablet on this server has a peer there.
+  std::unordered_map<HostPort, std::weak_ptr<MultiRaftHeartbeatBatcher>, HostPortHash> batchers_;
+};
+
+} // namespace consensus
+} // namespace yb
+
+#endif // YB_CONSENSUS_MULTI_RAFT_BATCHER_H
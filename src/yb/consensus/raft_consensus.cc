@@ -45,6 +45,7 @@
 #include "yb/consensus/consensus_peers.h"
 #include "yb/consensus/leader_election.h"
 #include "yb/consensus/log.h"
+#include "yb/consensus/log_util.h"
 #include "yb/consensus/peer_manager.h"
 #include "yb/consensus/quorum_util.h"
 #include "yb/consensus/replica_state.h"
@@ -63,6 +64,7 @@
 #include "yb/util/mem_tracker.h"
 #include "yb/util/metrics.h"
 #include "yb/util/net/dns_resolver.h"
+#include "yb/util/pb_util.h"
 #include "yb/util/random.h"
 #include "yb/util/random_util.h"
 #include "yb/util/threadpool.h"
@@ -195,9 +197,10 @@ shared_ptr<RaftConsensus> RaftConsensus::Create(
     const Callback<void(std::shared_ptr<StateChangeContext> context)> mark_dirty_clbk,
     TableType table_type,
     LostLeadershipListener lost_leadership_listener,
-    ThreadPool* raft_pool) {
+    ThreadPool* raft_pool,
+    MultiRaftManager* multi_raft_manager) {
   gscoped_ptr<PeerProxyFactory> rpc_factory(new RpcPeerProxyFactory(
-      messenger, proxy_cache, local_peer_pb.cloud_info()));
+      messenger, proxy_cache, local_peer_pb.cloud_info(), multi_raft_manager));
 
   // The message queue that keeps track of which operations need to be replicated
   // where.
@@ -1097,6 +1100,21 @@ void RaftConsensus::TryRemoveFollowerTask(const string& uuid,
               state_->LogPrefixThreadSafe() + "Unable to remove follower " + uuid);
 }
 
+// Parses the operations that the leader sent compressed into request->ops.
+static Status UncompressOps(ConsensusRequestPB* request) {
+  const auto codec = request->ops_compression_codec();
+  if (codec == NO_LOG_COMPRESSION) {
+    return STATUS(InvalidArgument, "Compressed operations without compression codec");
+  }
+  faststring buffer;
+  for (const auto& compressed : request->compressed_ops()) {
+    RETURN_NOT_OK(log::UncompressEntryBatch(codec, compressed, &buffer));
+    RETURN_NOT_OK(pb_util::ParseFromArray(request->add_ops(), buffer.data(), buffer.size()));
+  }
+  request->clear_compressed_ops();
+  return Status::OK();
+}
+
 Status RaftConsensus::Update(ConsensusRequestPB* request,
                              ConsensusResponsePB* response) {
 
@@ -1118,6 +1136,10 @@ Status RaftConsensus::Update(ConsensusRequestPB* request,
   RETURN_NOT_OK(ExecuteHook(PRE_UPDATE));
   response->set_responder_uuid(state_->GetPeerUuid());
 
+  if (request->compressed_ops_size() > 0) {
+    RETURN_NOT_OK(UncompressOps(request));
+  }
+
   VLOG_WITH_PREFIX(2) << "Replica received request: " << request->ShortDebugString();
 
   // see var declaration
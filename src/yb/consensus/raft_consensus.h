@@ -106,7 +106,8 @@ class RaftConsensus : public std::enable_shared_from_this<RaftConsensus>,
     const Callback<void(std::shared_ptr<StateChangeContext> context)> mark_dirty_clbk,
     TableType table_type,
     LostLeadershipListener lost_leadership_listener,
-    ThreadPool* raft_pool);
+    ThreadPool* raft_pool,
+    MultiRaftManager* multi_raft_manager = nullptr);
 
   RaftConsensus(const ConsensusOptions& options,
     std::unique_ptr<ConsensusMetadata> cmeta,
@@ -69,7 +69,9 @@ class ConflictResolverContext {
   virtual CHECKED_STATUS ReadConflicts(ConflictResolver* resolver) = 0;
 
   // Check priority of this one against existing transactions.
-  virtual CHECKED_STATUS CheckPriority(
+  // Returns true if conflict resolution should stop, because the caller waits for conflicting
+  // transactions with higher priority instead of failing.
+  virtual Result<bool> CheckPriority(
       ConflictResolver* resolver,
       std::vector<TransactionData>* transactions) = 0;
 
@@ -194,7 +196,9 @@ class ConflictResolver {
         return Status::OK();
       }
 
-      RETURN_NOT_OK(context_.CheckPriority(this, &transactions_));
+      if (VERIFY_RESULT(context_.CheckPriority(this, &transactions_))) {
+        return Status::OK();
+      }
 
       RETURN_NOT_OK(AbortTransactions());
 
@@ -323,12 +327,14 @@ class TransactionConflictResolverContext : public ConflictResolverContext {
  public:
   TransactionConflictResolverContext(const KeyValueWriteBatchPB& write_batch,
                                      HybridTime hybrid_time,
-                                     Counter* conflicts_metric)
+                                     Counter* conflicts_metric,
+                                     TransactionIdSet* blockers)
       : write_batch_(write_batch),
         hybrid_time_(hybrid_time),
         transaction_id_(FullyDecodeTransactionId(
             write_batch.transaction().transaction_id())),
-        conflicts_metric_(conflicts_metric)
+        conflicts_metric_(conflicts_metric),
+        blockers_(blockers)
   {}
 
   virtual ~TransactionConflictResolverContext() {}
@@ -390,9 +396,10 @@ class TransactionConflictResolverContext : public ConflictResolverContext {
     return resolver->ReadIntentConflicts(intent_type, intent_key_prefix);
   }
 
-  CHECKED_STATUS CheckPriority(ConflictResolver* resolver,
-                               std::vector<TransactionData>* transactions) override {
+  Result<bool> CheckPriority(ConflictResolver* resolver,
+                             std::vector<TransactionData>* transactions) override {
     auto our_priority = metadata_.priority;
+    TransactionIdSet blockers;
     for (auto& transaction : *transactions) {
       if (!fetched_metadata_for_transactions_) {
         auto their_metadata = resolver->Metadata(transaction.id);
@@ -406,12 +413,19 @@ class TransactionConflictResolverContext : public ConflictResolverContext {
       }
       auto their_priority = transaction.metadata.priority;
       if (our_priority < their_priority) {
-        return MakeConflictStatus(transaction.id, "higher priority", conflicts_metric_);
+        if (!blockers_) {
+          return MakeConflictStatus(transaction.id, "higher priority", conflicts_metric_);
+        }
+        blockers.insert(transaction.id);
       }
     }
     fetched_metadata_for_transactions_ = true;
 
-    return Status::OK();
+    if (blockers.empty()) {
+      return false;
+    }
+    *blockers_ = std::move(blockers);
+    return true;
   }
 
   CHECKED_STATUS CheckConflictWithCommitted(
@@ -440,6 +454,8 @@ class TransactionConflictResolverContext : public ConflictResolverContext {
   Status result_ = Status::OK();
   bool fetched_metadata_for_transactions_ = false;
   Counter* conflicts_metric_ = nullptr;
+  // Where to store higher priority transactions to wait for, null if waiting is not allowed.
+  TransactionIdSet* blockers_;
 };
 
 class OperationConflictResolverContext : public ConflictResolverContext {
@@ -477,8 +493,8 @@ class OperationConflictResolverContext : public ConflictResolverContext {
     return Status::OK();
   }
 
-  CHECKED_STATUS CheckPriority(ConflictResolver*, std::vector<TransactionData>*) override {
-    return Status::OK();
+  Result<bool> CheckPriority(ConflictResolver*, std::vector<TransactionData>*) override {
+    return false;
   }
 
   HybridTime GetHybridTime() override {
@@ -506,9 +522,10 @@ Status ResolveTransactionConflicts(const KeyValueWriteBatchPB& write_batch,
                                    HybridTime hybrid_time,
                                    const DocDB& doc_db,
                                    TransactionStatusManager* status_manager,
-                                   Counter* conflicts_metric) {
+                                   Counter* conflicts_metric,
+                                   TransactionIdSet* blockers) {
   DCHECK(hybrid_time.is_valid());
-  TransactionConflictResolverContext context(write_batch, hybrid_time, conflicts_metric);
+  TransactionConflictResolverContext context(write_batch, hybrid_time, conflicts_metric, blockers);
   ConflictResolver resolver(doc_db, status_manager, &context);
   return resolver.Resolve();
 }
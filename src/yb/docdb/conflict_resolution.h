@@ -14,6 +14,8 @@
 #ifndef YB_DOCDB_CONFLICT_RESOLUTION_H
 #define YB_DOCDB_CONFLICT_RESOLUTION_H
 
+#include "yb/common/transaction.h"
+
 #include "yb/docdb/doc_operation.h"
 #include "yb/docdb/value_type.h"
 
@@ -46,11 +48,15 @@ class KeyValueWriteBatchPB;
 // db - db that contains tablet data.
 // status_manager - status manager that should be used during this conflict resolution.
 // conflicts_metric - transaction_conflicts metric to update.
+// blockers - if not null, conflicts with pending transactions of higher priority are not reported.
+//            Those transactions are stored in blockers instead and OK is returned, so the caller
+//            could release its locks and retry once one of them is resolved.
 CHECKED_STATUS ResolveTransactionConflicts(const KeyValueWriteBatchPB& write_batch,
                                            HybridTime hybrid_time,
                                            const DocDB& doc_db,
                                            TransactionStatusManager* status_manager,
-                                           Counter* conflicts_metric);
+                                           Counter* conflicts_metric,
+                                           TransactionIdSet* blockers = nullptr);
 
 // Resolves conflicts for doc operations.
 // Read all intents that could conflict with provided doc_ops.
@@ -373,6 +373,39 @@ TEST(DocKeyTest, TestKeyMatching) {
   ASSERT_FALSE(may_match(EncodeSimpleSubDocKey(absent_key))) << "Key: " << absent_key;
 }
 
+TEST(DocKeyTest, TestWholeDocKeyMatching) {
+  DocDbAwareFilterPolicy policy(rocksdb::FilterPolicy::kDefaultFixedSizeFilterBits, nullptr,
+                                DocKeyPart::WHOLE_DOC_KEY);
+  ASSERT_STRNE(policy.Name(), DocDbAwareFilterPolicy(
+      rocksdb::FilterPolicy::kDefaultFixedSizeFilterBits, nullptr).Name());
+  std::string range_keys[] = { "r1", "r2", "r3" };
+  std::string absent_range_key = "r4";
+
+  std::unique_ptr<FilterBitsBuilder> builder(policy.GetFilterBitsBuilder());
+  ASSERT_NE(builder, nullptr);
+  for (const auto& range_key : range_keys) {
+    builder->AddKey(policy.GetKeyTransformer()->Transform(
+        EncodeSubDocKey("hash_key", range_key, "sub_key", 12345L)));
+  }
+  std::unique_ptr<const char[]> buf;
+  rocksdb::Slice filter = builder->Finish(&buf);
+
+  std::unique_ptr<FilterBitsReader> reader(policy.GetFilterBitsReader(filter));
+
+  auto may_match = [&](const std::string& sub_doc_key_str) {
+    return reader->MayMatch(policy.GetKeyTransformer()->Transform(sub_doc_key_str));
+  };
+
+  for (const auto& range_key : range_keys) {
+    // Only the DocKey is taken into account, so other subkeys of the same row still match.
+    ASSERT_TRUE(may_match(EncodeSubDocKey("hash_key", range_key, "another_sub_key", 55555L)))
+        << "Range key: " << range_key;
+  }
+  // The same hash key with a different range key is filtered out.
+  ASSERT_FALSE(may_match(EncodeSubDocKey("hash_key", absent_range_key, "sub_key", 12345L)))
+      << "Range key: " << absent_range_key;
+}
+
 TEST(DocKeyTest, TestWriteId) {
   SubDocKey subdoc_key(DocKey({PrimitiveValue("a"), PrimitiveValue(135)}),
                        DocHybridTime(1000000, 4091, 135));
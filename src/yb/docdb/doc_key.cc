@@ -687,6 +687,28 @@ class HashedComponentsExtractor : public rocksdb::FilterPolicy::KeyTransformer {
   }
 };
 
+class WholeDocKeyExtractor : public rocksdb::FilterPolicy::KeyTransformer {
+ public:
+  WholeDocKeyExtractor() {}
+  WholeDocKeyExtractor(const WholeDocKeyExtractor&) = delete;
+  WholeDocKeyExtractor& operator=(const WholeDocKeyExtractor&) = delete;
+
+  static WholeDocKeyExtractor& GetInstance() {
+    static WholeDocKeyExtractor instance;
+    return instance;
+  }
+
+  Slice Transform(Slice key) const override {
+    auto size = DocKey::EncodedSize(key, DocKeyPart::WHOLE_DOC_KEY);
+    if (!size.ok()) {
+      // Keys that do not start with a complete DocKey (e.g. transaction metadata in the intents
+      // DB) are never looked up with a filter, so just keep them consistent with the default mode.
+      return HashedComponentsExtractor::GetInstance().Transform(key);
+    }
+    return Slice(key.data(), *size);
+  }
+};
+
 } // namespace
 
 
@@ -715,6 +737,9 @@ rocksdb::FilterPolicy::FilterType DocDbAwareFilterPolicy::GetFilterType() const
 }
 
 const rocksdb::FilterPolicy::KeyTransformer* DocDbAwareFilterPolicy::GetKeyTransformer() const {
+  if (key_part_ == DocKeyPart::WHOLE_DOC_KEY) {
+    return &WholeDocKeyExtractor::GetInstance();
+  }
   return &HashedComponentsExtractor::GetInstance();
 }
 
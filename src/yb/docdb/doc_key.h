@@ -512,15 +512,22 @@ inline std::ostream& operator <<(std::ostream& out, const SubDocKey& subdoc_key)
 std::string BestEffortDocDBKeyToStr(const KeyBytes &key_bytes);
 std::string BestEffortDocDBKeyToStr(const rocksdb::Slice &slice);
 
-// This filter policy only takes into account hashed components of keys for filtering.
+// This filter policy only takes into account the DocKey part of keys for filtering: either the
+// hashed components only (the default) or the whole DocKey including the range components.
+// The two modes use different names, so RocksDB ignores filter blocks written in the other mode.
 class DocDbAwareFilterPolicy : public rocksdb::FilterPolicy {
  public:
-  explicit DocDbAwareFilterPolicy(size_t filter_block_size_bits, rocksdb::Logger* logger) {
+  DocDbAwareFilterPolicy(size_t filter_block_size_bits, rocksdb::Logger* logger,
+                         DocKeyPart key_part = DocKeyPart::HASHED_PART_ONLY)
+      : key_part_(key_part) {
     builtin_policy_.reset(rocksdb::NewFixedSizeFilterPolicy(
         filter_block_size_bits, rocksdb::FilterPolicy::kDefaultFixedSizeFilterErrorRate, logger));
   }
 
-  const char* Name() const override { return "DocKeyHashedComponentsFilter"; }
+  const char* Name() const override {
+    return key_part_ == DocKeyPart::WHOLE_DOC_KEY ? "DocKeyWholeKeyFilter"
+                                                  : "DocKeyHashedComponentsFilter";
+  }
 
   void CreateFilter(const rocksdb::Slice* keys, int n, std::string* dst) const override;
 
@@ -535,6 +542,7 @@ class DocDbAwareFilterPolicy : public rocksdb::FilterPolicy {
   const KeyTransformer* GetKeyTransformer() const override;
 
  private:
+  const DocKeyPart key_part_;
   std::unique_ptr<const rocksdb::FilterPolicy> builtin_policy_;
 };
 
@@ -11,6 +11,7 @@
 // under the License.
 //
 
+#include <algorithm>
 #include <thread>
 
 #include "yb/rocksdb/statistics.h"
@@ -35,6 +36,7 @@
 DECLARE_uint64(rocksdb_max_file_size_for_compaction);
 DECLARE_int32(rocksdb_level0_slowdown_writes_trigger);
 DECLARE_int32(rocksdb_level0_stop_writes_trigger);
+DECLARE_bool(ysql_enable_packed_row);
 
 using namespace std::literals; // NOLINT
 
@@ -842,6 +844,58 @@ TEST_F_EX(DocOperationTest, QLTxnDescendingReverseScan, DocOperationTxnScanTest)
   TestWithSortingType(ColumnSchema::kDescending, false);
 }
 
+// PGSQL INSERT writes a packed row, and compaction merges later column updates into it.
+TEST_F(DocOperationTest, PgsqlPackedRow) {
+  FLAGS_ysql_enable_packed_row = true;
+  const Schema schema = CreateSchema();
+
+  PgsqlWriteRequestPB pgsql_writereq_pb;
+  PgsqlResponsePB pgsql_writeresp_pb;
+  pgsql_writereq_pb.set_stmt_type(PgsqlWriteRequestPB::PGSQL_INSERT);
+  pgsql_writereq_pb.set_hash_code(kFixedHashCode);
+  pgsql_writereq_pb.add_partition_column_values()->mutable_value()->set_int32_value(1);
+  for (int32_t i = 1; i <= 3; ++i) {
+    auto* column = pgsql_writereq_pb.add_column_values();
+    column->set_column_id(i);
+    column->mutable_expr()->mutable_value()->set_int32_value(i + 1);
+  }
+  PgsqlWriteOperation pgsql_write_op(schema, kNonTransactionalOperationContext);
+  ASSERT_OK(pgsql_write_op.Init(&pgsql_writereq_pb, &pgsql_writeresp_pb));
+  auto doc_write_batch = MakeDocWriteBatch();
+  HybridTime restart_read_ht;
+  ASSERT_OK(pgsql_write_op.Apply(
+      {&doc_write_batch, MonoTime::Max() /* deadline */, ReadHybridTime::Max(),
+       &restart_read_ht}));
+  ASSERT_OK(WriteToRocksDB(doc_write_batch, HybridTime::FromMicros(1000)));
+
+  auto num_entries = [this] {
+    const auto dump = DocDBDebugDumpToStr();
+    return std::count(dump.begin(), dump.end(), '\n');
+  };
+  auto verify_row = [this, &schema](int32_t expected_c2) {
+    QLRowBlock row_block = ReadQLRow(schema, 1, HybridTime::FromMicros(3000));
+    ASSERT_EQ(1, row_block.row_count());
+    EXPECT_EQ(1, row_block.row(0).column(0).int32_value());
+    EXPECT_EQ(2, row_block.row(0).column(1).int32_value());
+    EXPECT_EQ(expected_c2, row_block.row(0).column(2).int32_value());
+    EXPECT_EQ(4, row_block.row(0).column(3).int32_value());
+  };
+  ASSERT_EQ(1, num_entries()) << DocDBDebugDumpToStr();
+  ASSERT_STR_CONTAINS(DocDBDebugDumpToStr(), "PackedRow");
+  ASSERT_NO_FATALS(verify_row(3));
+
+  const KeyBytes encoded_doc_key =
+      DocKey(kFixedHashCode, {PrimitiveValue::Int32(1)}).Encode();
+  ASSERT_OK(SetPrimitive(DocPath(encoded_doc_key, PrimitiveValue(ColumnId(2))),
+                         Value(PrimitiveValue::Int32(30)), HybridTime::FromMicros(2000)));
+  ASSERT_EQ(2, num_entries()) << DocDBDebugDumpToStr();
+  ASSERT_NO_FATALS(verify_row(30));
+
+  FullyCompactHistoryBefore(HybridTime::FromMicros(3000));
+  ASSERT_EQ(1, num_entries()) << DocDBDebugDumpToStr();
+  ASSERT_NO_FATALS(verify_row(30));
+}
+
 TEST_F(DocOperationTest, TestQLCompactions) {
   yb::QLWriteRequestPB ql_writereq_pb;
   yb::QLResponsePB ql_writeresp_pb;
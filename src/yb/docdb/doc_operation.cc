@@ -29,10 +29,12 @@
 #include "yb/docdb/doc_pgsql_scanspec.h"
 #include "yb/docdb/doc_rowwise_iterator.h"
 #include "yb/docdb/intent_aware_iterator.h"
+#include "yb/docdb/packed_row.h"
 #include "yb/docdb/subdocument.h"
 
 #include "yb/server/hybrid_clock.h"
 #include "yb/gutil/strings/substitute.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/stol_utils.h"
 #include "yb/util/trace.h"
 
@@ -47,6 +49,20 @@ DEFINE_bool(emulate_redis_responses,
     "and HDEL. If emulate_redis_responses is true, we read the required records to compute the "
     "response as specified by the official Redis API documentation. https://redis.io/commands");
 
+DEFINE_bool(ycql_enable_packed_row, false,
+            "If true, CQL INSERTs that set all the columns of a row without TTL or user timestamp "
+            "are written as a single packed value keyed by the DocKey of the row instead of an "
+            "entry per column. Requires all servers in the cluster to support packed rows.");
+TAG_FLAG(ycql_enable_packed_row, evolving);
+TAG_FLAG(ycql_enable_packed_row, runtime);
+
+DEFINE_bool(ysql_enable_packed_row, false,
+            "If true, PGSQL INSERTs that set all the columns of a row are written as a single "
+            "packed value keyed by the DocKey of the row instead of an entry per column. Requires "
+            "all servers in the cluster to support packed rows.");
+TAG_FLAG(ysql_enable_packed_row, evolving);
+TAG_FLAG(ysql_enable_packed_row, runtime);
+
 namespace yb {
 namespace docdb {
 
@@ -2417,6 +2433,68 @@ Status QLWriteOperation::ApplyForRegularColumns(const QLColumnValuePB& column_va
   return Status::OK();
 }
 
+bool QLWriteOperation::CanWritePackedRow(
+    const MonoDelta& ttl, const UserTimeMicros& user_timestamp) const {
+  if (!FLAGS_ycql_enable_packed_row ||
+      request_.type() != QLWriteRequestPB::QL_STMT_INSERT ||
+      pk_doc_path_ == nullptr ||
+      !ttl.Equals(Value::kMaxTtl) ||
+      user_timestamp != Value::kInvalidUserTimestamp ||
+      !TableTTL(schema_).Equals(Value::kMaxTtl)) {
+    return false;
+  }
+
+  // Every non-key column should be set to a value that is stored as a single primitive value.
+  size_t num_columns = 0;
+  for (const auto& column_value : request_.column_values()) {
+    if (!column_value.has_column_id() ||
+        !column_value.json_args().empty() ||
+        !column_value.subscript_args().empty() ||
+        GetTSWriteInstruction(column_value.expr()) != TSOpcode::kScalarInsert) {
+      return false;
+    }
+    const auto column = schema_.column_by_id(ColumnId(column_value.column_id()));
+    if (!column.ok() || column->is_static() || column->type()->HasComplexValues()) {
+      return false;
+    }
+    ++num_columns;
+  }
+  return num_columns == schema_.num_columns() - schema_.num_key_columns();
+}
+
+Status QLWriteOperation::ApplyPackedRow(const QLTableRow& existing_row,
+                                        const DocOperationApplyData& data,
+                                        QLTableRow* new_row) {
+  PackedRowEncoder encoder(request_.schema_version());
+  encoder.AddColumn(PrimitiveValue::SystemColumnId(SystemColumnIds::kLivenessColumn),
+                    PrimitiveValue());
+  for (const auto& column_value : request_.column_values()) {
+    const ColumnId column_id(column_value.column_id());
+    const auto maybe_column = schema_.column_by_id(column_id);
+    RETURN_NOT_OK(maybe_column);
+    const ColumnSchema& column = *maybe_column;
+
+    QLValue expr_result;
+    RETURN_NOT_OK(EvalExpr(column_value.expr(), existing_row, &expr_result));
+    const SubDocument sub_doc = SubDocument::FromQLValuePB(
+        expr_result.value(), column.sorting_type(), TSOpcode::kScalarInsert);
+    // Null columns are not stored, the packed row hides their older values anyway.
+    if (sub_doc.value_type() != ValueType::kTombstone) {
+      if (!IsPrimitiveValueType(sub_doc.value_type())) {
+        return STATUS_FORMAT(IllegalState, "Unexpected value type $0 of column $1 in packed row",
+                             sub_doc.value_type(), column.name());
+      }
+      encoder.AddColumn(PrimitiveValue(column_id), sub_doc);
+    }
+
+    if (update_indexes_) {
+      new_row->AllocColumn(column_id, expr_result);
+    }
+  }
+  return data.doc_write_batch->SetPrimitive(
+      *pk_doc_path_, Value(encoder.Finish()), data.read_time, data.deadline, request_.query_id());
+}
+
 Status QLWriteOperation::Apply(const DocOperationApplyData& data) {
   QLTableRow existing_row;
   if (request_.has_if_expr()) {
@@ -2488,6 +2566,14 @@ Status QLWriteOperation::Apply(const DocOperationApplyData& data) {
     // primary key at least.
     case QLWriteRequestPB::QL_STMT_INSERT:
     case QLWriteRequestPB::QL_STMT_UPDATE: {
+      if (CanWritePackedRow(ttl, user_timestamp)) {
+        RETURN_NOT_OK(ApplyPackedRow(existing_row, data, &new_row));
+        if (update_indexes_) {
+          RETURN_NOT_OK(UpdateIndexes(existing_row, new_row));
+        }
+        break;
+      }
+
       // Add the appropriate liveness column only for inserts.
       // We never use init markers for QL to ensure we perform writes without any reads to
       // ensure our write path is fast while complicating the read path a bit.
@@ -3090,6 +3176,12 @@ CHECKED_STATUS PgsqlWriteOperation::ApplyInsert(const DocOperationApplyData& dat
     return STATUS(QLError, "Primary key already exists");
   }
 
+  if (CanWritePackedRow()) {
+    RETURN_NOT_OK(ApplyPackedRow(data, table_row));
+    response_->set_status(PgsqlResponsePB::PGSQL_STATUS_OK);
+    return Status::OK();
+  }
+
   const MonoDelta ttl = Value::kMaxTtl;
   const UserTimeMicros user_timestamp = Value::kInvalidUserTimestamp;
 
@@ -3132,6 +3224,58 @@ CHECKED_STATUS PgsqlWriteOperation::ApplyInsert(const DocOperationApplyData& dat
   return Status::OK();
 }
 
+bool PgsqlWriteOperation::CanWritePackedRow() const {
+  if (!FLAGS_ysql_enable_packed_row || range_doc_path_ == nullptr) {
+    return false;
+  }
+
+  // Every non-key column should be set to a value that is stored as a single primitive value.
+  size_t num_columns = 0;
+  for (const auto& column_value : request_.column_values()) {
+    if (!column_value.has_column_id()) {
+      return false;
+    }
+    const auto column = schema_.column_by_id(ColumnId(column_value.column_id()));
+    if (!column.ok() || column->type()->HasComplexValues()) {
+      return false;
+    }
+    ++num_columns;
+  }
+  return num_columns == schema_.num_columns() - schema_.num_key_columns();
+}
+
+CHECKED_STATUS PgsqlWriteOperation::ApplyPackedRow(const DocOperationApplyData& data,
+                                                   const QLTableRow::SharedPtr& table_row) {
+  PackedRowEncoder encoder(request_.schema_version());
+  encoder.AddColumn(PrimitiveValue::SystemColumnId(SystemColumnIds::kLivenessColumn),
+                    PrimitiveValue());
+  for (const auto& column_value : request_.column_values()) {
+    const ColumnId column_id(column_value.column_id());
+    auto column = schema_.column_by_id(column_id);
+    RETURN_NOT_OK(column);
+
+    // Check column-write operator.
+    CHECK(GetTSWriteInstruction(column_value.expr()) == bfpg::TSOpcode::kScalarInsert)
+      << "Illegal write instruction";
+
+    QLValue expr_result;
+    RETURN_NOT_OK(EvalExpr(column_value.expr(), table_row, &expr_result));
+    const SubDocument sub_doc =
+        SubDocument::FromQLValuePB(expr_result.value(), column->sorting_type());
+    // Null columns are not stored, the packed row hides their older values anyway.
+    if (sub_doc.value_type() != ValueType::kTombstone) {
+      if (!IsPrimitiveValueType(sub_doc.value_type())) {
+        return STATUS_FORMAT(IllegalState, "Unexpected value type $0 of column $1 in packed row",
+                             sub_doc.value_type(), column->name());
+      }
+      encoder.AddColumn(PrimitiveValue(column_id), sub_doc);
+    }
+  }
+  return data.doc_write_batch->SetPrimitive(
+      *range_doc_path_, Value(encoder.Finish()), data.read_time, data.deadline,
+      request_.stmt_id());
+}
+
 CHECKED_STATUS PgsqlWriteOperation::ApplyUpdate(const DocOperationApplyData& data) {
   response_->set_status(PgsqlResponsePB::PGSQL_STATUS_OK);
   return Status::OK();
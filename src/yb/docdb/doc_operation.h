@@ -273,6 +273,14 @@ class QLWriteOperation : public DocOperation, public DocExprExecutor {
                                         const ColumnId& column_id,
                                         QLTableRow* new_row);
 
+  // Whether the request is an INSERT that could be written as a packed row, see packed_row.h.
+  bool CanWritePackedRow(const MonoDelta& ttl, const UserTimeMicros& user_timestamp) const;
+
+  // Writes all the columns of the INSERT as a single packed row value keyed by the DocKey.
+  CHECKED_STATUS ApplyPackedRow(const QLTableRow& existing_row,
+                                const DocOperationApplyData& data,
+                                QLTableRow* new_row);
+
   const QLWriteRequestPB& request() const { return request_; }
   QLResponsePB* response() const { return response_; }
 
@@ -431,6 +439,13 @@ class PgsqlWriteOperation : public PgsqlDocOperation {
   CHECKED_STATUS ApplyUpdate(const DocOperationApplyData& data);
   CHECKED_STATUS ApplyDelete(const DocOperationApplyData& data);
 
+  // Whether the request is an INSERT that could be written as a packed row, see packed_row.h.
+  bool CanWritePackedRow() const;
+
+  // Writes all the columns of the INSERT as a single packed row value keyed by the DocKey.
+  CHECKED_STATUS ApplyPackedRow(const DocOperationApplyData& data,
+                                const QLTableRow::SharedPtr& table_row);
+
   // Reading current row before operating on it.
   CHECKED_STATUS ReadColumns(const DocOperationApplyData& data,
                              const QLTableRow::SharedPtr& table_row);
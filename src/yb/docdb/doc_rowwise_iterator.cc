@@ -34,6 +34,39 @@ using yb::FormatRocksDBSliceAsStr;
 namespace yb {
 namespace docdb {
 
+namespace {
+
+// Returns true if the scan bounds select a single row, i.e. the lower bound is a fully-specified
+// DocKey and the upper bound is the same DocKey followed by the +inf range component.
+bool IsSingleRowScan(const DocKey& lower_doc_key, const DocKey& upper_doc_key,
+                     size_t num_range_key_columns) {
+  const auto& lower_range = lower_doc_key.range_group();
+  const auto& upper_range = upper_doc_key.range_group();
+  return lower_range.size() == num_range_key_columns &&
+         upper_range.size() == num_range_key_columns + 1 &&
+         upper_range.back().value_type() == ValueType::kHighest &&
+         upper_doc_key.HashedComponentsEqual(lower_doc_key) &&
+         std::equal(lower_range.begin(), lower_range.end(), upper_range.begin());
+}
+
+BloomFilterMode GetBloomFilterMode(const Schema& schema, const DocKey& lower_doc_key,
+                                   const DocKey& upper_doc_key) {
+  if (lower_doc_key.empty()) {
+    return BloomFilterMode::DONT_USE_BLOOM_FILTER;
+  }
+  // Filters built on the whole primary key can only tell whether that exact row may be present.
+  if (schema.table_properties().bloom_filter_key_type() ==
+          BloomFilterKeyType::PRIMARY_KEY_BLOOM_FILTER) {
+    return IsSingleRowScan(lower_doc_key, upper_doc_key, schema.num_range_key_columns())
+        ? BloomFilterMode::USE_BLOOM_FILTER : BloomFilterMode::DONT_USE_BLOOM_FILTER;
+  }
+  // TODO(bogdan): decide if this is a good enough heuristic for using blooms for scans.
+  return upper_doc_key.HashedComponentsEqual(lower_doc_key)
+      ? BloomFilterMode::USE_BLOOM_FILTER : BloomFilterMode::DONT_USE_BLOOM_FILTER;
+}
+
+} // namespace
+
 DocRowwiseIterator::DocRowwiseIterator(
     const Schema &projection,
     const Schema &schema,
@@ -89,11 +122,7 @@ Status DocRowwiseIterator::Init(const common::QLScanSpec& spec) {
   RETURN_NOT_OK(doc_spec.upper_bound(&upper_doc_key));
   VLOG(4) << "DocKey Bounds " << lower_doc_key.ToString() << ", " << upper_doc_key.ToString();
 
-  // TODO(bogdan): decide if this is a good enough heuristic for using blooms for scans.
-  const bool is_fixed_point_get = !lower_doc_key.empty() &&
-      upper_doc_key.HashedComponentsEqual(lower_doc_key);
-  const auto mode = is_fixed_point_get ? BloomFilterMode::USE_BLOOM_FILTER :
-      BloomFilterMode::DONT_USE_BLOOM_FILTER;
+  const auto mode = GetBloomFilterMode(schema_, lower_doc_key, upper_doc_key);
 
   const KeyBytes row_key_encoded = lower_doc_key.Encode();
   const Slice row_key_encoded_as_slice = row_key_encoded.AsSlice();
@@ -166,11 +195,7 @@ Status DocRowwiseIterator::Init(const common::PgsqlScanSpec& spec) {
   RETURN_NOT_OK(doc_spec.upper_bound(&upper_doc_key));
   VLOG(4) << "DocKey Bounds " << lower_doc_key.ToString() << ", " << upper_doc_key.ToString();
 
-  // TODO(bogdan): decide if this is a good enough heuristic for using blooms for scans.
-  const bool is_fixed_point_get = !lower_doc_key.empty() &&
-      upper_doc_key.HashedComponentsEqual(lower_doc_key);
-  const auto mode = is_fixed_point_get ? BloomFilterMode::USE_BLOOM_FILTER :
-      BloomFilterMode::DONT_USE_BLOOM_FILTER;
+  const auto mode = GetBloomFilterMode(schema_, lower_doc_key, upper_doc_key);
 
   const KeyBytes row_key_encoded = lower_doc_key.Encode();
   const Slice row_key_encoded_as_slice = row_key_encoded.AsSlice();
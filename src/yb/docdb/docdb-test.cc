@@ -13,6 +13,7 @@
 
 #include "yb/docdb/docdb.h"
 
+#include <algorithm>
 #include <memory>
 #include <string>
 
@@ -27,6 +28,7 @@
 #include "yb/docdb/docdb_test_util.h"
 #include "yb/docdb/in_mem_docdb.h"
 #include "yb/docdb/intent.h"
+#include "yb/docdb/packed_row.h"
 #include "yb/gutil/stringprintf.h"
 #include "yb/rocksutil/yb_rocksdb.h"
 #include "yb/server/hybrid_clock.h"
@@ -57,6 +59,8 @@ using namespace std::chrono_literals;
 
 DECLARE_bool(use_docdb_aware_bloom_filter);
 DECLARE_int32(max_nexts_to_avoid_seek);
+DECLARE_int32(rocksdb_max_subcompactions);
+DECLARE_string(rocksdb_compaction_style);
 
 namespace yb {
 namespace docdb {
@@ -1772,6 +1776,224 @@ SubDocKey(DocKey([], ["k6"]), [HT{ physical: 9000 }]) -> "v6"; ttl: 0.009s
       )#");
 }
 
+TEST_F(DocDBTest, PackedRowTest) {
+  const DocKey doc_key(PrimitiveValues("k1"));
+  KeyBytes encoded_doc_key(doc_key.Encode());
+  const PrimitiveValue liveness = PrimitiveValue::SystemColumnId(SystemColumnIds::kLivenessColumn);
+  const PrimitiveValue col10 = PrimitiveValue(ColumnId(10));
+  const PrimitiveValue col20 = PrimitiveValue(ColumnId(20));
+  const PrimitiveValue col30 = PrimitiveValue(ColumnId(30));
+
+  // Column written before the packed row is hidden by it.
+  ASSERT_OK(SetPrimitive(DocPath(encoded_doc_key, col30), Value(PrimitiveValue("v30")),
+                         1000_usec_ht));
+  PackedRowEncoder encoder(/* schema_version = */ 1);
+  encoder.AddColumn(liveness, PrimitiveValue());
+  encoder.AddColumn(col10, PrimitiveValue("v10"));
+  encoder.AddColumn(col20, PrimitiveValue("v20"));
+  ASSERT_OK(SetPrimitive(DocPath(encoded_doc_key), Value(encoder.Finish()), 2000_usec_ht));
+  // Columns written after the packed row override it.
+  ASSERT_OK(SetPrimitive(DocPath(encoded_doc_key, col20), Value(PrimitiveValue("v20_new")),
+                         3000_usec_ht));
+  ASSERT_OK(SetPrimitive(DocPath(encoded_doc_key, col10), Value(PrimitiveValue::kTombstone),
+                         4000_usec_ht));
+
+  const auto encoded_subdoc_key = SubDocKey(doc_key).EncodeWithoutHt();
+  const std::vector<PrimitiveValue> projection = {liveness, col10, col20, col30};
+  for (bool use_projection : {false, true}) {
+    SCOPED_TRACE(Format("use_projection: $0", use_projection));
+    auto read_row = [&](HybridTime ht, SubDocument* row) {
+      bool doc_found = false;
+      GetSubDocumentData data = { encoded_subdoc_key, row, &doc_found };
+      auto iter = CreateIntentAwareIterator(
+          doc_db(), BloomFilterMode::USE_BLOOM_FILTER, encoded_subdoc_key.AsSlice(),
+          rocksdb::kDefaultQueryId, kNonTransactionalOperationContext, MonoTime::Max(),
+          ReadHybridTime::SingleTime(ht));
+      ASSERT_OK(GetSubDocument(
+          iter.get(), data, use_projection ? &projection : nullptr, SeekFwdSuffices::kFalse));
+      // With projection, doc_found reflects only the last projected column.
+      ASSERT_TRUE(doc_found || use_projection);
+    };
+    auto column_value = [](const SubDocument& row, const PrimitiveValue& column) {
+      const SubDocument* value = row.GetChild(column);
+      return value == nullptr || value->value_type() == ValueType::kInvalid
+          ? std::string() : value->ToString();
+    };
+
+    SubDocument row;
+    read_row(1500_usec_ht, &row);
+    ASSERT_EQ("", column_value(row, col10));
+    ASSERT_EQ("\"v30\"", column_value(row, col30));
+
+    read_row(2500_usec_ht, &row);
+    ASSERT_EQ("null", column_value(row, liveness));
+    ASSERT_EQ("\"v10\"", column_value(row, col10));
+    ASSERT_EQ("\"v20\"", column_value(row, col20));
+    ASSERT_EQ("", column_value(row, col30));
+    ASSERT_EQ(2000, row.GetChild(col10)->GetWriteTime());
+
+    read_row(3500_usec_ht, &row);
+    ASSERT_EQ("\"v10\"", column_value(row, col10));
+    ASSERT_EQ("\"v20_new\"", column_value(row, col20));
+    ASSERT_EQ(3000, row.GetChild(col20)->GetWriteTime());
+
+    read_row(4500_usec_ht, &row);
+    ASSERT_EQ("null", column_value(row, liveness));
+    ASSERT_EQ("", column_value(row, col10));
+    ASSERT_EQ("\"v20_new\"", column_value(row, col20));
+    ASSERT_EQ("", column_value(row, col30));
+  }
+
+  auto read_compacted_row = [&](SubDocument* row) {
+    bool doc_found = false;
+    GetSubDocumentData data = { encoded_subdoc_key, row, &doc_found };
+    ASSERT_OK(GetSubDocument(
+        doc_db(), data, rocksdb::kDefaultQueryId, kNonTransactionalOperationContext,
+        MonoTime::Max()));
+    ASSERT_TRUE(doc_found);
+  };
+  auto num_entries = [this] {
+    const auto dump = DocDBDebugDumpToStr();
+    return std::count(dump.begin(), dump.end(), '\n');
+  };
+
+  // Compaction removes the column entry overwritten by the packed row, and merges the column
+  // written after the packed row below the history cutoff into it. The tombstone above the history
+  // cutoff is kept.
+  FullyCompactHistoryBefore(3500_usec_ht);
+  ASSERT_EQ(2, num_entries()) << DocDBDebugDumpToStr();
+  SubDocument row;
+  ASSERT_NO_FATALS(read_compacted_row(&row));
+  ASSERT_EQ(nullptr, row.GetChild(col10));
+  ASSERT_EQ(nullptr, row.GetChild(col30));
+  ASSERT_NE(nullptr, row.GetChild(liveness));
+  ASSERT_EQ("\"v20_new\"", row.GetChild(col20)->ToString());
+  // The merged column keeps its own write time.
+  ASSERT_EQ(3000, row.GetChild(col20)->GetWriteTime());
+
+  // Once the tombstone is below the history cutoff, the deleted column is removed from the packed
+  // row together with the tombstone.
+  FullyCompactHistoryBefore(5000_usec_ht);
+  ASSERT_EQ(1, num_entries()) << DocDBDebugDumpToStr();
+  ASSERT_NO_FATALS(read_compacted_row(&row));
+  ASSERT_EQ(nullptr, row.GetChild(col10));
+  ASSERT_EQ(nullptr, row.GetChild(col30));
+  ASSERT_NE(nullptr, row.GetChild(liveness));
+  ASSERT_EQ(2000, row.GetChild(liveness)->GetWriteTime());
+  ASSERT_EQ("\"v20_new\"", row.GetChild(col20)->ToString());
+  ASSERT_EQ(3000, row.GetChild(col20)->GetWriteTime());
+}
+
+// Columns that could not be stored in a packed row are not merged into it by compactions.
+TEST_F(DocDBTest, PackedRowNotMergedColumnsTest) {
+  const DocKey doc_key(PrimitiveValues("k1"));
+  KeyBytes encoded_doc_key(doc_key.Encode());
+  const PrimitiveValue col10 = PrimitiveValue(ColumnId(10));
+  const PrimitiveValue col20 = PrimitiveValue(ColumnId(20));
+  const PrimitiveValue col30 = PrimitiveValue(ColumnId(30));
+
+  PackedRowEncoder encoder(/* schema_version = */ 1);
+  encoder.AddColumn(col10, PrimitiveValue("v10"));
+  encoder.AddColumn(col20, PrimitiveValue("v20"));
+  ASSERT_OK(SetPrimitive(DocPath(encoded_doc_key), Value(encoder.Finish()), 1000_usec_ht));
+  ASSERT_OK(SetPrimitive(DocPath(encoded_doc_key, col10),
+                         Value(PrimitiveValue("v10_ttl"), MonoDelta::FromSeconds(1000)),
+                         2000_usec_ht));
+  ASSERT_OK(SetPrimitive(DocPath(encoded_doc_key, col20, PrimitiveValue("key")),
+                         Value(PrimitiveValue("map_value")), 3000_usec_ht));
+  ASSERT_OK(SetPrimitive(DocPath(encoded_doc_key, col30), Value(PrimitiveValue("v30")),
+                         4000_usec_ht));
+
+  FullyCompactHistoryBefore(5000_usec_ht);
+  // Only col30 is merged, the column with TTL and the map entry are kept.
+  const auto dump = DocDBDebugDumpToStr();
+  ASSERT_EQ(3, std::count(dump.begin(), dump.end(), '\n')) << dump;
+  ASSERT_STR_CONTAINS(dump, "\"v10_ttl\"");
+  ASSERT_STR_CONTAINS(dump, "\"map_value\"");
+
+  SubDocument row;
+  bool doc_found = false;
+  const auto encoded_subdoc_key = SubDocKey(doc_key).EncodeWithoutHt();
+  GetSubDocumentData data = { encoded_subdoc_key, &row, &doc_found };
+  ASSERT_OK(GetSubDocument(
+      doc_db(), data, rocksdb::kDefaultQueryId, kNonTransactionalOperationContext,
+      MonoTime::Max()));
+  ASSERT_TRUE(doc_found);
+  ASSERT_EQ("\"v10_ttl\"", row.GetChild(col10)->ToString());
+  ASSERT_EQ("\"v30\"", row.GetChild(col30)->ToString());
+  ASSERT_EQ(4000, row.GetChild(col30)->GetWriteTime());
+}
+
+TEST_F(DocDBTest, SubcompactionBoundaryTest) {
+  DocDBCompactionFilterFactory factory(
+      std::make_shared<FixedHybridTimeRetentionPolicy>(HybridTime::kMax, Value::kMaxTtl));
+  const DocKey doc_key(PrimitiveValues("k1", 10));
+  const KeyBytes encoded_doc_key = doc_key.Encode();
+  const KeyBytes column_key =
+      SubDocKey(doc_key, PrimitiveValue(ColumnId(1)), 1000_usec_ht).Encode();
+  // Boundary inside of a document is moved to the start of the document.
+  ASSERT_EQ(encoded_doc_key.AsSlice(), factory.AdjustSubcompactionBoundary(column_key.AsSlice()));
+  ASSERT_EQ(encoded_doc_key.AsSlice(),
+            factory.AdjustSubcompactionBoundary(encoded_doc_key.AsSlice()));
+}
+
+TEST_F(DocDBTest, LevelCompactionGarbageCollection) {
+  google::FlagSaver flag_saver;
+  FLAGS_rocksdb_compaction_style = "level";
+  FLAGS_rocksdb_max_subcompactions = 2;
+  ASSERT_OK(ReinitDBOptions());
+
+  const HybridTime t0 = 1000_usec_ht;
+  const HybridTime t1 = 3000_usec_ht;
+  const HybridTime t2 = 5000_usec_ht;
+  auto set_value = [this](const std::string& key, const std::string& value, HybridTime ht,
+                          MonoDelta ttl = Value::kMaxTtl) {
+    return SetPrimitive(DocPath(DocKey(PrimitiveValues(key)).Encode(), PrimitiveValue("s")),
+                        Value(PrimitiveValue(value), ttl), ht);
+  };
+
+  // Move the documents to the bottommost level, without removing anything.
+  for (const auto& key : {"a", "b", "d", "e"}) {
+    ASSERT_OK(set_value(key, std::string(key) + "0", t0));
+  }
+  ASSERT_OK(set_value("c", "c0", t0, 1ms));
+  ASSERT_OK(FlushRocksDbAndWait());
+  ASSERT_OK(FullyCompactDB(rocksdb_.get()));
+
+  // A separate file, so the following compaction is not a full one.
+  ASSERT_OK(set_value("x", "x0", t0));
+  ASSERT_OK(FlushRocksDbAndWait());
+  const KeyBytes encoded_x = DocKey(PrimitiveValues("x")).Encode();
+  const rocksdb::Slice x_slice = encoded_x.AsSlice();
+  ASSERT_OK(rocksdb_->CompactRange(rocksdb::CompactRangeOptions(), &x_slice, &x_slice));
+
+  ASSERT_OK(set_value("a", "a1", t1));
+  ASSERT_OK(DeleteSubDoc(DocPath(DocKey(PrimitiveValues("b")).Encode()), t1));
+  ASSERT_OK(set_value("e", "e1", t1));
+  ASSERT_OK(FlushRocksDbAndWait());
+
+  SetHistoryCutoffHybridTime(t2);
+  // Compaction of the new file to the bottommost level, which does not include the file of "x".
+  const KeyBytes encoded_b = DocKey(PrimitiveValues("b")).Encode();
+  const rocksdb::Slice b_slice = encoded_b.AsSlice();
+  ASSERT_OK(rocksdb_->CompactRange(rocksdb::CompactRangeOptions(), &b_slice, &b_slice));
+  SetHistoryCutoffHybridTime(HybridTime::kMin);
+
+  std::vector<rocksdb::LiveFileMetaData> files;
+  rocksdb_->GetLiveFilesMetaData(&files);
+  ASSERT_EQ(2U, files.size());
+
+  // The deleted document and the expired value are removed from the bottommost level, as by a
+  // full compaction.
+  AssertDocDbDebugDumpStrEq(
+      R"#(
+SubDocKey(DocKey([], ["a"]), ["s"; HT{ physical: 3000 }]) -> "a1"
+SubDocKey(DocKey([], ["d"]), ["s"; HT{ physical: 1000 }]) -> "d0"
+SubDocKey(DocKey([], ["e"]), ["s"; HT{ physical: 3000 }]) -> "e1"
+SubDocKey(DocKey([], ["x"]), ["s"; HT{ physical: 1000 }]) -> "x0"
+      )#");
+}
+
 TEST_F(DocDBTest, TTLCompactionTest) {
   const DocKey doc_key(PrimitiveValues("k1"));
   const MonoDelta one_ms = 1ms;
@@ -31,6 +31,7 @@
 #include "yb/docdb/docdb_util.h"
 #include "yb/docdb/intent.h"
 #include "yb/docdb/intent_aware_iterator.h"
+#include "yb/docdb/packed_row.h"
 #include "yb/docdb/shared_lock_manager.h"
 #include "yb/docdb/subdocument.h"
 #include "yb/docdb/value.h"
@@ -210,8 +211,18 @@ void PrepareNonTransactionWriteBatch(
     const KeyValueWriteBatchPB& put_batch,
     HybridTime hybrid_time,
     rocksdb::WriteBatch* rocksdb_write_batch) {
+  PrepareNonTransactionWriteBatch(
+      put_batch, 0 /* begin */, put_batch.kv_pairs_size(), hybrid_time, rocksdb_write_batch);
+}
+
+void PrepareNonTransactionWriteBatch(
+    const KeyValueWriteBatchPB& put_batch,
+    int begin,
+    int end,
+    HybridTime hybrid_time,
+    rocksdb::WriteBatch* rocksdb_write_batch) {
   DocHybridTimeBuffer doc_ht_buffer;
-  for (int write_id = 0; write_id < put_batch.kv_pairs_size(); ++write_id) {
+  for (int write_id = begin; write_id < end; ++write_id) {
     const auto& kv_pair = put_batch.kv_pairs(write_id);
     CHECK(!kv_pair.key().empty());
     CHECK(!kv_pair.value().empty());
@@ -433,6 +444,8 @@ CHECKED_STATUS BuildSubDocument(
     int64* num_values_observed) {
   VLOG(3) << "BuildSubDocument data: " << data << " read_time: " << iter->read_time()
           << " low_ts: " << low_ts;
+  // Whether the result was filled with the columns of a packed row found at this level.
+  bool packed_row_found = false;
   while (iter->valid()) {
     // Since we modify num_values_observed on recursive calls, we keep a local copy of the value.
     int64 current_values_observed = *num_values_observed;
@@ -490,6 +503,21 @@ CHECKED_STATUS BuildSubDocument(
         value_type = ValueType::kTombstone;
       }
 
+      if (value_type == ValueType::kPackedRow) {
+        // A packed row is an init marker of the row that also carries the values of its columns.
+        // Column entries written after it are applied on top of those values below.
+        if (low_ts < write_time) {
+          low_ts = write_time;
+        }
+        RETURN_NOT_OK(DecodePackedRow(
+            doc_value.primitive_value().GetPackedRow(),
+            write_time.hybrid_time().GetPhysicalValueMicros(), data.result));
+        packed_row_found = true;
+        VLOG(3) << "SeekPastSubKey: " << SubDocKey::DebugSliceToString(key);
+        iter->SeekPastSubKey(key);
+        continue;
+      }
+
       const bool is_collection = IsCollectionType(value_type);
       // We have found some key that matches our entire subdocument_key, i.e. we didn't skip ahead
       // to a lower level key (with optional object init markers).
@@ -499,6 +527,10 @@ CHECKED_STATUS BuildSubDocument(
         }
         if (is_collection) {
           *data.result = SubDocument(value_type);
+        } else {
+          // The result could be seeded with the value of a packed row column, which is deleted
+          // by this tombstone.
+          *data.result = SubDocument(ValueType::kInvalid);
         }
 
         // If the subkey lower bound filters out the key we found, we want to skip to the lower
@@ -553,6 +585,20 @@ CHECKED_STATUS BuildSubDocument(
       }
     }
     SubDocument descendant{PrimitiveValue(ValueType::kInvalid)};
+    // Column of the packed row found at this level that descendant is seeded with, so that it is
+    // only overridden by entries written after the packed row.
+    PrimitiveValue packed_column(ValueType::kInvalid);
+    if (packed_row_found) {
+      Slice temp = key;
+      temp.remove_prefix(data.subdocument_key.size());
+      PrimitiveValue child;
+      RETURN_NOT_OK(child.DecodeFromKey(&temp));
+      const SubDocument* packed_value = temp.empty() ? data.result->GetChild(child) : nullptr;
+      if (packed_value != nullptr) {
+        descendant = *packed_value;
+        packed_column = std::move(child);
+      }
+    }
     // TODO: what if the key we found is the same as before?
     //       We'll get into an infinite recursion then.
     {
@@ -564,6 +610,9 @@ CHECKED_STATUS BuildSubDocument(
     }
     if (descendant.value_type() == ValueType::kInvalid) {
       // The document was not found in this level (maybe a tombstone was encountered).
+      if (packed_column.value_type() != ValueType::kInvalid) {
+        data.result->DeleteChild(packed_column);
+      }
       continue;
     }
 
@@ -625,6 +674,23 @@ CHECKED_STATUS BuildSubDocument(
   return Status::OK();
 }
 
+// Decodes the packed row stored as doc_value of the DocKey, if it is one and has not expired.
+CHECKED_STATUS DecodeDocKeyPackedRow(
+    const Value& doc_value, const DocHybridTime& write_time, const Expiration& exp,
+    const ReadHybridTime& read_time, SubDocument* packed_row) {
+  if (doc_value.value_type() != ValueType::kPackedRow) {
+    return Status::OK();
+  }
+  bool has_expired;
+  RETURN_NOT_OK(HasExpiredTTL(exp.write_ht, exp.ttl, read_time.read, &has_expired));
+  if (has_expired) {
+    return Status::OK();
+  }
+  return DecodePackedRow(
+      doc_value.primitive_value().GetPackedRow(),
+      write_time.hybrid_time().GetPhysicalValueMicros(), packed_row);
+}
+
 }  // namespace
 
 yb::Status FindLastWriteTime(
@@ -748,7 +814,10 @@ yb::Status GetSubDocument(
   } else {
     db_iter->Seek(key_slice);
   }
-  Value doc_value;
+  Value doc_value(PrimitiveValue(ValueType::kInvalid));
+  // Columns of the row if it was written as a packed row, used as the initial values of the
+  // requested subdocuments.
+  SubDocument packed_row(ValueType::kInvalid);
   // Check ancestors for init markers, tombstones, and expiration, tracking
   // the expiration and corresponding most recent write time in exp, and the
   // the general most recent overwrite time in max_overwrite_ht
@@ -760,7 +829,13 @@ yb::Status GetSubDocument(
       if (!decode_result) {
         break;
       }
-      RETURN_NOT_OK(FindLastWriteTime(db_iter, key_slice, &max_overwrite_ht, &data.exp));
+      const bool is_doc_key = key_slice.size() == dockey_size;
+      RETURN_NOT_OK(FindLastWriteTime(db_iter, key_slice, &max_overwrite_ht, &data.exp,
+                                      is_doc_key ? &doc_value : nullptr));
+      if (is_doc_key) {
+        RETURN_NOT_OK(DecodeDocKeyPackedRow(
+            doc_value, max_overwrite_ht, data.exp, db_iter->read_time(), &packed_row));
+      }
       key_slice = Slice(key_slice.data(), temp_key.data() - key_slice.data());
     }
   }
@@ -771,6 +846,11 @@ yb::Status GetSubDocument(
   RETURN_NOT_OK(FindLastWriteTime(db_iter, key_slice, &max_overwrite_ht, &data.exp, &doc_value));
 
   const ValueType value_type = doc_value.value_type();
+  // When the whole row is requested without projection, BuildSubDocument expands the packed row.
+  if (projection != nullptr && key_slice.size() == dockey_size) {
+    RETURN_NOT_OK(DecodeDocKeyPackedRow(
+        doc_value, max_overwrite_ht, data.exp, db_iter->read_time(), &packed_row));
+  }
 
   if (data.return_type_only) {
     *data.doc_found = value_type != ValueType::kInvalid &&
@@ -791,6 +871,17 @@ yb::Status GetSubDocument(
 
   if (projection == nullptr) {
     *data.result = SubDocument(ValueType::kInvalid);
+    if (packed_row.value_type() != ValueType::kInvalid) {
+      // A column of a packed row is requested.
+      Slice subkey_slice = key_slice;
+      subkey_slice.remove_prefix(dockey_size);
+      PrimitiveValue subkey;
+      RETURN_NOT_OK(subkey.DecodeFromKey(&subkey_slice));
+      const SubDocument* packed_value = packed_row.GetChild(subkey);
+      if (subkey_slice.empty() && packed_value != nullptr) {
+        *data.result = *packed_value;
+      }
+    }
     int64 num_values_observed = 0;
     IntentAwareIteratorPrefixScope prefix_scope(key_slice, db_iter);
     RETURN_NOT_OK(BuildSubDocument(db_iter, data, max_overwrite_ht,
@@ -824,6 +915,12 @@ yb::Status GetSubDocument(
     IntentAwareIteratorPrefixScope prefix_scope(key_bytes, db_iter);
     db_iter->SeekForward(&key_bytes);
     SubDocument descendant(ValueType::kInvalid);
+    if (packed_row.value_type() != ValueType::kInvalid) {
+      const SubDocument* packed_value = packed_row.GetChild(subkey);
+      if (packed_value != nullptr) {
+        descendant = *packed_value;
+      }
+    }
     int64 num_values_observed = 0;
     RETURN_NOT_OK(BuildSubDocument(
         db_iter, data.Adjusted(key_bytes, &descendant), max_overwrite_ht,
@@ -1083,9 +1180,11 @@ CHECKED_STATUS IntentToWriteRequest(
         intent_iter->value(), transaction_id_slice, &stored_write_id, &intent_value));
 
     // Write id should match to one that were calculated during append of intents.
-    // Doing it just for sanity check.
-    DCHECK_EQ(stored_write_id, *write_id)
+    // Doing it just for sanity check. When the apply is resumed after restart, intents applied
+    // before restart could be already removed, so stored write id is used for the applied record.
+    DCHECK_GE(stored_write_id, *write_id)
       << "Value: " << intent_iter->value().ToDebugHexString();
+    *write_id = stored_write_id;
 
     // After strip of prefix and suffix intent_key contains just SubDocKey w/o a hybrid time.
     // Time will be added when writing batch to RocksDB.
@@ -1107,7 +1206,9 @@ CHECKED_STATUS IntentToWriteRequest(
 Status PrepareApplyIntentsBatch(
     const TransactionId &transaction_id, HybridTime commit_ht,
     rocksdb::WriteBatch *regular_batch,
-    rocksdb::DB *intents_db, rocksdb::WriteBatch *intents_batch) {
+    rocksdb::DB *intents_db, rocksdb::WriteBatch *intents_batch,
+    ApplyTransactionState* apply_state, size_t max_records) {
+  DCHECK(apply_state || max_records == 0);
   Slice reverse_index_upperbound;
   auto reverse_index_iter = CreateRocksDBIterator(
       intents_db, BloomFilterMode::DONT_USE_BLOOM_FILTER, boost::none, rocksdb::kDefaultQueryId,
@@ -1129,11 +1230,17 @@ Status PrepareApplyIntentsBatch(
   txn_reverse_index_upperbound.AppendValueType(ValueType::kMaxByte);
   reverse_index_upperbound = txn_reverse_index_upperbound.AsSlice();
 
-  reverse_index_iter->Seek(txn_reverse_index_prefix.data());
+  IntraTxnWriteId write_id = 0;
+  if (apply_state && apply_state->active()) {
+    reverse_index_iter->Seek(apply_state->key.AsSlice());
+    write_id = apply_state->write_id;
+  } else {
+    reverse_index_iter->Seek(txn_reverse_index_prefix.data());
+  }
 
   DocHybridTimeBuffer doc_ht_buffer;
 
-  IntraTxnWriteId write_id = 0;
+  size_t num_records = 0;
   while (reverse_index_iter->Valid()) {
     rocksdb::Slice key_slice(reverse_index_iter->key());
 
@@ -1141,6 +1248,13 @@ Status PrepareApplyIntentsBatch(
       break;
     }
 
+    if (max_records && num_records == max_records) {
+      apply_state->key.Reset(key_slice);
+      apply_state->write_id = write_id;
+      return Status::OK();
+    }
+    ++num_records;
+
     VLOG(4) << "Apply reverse index record: "
             << EntryToString(*reverse_index_iter, StorageDbType::kIntents);
 
@@ -1155,13 +1269,19 @@ Status PrepareApplyIntentsBatch(
       }
 
       intents_batch->Delete(reverse_index_iter->value());
+      intents_batch->Delete(reverse_index_iter->key());
     }
 
-    intents_batch->Delete(reverse_index_iter->key());
-
     reverse_index_iter->Next();
   }
 
+  // Transaction metadata is removed last, so a transaction applied in several batches could still
+  // be loaded until its apply is complete.
+  intents_batch->Delete(txn_reverse_index_prefix.AsSlice());
+  if (apply_state) {
+    *apply_state = ApplyTransactionState();
+  }
+
   return Status::OK();
 }
 
@@ -130,6 +130,16 @@ void PrepareNonTransactionWriteBatch(
     HybridTime hybrid_time,
     rocksdb::WriteBatch* rocksdb_write_batch);
 
+// Same as above, but adds only key value pairs with indexes in [begin, end) of put_batch. Keys are
+// the same as the ones produced for the whole batch, so parts of the batch could be written
+// separately.
+void PrepareNonTransactionWriteBatch(
+    const docdb::KeyValueWriteBatchPB& put_batch,
+    int begin,
+    int end,
+    HybridTime hybrid_time,
+    rocksdb::WriteBatch* rocksdb_write_batch);
+
 // Enumerates intents corresponding to provided key value pairs.
 // For each key it generates a strong intent and for each parent of each it generates a weak one.
 // functor should accept 3 arguments:
@@ -156,10 +166,30 @@ void PrepareTransactionWriteBatch(
     IsolationLevel isolation_level,
     IntraTxnWriteId* write_id);
 
+// Position of the transaction apply, that is split into several batches.
+struct ApplyTransactionState {
+  // Reverse index key to continue apply from. Empty when there is nothing left to apply.
+  KeyBytes key;
+  // Write id of the next applied intent.
+  IntraTxnWriteId write_id = 0;
+
+  bool active() const {
+    return !key.empty();
+  }
+};
+
+// Fills regular_batch with records of committed intents of the transaction, and intents_batch with
+// deletions of those intents. If regular_batch is null, intents are just removed.
+//
+// If apply_state is specified, starts from the position it contains (or from the beginning when it
+// is not active) and processes at most max_records reverse index records. Then apply_state is
+// updated to the position of the next batch, or reset when all intents were processed.
+// Transaction metadata is removed in the last batch.
 CHECKED_STATUS PrepareApplyIntentsBatch(
     const TransactionId& transaction_id, HybridTime commit_ht,
     rocksdb::WriteBatch* regular_batch,
-    rocksdb::DB* intents_db, rocksdb::WriteBatch* intents_batch);
+    rocksdb::DB* intents_db, rocksdb::WriteBatch* intents_batch,
+    ApplyTransactionState* apply_state = nullptr, size_t max_records = 0);
 
 // A visitor class that could be overridden to consume results of scanning SubDocuments.
 // See e.g. SubDocumentBuildingVisitor (used in implementing GetSubDocument) as example usage.
@@ -13,6 +13,8 @@
 
 #include "yb/docdb/docdb_compaction_filter.h"
 
+#include <algorithm>
+#include <map>
 #include <memory>
 
 #include <glog/logging.h>
@@ -22,7 +24,9 @@
 
 #include "yb/docdb/doc_key.h"
 #include "yb/docdb/docdb-internal.h"
+#include "yb/docdb/packed_row.h"
 #include "yb/docdb/value.h"
+#include "yb/rocksdb/db/dbformat.h"
 #include "yb/rocksutil/yb_rocksdb.h"
 
 using std::shared_ptr;
@@ -39,13 +43,17 @@ namespace docdb {
 DocDBCompactionFilter::DocDBCompactionFilter(HybridTime history_cutoff,
                                              ColumnIdsPtr deleted_cols,
                                              bool is_major_compaction,
-                                             MonoDelta table_ttl)
+                                             MonoDelta table_ttl,
+                                             KeyBounds key_bounds,
+                                             std::vector<std::string> boundary_doc_keys)
     : history_cutoff_(history_cutoff),
       is_major_compaction_(is_major_compaction),
       is_first_key_value_(true),
       filter_usage_logged_(false),
       table_ttl_(table_ttl),
-      deleted_cols_(deleted_cols) {
+      boundary_doc_keys_(std::move(boundary_doc_keys)),
+      deleted_cols_(deleted_cols),
+      key_bounds_(std::move(key_bounds)) {
 }
 
 DocDBCompactionFilter::~DocDBCompactionFilter() {
@@ -69,6 +77,10 @@ bool DocDBCompactionFilter::Filter(int level,
     return true;
   }
 
+  if (!key_bounds_.IsWithinBounds(key)) {
+    return true;
+  }
+
   SubDocKey subdoc_key;
 
   // TODO: Find a better way for handling of data corruption encountered during compactions.
@@ -89,6 +101,13 @@ bool DocDBCompactionFilter::Filter(int level,
   // SubDocKey.
   overwrite_ht_.resize(min(overwrite_ht_.size(), num_shared_components));
   expiration_.resize(min(expiration_.size(), num_shared_components));
+  if (num_shared_components == 0) {
+    doc_has_packed_row_ = false;
+    doc_at_boundary_ = std::any_of(
+        boundary_doc_keys_.begin(), boundary_doc_keys_.end(), [&key](const std::string& doc_key) {
+          return key.starts_with(doc_key);
+        });
+  }
   const DocHybridTime& ht = subdoc_key.doc_hybrid_time();
   // We're comparing the hybrid time in this key with the stack top of overwrite_ht_ after
   // truncating the stack to the number of components in the common prefix of previous and current
@@ -225,6 +244,13 @@ bool DocDBCompactionFilter::Filter(int level,
   CHECK_OK(HasExpiredTTL(true_ttl == expiration_.back().ttl ?
                          expiration_.back().write_ht : ht.hybrid_time(),
                          true_ttl, history_cutoff_, &has_expired));
+  if (new_stack_size == 1 && !has_expired && CanRemoveDeletedValues()) {
+    // Values written by transactions are prefixed with the intent hybrid time, which
+    // DecodePrimitiveValueType does not skip.
+    Value value;
+    CHECK_OK(value.Decode(existing_value));
+    doc_has_packed_row_ = value.value_type() == ValueType::kPackedRow;
+  }
   // As of 02/2017, we don't have init markers for top level documents in QL. As a result, we can
   // compact away each column if it has expired, including the liveness system column. The init
   // markers in Redis wouldn't be affected since they don't have any TTL associated with them and
@@ -232,7 +258,7 @@ bool DocDBCompactionFilter::Filter(int level,
   if (has_expired) {
     // This is consistent with the condition we're testing for deletes at the bottom of the function
     // because ht_at_or_below_cutoff is implied by has_expired.
-    if (is_major_compaction_) {
+    if (CanRemoveDeletedValues()) {
       return true;
     }
 
@@ -258,13 +284,149 @@ bool DocDBCompactionFilter::Filter(int level,
   // compactions. However, we do need to update the overwrite hybrid time stack in this case (as we
   // just did), because this deletion (tombstone) entry might be the only reason for cleaning up
   // more entries appearing at earlier hybrid times.
-  return value_type == ValueType::kTombstone && is_major_compaction_;
+  return value_type == ValueType::kTombstone && CanRemoveDeletedValues();
 }
 
 const char* DocDBCompactionFilter::Name() const {
   return "DocDBCompactionFilter";
 }
 
+rocksdb::Slice DocDBCompactionFilter::GroupPrefix(const rocksdb::Slice& user_key) const {
+  // Filter has just processed this key, so doc_has_packed_row_ gets set at the packed row, which
+  // is the first key of the document at or below the history cutoff. The keys of the document
+  // before it are above the history cutoff and are not re-packed anyway.
+  if (!doc_has_packed_row_) {
+    return rocksdb::Slice();
+  }
+  auto doc_key_size = DocKey::EncodedSize(user_key, DocKeyPart::WHOLE_DOC_KEY);
+  if (!doc_key_size.ok()) {
+    return rocksdb::Slice();
+  }
+  return rocksdb::Slice(user_key.data(), *doc_key_size);
+}
+
+void DocDBCompactionFilter::CompactGroup(
+    std::vector<rocksdb::CompactionGroupEntry>* entries) const {
+  const auto status = RepackRow(entries);
+  // The entries are left unchanged on failure, which is still a valid compaction output.
+  LOG_IF(DFATAL, !status.ok()) << "Failed to re-pack row during compaction: " << status;
+}
+
+Status DocDBCompactionFilter::RepackRow(std::vector<rocksdb::CompactionGroupEntry>* entries) const {
+  auto& packed_entry = entries->front();
+  SubDocKey packed_key;
+  RETURN_NOT_OK(packed_key.FullyDecodeFrom(rocksdb::ExtractUserKey(packed_entry.key)));
+  Value packed_value;
+  RETURN_NOT_OK(packed_value.Decode(packed_entry.value));
+  if (packed_key.num_subkeys() != 0 || packed_value.value_type() != ValueType::kPackedRow) {
+    return STATUS_FORMAT(IllegalState, "Group does not start with a packed row: $0",
+                         packed_key);
+  }
+  const PrimitiveValue packed_row = packed_value.primitive_value();
+  uint32_t schema_version = 0;
+  std::vector<PackedColumn> packed_columns;
+  RETURN_NOT_OK(DecodePackedColumns(packed_row.GetPackedRow(), &schema_version, &packed_columns));
+  // Columns are keyed by their encoded subkeys.
+  std::map<std::string, PackedColumn> columns;
+  for (const auto& column : packed_columns) {
+    columns[column.subkey.ToBuffer()] = column;
+  }
+
+  // Index of the entry at or below the history cutoff of each column, the older ones were already
+  // removed by Filter, or -1 when the column cannot be merged, because it also has other entries
+  // below its key.
+  std::map<std::string, int> column_entries;
+  std::vector<SubDocKey> subdoc_keys(entries->size());
+  for (int i = 1; i < entries->size(); ++i) {
+    const Slice user_key = rocksdb::ExtractUserKey((*entries)[i].key);
+    auto& subdoc_key = subdoc_keys[i];
+    RETURN_NOT_OK(subdoc_key.FullyDecodeFrom(user_key));
+    if (subdoc_key.num_subkeys() == 0) {
+      return STATUS_FORMAT(IllegalState, "Unexpected entry after the packed row: $0", subdoc_key);
+    }
+    const auto& first_subkey = subdoc_key.subkeys()[0];
+    if (first_subkey.value_type() != ValueType::kColumnId &&
+        first_subkey.value_type() != ValueType::kSystemColumnId) {
+      continue;
+    }
+    // The first subkey follows the encoded DocKey, that is the group prefix.
+    Slice column_subkey = user_key;
+    column_subkey.remove_prefix(VERIFY_RESULT(
+        DocKey::EncodedSize(user_key, DocKeyPart::WHOLE_DOC_KEY)));
+    const auto* subkey_start = column_subkey.data();
+    PrimitiveValue subkey;
+    RETURN_NOT_OK(subkey.DecodeFromKey(&column_subkey));
+
+    auto it = column_entries.emplace(
+        Slice(subkey_start, column_subkey.data()).ToBuffer(), i).first;
+    if (subdoc_key.num_subkeys() > 1) {
+      it->second = -1;
+    } else if (subdoc_key.doc_hybrid_time().hybrid_time() > history_cutoff_) {
+      // Newer entries are kept as they are, and override the packed value on read.
+      if (it->second == i) {
+        column_entries.erase(it);
+      }
+    } else if (it->second != i ||
+               subdoc_key.doc_hybrid_time() <= packed_key.doc_hybrid_time()) {
+      it->second = -1;
+    }
+  }
+
+  std::vector<bool> merged(entries->size());
+  // Values of the merged columns, referenced by columns.
+  std::vector<std::string> column_values;
+  column_values.reserve(column_entries.size());
+  for (const auto& column_entry : column_entries) {
+    const auto i = column_entry.second;
+    if (i < 0) {
+      continue;
+    }
+    Value value;
+    RETURN_NOT_OK(value.Decode((*entries)[i].value));
+    if (value.merge_flags() != 0 || value.has_ttl() || value.has_user_timestamp()) {
+      continue;
+    }
+    if (value.value_type() == ValueType::kTombstone) {
+      columns.erase(column_entry.first);
+    } else if (IsPrimitiveValueType(value.value_type()) &&
+               value.value_type() != ValueType::kPackedRow) {
+      column_values.push_back(value.primitive_value().ToValue());
+      columns[column_entry.first] = PackedColumn {
+          column_entry.first, column_values.back(), subdoc_keys[i].doc_hybrid_time() };
+    } else {
+      continue;
+    }
+    merged[i] = true;
+  }
+  if (std::find(merged.begin(), merged.end(), true) == merged.end()) {
+    return Status::OK();
+  }
+
+  PackedRowEncoder encoder(schema_version);
+  for (const auto& column : columns) {
+    encoder.AddEncodedColumn(column.second);
+  }
+  // Keep the prefix of the value, i.e. the intent hybrid time of a packed row written by a
+  // transaction, and replace the packed row that follows it.
+  const auto encoded_packed_row = packed_row.ToValue();
+  std::string new_value = packed_entry.value.substr(
+      0, packed_entry.value.size() - encoded_packed_row.size());
+  new_value += encoder.Finish().ToValue();
+  packed_entry.value = std::move(new_value);
+
+  size_t new_size = 0;
+  for (size_t i = 0; i != entries->size(); ++i) {
+    if (!merged[i]) {
+      if (new_size != i) {
+        (*entries)[new_size] = std::move((*entries)[i]);
+      }
+      ++new_size;
+    }
+  }
+  entries->resize(new_size);
+  return Status::OK();
+}
+
 // ------------------------------------------------------------------------------------------------
 
 DocDBCompactionFilterFactory::DocDBCompactionFilterFactory(
@@ -278,10 +440,35 @@ DocDBCompactionFilterFactory::~DocDBCompactionFilterFactory() {
 
 unique_ptr<CompactionFilter> DocDBCompactionFilterFactory::CreateCompactionFilter(
     const CompactionFilter::Context& context) {
+  // A compaction to the bottommost level sees all the older versions of the keys in its range, so
+  // it could remove deleted values like a full compaction, which is rare with level compaction
+  // (rocksdb only reports bottommost compactions for level compaction style).
+  // However, documents at the boundaries of its inputs could have other keys in files that are not
+  // compacted.
+  std::vector<std::string> boundary_doc_keys;
+  if (!context.is_full_compaction && context.is_bottommost_level) {
+    for (const auto& user_key : context.input_boundary_user_keys) {
+      boundary_doc_keys.push_back(AdjustSubcompactionBoundary(user_key).ToBuffer());
+    }
+  }
   return unique_ptr<DocDBCompactionFilter>(
       new DocDBCompactionFilter(retention_policy_->GetHistoryCutoff(),
                                 retention_policy_->GetDeletedColumns(),
-                                context.is_full_compaction, retention_policy_->GetTableTTL()));
+                                context.is_full_compaction || context.is_bottommost_level,
+                                retention_policy_->GetTableTTL(),
+                                retention_policy_->GetKeyBounds(),
+                                std::move(boundary_doc_keys)));
+}
+
+rocksdb::Slice DocDBCompactionFilterFactory::AdjustSubcompactionBoundary(
+    const rocksdb::Slice& user_key) const {
+  auto doc_key_size = DocKey::EncodedSize(user_key, DocKeyPart::WHOLE_DOC_KEY);
+  if (!doc_key_size.ok()) {
+    // Not a DocDB key, e.g. an obsolete intent, so there is no document to keep together.
+    return user_key;
+  }
+  // The encoded DocKey sorts before all the keys of the document.
+  return rocksdb::Slice(user_key.data(), *doc_key_size);
 }
 
 const char* DocDBCompactionFilterFactory::Name() const {
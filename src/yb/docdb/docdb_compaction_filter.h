@@ -16,6 +16,7 @@
 
 #include <atomic>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "yb/rocksdb/compaction_filter.h"
@@ -29,12 +30,26 @@ namespace docdb {
 
 struct Expiration;
 
+// Range of encoded DocDB keys that belong to a tablet. An empty bound means the range is not
+// limited on that side.
+struct KeyBounds {
+  std::string lower;
+  std::string upper;
+
+  bool IsWithinBounds(const Slice& key) const {
+    return (lower.empty() || key.compare(lower) >= 0) &&
+           (upper.empty() || key.compare(upper) < 0);
+  }
+};
+
 class DocDBCompactionFilter : public rocksdb::CompactionFilter {
  public:
   DocDBCompactionFilter(HybridTime history_cutoff,
                         ColumnIdsPtr deleted_cols,
                         bool is_major_compaction,
-                        MonoDelta table_ttl);
+                        MonoDelta table_ttl,
+                        KeyBounds key_bounds = KeyBounds(),
+                        std::vector<std::string> boundary_doc_keys = {});
 
   ~DocDBCompactionFilter() override;
   bool Filter(int level,
@@ -44,12 +59,28 @@ class DocDBCompactionFilter : public rocksdb::CompactionFilter {
               bool* value_changed) const override;
   const char* Name() const override;
 
+  // Documents with a packed row at or below the history cutoff are grouped, so CompactGroup could
+  // merge the column entries written after the packed row into it.
+  rocksdb::Slice GroupPrefix(const rocksdb::Slice& user_key) const override;
+  void CompactGroup(std::vector<rocksdb::CompactionGroupEntry>* entries) const override;
+
   // This indicates we don't have a cached TTL. We need this to be different from kMaxTtl
   // and kResetTtl because a PERSIST call would lead to a cached TTL of kMaxTtl, and kResetTtl
   // indicates no TTL in Cassandra.
   const MonoDelta kNoTtl = MonoDelta::FromNanoseconds(-1);
 
  private:
+  // Merges the column entries at or below the history cutoff that follow the packed row at the
+  // start of the group into the packed row, and removes them from the group. Entries of a column
+  // are only merged if the column has a single primitive value without TTL or user timestamp. The
+  // merged columns keep their write time.
+  CHECKED_STATUS RepackRow(std::vector<rocksdb::CompactionGroupEntry>* entries) const;
+
+  // Whether tombstones and expired values of the current document could be removed.
+  bool CanRemoveDeletedValues() const {
+    return is_major_compaction_ && !doc_has_packed_row_ && !doc_at_boundary_;
+  }
+
   // We will not keep history below this hybrid_time. The view of the database at this hybrid_time
   // is preserved, but after the compaction completes, we should not expect to be able to do
   // consistent scans at DocDB hybrid times lower than this. Those scans will result in missing
@@ -107,7 +138,26 @@ class DocDBCompactionFilter : public rocksdb::CompactionFilter {
   // Default TTL of table.
   MonoDelta table_ttl_;
   mutable bool within_merge_block_ = false;
+
+  // Whether the current document has a packed row at or below the history cutoff, and this
+  // compaction could remove deleted values of the document. Such document is re-packed by
+  // CompactGroup. Filter keeps the tombstones of its deleted and expired columns, so CompactGroup
+  // removes these columns from the packed row together with the tombstones, since removing only
+  // the tombstones would expose the older column values stored in the packed row.
+  mutable bool doc_has_packed_row_ = false;
+
+  // Encoded DocKeys of the documents at the boundaries of the inputs of a compaction to the
+  // bottommost level that does not include all the files. Such documents could have keys outside
+  // of the compaction, so they are compacted as by a minor compaction, since removing a tombstone
+  // could expose older keys of the document in other files.
+  const std::vector<std::string> boundary_doc_keys_;
+  mutable bool doc_at_boundary_ = false;
+
   ColumnIdsPtr deleted_cols_;
+
+  // Keys outside of these bounds do not belong to the tablet, which happens after a split, and are
+  // removed.
+  const KeyBounds key_bounds_;
 };
 
 // A strategy for deciding the history cutoff. We may implement this differently in production and
@@ -118,6 +168,7 @@ class HistoryRetentionPolicy {
   virtual HybridTime GetHistoryCutoff() = 0;
   virtual ColumnIdsPtr GetDeletedColumns() = 0;
   virtual MonoDelta GetTableTTL() = 0;
+  virtual KeyBounds GetKeyBounds() { return KeyBounds(); }
 };
 
 // A history retention policy that always returns the same hybrid_time. Useful in tests. This class
@@ -151,6 +202,11 @@ class DocDBCompactionFilterFactory : public rocksdb::CompactionFilterFactory {
   ~DocDBCompactionFilterFactory() override;
   std::unique_ptr<rocksdb::CompactionFilter> CreateCompactionFilter(
       const rocksdb::CompactionFilter::Context& context) override;
+
+  // DocDBCompactionFilter tracks overwrites and packed rows within a document, so subcompactions
+  // are split at document boundaries.
+  rocksdb::Slice AdjustSubcompactionBoundary(const rocksdb::Slice& user_key) const override;
+
   const char* Name() const override;
 
  private:
@@ -49,12 +49,33 @@ DEFINE_int32(rocksdb_universal_compaction_size_ratio, 20,
              "The percentage upto which files that are larger are include in a compaction.");
 DEFINE_int32(rocksdb_universal_compaction_min_merge_width, 4,
              "The minimum number of files in a single compaction run.");
+DEFINE_int32(rocksdb_universal_compaction_compression_size_percent, -1,
+             "Percentage of the data, starting from the oldest files, that universal compaction "
+             "keeps compressed. Outputs holding the newest data beyond that are written "
+             "uncompressed. -1 to compress every compaction output.");
 DEFINE_int64(rocksdb_compact_flush_rate_limit_bytes_per_sec, 100 * 1024 * 1024,
              "Use to control write rate of flush and compaction.");
 DEFINE_uint64(rocksdb_compaction_size_threshold_bytes, 2ULL * 1024 * 1024 * 1024,
              "Threshold beyond which compaction is considered large.");
 DEFINE_uint64(rocksdb_max_file_size_for_compaction, 0,
              "Maximal allowed file size to participate in RocksDB compaction. 0 - unlimited.");
+DEFINE_string(rocksdb_compaction_style, "universal",
+              "Compaction style of DocDB RocksDB instances: universal or level. Major universal "
+              "compactions rewrite the whole tablet at once, level compactions merge key ranges of "
+              "adjacent levels, which needs less temporary disk space at the cost of rewriting the "
+              "data more times.");
+DEFINE_int32(rocksdb_num_levels, -1,
+             "Number of levels of DocDB RocksDB instances. -1 to use 1 level for universal "
+             "compaction and 7 levels for level compaction. Universal compactions with more than "
+             "one level write major compaction outputs to the last level, which allows splitting "
+             "them into subcompactions.");
+DEFINE_int32(rocksdb_max_subcompactions, 1,
+             "Maximum number of threads a single compaction is split into, each of them compacting "
+             "its own key range. Subcompactions are split at document boundaries.");
+DEFINE_uint64(rocksdb_level_compaction_max_bytes_for_level_base, 256_MB,
+              "Size of level 1 with level compaction, each next level is 10 times larger.");
+DEFINE_uint64(rocksdb_level_compaction_target_file_size_base, 64_MB,
+              "Target size of files written by level compactions.");
 
 DEFINE_int64(db_block_size_bytes, 32_KB,
              "Size of RocksDB data block (in bytes).");
@@ -70,6 +91,13 @@ DEFINE_int64(db_min_keys_per_index_block, 100,
 
 DEFINE_int64(db_write_buffer_size, -1,
              "Size of RocksDB write buffer (in bytes). -1 to use default.");
+DEFINE_bool(rocksdb_allow_concurrent_memtable_write, false,
+            "Whether write batches that are written to the same RocksDB instance at the same time "
+            "are inserted into the memtable concurrently. Large tablet write batches are split "
+            "into parts written concurrently when this is set.");
+DEFINE_bool(rocksdb_enable_write_thread_adaptive_yield, false,
+            "Whether threads waiting for the RocksDB write group leader spin for a while before "
+            "blocking.");
 
 DEFINE_bool(use_docdb_aware_bloom_filter, true,
             "Whether to use the DocDbAwareFilterPolicy for both bloom storage and seeks.");
@@ -90,6 +118,24 @@ namespace docdb {
 
 std::shared_ptr<rocksdb::BoundaryValuesExtractor> DocBoundaryValuesExtractorInstance();
 
+namespace {
+
+rocksdb::CompressionType ToRocksDBCompressionType(TableCompressionType compression_type) {
+  switch (compression_type) {
+    case TableCompressionType::NO_COMPRESSION:
+      return rocksdb::kNoCompression;
+    case TableCompressionType::SNAPPY_COMPRESSION:
+      return rocksdb::kSnappyCompression;
+    case TableCompressionType::LZ4_COMPRESSION:
+      return rocksdb::kLZ4Compression;
+    case TableCompressionType::ZLIB_COMPRESSION:
+      return rocksdb::kZlibCompression;
+  }
+  FATAL_INVALID_ENUM_VALUE(TableCompressionType, compression_type);
+}
+
+} // namespace
+
 Status SeekToValidKvAtTs(
     rocksdb::Iterator *iter,
     const rocksdb::Slice &search_key,
@@ -370,10 +416,26 @@ unique_ptr<IntentAwareIterator> CreateIntentAwareIterator(
       doc_db, read_opts, deadline, read_time, txn_op_context);
 }
 
+int GetMaxBackgroundCompactions() {
+  if (FLAGS_rocksdb_max_background_compactions != -1) {
+    return FLAGS_rocksdb_max_background_compactions;
+  }
+  int num_cpus = std::thread::hardware_concurrency();
+  if (num_cpus <= 4) {
+    return 1;
+  } else if (num_cpus <= 8) {
+    return 2;
+  } else if (num_cpus <= 32) {
+    return 3;
+  }
+  return 4;
+}
+
 void InitRocksDBOptions(
     rocksdb::Options* options, const string& tablet_id,
     const shared_ptr<rocksdb::Statistics>& statistics,
-    const tablet::TabletOptions& tablet_options) {
+    const tablet::TabletOptions& tablet_options,
+    const TableProperties& table_properties) {
   options->create_if_missing = true;
   options->disableDataSync = true;
   options->statistics = statistics;
@@ -383,13 +445,20 @@ void InitRocksDBOptions(
   options->initial_seqno = FLAGS_initial_seqno;
   options->boundary_extractor = DocBoundaryValuesExtractorInstance();
   options->memory_monitor = tablet_options.memory_monitor;
+  options->compaction_scheduler = tablet_options.compaction_scheduler;
   if (FLAGS_db_write_buffer_size != -1) {
     options->write_buffer_size = FLAGS_db_write_buffer_size;
   }
+  options->allow_concurrent_memtable_write = FLAGS_rocksdb_allow_concurrent_memtable_write;
+  options->enable_write_thread_adaptive_yield = FLAGS_rocksdb_enable_write_thread_adaptive_yield;
   options->listeners.insert(
       options->listeners.end(), tablet_options.listeners.begin(),
       tablet_options.listeners.end()); // Append listeners
 
+  if (table_properties.HasCompressionType()) {
+    options->compression = ToRocksDBCompressionType(table_properties.compression_type());
+  }
+
   // Set block cache options.
   rocksdb::BlockBasedTableOptions table_options;
   if (tablet_options.block_cache) {
@@ -407,8 +476,11 @@ void InitRocksDBOptions(
 
   // Set our custom bloom filter that is docdb aware.
   if (FLAGS_use_docdb_aware_bloom_filter) {
+    const auto filter_key_part =
+        table_properties.bloom_filter_key_type() == BloomFilterKeyType::PRIMARY_KEY_BLOOM_FILTER
+            ? DocKeyPart::WHOLE_DOC_KEY : DocKeyPart::HASHED_PART_ONLY;
     table_options.filter_policy.reset(new DocDbAwareFilterPolicy(
-        table_options.filter_block_size * 8, options->info_log.get()));
+        table_options.filter_block_size * 8, options->info_log.get(), filter_key_part));
   }
 
   if (FLAGS_use_multi_level_index) {
@@ -421,28 +493,26 @@ void InitRocksDBOptions(
 
   // Compaction related options.
 
-  // Enable universal style compactions.
   bool compactions_enabled = !FLAGS_rocksdb_disable_compactions;
-  options->compaction_style = compactions_enabled
-    ? rocksdb::CompactionStyle::kCompactionStyleUniversal
-    : rocksdb::CompactionStyle::kCompactionStyleNone;
-  // Set the number of levels to 1.
-  options->num_levels = 1;
+  const bool level_compactions = FLAGS_rocksdb_compaction_style == "level";
+  LOG_IF(DFATAL, !level_compactions && FLAGS_rocksdb_compaction_style != "universal")
+      << "Unknown compaction style " << FLAGS_rocksdb_compaction_style << ", using universal";
+  if (!compactions_enabled) {
+    options->compaction_style = rocksdb::CompactionStyle::kCompactionStyleNone;
+  } else if (level_compactions) {
+    options->compaction_style = rocksdb::CompactionStyle::kCompactionStyleLevel;
+  } else {
+    options->compaction_style = rocksdb::CompactionStyle::kCompactionStyleUniversal;
+  }
+  if (FLAGS_rocksdb_num_levels != -1) {
+    // Level compaction needs at least one level besides level 0.
+    options->num_levels = std::max(FLAGS_rocksdb_num_levels, level_compactions ? 2 : 1);
+  } else {
+    options->num_levels = level_compactions ? 7 : 1;
+  }
 
   if (compactions_enabled) {
-    auto rocksdb_max_background_compactions = FLAGS_rocksdb_max_background_compactions;
-    if (rocksdb_max_background_compactions == -1) {
-      int num_cpus = std::thread::hardware_concurrency();
-      if (num_cpus <= 4) {
-        rocksdb_max_background_compactions = 1;
-      } else if (num_cpus <= 8) {
-        rocksdb_max_background_compactions = 2;
-      } else if (num_cpus <= 32) {
-        rocksdb_max_background_compactions = 3;
-      } else {
-        rocksdb_max_background_compactions = 4;
-      }
-    }
+    auto rocksdb_max_background_compactions = GetMaxBackgroundCompactions();
     auto rocksdb_base_background_compactions = FLAGS_rocksdb_base_background_compactions;
     if (rocksdb_base_background_compactions == -1) {
       rocksdb_base_background_compactions = rocksdb_max_background_compactions;
@@ -461,7 +531,17 @@ void InitRocksDBOptions(
         FLAGS_rocksdb_universal_compaction_size_ratio;
     options->compaction_options_universal.min_merge_width =
         FLAGS_rocksdb_universal_compaction_min_merge_width;
+    options->compaction_options_universal.compression_size_percent =
+        FLAGS_rocksdb_universal_compaction_compression_size_percent;
     options->compaction_size_threshold_bytes = FLAGS_rocksdb_compaction_size_threshold_bytes;
+    if (level_compactions) {
+      // Level targets are computed from the size of the last level, so the space amplification
+      // stays bounded while the tablet grows.
+      options->level_compaction_dynamic_level_bytes = true;
+      options->max_bytes_for_level_base = FLAGS_rocksdb_level_compaction_max_bytes_for_level_base;
+      options->target_file_size_base = FLAGS_rocksdb_level_compaction_target_file_size_base;
+    }
+    options->max_subcompactions = std::max(FLAGS_rocksdb_max_subcompactions, 1);
     if (FLAGS_rocksdb_compact_flush_rate_limit_bytes_per_sec > 0) {
       options->rate_limiter.reset(
           rocksdb::NewGenericRateLimiter(FLAGS_rocksdb_compact_flush_rate_limit_bytes_per_sec));
@@ -104,7 +104,8 @@ enum class BloomFilterMode {
 
 // It is only allowed to use bloom filters on scans within the same hashed components of the key,
 // because BloomFilterAwareIterator relies on it and ignores SST file completely if there are no
-// keys with the same hashed components as key specified for seek operation.
+// keys with the same hashed components as key specified for seek operation. For tables with
+// PRIMARY_KEY_BLOOM_FILTER the scan must also stay within the whole DocKey of that key.
 // Note: bloom_filter_mode should be specified explicitly to avoid using it incorrectly by default.
 // user_key_for_filter is used with BloomFilterMode::USE_BLOOM_FILTER to exclude SST files which
 // have the same hashed components as (Sub)DocKey encoded in user_key_for_filter.
@@ -131,11 +132,17 @@ std::unique_ptr<IntentAwareIterator> CreateIntentAwareIterator(
 
 // Initialize the RocksDB 'options' object for tablet identified by 'tablet_id'. The 'statistics'
 // object provided by the caller will be used by RocksDB to maintain the stats for the tablet
-// specified by 'tablet_id'.
+// specified by 'tablet_id'. Per-table storage settings (e.g. the bloom filter key type) are taken
+// from 'table_properties'.
 void InitRocksDBOptions(
     rocksdb::Options* options, const std::string& tablet_id,
     const std::shared_ptr<rocksdb::Statistics>& statistics,
-    const tablet::TabletOptions& tablet_options);
+    const tablet::TabletOptions& tablet_options,
+    const TableProperties& table_properties = TableProperties());
+
+// Returns the maximum number of concurrent background compactions of a tablet, either set by
+// --rocksdb_max_background_compactions or derived from the number of CPUs.
+int GetMaxBackgroundCompactions();
 
 }  // namespace docdb
 }  // namespace yb
@@ -0,0 +1,106 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/packed_row.h"
+
+#include "yb/docdb/key_bytes.h"
+
+#include "yb/util/fast_varint.h"
+
+namespace yb {
+namespace docdb {
+
+PackedRowEncoder::PackedRowEncoder(uint32_t schema_version) {
+  util::FastAppendUnsignedVarIntToStr(schema_version, &buffer_);
+}
+
+void PackedRowEncoder::AddColumn(const PrimitiveValue& subkey, const PrimitiveValue& value) {
+  DCHECK(subkey.value_type() == ValueType::kColumnId ||
+         subkey.value_type() == ValueType::kSystemColumnId) << subkey.ToString();
+  KeyBytes key_bytes;
+  subkey.AppendToKey(&key_bytes);
+  buffer_.append(key_bytes.data());
+  const std::string encoded_value = value.ToValue();
+  util::FastAppendUnsignedVarIntToStr(encoded_value.size(), &buffer_);
+  buffer_.append(encoded_value);
+}
+
+void PackedRowEncoder::AddEncodedColumn(const PackedColumn& column) {
+  buffer_.append(column.subkey.cdata(), column.subkey.size());
+  if (column.write_time.is_valid()) {
+    std::string write_time;
+    write_time.push_back(ValueTypeAsChar::kHybridTime);
+    column.write_time.AppendEncodedInDocDbFormat(&write_time);
+    util::FastAppendUnsignedVarIntToStr(write_time.size() + column.value.size(), &buffer_);
+    buffer_.append(write_time);
+  } else {
+    util::FastAppendUnsignedVarIntToStr(column.value.size(), &buffer_);
+  }
+  buffer_.append(column.value.cdata(), column.value.size());
+}
+
+PrimitiveValue PackedRowEncoder::Finish() {
+  return PrimitiveValue::PackedRow(std::move(buffer_));
+}
+
+Status DecodePackedColumns(const Slice& packed_row, uint32_t* schema_version,
+                           std::vector<PackedColumn>* columns) {
+  Slice slice = packed_row;
+  const auto version = VERIFY_RESULT(util::FastDecodeUnsignedVarInt(&slice));
+  if (schema_version) {
+    *schema_version = static_cast<uint32_t>(version);
+  }
+  columns->clear();
+  while (!slice.empty()) {
+    PackedColumn column;
+    const auto* subkey_start = slice.data();
+    PrimitiveValue subkey;
+    RETURN_NOT_OK(subkey.DecodeFromKey(&slice));
+    column.subkey = Slice(subkey_start, slice.data());
+    const auto value_size = VERIFY_RESULT(util::FastDecodeUnsignedVarInt(&slice));
+    if (value_size > slice.size()) {
+      return STATUS_FORMAT(Corruption, "Packed row value of $0 is $1 bytes, but only $2 left",
+                           subkey, value_size, slice.size());
+    }
+    column.value = Slice(slice.data(), value_size);
+    slice.remove_prefix(value_size);
+    if (DecodeValueType(column.value) == ValueType::kHybridTime) {
+      column.value.consume_byte();
+      RETURN_NOT_OK(column.write_time.DecodeFrom(&column.value));
+    }
+    columns->push_back(column);
+  }
+  return Status::OK();
+}
+
+Status DecodePackedRow(const Slice& packed_row, int64_t write_time_micros,
+                       SubDocument* result, uint32_t* schema_version) {
+  std::vector<PackedColumn> columns;
+  RETURN_NOT_OK(DecodePackedColumns(packed_row, schema_version, &columns));
+  *result = SubDocument();
+  for (const auto& column : columns) {
+    Slice subkey_slice = column.subkey;
+    PrimitiveValue subkey;
+    RETURN_NOT_OK(subkey.DecodeFromKey(&subkey_slice));
+    PrimitiveValue value;
+    RETURN_NOT_OK(value.DecodeFromValue(column.value));
+    value.SetTtl(-1);
+    value.SetWriteTime(column.write_time.is_valid()
+        ? column.write_time.hybrid_time().GetPhysicalValueMicros() : write_time_micros);
+    result->SetChildPrimitive(subkey, std::move(value));
+  }
+  return Status::OK();
+}
+
+} // namespace docdb
+} // namespace yb
@@ -0,0 +1,84 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_DOCDB_PACKED_ROW_H
+#define YB_DOCDB_PACKED_ROW_H
+
+#include <string>
+#include <vector>
+
+#include "yb/common/doc_hybrid_time.h"
+
+#include "yb/docdb/primitive_value.h"
+#include "yb/docdb/subdocument.h"
+
+#include "yb/util/slice.h"
+#include "yb/util/status.h"
+
+namespace yb {
+namespace docdb {
+
+// A packed row is the value of all the columns of a CQL or PGSQL row written by a single INSERT,
+// stored as a single kPackedRow value keyed by the DocKey of the row instead of an entry per column:
+//
+//   <schema version: unsigned varint>
+//   (<column subkey in key encoding> <value size: unsigned varint>
+//    [kHybridTime <column write time>] <value in value encoding>)*
+//
+// Column subkeys are ColumnId or SystemColumnId primitive values, columns set to null are not
+// stored. On read, a packed row acts as an init marker of the row at its write time, i.e. it hides
+// column entries written before it, while column entries written after it override the packed
+// values.
+//
+// Columns have the write time of the packed row, unless they were written after it and merged into
+// the packed row by a compaction, see DocDBCompactionFilter::CompactGroup. Such columns keep their
+// own write time, which is stored before the value.
+struct PackedColumn {
+  // ColumnId or SystemColumnId in key encoding.
+  Slice subkey;
+  // Primitive value in value encoding.
+  Slice value;
+  // Invalid if the column has the write time of the packed row.
+  DocHybridTime write_time;
+};
+
+class PackedRowEncoder {
+ public:
+  explicit PackedRowEncoder(uint32_t schema_version);
+
+  void AddColumn(const PrimitiveValue& subkey, const PrimitiveValue& value);
+
+  void AddEncodedColumn(const PackedColumn& column);
+
+  // Returns the kPackedRow value, the encoder should not be used after that.
+  PrimitiveValue Finish();
+
+ private:
+  std::string buffer_;
+};
+
+// Decodes the packed row into an object with a child per stored column. Column values get the
+// specified write time, unless they have their own, and no TTL, since rows with TTL or user
+// timestamp are never packed.
+CHECKED_STATUS DecodePackedRow(const Slice& packed_row, int64_t write_time_micros,
+                               SubDocument* result, uint32_t* schema_version = nullptr);
+
+// Splits the packed row into columns without decoding their values. The columns point into
+// packed_row.
+CHECKED_STATUS DecodePackedColumns(const Slice& packed_row, uint32_t* schema_version,
+                                   std::vector<PackedColumn>* columns);
+
+} // namespace docdb
+} // namespace yb
+
+#endif // YB_DOCDB_PACKED_ROW_H
@@ -57,6 +57,7 @@ using yb::util::DecodeDoubleFromKey;
     case ValueType::kGroupEndDescending: FALLTHROUGH_INTENDED; \
     case ValueType::kInvalid: FALLTHROUGH_INTENDED; \
     case ValueType::kJsonb: FALLTHROUGH_INTENDED; \
+    case ValueType::kPackedRow: FALLTHROUGH_INTENDED; \
     case ValueType::kObject: FALLTHROUGH_INTENDED; \
     case ValueType::kObsoleteIntentPrefix: FALLTHROUGH_INTENDED; \
     case ValueType::kRedisList: FALLTHROUGH_INTENDED;            \
@@ -175,6 +176,8 @@ string PrimitiveValue::ToString() const {
       return inetaddress_val_->ToString();
     case ValueType::kJsonb:
       return FormatBytesAsStr(json_val_);
+    case ValueType::kPackedRow:
+      return Substitute("PackedRow($0)", FormatBytesAsStr(packed_row_val_));
     case ValueType::kUuidDescending: FALLTHROUGH_INTENDED;
     case ValueType::kUuid:
       return uuid_val_.ToString();
@@ -493,6 +496,10 @@ string PrimitiveValue::ToValue() const {
       return result;
     }
 
+    case ValueType::kPackedRow:
+      result.append(packed_row_val_);
+      return result;
+
     case ValueType::kUuidDescending: FALLTHROUGH_INTENDED;
     case ValueType::kTransactionId: FALLTHROUGH_INTENDED;
     case ValueType::kUuid: {
@@ -1024,6 +1031,11 @@ Status PrimitiveValue::DecodeFromValue(const rocksdb::Slice& rocksdb_slice) {
       return Status::OK();
     }
 
+    case ValueType::kPackedRow:
+      new(&packed_row_val_) string(slice.cdata(), slice.size());
+      type_ = value_type;
+      return Status::OK();
+
     case ValueType::kInetaddress: {
       if (slice.size() != kInetAddressV4Size && slice.size() != kInetAddressV6Size) {
         return STATUS_FORMAT(Corruption,
@@ -1188,6 +1200,13 @@ PrimitiveValue PrimitiveValue::Jsonb(const std::string& json) {
   return primitive_value;
 }
 
+PrimitiveValue PrimitiveValue::PackedRow(std::string packed_row) {
+  PrimitiveValue primitive_value;
+  primitive_value.type_ = ValueType::kPackedRow;
+  new(&primitive_value.packed_row_val_) string(std::move(packed_row));
+  return primitive_value;
+}
+
 KeyBytes PrimitiveValue::ToKeyBytes() const {
   KeyBytes kb;
   AppendToKey(&kb);
@@ -1381,6 +1400,8 @@ PrimitiveValue::PrimitiveValue(ValueType value_type)
     frozen_val_ = new FrozenContainer();
   } else if (value_type == ValueType::kJsonb) {
     new(&json_val_) std::string();
+  } else if (value_type == ValueType::kPackedRow) {
+    new(&packed_row_val_) std::string();
   }
 }
 
@@ -82,6 +82,9 @@ namespace docdb {
     ((kDoubleDescending, 'L'))  /* ASCII code 76 */ \
     ((kFloatDescending, 'M')) /* ASCII code 77 */ \
     ((kUInt32, 'O'))  /* ASCII code 78 */ \
+    /* Values of all the columns of a row written as a single value at the DocKey level, see */ \
+    /* packed_row.h. */ \
+    ((kPackedRow, 'P'))  /* ASCII code 80 */ \
     ((kString, 'S'))  /* ASCII code 83 */ \
     ((kTrue, 'T'))  /* ASCII code 84 */ \
     ((kTombstone, 'X'))  /* ASCII code 88 */ \
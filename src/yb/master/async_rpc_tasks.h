@@ -385,6 +385,38 @@ class AsyncTruncate : public RetryingTSRpcTask {
   tserver::TruncateResponsePB resp_;
 };
 
+// Send a SplitTablet() RPC request to the leader replica of the tablet.
+// Keeps retrying until the leader has split the tablet into the given tablets.
+class AsyncSplitTablet : public RetryingTSRpcTask {
+ public:
+  AsyncSplitTablet(Master* master,
+                   ThreadPool* callback_pool,
+                   const scoped_refptr<TabletInfo>& tablet,
+                   std::string new_tablet1_id,
+                   std::string new_tablet2_id,
+                   std::string split_partition_key);
+
+  Type type() const override { return ASYNC_SPLIT_TABLET; }
+
+  std::string type_name() const override { return "Split Tablet"; }
+
+  std::string description() const override;
+
+ protected:
+  TabletId tablet_id() const override;
+
+  TabletServerId permanent_uuid() const;
+
+  void HandleResponse(int attempt) override;
+  bool SendRequest(int attempt) override;
+
+  scoped_refptr<TabletInfo> tablet_;
+  const std::string new_tablet1_id_;
+  const std::string new_tablet2_id_;
+  const std::string split_partition_key_;
+  tserver::SplitTabletResponsePB resp_;
+};
+
 class CommonInfoForRaftTask : public RetryingTSRpcTask {
  public:
   CommonInfoForRaftTask(
@@ -179,6 +179,10 @@ class TestLoadBalancerBase {
 
     PrepareTestState(ts_descs_multi_az);
     TestLeaderOverReplication();
+
+    // Keep last, as the reported metrics stay on the tablets.
+    PrepareTestState(ts_descs_multi_az);
+    TestBalancingByResourceUsage();
   }
 
  protected:
@@ -486,6 +490,37 @@ class TestLoadBalancerBase {
     ASSERT_EQ(0, cb_->get_total_over_replication());
   }
 
+  void TestBalancingByResourceUsage() {
+    LOG(INFO) << "Testing balancing by the resource usage reported for each tablet";
+    PlacementInfoPB* cluster_placement = replication_info_.mutable_live_replicas();
+    cluster_placement->set_num_replicas(kNumReplicas);
+
+    // Make the last tablet ten times larger than the others.
+    for (int i = 0; i < tablets_.size(); ++i) {
+      TabletMetricsPB metrics;
+      metrics.set_tablet_id(tablets_[i]->tablet_id());
+      metrics.set_total_sst_file_size(i == tablets_.size() - 1 ? 1000 : 100);
+      for (const auto& ts_desc : ts_descs_) {
+        tablets_[i]->UpdateReplicaMetrics(ts_desc->permanent_uuid(), metrics);
+      }
+    }
+
+    // Add an empty TS.
+    ts_descs_.push_back(SetupTS("3333", "a"));
+    AnalyzeTablets();
+
+    // Moving the large tablet to the empty TS evens out the load best, even though moving any
+    // tablet would even out the replica counts.
+    string expected_tablet_id = tablets_.back()->tablet_id();
+    string expected_from_ts = ts_descs_[2]->permanent_uuid();
+    string expected_to_ts = ts_descs_[3]->permanent_uuid();
+    TestAddLoad(expected_tablet_id, expected_from_ts, expected_to_ts);
+
+    // The remaining load difference is smaller than any tablet, so nothing else should move.
+    string tablet_id, from_ts, to_ts;
+    ASSERT_FALSE(ASSERT_RESULT(HandleAddReplicas(&tablet_id, &from_ts, &to_ts)));
+  }
+
   void TestWithMissingTabletServers() {
     LOG(INFO) << "Testing with missing tablet servers";
     SetupClusterConfig({"a"}, &replication_info_);
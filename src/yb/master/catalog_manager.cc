@@ -194,9 +194,20 @@ DEFINE_test_flag(bool, catalog_manager_simulate_system_table_create_failure, fal
                  "persisted in syscatalog, but the tablet information is not yet persisted and "
                  "there is a failure.");
 
+DEFINE_test_flag(bool, pause_tablet_split_completion, false,
+                 "Keep the parent tablet of a split serving after both of the tablets created by "
+                 "the split are running.");
+
 DEFINE_string(cluster_uuid, "", "Cluster UUID to be used by this cluster");
 TAG_FLAG(cluster_uuid, hidden);
 
+DEFINE_uint64(tablet_split_size_threshold_bytes, 0,
+              "Size of the SST files of a tablet leader above which the tablet is split in two "
+              "halves of its hash range. Only non-transactional YCQL tables are split. "
+              "0 disables tablet splitting.");
+TAG_FLAG(tablet_split_size_threshold_bytes, advanced);
+TAG_FLAG(tablet_split_size_threshold_bytes, runtime);
+
 DECLARE_int32(yb_num_shards_per_tserver);
 
 namespace yb {
@@ -364,8 +375,9 @@ class TabletLoader : public Visitor<PersistentTabletInfo> {
         return STATUS(Corruption, "Missing table for tablet: ", tablet_id);
       }
 
-      // Add the tablet to the Table.
-      if (!l->mutable_data()->is_deleted()) {
+      // Add the tablet to the Table. Tablets created by a split that has not completed yet are
+      // added once the split completes.
+      if (!l->mutable_data()->is_deleted() && metadata.split_parent_tablet_id().empty()) {
         table->AddTablet(tablet);
       }
     }
@@ -885,6 +897,12 @@ Status CatalogManager::VisitSysCatalog() {
 
   BuildRecursiveRolesUnlocked();
 
+  // Replicas are added to the locations as tablet servers report them.
+  tablet_locations_map_.Reset();
+  for (const auto& entry : tablet_map_) {
+    UpdateTabletLocations(entry.second);
+  }
+
   return Status::OK();
 }
 
@@ -1573,6 +1591,10 @@ Status CatalogManager::CreateCopartitionedTable(const CreateTableRequestPB req,
   for (TabletInfo *tablet : tablets) {
     tablet->mutable_metadata()->CommitMutation();
   }
+  // Copartitioned tablets are already running, so they are visible right away.
+  for (const auto& tablet : scoped_ref_tablets) {
+    UpdateTabletLocations(tablet);
+  }
 
   for (const auto& tablet : scoped_ref_tablets) {
     SendCopartitionTabletRequest(tablet, this_table_info);
@@ -2737,6 +2759,14 @@ Status CatalogManager::AlterTable(const AlterTableRequestPB* req,
   // Update the in-memory state.
   TRACE("Committing in-memory state");
   l->Commit();
+  if (req->has_new_namespace() || req->has_new_table_name()) {
+    // Readers of the locations that list them by table name have to refresh them.
+    TabletInfos tablets;
+    table->GetAllTablets(&tablets);
+    for (const auto& tablet : tablets) {
+      tablet_locations_map_.Touch(tablet->tablet_id());
+    }
+  }
 
   SendAlterTableRequest(table);
 
@@ -3133,6 +3163,23 @@ Status CatalogManager::ProcessTabletReport(TSDescriptor* ts_desc,
   }
 
   if (!report.is_incremental()) {
+    // The server sends a full report after it registers, possibly with a new address, that the
+    // locations of its tablets have to be rebuilt with.
+    TabletInfos tablets;
+    tablets.reserve(report.updated_tablets_size());
+    {
+      boost::shared_lock<LockType> l(lock_);
+      for (const ReportedTabletPB& reported : report.updated_tablets()) {
+        auto tablet = FindPtrOrNull(tablet_map_, reported.tablet_id());
+        if (tablet) {
+          tablets.push_back(std::move(tablet));
+        }
+      }
+    }
+    for (const auto& tablet : tablets) {
+      UpdateTabletLocations(tablet);
+    }
+
     if (report.updated_tablets_size() == 0) {
       LOG(INFO) << ts_desc->permanent_uuid() << " sent full tablet report with 0 tablets.";
     }
@@ -3147,6 +3194,249 @@ Status CatalogManager::ProcessTabletReport(TSDescriptor* ts_desc,
   return Status::OK();
 }
 
+void CatalogManager::ProcessTabletMetrics(
+    TSDescriptor* ts_desc, const google::protobuf::RepeatedPtrField<TabletMetricsPB>& metrics) {
+  if (metrics.empty()) {
+    return;
+  }
+
+  TabletInfos tablets;
+  tablets.reserve(metrics.size());
+  {
+    boost::shared_lock<LockType> l(lock_);
+    for (const auto& tablet_metrics : metrics) {
+      tablets.push_back(FindPtrOrNull(tablet_map_, tablet_metrics.tablet_id()));
+    }
+  }
+
+  const uint64_t split_threshold = FLAGS_tablet_split_size_threshold_bytes;
+  const auto split_retry_interval = MonoDelta::FromMilliseconds(FLAGS_tablet_creation_timeout_ms);
+  for (int i = 0; i != metrics.size(); ++i) {
+    const auto& tablet_metrics = metrics.Get(i);
+    const auto& tablet = tablets[i];
+    if (!tablet || !tablet->table()) {
+      // Unknown and orphaned tablets are taken care of while processing the tablet report.
+      continue;
+    }
+    tablet->UpdateReplicaMetrics(ts_desc->permanent_uuid(), tablet_metrics);
+
+    if (!tablet_metrics.is_leader()) {
+      continue;
+    }
+    if (split_threshold == 0 || tablet_metrics.total_sst_file_size() < split_threshold ||
+        tablet_metrics.has_parent_data()) {
+      if (tablet->SetSplitCandidate(false)) {
+        VLOG(1) << "Tablet " << tablet->ToString() << " is no longer a split candidate";
+      }
+      continue;
+    }
+
+    const bool new_candidate = tablet->SetSplitCandidate(true);
+    if (new_candidate) {
+      LOG(INFO) << "Tablet " << tablet->ToString() << " has "
+                << tablet_metrics.total_sst_file_size() << " bytes of SST files on leader "
+                << ts_desc->permanent_uuid() << ", splitting it";
+    }
+    if (!tablet->ShouldRequestSplit(split_retry_interval)) {
+      continue;
+    }
+    Status s = SplitTablet(tablet);
+    if (!s.ok()) {
+      if (new_candidate) {
+        LOG(WARNING) << "Tablet " << tablet->ToString() << " cannot be split: " << s;
+      } else {
+        VLOG(1) << "Tablet " << tablet->ToString() << " cannot be split: " << s;
+      }
+    }
+  }
+}
+
+Status CatalogManager::SplitTablet(const scoped_refptr<TabletInfo>& tablet) {
+  const auto& table = tablet->table();
+  if (IsSystemTable(*table)) {
+    return STATUS(NotSupported, "System tables are not split");
+  }
+
+  Schema schema;
+  PartitionSchema partition_schema;
+  {
+    auto table_lock = table->LockForRead();
+    const auto& table_pb = table_lock->data().pb;
+    if (!table_lock->data().is_running()) {
+      return STATUS(IllegalState, "Table is not running");
+    }
+    // Only plain YCQL tables are split: intents and index entries are not moved to the new
+    // tablets.
+    if (table_pb.table_type() != YQL_TABLE_TYPE ||
+        table_pb.schema().table_properties().is_transactional() ||
+        !table_pb.indexed_table_id().empty()) {
+      return STATUS(NotSupported, "Only non-transactional YCQL tables can be split");
+    }
+    RETURN_NOT_OK(SchemaFromPB(table_pb.schema(), &schema));
+    RETURN_NOT_OK(PartitionSchema::FromPB(table_pb.partition_schema(), schema,
+                                          &partition_schema));
+  }
+
+  auto tablet_lock = tablet->LockForWrite();
+  const auto& tablet_pb = tablet_lock->data().pb;
+  if (!tablet_lock->data().is_running()) {
+    return STATUS(IllegalState, "Tablet is not running");
+  }
+  if (tablet_pb.table_ids_size() > 1) {
+    return STATUS(NotSupported, "Copartitioned tablets are not split");
+  }
+
+  Partition partition, left, right;
+  Partition::FromPB(tablet_pb.partition(), &partition);
+  RETURN_NOT_OK(partition_schema.SplitHashPartition(partition, &left, &right));
+
+  if (tablet_pb.split_tablet_ids_size() != 0) {
+    // The split has already been started, resend the request in case the leader did not get it.
+    const TabletId new_tablet1_id = tablet_pb.split_tablet_ids(0);
+    const TabletId new_tablet2_id = tablet_pb.split_tablet_ids(1);
+    tablet_lock->Unlock();
+    SendSplitTabletRequest(tablet, new_tablet1_id, new_tablet2_id, right.partition_key_start());
+    return Status::OK();
+  }
+
+  // The new tablets get the replicas of the tablet being split, they are created by its tablet
+  // servers when the split is applied.
+  TabletInfos new_tablets;
+  vector<TabletInfo*> tablets_to_add;
+  for (const Partition* new_partition : {&left, &right}) {
+    PartitionPB partition_pb;
+    new_partition->ToPB(&partition_pb);
+    TabletInfo* new_tablet = CreateTabletInfo(table.get(), partition_pb);
+    new_tablets.emplace_back(new_tablet);
+    tablets_to_add.push_back(new_tablet);
+
+    auto* new_data = new_tablet->mutable_metadata()->mutable_dirty();
+    new_data->set_state(SysTabletsEntryPB::CREATING,
+                        Substitute("Splitting tablet $0", tablet->tablet_id()));
+    new_data->pb.set_split_parent_tablet_id(tablet->tablet_id());
+    ConsensusStatePB* cstate = new_data->pb.mutable_committed_consensus_state();
+    cstate->set_current_term(kMinimumTerm);
+    *cstate->mutable_config() = tablet_pb.committed_consensus_state().config();
+    cstate->mutable_config()->set_opid_index(consensus::kInvalidOpIdIndex);
+    tablet_lock->mutable_data()->pb.add_split_tablet_ids(new_tablet->tablet_id());
+  }
+
+  Status s = sys_catalog_->AddAndUpdateItems(tablets_to_add, {tablet.get()});
+  if (!s.ok()) {
+    for (const auto& new_tablet : new_tablets) {
+      new_tablet->mutable_metadata()->AbortMutation();
+    }
+    return s.CloneAndPrepend("An error occurred while updating sys-tablets");
+  }
+
+  tablet_lock->Commit();
+  for (const auto& new_tablet : new_tablets) {
+    new_tablet->set_last_update_time(MonoTime::Now());
+    new_tablet->mutable_metadata()->CommitMutation();
+  }
+  {
+    // The new tablets are added to their table only once both of them are running.
+    std::lock_guard<LockType> l(lock_);
+    for (const auto& new_tablet : new_tablets) {
+      InsertOrDie(&tablet_map_, new_tablet->tablet_id(), new_tablet);
+    }
+  }
+
+  LOG(INFO) << "Splitting tablet " << tablet->ToString() << " into "
+            << partition_schema.PartitionDebugString(left, schema) << " ("
+            << new_tablets[0]->tablet_id() << ") and "
+            << partition_schema.PartitionDebugString(right, schema) << " ("
+            << new_tablets[1]->tablet_id() << ")";
+  SendSplitTabletRequest(tablet, new_tablets[0]->tablet_id(), new_tablets[1]->tablet_id(),
+                         right.partition_key_start());
+  return Status::OK();
+}
+
+void CatalogManager::SendSplitTabletRequest(const scoped_refptr<TabletInfo>& tablet,
+                                            const std::string& new_tablet1_id,
+                                            const std::string& new_tablet2_id,
+                                            const std::string& split_partition_key) {
+  auto call = std::make_shared<AsyncSplitTablet>(
+      master_, worker_pool_.get(), tablet, new_tablet1_id, new_tablet2_id, split_partition_key);
+  tablet->table()->AddTask(call);
+  WARN_NOT_OK(call->Run(), Substitute("Failed to send split request for tablet $0", tablet->id()));
+}
+
+Status CatalogManager::MaybeCompleteTabletSplit(const scoped_refptr<TabletInfo>& tablet) {
+  TabletId parent_id;
+  {
+    auto tablet_lock = tablet->LockForRead();
+    if (!tablet_lock->data().is_running()) {
+      return Status::OK();
+    }
+    parent_id = tablet_lock->data().pb.split_parent_tablet_id();
+  }
+  if (parent_id.empty() || FLAGS_pause_tablet_split_completion) {
+    return Status::OK();
+  }
+
+  scoped_refptr<TabletInfo> parent;
+  TabletInfos new_tablets;
+  {
+    boost::shared_lock<LockType> l(lock_);
+    parent = FindPtrOrNull(tablet_map_, parent_id);
+    if (!parent) {
+      return STATUS_FORMAT(IllegalState, "Tablet $0 split from unknown tablet $1",
+                           tablet->tablet_id(), parent_id);
+    }
+    auto parent_lock = parent->LockForRead();
+    for (const auto& new_tablet_id : parent_lock->data().pb.split_tablet_ids()) {
+      auto new_tablet = FindPtrOrNull(tablet_map_, new_tablet_id);
+      if (!new_tablet) {
+        return STATUS_FORMAT(IllegalState, "Tablet $0 split into unknown tablet $1",
+                             parent_id, new_tablet_id);
+      }
+      new_tablets.push_back(new_tablet);
+    }
+  }
+
+  // Both the tablets created by the split report to this function, the parent lock serializes
+  // them and is always taken first.
+  auto parent_lock = parent->LockForWrite();
+  if (parent_lock->data().is_deleted()) {
+    return Status::OK();
+  }
+  vector<std::unique_ptr<TabletInfo::lock_type>> new_tablet_locks;
+  vector<TabletInfo*> tablets_to_update = { parent.get() };
+  vector<TabletInfo*> tablets_to_add_to_table;
+  for (const auto& new_tablet : new_tablets) {
+    new_tablet_locks.push_back(new_tablet->LockForWrite());
+    if (!new_tablet_locks.back()->data().is_running()) {
+      return Status::OK();
+    }
+    new_tablet_locks.back()->mutable_data()->pb.clear_split_parent_tablet_id();
+    tablets_to_update.push_back(new_tablet.get());
+    tablets_to_add_to_table.push_back(new_tablet.get());
+  }
+
+  const string msg = Substitute("Split into $0 and $1 at $2", new_tablets[0]->tablet_id(),
+                                new_tablets[1]->tablet_id(), LocalTimeAsString());
+  parent_lock->mutable_data()->set_state(SysTabletsEntryPB::DELETED, msg);
+  RETURN_NOT_OK_PREPEND(sys_catalog_->UpdateItems(tablets_to_update),
+                        "An error occurred while updating sys-tablets");
+
+  // The first new tablet starts at the same partition key and replaces the parent in the table.
+  parent->table()->AddTablets(tablets_to_add_to_table);
+  for (auto& new_tablet_lock : new_tablet_locks) {
+    new_tablet_lock->Commit();
+  }
+  parent_lock->Commit();
+  tablet_locations_map_.Remove(parent->tablet_id());
+  for (const auto& new_tablet : new_tablets) {
+    UpdateTabletLocations(new_tablet);
+  }
+
+  LOG(INFO) << "Tablet " << parent->ToString() << " has been replaced by its split tablets: "
+            << msg;
+  DeleteTabletReplicas(parent.get(), msg);
+  return Status::OK();
+}
+
 namespace {
 // Return true if receiving 'report' for a tablet in CREATING state should
 // transition it to the RUNNING state.
@@ -3257,6 +3547,9 @@ Status CatalogManager::HandleReportedTablet(TSDescriptor* ts_desc,
     return Status::OK();
   }
 
+  // Whether the report changes the tablet state, replicas or leader, i.e. its locations.
+  bool locations_changed = false;
+
   // The report will not have a committed_consensus_state if it is in the
   // middle of starting up, such as during tablet bootstrap.
   if (report.has_committed_consensus_state()) {
@@ -3297,6 +3590,7 @@ Status CatalogManager::HandleReportedTablet(TSDescriptor* ts_desc,
       VLOG(1) << "Tablet " << tablet->ToString() << " is now online";
       tablet_lock->mutable_data()->set_state(SysTabletsEntryPB::RUNNING,
                                              "Tablet reported with an active leader");
+      locations_changed = true;
     }
 
     // The Master only accepts committed consensus configurations since it needs the committed index
@@ -3360,6 +3654,11 @@ Status CatalogManager::HandleReportedTablet(TSDescriptor* ts_desc,
 
       RETURN_NOT_OK(ResetTabletReplicasFromReportedConfig(*final_report, tablet,
                                                           tablet_lock.get(), table_lock.get()));
+      // A report from a new term with the same leader and config does not change the locations.
+      if (cstate.config().opid_index() > prev_cstate.config().opid_index() ||
+          cstate.leader_uuid() != prev_cstate.leader_uuid()) {
+        locations_changed = true;
+      }
 
       // Sanity check replicas for this tablet.
       TabletInfo::ReplicaMap replica_map;
@@ -3374,7 +3673,9 @@ Status CatalogManager::HandleReportedTablet(TSDescriptor* ts_desc,
       // been added as replica, add it.
       LOG(INFO) << "Peer " << ts_desc->permanent_uuid() << " sent full tablet report for "
                 << tablet->tablet_id() << ". Consensus state: " << cstate.ShortDebugString();
-      AddReplicaToTabletIfNotFound(ts_desc, report, tablet);
+      if (AddReplicaToTabletIfNotFound(ts_desc, report, tablet)) {
+        locations_changed = true;
+      }
     }
   }
 
@@ -3388,6 +3689,12 @@ Status CatalogManager::HandleReportedTablet(TSDescriptor* ts_desc,
     return s;
   }
   tablet_lock->Commit();
+  if (locations_changed) {
+    UpdateTabletLocations(tablet);
+  }
+
+  WARN_NOT_OK(MaybeCompleteTabletSplit(tablet),
+              Substitute("Failed to complete split of tablet $0", tablet->tablet_id()));
 
   // Need to defer the AlterTable command to after we've committed the new tablet data,
   // since the tablet report may also be updating the raft config, and the Alter Table
@@ -4399,13 +4706,13 @@ Status CatalogManager::ResetTabletReplicasFromReportedConfig(
   return Status::OK();
 }
 
-void CatalogManager::AddReplicaToTabletIfNotFound(TSDescriptor* ts_desc,
+bool CatalogManager::AddReplicaToTabletIfNotFound(TSDescriptor* ts_desc,
                                                   const ReportedTabletPB& report,
                                                   const scoped_refptr<TabletInfo>& tablet) {
   TabletReplica replica;
   NewReplica(ts_desc, report, &replica);
   // Only inserts if a replica with a matching UUID was not already present.
-  ignore_result(tablet->AddToReplicaLocations(replica));
+  return tablet->AddToReplicaLocations(replica);
 }
 
 void CatalogManager::NewReplica(TSDescriptor* ts_desc,
@@ -4664,6 +4971,7 @@ void CatalogManager::DeleteTabletsAndSendRequests(const scoped_refptr<TableInfo>
     tablet_lock->mutable_data()->set_state(SysTabletsEntryPB::DELETED, deletion_msg);
     CHECK_OK(sys_catalog_->UpdateItem(tablet.get()));
     tablet_lock->Commit();
+    tablet_locations_map_.Remove(tablet->tablet_id());
   }
 }
 
@@ -4796,6 +5104,11 @@ void CatalogManager::ExtractTabletsToProcess(
       continue;
     }
 
+    // Tablets created by a split are created by the tablet servers of the split tablet.
+    if (!tablet_lock->data().pb.split_parent_tablet_id().empty()) {
+      continue;
+    }
+
     // Running tablets.
     if (tablet_lock->data().is_running()) {
       // TODO: handle last update > not responding timeout?
@@ -5445,7 +5758,7 @@ Status CatalogManager::GetTabletLocations(const TabletId& tablet_id,
     }
   }
 
-  Status s = BuildLocationsForTablet(tablet_info, locs_pb);
+  Status s = GetLocationsForTablet(tablet_info, locs_pb);
 
   int num_replicas = 0;
   if (GetReplicationFactor(&num_replicas).ok() && num_replicas > 0 &&
@@ -5480,24 +5793,32 @@ Status CatalogManager::GetTableLocations(const GetTableLocationsRequestPB* req,
     return SetupError(resp->mutable_error(), MasterErrorPB::TABLE_NOT_FOUND, s);
   }
 
-  auto l = table->LockForRead();
-  if (l->data().started_deleting()) {
-    Status s = STATUS(NotFound, "The table was deleted",
-                                l->data().pb.state_msg());
-    return SetupError(resp->mutable_error(), MasterErrorPB::TABLE_NOT_FOUND, s);
-  }
+  {
+    auto l = table->LockForRead();
+    if (l->data().started_deleting()) {
+      Status s = STATUS(NotFound, "The table was deleted",
+                                  l->data().pb.state_msg());
+      return SetupError(resp->mutable_error(), MasterErrorPB::TABLE_NOT_FOUND, s);
+    }
 
-  if (!l->data().is_running()) {
-    Status s = STATUS(ServiceUnavailable, "The table is not running");
-    return SetupError(resp->mutable_error(), MasterErrorPB::TABLE_NOT_FOUND, s);
+    if (!l->data().is_running()) {
+      Status s = STATUS(ServiceUnavailable, "The table is not running");
+      return SetupError(resp->mutable_error(), MasterErrorPB::TABLE_NOT_FOUND, s);
+    }
+
+    resp->set_table_type(l->data().pb.table_type());
   }
 
+  // Taken before the locations, so the changes made while they are collected are sent again
+  // next time.
+  TabletLocationsMap::Version version = tablet_locations_map_.version();
+
   vector<scoped_refptr<TabletInfo>> tablets_in_range;
   table->GetTabletsInRange(req, &tablets_in_range);
 
   bool require_tablets_runnings = req->require_tablets_running();
   for (const scoped_refptr<TabletInfo>& tablet : tablets_in_range) {
-    auto status = BuildLocationsForTablet(tablet, resp->add_tablet_locations());
+    auto status = GetLocationsForTablet(tablet, resp->add_tablet_locations());
     if (!status.ok()) {
       // Not running.
       if (require_tablets_runnings) {
@@ -5508,11 +5829,65 @@ Status CatalogManager::GetTableLocations(const GetTableLocationsRequestPB* req,
     }
   }
 
-  resp->set_table_type(table->metadata().state().pb.table_type());
+  if (req->has_known_locations_version()) {
+    FillTabletLocationsChanges(req->known_locations_version(), table->id(), resp, &version);
+  }
+  resp->mutable_locations_version()->set_epoch(version.epoch);
+  resp->mutable_locations_version()->set_version(version.version);
 
   return Status::OK();
 }
 
+void CatalogManager::FillTabletLocationsChanges(const TabletLocationsVersionPB& known_version,
+                                                const TableId& table_id,
+                                                GetTableLocationsResponsePB* resp,
+                                                TabletLocationsMap::Version* version) {
+  std::vector<TabletLocationsMap::Change> changes;
+  TabletLocationsMap::Version since{known_version.epoch(), known_version.version()};
+  TabletLocationsMap::Version current;
+  if (!tablet_locations_map_.GetChanges(since, table_id, &changes, &current)) {
+    resp->set_locations_changes_unavailable(true);
+    return;
+  }
+
+  unordered_set<TabletId> returned_tablets;
+  for (const auto& locations : resp->tablet_locations()) {
+    returned_tablets.insert(locations.tablet_id());
+  }
+  for (const auto& change : changes) {
+    if (returned_tablets.count(change.tablet_id)) {
+      continue;
+    }
+    if (change.locations) {
+      *resp->add_changed_tablet_locations() = *change.locations;
+    } else {
+      resp->add_removed_tablet_ids(change.tablet_id);
+    }
+  }
+  // The changes were taken after the locations, so they bring the caller to a later version.
+  *version = current;
+}
+
+void CatalogManager::UpdateTabletLocations(const scoped_refptr<TabletInfo>& tablet) {
+  // Replicas of system tablets are the masters, their locations are built on request.
+  if (tablet->IsSupportedSystemTable(sys_tables_handler_.supported_system_tables())) {
+    return;
+  }
+  tablet_locations_map_.Update(tablet->tablet_id(), [this, &tablet](TabletLocationsPB* locs_pb) {
+    return BuildLocationsForTablet(tablet, locs_pb);
+  });
+}
+
+Status CatalogManager::GetLocationsForTablet(const scoped_refptr<TabletInfo>& tablet,
+                                             TabletLocationsPB* locs_pb) {
+  auto locations = tablet_locations_map_.Find(tablet->tablet_id());
+  if (locations) {
+    *locs_pb = *locations;
+    return Status::OK();
+  }
+  return BuildLocationsForTablet(tablet, locs_pb);
+}
+
 Status CatalogManager::GetCurrentConfig(consensus::ConsensusStatePB* cpb) const {
   if (!sys_catalog_->tablet_peer() || !sys_catalog_->tablet_peer()->consensus()) {
     std::string uuid = master_->fs_manager()->uuid();
@@ -6090,6 +6465,40 @@ void TabletInfo::GetLeaderStepDownFailureTimes(MonoTime forget_failures_before,
   *dest = leader_stepdown_failure_times_;
 }
 
+void TabletInfo::UpdateReplicaMetrics(const TabletServerId& ts_uuid,
+                                      const TabletMetricsPB& metrics) {
+  std::lock_guard<simple_spinlock> l(lock_);
+  auto& replica_metrics = replica_metrics_[ts_uuid];
+  replica_metrics.is_leader = metrics.is_leader();
+  replica_metrics.total_sst_file_size = metrics.total_sst_file_size();
+  replica_metrics.read_ops_per_sec = metrics.read_ops_per_sec();
+  replica_metrics.write_ops_per_sec = metrics.write_ops_per_sec();
+}
+
+void TabletInfo::GetReplicaMetrics(TabletReplicaMetrics* dest) const {
+  std::lock_guard<simple_spinlock> l(lock_);
+  *dest = replica_metrics_;
+}
+
+bool TabletInfo::SetSplitCandidate(bool is_split_candidate) {
+  std::lock_guard<simple_spinlock> l(lock_);
+  if (is_split_candidate_ == is_split_candidate) {
+    return false;
+  }
+  is_split_candidate_ = is_split_candidate;
+  return true;
+}
+
+bool TabletInfo::ShouldRequestSplit(MonoDelta interval) {
+  const MonoTime now = MonoTime::Now();
+  std::lock_guard<simple_spinlock> l(lock_);
+  if (last_split_request_time_.Initialized() && now < last_split_request_time_ + interval) {
+    return false;
+  }
+  last_split_request_time_ = now;
+  return true;
+}
+
 void PersistentTabletInfo::set_state(SysTabletsEntryPB::State state, const string& msg) {
   pb.set_state(state);
   pb.set_state_msg(msg);
@@ -52,6 +52,7 @@
 #include "yb/master/master_defaults.h"
 #include "yb/master/master.pb.h"
 #include "yb/master/system_tables_handler.h"
+#include "yb/master/tablet_locations_map.h"
 #include "yb/master/ts_manager.h"
 #include "yb/master/yql_virtual_table.h"
 #include "yb/server/monitored_task.h"
@@ -93,6 +94,16 @@ typedef unordered_map<TabletId, TabletServerId> TabletToTabletServerMap;
 
 typedef std::unordered_map<TabletServerId, MonoTime> LeaderStepDownFailureTimes;
 
+// Resource usage of a tablet replica, as last reported by its tablet server.
+struct ReplicaMetrics {
+  bool is_leader = false;
+  uint64_t total_sst_file_size = 0;
+  double read_ops_per_sec = 0;
+  double write_ops_per_sec = 0;
+};
+
+typedef std::unordered_map<TabletServerId, ReplicaMetrics> TabletReplicaMetrics;
+
 // This class is a base wrapper around the protos that get serialized in the data column of the
 // sys_catalog. Subclasses of this will provide convenience getter/setter methods around the
 // protos and instances of these will be wrapped around CowObjects and locks for access and
@@ -257,6 +268,18 @@ class TabletInfo : public RefCountedThreadSafe<TabletInfo>,
   // failures that happened before a certain point in time.
   void GetLeaderStepDownFailureTimes(MonoTime forget_failures_before,
                                      LeaderStepDownFailureTimes* dest);
+
+  // Accessors for the latest metrics reported by the tablet servers hosting this tablet.
+  void UpdateReplicaMetrics(const TabletServerId& ts_uuid, const TabletMetricsPB& metrics);
+  void GetReplicaMetrics(TabletReplicaMetrics* dest) const;
+
+  // Sets whether this tablet is a split candidate. Returns true iff the value has changed.
+  bool SetSplitCandidate(bool is_split_candidate);
+
+  // Returns true and records the current time iff no split of this tablet has been requested
+  // within the given interval.
+  bool ShouldRequestSplit(MonoDelta interval);
+
  private:
   friend class RefCountedThreadSafe<TabletInfo>;
   ~TabletInfo();
@@ -281,6 +304,15 @@ class TabletInfo : public RefCountedThreadSafe<TabletInfo>,
 
   LeaderStepDownFailureTimes leader_stepdown_failure_times_;
 
+  // Latest metrics reported for each replica of this tablet (in-memory only).
+  TabletReplicaMetrics replica_metrics_;
+
+  // Whether this tablet has been found to exceed the split size threshold (in-memory only).
+  bool is_split_candidate_ = false;
+
+  // The last time a split of this tablet was requested (in-memory only).
+  MonoTime last_split_request_time_;
+
   DISALLOW_COPY_AND_ASSIGN(TabletInfo);
 };
 
@@ -834,6 +866,13 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
   CHECKED_STATUS GetTabletLocations(const TabletId& tablet_id,
                                     TabletLocationsPB* locs_pb);
 
+  // Locations of the running tablets, updated after changes of them are committed. Used to serve
+  // GetTableLocations and to maintain data derived from tablet locations, such as contents of
+  // system.partitions.
+  const TabletLocationsMap& tablet_locations_map() const {
+    return tablet_locations_map_;
+  }
+
   // Retrieves a SystemTablet instance based on the existing system tablets already created in our
   // syscatalog.
   CHECKED_STATUS RetrieveSystemTablet(const TabletId& tablet_id,
@@ -848,6 +887,11 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
                                      TabletReportUpdatesPB *report_update,
                                      rpc::RpcContext* rpc);
 
+  // Records the per-tablet metrics sent by the given tablet server in its heartbeat and splits
+  // the tablets it leads that have grown above --tablet_split_size_threshold_bytes.
+  void ProcessTabletMetrics(TSDescriptor* ts_desc,
+                            const google::protobuf::RepeatedPtrField<TabletMetricsPB>& metrics);
+
   // Create a new Namespace with the specified attributes.
   //
   // The RPC context is provided for logging/tracing purposes,
@@ -1269,6 +1313,22 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
   CHECKED_STATUS BuildLocationsForTablet(const scoped_refptr<TabletInfo>& tablet,
                                          TabletLocationsPB* locs_pb);
 
+  // Rebuilds the locations of the tablet in tablet_locations_map_, or removes them if the tablet
+  // is not running anymore. Must be called after committing changes of the tablet.
+  void UpdateTabletLocations(const scoped_refptr<TabletInfo>& tablet);
+
+  // Fills the locations of the tablet from tablet_locations_map_, building them if the map does
+  // not have them, e.g. for system tablets.
+  CHECKED_STATUS GetLocationsForTablet(const scoped_refptr<TabletInfo>& tablet,
+                                       TabletLocationsPB* locs_pb);
+
+  // Fills the changes of the locations of the table's tablets made after 'known_version' that are
+  // not already in the response, and moves 'version' to the version they bring the client to.
+  void FillTabletLocationsChanges(const TabletLocationsVersionPB& known_version,
+                                  const TableId& table_id,
+                                  GetTableLocationsResponsePB* resp,
+                                  TabletLocationsMap::Version* version);
+
   // Handle one of the tablets in a tablet reported.
   // Requires that the lock is already held.
   CHECKED_STATUS HandleReportedTablet(TSDescriptor* ts_desc,
@@ -1285,7 +1345,8 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
   // server that is part of a consensus configuration has not heartbeated to the Master yet, we
   // leave it out of the consensus configuration reported to clients.
   // TODO: See if we can remove this logic, as it seems confusing.
-  void AddReplicaToTabletIfNotFound(TSDescriptor* ts_desc,
+  // Returns true if the replica was added.
+  bool AddReplicaToTabletIfNotFound(TSDescriptor* ts_desc,
                                     const ReportedTabletPB& report,
                                     const scoped_refptr<TabletInfo>& tablet);
 
@@ -1372,6 +1433,21 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
   // Start the background task to send the TruncateTable() RPC to the leader for this tablet.
   void SendTruncateTabletRequest(const scoped_refptr<TabletInfo>& tablet);
 
+  // Splits the given tablet of a running table in two halves of its hash range: persists the
+  // new tablets and asks the tablet leader to split. If the split has already been started,
+  // only resends the request.
+  CHECKED_STATUS SplitTablet(const scoped_refptr<TabletInfo>& tablet);
+
+  // Start the background task to send the SplitTablet() RPC to the leader for this tablet.
+  void SendSplitTabletRequest(const scoped_refptr<TabletInfo>& tablet,
+                              const std::string& new_tablet1_id,
+                              const std::string& new_tablet2_id,
+                              const std::string& split_partition_key);
+
+  // Called after a report for a tablet created by a split. Once both tablets created by the
+  // split are running, replaces the parent tablet with them in its table and deletes the parent.
+  CHECKED_STATUS MaybeCompleteTabletSplit(const scoped_refptr<TabletInfo>& tablet);
+
   // Truncate the specified table/index.
   CHECKED_STATUS TruncateTable(const TableId& table_id,
                                bool is_index,
@@ -1579,6 +1655,9 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
   // correctly.
   int64_t leader_ready_term_;
 
+  // See tablet_locations_map().
+  TabletLocationsMap tablet_locations_map_;
+
   // Lock used to fence operations and leader elections. All logical operations
   // (i.e. create table, alter table, etc.) should acquire this lock for
   // reading. Following an election where this master is elected leader, it
@@ -14,12 +14,14 @@
 #include "yb/master/cluster_balance.h"
 
 #include <algorithm>
+#include <cmath>
 #include <memory>
 
 #include <boost/thread/locks.hpp>
 
 #include "yb/consensus/quorum_util.h"
 #include "yb/master/master.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/random_util.h"
 
 DEFINE_bool(enable_load_balancing,
@@ -60,6 +62,19 @@ DEFINE_int32(load_balancer_max_concurrent_moves,
              "Maximum number of tablet leaders on tablet servers to move in any one run of the "
              "load balancer.");
 
+DEFINE_double(load_balancer_sst_size_weight,
+              1.0,
+              "Weight of the SST file size of a tablet, relative to the average tablet of its "
+              "table, in the load of a tablet replica. 0 ignores the reported SST file sizes.");
+TAG_FLAG(load_balancer_sst_size_weight, advanced);
+
+DEFINE_double(load_balancer_ops_weight,
+              1.0,
+              "Weight of the read and write ops/sec of a tablet, relative to the average tablet of "
+              "its table, in the load of a tablet replica and of a tablet leader. 0 ignores the "
+              "reported ops/sec.");
+TAG_FLAG(load_balancer_ops_weight, advanced);
+
 DECLARE_int32(min_leader_stepdown_retry_interval_ms);
 
 namespace yb {
@@ -463,7 +478,7 @@ void ClusterLoadBalancer::DumpSortedLoad() const {
   out << "Table load: ";
   for (int left = 0; left <= last_pos; ++left) {
     const TabletServerId& uuid = state_->sorted_load_[left];
-    int load = state_->GetLoad(uuid);
+    double load = state_->GetLoad(uuid);
     out << uuid << ":" << load << " ";
   }
   VLOG(1) << out.str();
@@ -500,7 +515,7 @@ Result<bool> ClusterLoadBalancer::GetLoadToMove(
     for (int right = last_pos; right >= 0; --right) {
       const TabletServerId& low_load_uuid = state_->sorted_load_[left];
       const TabletServerId& high_load_uuid = state_->sorted_load_[right];
-      int load_variance = state_->GetLoad(high_load_uuid) - state_->GetLoad(low_load_uuid);
+      double load_variance = state_->GetLoad(high_load_uuid) - state_->GetLoad(low_load_uuid);
 
       // Check for state change or end conditions.
       if (left == right || load_variance < state_->options_->kMinLoadVarianceToBalance) {
@@ -577,6 +592,11 @@ bool ClusterLoadBalancer::GetTabletToMove(
 
   bool same_placement = state_->per_ts_meta_[from_ts].descriptor->placement_id() ==
                         state_->per_ts_meta_[to_ts].descriptor->placement_id();
+  // Moving a tablet with load L changes the load difference between the two TSs by 2 * L, so we
+  // only move tablets lighter than the difference, preferring the one closest to half of it.
+  const double load_variance = state_->GetLoad(from_ts) - state_->GetLoad(to_ts);
+  bool found = false;
+  double best_distance = 0;
   for (const auto& tablet_id : non_over_replicated_tablets) {
     const auto& placement_info = GetPlacementByTablet(tablet_id);
     // TODO(bogdan): this should be augmented as well to allow dropping by one replica, if still
@@ -594,13 +614,21 @@ bool ClusterLoadBalancer::GetTabletToMove(
       continue;
     }
     // If we got here, it means we either have no placement, in which case we can pick any TS, or
-    // we have placement and it's valid to move across these two tablet servers, so set the tablet
-    // and leave.
-    *moving_tablet_id = tablet_id;
-    return true;
+    // we have placement and it's valid to move across these two tablet servers, so the tablet is a
+    // candidate as long as moving it reduces the load difference.
+    const double tablet_load = state_->GetTabletLoad(tablet_id);
+    if (tablet_load >= load_variance) {
+      continue;
+    }
+    const double distance = std::abs(load_variance / 2 - tablet_load);
+    if (!found || distance < best_distance) {
+      *moving_tablet_id = tablet_id;
+      best_distance = distance;
+      found = true;
+    }
   }
   // If we couldn't select a tablet above, we have to return failure.
-  return false;
+  return found;
 }
 
 bool ClusterLoadBalancer::GetLeaderToMove(
@@ -637,7 +665,7 @@ bool ClusterLoadBalancer::GetLeaderToMove(
     for (int right = last_pos; right >= 0; --right) {
       const TabletServerId& low_load_uuid = state_->sorted_leader_load_[left];
       const TabletServerId& high_load_uuid = state_->sorted_leader_load_[right];
-      int load_variance =
+      double load_variance =
           state_->GetLeaderLoad(high_load_uuid) - state_->GetLeaderLoad(low_load_uuid);
 
       // Check for state change or end conditions.
@@ -659,7 +687,21 @@ bool ClusterLoadBalancer::GetLeaderToMove(
       const auto& itr = std::inserter(intersection, intersection.begin());
       std::set_intersection(leaders.begin(), leaders.end(), peers.begin(), peers.end(), itr);
 
+      // As with replicas, only move leaders lighter than the load difference, trying the ones
+      // closest to half of it first.
+      vector<TabletId> candidates;
       for (const auto& tablet_id : intersection) {
+        if (state_->GetTabletLeaderLoad(tablet_id) < load_variance) {
+          candidates.push_back(tablet_id);
+        }
+      }
+      std::stable_sort(candidates.begin(), candidates.end(),
+                       [this, load_variance](const TabletId& lhs, const TabletId& rhs) {
+        return std::abs(load_variance / 2 - state_->GetTabletLeaderLoad(lhs)) <
+               std::abs(load_variance / 2 - state_->GetTabletLeaderLoad(rhs));
+      });
+
+      for (const auto& tablet_id : candidates) {
         *moving_tablet_id = tablet_id;
         *from_ts = high_load_uuid;
         *to_ts = low_load_uuid;
@@ -16,6 +16,7 @@
 
 #include <unordered_set>
 
+#include <algorithm>
 #include <map>
 #include <memory>
 #include <set>
@@ -48,6 +49,10 @@ DECLARE_int32(load_balancer_max_concurrent_removals);
 
 DECLARE_int32(load_balancer_max_concurrent_moves);
 
+DECLARE_double(load_balancer_sst_size_weight);
+
+DECLARE_double(load_balancer_ops_weight);
+
 namespace yb {
 namespace master {
 
@@ -116,6 +121,15 @@ struct CBTabletMetadata {
   // Leader stepdown failures. We use this to prevent retrying the same leader stepdown too soon.
   LeaderStepDownFailureTimes leader_stepdown_failures;
 
+  // Whether any replica of this tablet has reported its resource usage in a heartbeat.
+  bool has_metrics = false;
+
+  // Largest SST file size reported by the replicas of this tablet.
+  uint64_t sst_file_size = 0;
+
+  // Highest rate of read and write operations reported by the replicas of this tablet.
+  double ops_per_sec = 0;
+
   std::string ToString() const {
     return Format("{ running: $0 starting: $1 is_under_replicated: $2 "
                       "under_replicated_placements: $3 is_over_replicated: $4 "
@@ -175,6 +189,11 @@ struct Options {
   // Max number of tablet leaders on tablet servers to move in any one run of the load balancer.
   int kMaxConcurrentLeaderMoves = FLAGS_load_balancer_max_concurrent_moves;
 
+  // Weights of the SST file size and the ops/sec of a tablet, relative to the table average,
+  // in the load of a tablet replica. With both set to 0, load is just the replica count.
+  double kSstSizeLoadWeight = FLAGS_load_balancer_sst_size_weight;
+  double kOpsLoadWeight = FLAGS_load_balancer_ops_weight;
+
   // TODO(bogdan): add state for leaders starting remote bootstraps, to limit on that end too.
 };
 
@@ -187,8 +206,8 @@ class ClusterLoadState {
 
   // Comparators used for sorting by load.
   bool CompareByUuid(const TabletServerId& a, const TabletServerId& b) {
-    int load_a = GetLoad(a);
-    int load_b = GetLoad(b);
+    double load_a = GetLoad(a);
+    double load_b = GetLoad(b);
     if (load_a == load_b) {
       return a < b;
     } else {
@@ -224,15 +243,73 @@ class ClusterLoadState {
     ClusterLoadState* state_;
   };
 
-  // Get the load for a certain TS.
-  int GetLoad(const TabletServerId& ts_uuid) const {
+  // Get the load for a certain TS. Each replica counts as 1 when there is no resource usage to
+  // weigh by, so an average tablet of the table always contributes a load of 1.
+  double GetLoad(const TabletServerId& ts_uuid) const {
     const auto& ts_meta = per_ts_meta_.at(ts_uuid);
-    return ts_meta.starting_tablets.size() + ts_meta.running_tablets.size();
+    if (!IsLoadWeighted()) {
+      return ts_meta.starting_tablets.size() + ts_meta.running_tablets.size();
+    }
+    double load = 0;
+    for (const auto& tablet_id : ts_meta.starting_tablets) {
+      load += GetTabletLoad(tablet_id);
+    }
+    for (const auto& tablet_id : ts_meta.running_tablets) {
+      load += GetTabletLoad(tablet_id);
+    }
+    return load;
+  }
+
+  // Get the leader load for a certain TS.
+  double GetLeaderLoad(const TabletServerId& ts_uuid) const {
+    const auto& leaders = per_ts_meta_.at(ts_uuid).leaders;
+    if (!IsLoadWeighted()) {
+      return leaders.size();
+    }
+    double load = 0;
+    for (const auto& tablet_id : leaders) {
+      load += GetTabletLeaderLoad(tablet_id);
+    }
+    return load;
+  }
+
+  // Get the load that a single replica of the tablet adds to its TS.
+  double GetTabletLoad(const TabletId& tablet_id) const {
+    const auto& tablet_meta = per_tablet_meta_.at(tablet_id);
+    if (!IsLoadWeighted() || !tablet_meta.has_metrics) {
+      return 1;
+    }
+    const double sst_size_weight = total_sst_file_size_ > 0 ? options_->kSstSizeLoadWeight : 0;
+    const double ops_weight = total_ops_per_sec_ > 0 ? options_->kOpsLoadWeight : 0;
+    double load = 1;
+    if (sst_size_weight > 0) {
+      load += sst_size_weight * tablet_meta.sst_file_size * num_tablets_with_metrics_ /
+              total_sst_file_size_;
+    }
+    if (ops_weight > 0) {
+      load += ops_weight * tablet_meta.ops_per_sec * num_tablets_with_metrics_ /
+              total_ops_per_sec_;
+    }
+    return load / (1 + sst_size_weight + ops_weight);
+  }
+
+  // Get the load that the leader of the tablet adds to its TS. Only the request rate is taken into
+  // account, as the data is present on every replica.
+  double GetTabletLeaderLoad(const TabletId& tablet_id) const {
+    const auto& tablet_meta = per_tablet_meta_.at(tablet_id);
+    if (!IsLoadWeighted() || !tablet_meta.has_metrics || total_ops_per_sec_ <= 0 ||
+        options_->kOpsLoadWeight <= 0) {
+      return 1;
+    }
+    return (1 + options_->kOpsLoadWeight * tablet_meta.ops_per_sec * num_tablets_with_metrics_ /
+                total_ops_per_sec_) / (1 + options_->kOpsLoadWeight);
   }
 
-  // Get the load for a certain TS.
-  int GetLeaderLoad(const TabletServerId& ts_uuid) const {
-    return per_ts_meta_.at(ts_uuid).leaders.size();
+  // Whether any of the tablets reported resource usage that should be weighed in the load.
+  bool IsLoadWeighted() const {
+    return num_tablets_with_metrics_ > 0 &&
+           ((options_->kSstSizeLoadWeight > 0 && total_sst_file_size_ > 0) ||
+            (options_->kOpsLoadWeight > 0 && total_ops_per_sec_ > 0));
   }
 
   void SetBlacklist(const BlacklistPB& blacklist) { blacklist_ = blacklist; }
@@ -291,6 +368,8 @@ class ClusterLoadState {
       }
     }
 
+    UpdateTabletLoad(tablet, replica_map, &tablet_meta);
+
     // Only set the over-replication section if we need to.
     int placement_num_replicas = placement.num_replicas() > 0 ?
         placement.num_replicas() : FLAGS_replication_factor;
@@ -368,6 +447,29 @@ class ClusterLoadState {
     return true;
   }
 
+  // Fill the resource usage of the tablet from the metrics reported by its current replicas.
+  void UpdateTabletLoad(TabletInfo* tablet, const TabletInfo::ReplicaMap& replica_map,
+                        CBTabletMetadata* tablet_meta) {
+    TabletReplicaMetrics replica_metrics;
+    tablet->GetReplicaMetrics(&replica_metrics);
+    for (const auto& entry : replica_metrics) {
+      if (!replica_map.count(entry.first)) {
+        continue;
+      }
+      const auto& metrics = entry.second;
+      tablet_meta->has_metrics = true;
+      tablet_meta->sst_file_size = std::max(tablet_meta->sst_file_size,
+                                            metrics.total_sst_file_size);
+      tablet_meta->ops_per_sec = std::max(tablet_meta->ops_per_sec,
+                                          metrics.read_ops_per_sec + metrics.write_ops_per_sec);
+    }
+    if (tablet_meta->has_metrics) {
+      ++num_tablets_with_metrics_;
+      total_sst_file_size_ += tablet_meta->sst_file_size;
+      total_ops_per_sec_ += tablet_meta->ops_per_sec;
+    }
+  }
+
   virtual void UpdateTabletServer(std::shared_ptr<TSDescriptor> ts_desc) {
     const auto& ts_uuid = ts_desc->permanent_uuid();
     // Set and get, so we can use this for both tablet servers we've added data to, as well as
@@ -616,6 +718,12 @@ class ClusterLoadState {
   // Total number of tablet replicas being started across the cluster.
   int total_starting_ = 0;
 
+  // Number of tablets that have reported resource usage, and the sum of that usage. Used to
+  // express the load of each tablet relative to the average tablet of the table.
+  int num_tablets_with_metrics_ = 0;
+  uint64_t total_sst_file_size_ = 0;
+  double total_ops_per_sec_ = 0;
+
   // Set of ts_uuid sorted ascending by load. This is the actual raw data of TS load.
   vector<TabletServerId> sorted_load_;
 
@@ -42,12 +42,14 @@
 #include "yb/gutil/strings/substitute.h"
 #include "yb/master/master-test-util.h"
 #include "yb/master/call_home.h"
+#include "yb/master/catalog_manager.h"
 #include "yb/master/master.h"
 #include "yb/master/master.proxy.h"
 #include "yb/master/mini_master.h"
 #include "yb/master/sys_catalog.h"
 #include "yb/master/ts_descriptor.h"
 #include "yb/master/ts_manager.h"
+#include "yb/master/yql_partitions_vtable.h"
 #include "yb/rpc/messenger.h"
 #include "yb/server/rpc_server.h"
 #include "yb/server/server_base.proxy.h"
@@ -66,6 +68,7 @@ DECLARE_string(callhome_tag);
 DECLARE_string(callhome_url);
 DECLARE_bool(catalog_manager_check_ts_count_for_create_table);
 DECLARE_double(leader_failure_max_missed_heartbeat_periods);
+DECLARE_int32(partitions_vtable_cache_max_age_ms);
 
 #define NAMESPACE_ENTRY(namespace) \
     std::make_tuple(k##namespace##NamespaceName, k##namespace##NamespaceId)
@@ -509,8 +512,18 @@ TEST_F(MasterTest, TestCatalog) {
       }, tables);
 
   // Delete the table
+  auto* catalog_manager = mini_master_->master()->catalog_manager();
   TableId id;
   ASSERT_OK(DeleteTable(default_namespace_name, kTableName, &id));
+  // Cached tablet locations, e.g. system.partitions, should not include the deleted table.
+  {
+    std::vector<TabletLocationsMap::Change> tablets;
+    TabletLocationsMap::Version version;
+    catalog_manager->tablet_locations_map().GetAll(&tablets, &version);
+    for (const auto& tablet : tablets) {
+      ASSERT_NE(id, tablet.table_id);
+    }
+  }
 
   IsDeleteTableDoneRequestPB done_req;
   done_req.set_table_id(id);
@@ -605,6 +618,164 @@ TEST_F(MasterTest, TestCatalog) {
   }
 }
 
+// Checks that system.partitions and GetTableLocations follow the changes of tablet locations.
+TEST_F(MasterTest, TestPartitionsVTableCache) {
+  FLAGS_partitions_vtable_cache_max_age_ms = 60000;
+  YQLPartitionsVTable vtable(mini_master_->master());
+  auto retrieve = [&vtable]() -> Result<std::string> {
+    std::unique_ptr<QLRowBlock> rows;
+    RETURN_NOT_OK(vtable.RetrieveData(QLReadRequestPB(), &rows));
+    return rows->ToString();
+  };
+
+  // Sends a heartbeat from a fake tablet server, registering it. If tablet_id is not empty, the
+  // heartbeat has a report of a running replica of that tablet with the specified leader.
+  const std::vector<std::string> ts_uuids = { "ts-uuid-0", "ts-uuid-1", "ts-uuid-2" };
+  auto heartbeat = [this, &ts_uuids](size_t ts_idx, const TabletId& tablet_id = TabletId(),
+                                     int64_t term = 0, size_t leader_idx = 0) {
+    TSHeartbeatRequestPB req;
+    TSHeartbeatResponsePB resp;
+    req.mutable_common()->mutable_ts_instance()->set_permanent_uuid(ts_uuids[ts_idx]);
+    req.mutable_common()->mutable_ts_instance()->set_instance_seqno(1);
+    MakeHostPortPB(Format("127.0.0.$0", ts_idx + 1), 1000,
+                   req.mutable_registration()->mutable_common()->add_private_rpc_addresses());
+    if (!tablet_id.empty()) {
+      TabletReportPB* tablet_report = req.mutable_tablet_report();
+      tablet_report->set_is_incremental(false);
+      tablet_report->set_sequence_number(0);
+      ReportedTabletPB* reported = tablet_report->add_updated_tablets();
+      reported->set_tablet_id(tablet_id);
+      reported->set_state(tablet::RUNNING);
+      consensus::ConsensusStatePB* cstate = reported->mutable_committed_consensus_state();
+      cstate->set_current_term(term);
+      cstate->set_leader_uuid(ts_uuids[leader_idx]);
+      cstate->mutable_config()->set_opid_index(1);
+      for (const auto& uuid : ts_uuids) {
+        auto* peer = cstate->mutable_config()->add_peers();
+        peer->set_permanent_uuid(uuid);
+        peer->set_member_type(consensus::RaftPeerPB::VOTER);
+      }
+    }
+    RETURN_NOT_OK(proxy_->TSHeartbeat(req, &resp, ResetAndGetController()));
+    if (resp.has_error()) {
+      return StatusFromPB(resp.error().status());
+    }
+    return Status::OK();
+  };
+  for (size_t i = 0; i != ts_uuids.size(); ++i) {
+    ASSERT_OK(heartbeat(i));
+  }
+
+  // The cache is served while the locations are unchanged.
+  const auto initial_rows = ASSERT_RESULT(retrieve());
+  ASSERT_EQ(1U, vtable.TEST_num_rebuilds());
+  ASSERT_EQ(initial_rows, ASSERT_RESULT(retrieve()));
+  ASSERT_EQ(1U, vtable.TEST_num_rebuilds());
+  ASSERT_EQ(0U, vtable.TEST_num_incremental_updates());
+
+  // Tablets of a created table are not running yet, so they are not listed.
+  const char *kTableName = "testtb";
+  const Schema kTableSchema({ ColumnSchema("key", INT32),
+                              ColumnSchema("v1", UINT64),
+                              ColumnSchema("v2", STRING) },
+                            1);
+  ASSERT_OK(CreateTable(kTableName, kTableSchema));
+  ASSERT_EQ(initial_rows, ASSERT_RESULT(retrieve()));
+  ASSERT_EQ(1U, vtable.TEST_num_rebuilds());
+
+  scoped_refptr<TableInfo> table;
+  scoped_refptr<TabletInfo> tablet;
+  {
+    std::vector<scoped_refptr<TableInfo>> tables;
+    mini_master_->master()->catalog_manager()->GetAllTables(&tables);
+    for (const auto& candidate : tables) {
+      if (candidate->name() == kTableName) {
+        std::vector<scoped_refptr<TabletInfo>> tablets;
+        candidate->GetAllTablets(&tablets);
+        ASSERT_FALSE(tablets.empty());
+        table = candidate;
+        tablet = tablets.front();
+      }
+    }
+  }
+  ASSERT_TRUE(tablet);
+  // Replicas of the tablet are assigned to the fake tablet servers in background.
+  ASSERT_OK(WaitFor([&tablet]() -> Result<bool> {
+    return tablet->LockForRead()->data().pb.state() == SysTabletsEntryPB::CREATING;
+  }, MonoDelta::FromSeconds(10), "Tablet replicas assigned"));
+
+  // The row of the tablet is added after it becomes running.
+  ASSERT_OK(heartbeat(0, tablet->tablet_id(), /* term */ 1, /* leader_idx */ 0));
+  const auto running_rows = ASSERT_RESULT(retrieve());
+  ASSERT_NE(initial_rows, running_rows);
+  ASSERT_EQ(1U, vtable.TEST_num_rebuilds());
+  ASSERT_EQ(1U, vtable.TEST_num_incremental_updates());
+
+  // The locations of the first tablet only, starting after it, so its changes are sent as such.
+  auto get_locations = [this, &table, &tablet](
+      const TabletLocationsVersionPB* known_version) -> Result<GetTableLocationsResponsePB> {
+    GetTableLocationsRequestPB req;
+    GetTableLocationsResponsePB resp;
+    req.mutable_table()->set_table_id(table->id());
+    req.set_partition_key_start(
+        tablet->LockForRead()->data().pb.partition().partition_key_end());
+    if (known_version) {
+      *req.mutable_known_locations_version() = *known_version;
+    }
+    RETURN_NOT_OK(proxy_->GetTableLocations(req, &resp, ResetAndGetController()));
+    if (resp.has_error()) {
+      return StatusFromPB(resp.error().status());
+    }
+    return resp;
+  };
+  const auto initial_locations = ASSERT_RESULT(get_locations(nullptr));
+  ASSERT_TRUE(initial_locations.has_locations_version());
+  ASSERT_EQ(0, initial_locations.changed_tablet_locations_size());
+
+  // The row of the tablet is updated after the leader changes.
+  ASSERT_OK(heartbeat(1, tablet->tablet_id(), /* term */ 2, /* leader_idx */ 1));
+  const auto new_leader_rows = ASSERT_RESULT(retrieve());
+  ASSERT_NE(running_rows, new_leader_rows);
+  ASSERT_EQ(1U, vtable.TEST_num_rebuilds());
+  ASSERT_EQ(2U, vtable.TEST_num_incremental_updates());
+
+  // The new leader is sent to the client that knows the locations before the change.
+  auto changed_locations = ASSERT_RESULT(get_locations(&initial_locations.locations_version()));
+  ASSERT_FALSE(changed_locations.locations_changes_unavailable());
+  ASSERT_EQ(1, changed_locations.changed_tablet_locations_size());
+  ASSERT_EQ(tablet->tablet_id(), changed_locations.changed_tablet_locations(0).tablet_id());
+  ASSERT_GT(changed_locations.locations_version().version(),
+            initial_locations.locations_version().version());
+  changed_locations = ASSERT_RESULT(get_locations(&changed_locations.locations_version()));
+  ASSERT_EQ(0, changed_locations.changed_tablet_locations_size());
+
+  // Changes of another epoch are not available.
+  TabletLocationsVersionPB unknown_version = initial_locations.locations_version();
+  unknown_version.set_epoch(unknown_version.epoch() + 1);
+  changed_locations = ASSERT_RESULT(get_locations(&unknown_version));
+  ASSERT_TRUE(changed_locations.locations_changes_unavailable());
+
+  // Reports that do not change the locations do not invalidate the cache.
+  ASSERT_OK(heartbeat(1, tablet->tablet_id(), /* term */ 2, /* leader_idx */ 1));
+  ASSERT_OK(heartbeat(2, tablet->tablet_id(), /* term */ 2, /* leader_idx */ 1));
+  ASSERT_EQ(new_leader_rows, ASSERT_RESULT(retrieve()));
+  ASSERT_EQ(1U, vtable.TEST_num_rebuilds());
+  ASSERT_EQ(2U, vtable.TEST_num_incremental_updates());
+
+  // The cache is rebuilt once it gets older than the max age.
+  FLAGS_partitions_vtable_cache_max_age_ms = 100;
+  SleepFor(MonoDelta::FromMilliseconds(200));
+  ASSERT_EQ(new_leader_rows, ASSERT_RESULT(retrieve()));
+  ASSERT_EQ(2U, vtable.TEST_num_rebuilds());
+
+  // The row of the tablet is removed after its table is deleted.
+  FLAGS_partitions_vtable_cache_max_age_ms = 60000;
+  ASSERT_OK(DeleteTable(default_namespace_name, kTableName));
+  ASSERT_EQ(initial_rows, ASSERT_RESULT(retrieve()));
+  ASSERT_EQ(2U, vtable.TEST_num_rebuilds());
+  ASSERT_EQ(3U, vtable.TEST_num_incremental_updates());
+}
+
 // Regression test for KUDU-253/KUDU-592: crash if the schema passed to CreateTable
 // is invalid.
 TEST_F(MasterTest, TestCreateTableInvalidSchema) {
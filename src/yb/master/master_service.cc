@@ -177,6 +177,10 @@ void MasterServiceImpl::TSHeartbeat(const TSHeartbeatRequestPB* req,
     }
   }
 
+  if (req->tablet_metrics_size() > 0) {
+    server_->catalog_manager()->ProcessTabletMetrics(ts_desc.get(), req->tablet_metrics());
+  }
+
   if (!ts_desc->has_tablet_report()) {
     resp->set_needs_full_tablet_report(true);
   }
@@ -0,0 +1,131 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <gtest/gtest.h>
+
+#include "yb/master/tablet_locations_map.h"
+
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+DECLARE_int32(tablet_locations_map_max_removed_tablets);
+
+namespace yb {
+namespace master {
+
+class TabletLocationsMapTest : public YBTest {
+ protected:
+  // Sets the locations of the tablet to a single replica on the specified tablet server.
+  void Update(const TabletId& tablet_id, const TableId& table_id, const std::string& ts_uuid) {
+    map_.Update(tablet_id, [&](TabletLocationsPB* locations) {
+      locations->set_tablet_id(tablet_id);
+      locations->set_table_id(table_id);
+      locations->add_replicas()->mutable_ts_info()->set_permanent_uuid(ts_uuid);
+      return Status::OK();
+    });
+  }
+
+  // Returns the changes since 'since' as "tablet:ts_uuid" for changed and "tablet:-" for removed
+  // tablets, in the order of their versions.
+  Result<std::string> Changes(const TabletLocationsMap::Version& since,
+                              const TableId& table_id = TableId(),
+                              TabletLocationsMap::Version* current = nullptr) {
+    std::vector<TabletLocationsMap::Change> changes;
+    TabletLocationsMap::Version version;
+    if (!map_.GetChanges(since, table_id, &changes, &version)) {
+      return STATUS(NotFound, "Changes not available");
+    }
+    if (current) {
+      *current = version;
+    }
+    std::string result;
+    for (const auto& change : changes) {
+      if (!result.empty()) {
+        result += ",";
+      }
+      result += change.tablet_id + ":" +
+                (change.locations ? change.locations->replicas(0).ts_info().permanent_uuid()
+                                  : std::string("-"));
+    }
+    return result;
+  }
+
+  TabletLocationsMap map_;
+};
+
+TEST_F(TabletLocationsMapTest, Changes) {
+  const auto initial = map_.version();
+  Update("t1", "table1", "ts1");
+  Update("t2", "table1", "ts1");
+  Update("t3", "table2", "ts1");
+  ASSERT_EQ("t1:ts1,t2:ts1,t3:ts1", ASSERT_RESULT(Changes(initial)));
+  ASSERT_EQ("t3:ts1", ASSERT_RESULT(Changes(initial, "table2")));
+
+  TabletLocationsMap::Version version;
+  ASSERT_EQ("t1:ts1,t2:ts1,t3:ts1", ASSERT_RESULT(Changes(initial, TableId(), &version)));
+  ASSERT_EQ("", ASSERT_RESULT(Changes(version)));
+
+  // Unchanged locations do not give the tablet a new version.
+  Update("t1", "table1", "ts1");
+  ASSERT_EQ("", ASSERT_RESULT(Changes(version)));
+
+  // Only the last change of a tablet is returned.
+  Update("t1", "table1", "ts2");
+  map_.Remove("t2");
+  Update("t1", "table1", "ts3");
+  ASSERT_EQ("t2:-,t1:ts3", ASSERT_RESULT(Changes(version, "table1")));
+  ASSERT_EQ("ts3", map_.Find("t1")->replicas(0).ts_info().permanent_uuid());
+  ASSERT_EQ(nullptr, map_.Find("t2"));
+
+  // A failed build removes the tablet.
+  const auto before_failure = map_.version();
+  map_.Update("t3", [](TabletLocationsPB*) { return STATUS(NotFound, "Tablet deleted"); });
+  ASSERT_EQ("t3:-", ASSERT_RESULT(Changes(before_failure)));
+
+  // Touch gives the tablet a new version without changing its locations.
+  const auto before_touch = map_.version();
+  map_.Touch("t1");
+  ASSERT_EQ("t1:ts3", ASSERT_RESULT(Changes(before_touch)));
+
+  std::vector<TabletLocationsMap::Change> tablets;
+  map_.GetAll(&tablets, &version);
+  ASSERT_EQ(1U, tablets.size());
+  ASSERT_EQ("t1", tablets[0].tablet_id);
+}
+
+TEST_F(TabletLocationsMapTest, ForgottenChanges) {
+  FLAGS_tablet_locations_map_max_removed_tablets = 1;
+  const auto initial = map_.version();
+  Update("t1", "table1", "ts1");
+  Update("t2", "table1", "ts1");
+  map_.Remove("t1");
+  ASSERT_EQ("t2:ts1,t1:-", ASSERT_RESULT(Changes(initial)));
+
+  // The removal of t1 is forgotten, so the changes since before it are not available.
+  const auto after_first_removal = map_.version();
+  map_.Remove("t2");
+  ASSERT_NOK(Changes(initial));
+  ASSERT_EQ("t2:-", ASSERT_RESULT(Changes(after_first_removal)));
+
+  // Versions of the map are not comparable after a reset.
+  Update("t3", "table1", "ts1");
+  const auto before_reset = map_.version();
+  map_.Reset();
+  ASSERT_NE(before_reset.epoch, map_.version().epoch);
+  ASSERT_NOK(Changes(before_reset));
+  ASSERT_EQ(nullptr, map_.Find("t3"));
+  ASSERT_EQ("", ASSERT_RESULT(Changes(map_.version())));
+}
+
+}  // namespace master
+}  // namespace yb
@@ -0,0 +1,176 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/master/tablet_locations_map.h"
+
+#include <algorithm>
+#include <limits>
+
+#include <boost/thread/locks.hpp>
+
+#include <gflags/gflags.h>
+
+#include "yb/util/flag_tags.h"
+#include "yb/util/random_util.h"
+
+DEFINE_int32(tablet_locations_map_max_removed_tablets, 100000,
+             "Max number of removed tablets the master remembers to send their removal to "
+             "clients that fetch the changes of tablet locations. Clients that missed forgotten "
+             "removals refresh all locations of the table instead.");
+TAG_FLAG(tablet_locations_map_max_removed_tablets, advanced);
+
+namespace yb {
+namespace master {
+
+namespace {
+
+uint64_t NewEpoch() {
+  // Zero is the epoch of a reader that has not fetched anything yet.
+  return RandomUniformInt<uint64_t>(1, std::numeric_limits<uint64_t>::max());
+}
+
+} // namespace
+
+TabletLocationsMap::TabletLocationsMap() : epoch_(NewEpoch()) {
+}
+
+void TabletLocationsMap::Reset() {
+  std::lock_guard<std::mutex> update_lock(update_mutex_);
+  std::lock_guard<rw_spinlock> lock(lock_);
+  epoch_ = NewEpoch();
+  // The version is not reset, so readers that only compare versions see the reset as a change.
+  ++version_;
+  forgotten_version_ = version_;
+  tablets_.clear();
+  changes_.clear();
+  removals_.clear();
+}
+
+void TabletLocationsMap::Update(const TabletId& tablet_id, const LocationsBuilder& builder) {
+  std::lock_guard<std::mutex> update_lock(update_mutex_);
+  auto locations = std::make_shared<TabletLocationsPB>();
+  if (!builder(locations.get()).ok()) {
+    Set(tablet_id, TableId(), nullptr);
+    return;
+  }
+  const TableId table_id = locations->table_id();
+  Set(tablet_id, table_id, std::move(locations));
+}
+
+void TabletLocationsMap::Remove(const TabletId& tablet_id) {
+  std::lock_guard<std::mutex> update_lock(update_mutex_);
+  Set(tablet_id, TableId(), nullptr);
+}
+
+void TabletLocationsMap::Touch(const TabletId& tablet_id) {
+  std::lock_guard<std::mutex> update_lock(update_mutex_);
+  std::lock_guard<rw_spinlock> lock(lock_);
+  auto it = tablets_.find(tablet_id);
+  if (it == tablets_.end() || !it->second.locations) {
+    return;
+  }
+  changes_.erase(it->second.version);
+  it->second.version = ++version_;
+  changes_.emplace(version_, tablet_id);
+}
+
+void TabletLocationsMap::Set(const TabletId& tablet_id, const TableId& table_id,
+                             std::shared_ptr<const TabletLocationsPB> locations) {
+  // Only writers modify the map and they hold update_mutex_, so it is read without lock_ here.
+  auto it = tablets_.find(tablet_id);
+  if (it == tablets_.end() || !it->second.locations) {
+    if (!locations) {
+      // Unknown or already removed.
+      return;
+    }
+  } else if (locations &&
+             locations->SerializeAsString() == it->second.locations->SerializeAsString()) {
+    // Not changed, so readers do not have to fetch it again.
+    return;
+  }
+
+  std::lock_guard<rw_spinlock> lock(lock_);
+  if (it == tablets_.end()) {
+    it = tablets_.emplace(tablet_id, Entry()).first;
+  } else {
+    changes_.erase(it->second.version);
+    removals_.erase(it->second.version);
+  }
+
+  Entry& entry = it->second;
+  entry.version = ++version_;
+  changes_.emplace(version_, tablet_id);
+  if (locations) {
+    entry.table_id = table_id;
+    entry.locations = std::move(locations);
+  } else {
+    // The table id is kept, so readers of the table get the removal.
+    entry.locations = nullptr;
+    removals_.insert(version_);
+    ForgetRemovedTabletsUnlocked();
+  }
+}
+
+void TabletLocationsMap::ForgetRemovedTabletsUnlocked() {
+  const size_t max_removed_tablets = std::max(FLAGS_tablet_locations_map_max_removed_tablets, 0);
+  while (removals_.size() > max_removed_tablets) {
+    const uint64_t version = *removals_.begin();
+    removals_.erase(removals_.begin());
+    auto it = changes_.find(version);
+    tablets_.erase(it->second);
+    changes_.erase(it);
+    forgotten_version_ = std::max(forgotten_version_, version);
+  }
+}
+
+std::shared_ptr<const TabletLocationsPB> TabletLocationsMap::Find(
+    const TabletId& tablet_id) const {
+  boost::shared_lock<rw_spinlock> lock(lock_);
+  auto it = tablets_.find(tablet_id);
+  return it != tablets_.end() ? it->second.locations : nullptr;
+}
+
+TabletLocationsMap::Version TabletLocationsMap::version() const {
+  boost::shared_lock<rw_spinlock> lock(lock_);
+  return Version{epoch_, version_};
+}
+
+bool TabletLocationsMap::GetChanges(const Version& since, const TableId& table_id,
+                                    std::vector<Change>* changes, Version* current) const {
+  boost::shared_lock<rw_spinlock> lock(lock_);
+  if (since.epoch != epoch_ || since.version < forgotten_version_ || since.version > version_) {
+    return false;
+  }
+  for (auto it = changes_.upper_bound(since.version); it != changes_.end(); ++it) {
+    const Entry& entry = tablets_.at(it->second);
+    if (table_id.empty() || entry.table_id == table_id) {
+      changes->push_back(Change{it->second, entry.table_id, entry.locations});
+    }
+  }
+  *current = Version{epoch_, version_};
+  return true;
+}
+
+void TabletLocationsMap::GetAll(std::vector<Change>* tablets, Version* current) const {
+  boost::shared_lock<rw_spinlock> lock(lock_);
+  tablets->reserve(tablets->size() + tablets_.size());
+  for (const auto& p : tablets_) {
+    if (p.second.locations) {
+      tablets->push_back(Change{p.first, p.second.table_id, p.second.locations});
+    }
+  }
+  *current = Version{epoch_, version_};
+}
+
+}  // namespace master
+}  // namespace yb
@@ -0,0 +1,130 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+#ifndef YB_MASTER_TABLET_LOCATIONS_MAP_H
+#define YB_MASTER_TABLET_LOCATIONS_MAP_H
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+#include "yb/common/entity_ids.h"
+#include "yb/master/master.pb.h"
+#include "yb/util/locks.h"
+#include "yb/util/status.h"
+
+namespace yb {
+namespace master {
+
+// Locations of the running tablets, kept up to date by the catalog manager as tablets are
+// reported, so requests for tablet locations are served without building them under catalog
+// locks.
+//
+// Every change of a tablet gives it the next version of the map. A removed tablet is remembered
+// with the version of its removal, so a reader that knows the map at some version can fetch only
+// the changes made since. The epoch of the map changes when it is reset, e.g. on master leader
+// change, and versions of different epochs are not comparable.
+class TabletLocationsMap {
+ public:
+  struct Version {
+    uint64_t epoch = 0;
+    uint64_t version = 0;
+  };
+
+  // Locations of a tablet, or its removal when 'locations' is null.
+  struct Change {
+    TabletId tablet_id;
+    TableId table_id;
+    std::shared_ptr<const TabletLocationsPB> locations;
+  };
+
+  typedef std::function<Status(TabletLocationsPB*)> LocationsBuilder;
+
+  TabletLocationsMap();
+
+  // Removes all tablets and starts a new epoch.
+  void Reset();
+
+  // Sets the locations of the tablet to the ones filled by 'builder', or removes the tablet if
+  // 'builder' fails, e.g. because the tablet is not running. Updates are serialized, so when
+  // several threads update the same tablet, the map keeps the locations built last.
+  void Update(const TabletId& tablet_id, const LocationsBuilder& builder);
+
+  void Remove(const TabletId& tablet_id);
+
+  // Gives the tablet a new version without changing its locations, for readers that combine them
+  // with other data of its table, such as the table name.
+  void Touch(const TabletId& tablet_id);
+
+  // Returns the locations of the tablet, or nullptr if it is not in the map.
+  std::shared_ptr<const TabletLocationsPB> Find(const TabletId& tablet_id) const;
+
+  Version version() const;
+
+  // Appends the changes of the tablets of table 'table_id', or of all tables if it is empty, made
+  // after version 'since' to 'changes' and sets 'current' to the version they bring the caller to.
+  // Returns false and appends nothing if those changes are not available, because 'since' is of
+  // another epoch or removals made after it were forgotten.
+  bool GetChanges(const Version& since, const TableId& table_id,
+                  std::vector<Change>* changes, Version* current) const;
+
+  // Appends all tablets in the map to 'tablets' and sets 'current' to the version of the map they
+  // were taken at.
+  void GetAll(std::vector<Change>* tablets, Version* current) const;
+
+ private:
+  struct Entry {
+    TableId table_id;
+    uint64_t version = 0;
+    // Null when the tablet was removed.
+    std::shared_ptr<const TabletLocationsPB> locations;
+  };
+
+  // Sets the locations of the tablet, or removes it if 'locations' is null. Requires
+  // update_mutex_.
+  void Set(const TabletId& tablet_id, const TableId& table_id,
+           std::shared_ptr<const TabletLocationsPB> locations);
+
+  // Forgets the oldest removed tablets, keeping at most --tablet_locations_map_max_removed_tablets.
+  void ForgetRemovedTabletsUnlocked();
+
+  // Serializes updates, so the locations are built and stored atomically.
+  std::mutex update_mutex_;
+
+  mutable rw_spinlock lock_;
+
+  uint64_t epoch_;
+
+  uint64_t version_ = 0;
+
+  // Changes made at or before this version are not available anymore.
+  uint64_t forgotten_version_ = 0;
+
+  std::unordered_map<TabletId, Entry> tablets_;
+
+  // Tablet by the version of its last change.
+  std::map<uint64_t, TabletId> changes_;
+
+  // Versions of the removals that are still remembered.
+  std::set<uint64_t> removals_;
+
+  DISALLOW_COPY_AND_ASSIGN(TabletLocationsMap);
+};
+
+}  // namespace master
+}  // namespace yb
+
+#endif // YB_MASTER_TABLET_LOCATIONS_MAP_H
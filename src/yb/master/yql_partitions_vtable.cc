@@ -13,81 +13,180 @@
 
 #include "yb/master/yql_partitions_vtable.h"
 
+#include <algorithm>
+#include <tuple>
+
 #include "yb/common/ql_value.h"
 #include "yb/common/redis_constants_common.h"
 
 #include "yb/master/catalog_manager.h"
 #include "yb/master/master_util.h"
 
+#include "yb/util/flag_tags.h"
+
+DEFINE_int32(partitions_vtable_cache_max_age_ms, 10000,
+             "Max age of the cached contents of system.partitions. The cached rows are updated "
+             "with the changes of tables, tablets or their replicas, and all of them are rebuilt "
+             "once they get older than this. 0 disables the cache.");
+TAG_FLAG(partitions_vtable_cache_max_age_ms, advanced);
+TAG_FLAG(partitions_vtable_cache_max_age_ms, runtime);
+
 namespace yb {
 namespace master {
 
 YQLPartitionsVTable::YQLPartitionsVTable(const Master* const master)
-    : YQLVirtualTable(master::kSystemPartitionsTableName, master, CreateSchema()) {
+    : YQLVirtualTable(master::kSystemPartitionsTableName, master, CreateSchema()),
+      row_schema_(std::make_shared<Schema>(schema_)) {
 }
 
 Status YQLPartitionsVTable::RetrieveData(const QLReadRequestPB& request,
                                          std::unique_ptr<QLRowBlock>* vtable) const {
-  vtable->reset(new QLRowBlock(schema_));
-  std::vector<scoped_refptr<TableInfo> > tables;
-  CatalogManager* catalog_manager = master_->catalog_manager();
-  catalog_manager->GetAllTables(&tables, true /* includeOnlyRunningTables */);
-  for (const scoped_refptr<TableInfo>& table : tables) {
-
-    // Get namespace for table.
-    NamespaceIdentifierPB nsId;
-    nsId.set_id(table->namespace_id());
-    scoped_refptr<NamespaceInfo> nsInfo;
-    RETURN_NOT_OK(catalog_manager->FindNamespace(nsId, &nsInfo));
-
-    // Hide redis table from YQL.
-    if (nsInfo->name() == common::kRedisKeyspaceName && table->name() == common::kRedisTableName) {
-      continue;
-    }
+  std::shared_ptr<const QLRowBlock> data;
+  RETURN_NOT_OK(RetrieveSharedData(request, &data));
+  // The caller could modify the result, so it gets a copy.
+  vtable->reset(new QLRowBlock(*data));
+  return Status::OK();
+}
 
-    // Get tablets for table.
-    std::vector<scoped_refptr<TabletInfo> > tablets;
-    table->GetAllTablets(&tablets);
-    for (const scoped_refptr<TabletInfo>& tablet : tablets) {
-      TabletLocationsPB tabletLocationsPB;
-      Status s = catalog_manager->GetTabletLocations(tablet->id(), &tabletLocationsPB);
-      // Skip not-found tablets: they might not be running yet or have been deleted.
-      if (!s.ok()) {
-        continue;
-      }
+Status YQLPartitionsVTable::RetrieveSharedData(const QLReadRequestPB& request,
+                                               std::shared_ptr<const QLRowBlock>* vtable) const {
+  const int max_age_ms = FLAGS_partitions_vtable_cache_max_age_ms;
+  if (max_age_ms <= 0) {
+    PartitionRows rows;
+    TabletLocationsMap::Version version;
+    RETURN_NOT_OK(BuildRows(&rows, &version));
+    auto data = std::make_shared<QLRowBlock>(schema_);
+    RETURN_NOT_OK(AssembleData(rows, data.get()));
+    *vtable = std::move(data);
+    return Status::OK();
+  }
 
-      QLRow& row = (*vtable)->Extend();
-      RETURN_NOT_OK(SetColumnValue(kKeyspaceName, nsInfo->name(), &row));
-      RETURN_NOT_OK(SetColumnValue(kTableName, table->name(), &row));
-
-      const PartitionPB& partition = tabletLocationsPB.partition();
-      RETURN_NOT_OK(SetColumnValue(kStartKey, partition.partition_key_start(), &row));
-      RETURN_NOT_OK(SetColumnValue(kEndKey, partition.partition_key_end(), &row));
-
-      // Note: tablet id is in host byte order.
-      Uuid uuid;
-      RETURN_NOT_OK(uuid.FromHexString(tablet->id()));
-      RETURN_NOT_OK(SetColumnValue(kId, uuid, &row));
-
-      // Get replicas for tablet.
-      QLValuePB replica_addresses;
-      QLMapValuePB *map_value = replica_addresses.mutable_map_value();
-      for (const auto replica : tabletLocationsPB.replicas()) {
-        InetAddress addr;
-        RETURN_NOT_OK(addr.FromString(DesiredHostPort(replica.ts_info(), CloudInfoPB()).host()));
-        QLValue elem_key;
-        elem_key.set_inetaddress_value(addr);
-        *map_value->add_keys() = elem_key.value();
-
-        const string& role = consensus::RaftPeerPB::Role_Name(replica.role());
-        QLValue elem_value;
-        elem_value.set_string_value(role);
-        *map_value->add_values() = elem_value.value();
+  const TabletLocationsMap& locations_map = master_->catalog_manager()->tablet_locations_map();
+  std::lock_guard<std::mutex> lock(mutex_);
+  const MonoTime now = MonoTime::Now();
+  if (cache_ && now <= cache_time_ + MonoDelta::FromMilliseconds(max_age_ms)) {
+    const TabletLocationsMap::Version version = locations_map.version();
+    if (version.epoch == cache_version_.epoch && version.version == cache_version_.version) {
+      *vtable = cache_;
+      return Status::OK();
+    }
+
+    std::vector<TabletLocationsMap::Change> changes;
+    TabletLocationsMap::Version changes_version;
+    if (locations_map.GetChanges(cache_version_, TableId(), &changes, &changes_version)) {
+      for (const auto& change : changes) {
+        RETURN_NOT_OK(ApplyChange(change, &rows_));
       }
-      RETURN_NOT_OK(SetColumnValue(kReplicaAddresses, replica_addresses, &row));
+      auto data = std::make_shared<QLRowBlock>(schema_);
+      RETURN_NOT_OK(AssembleData(rows_, data.get()));
+      cache_ = std::move(data);
+      cache_version_ = changes_version;
+      ++num_incremental_updates_;
+      *vtable = cache_;
+      return Status::OK();
     }
   }
 
+  PartitionRows rows;
+  TabletLocationsMap::Version version;
+  RETURN_NOT_OK(BuildRows(&rows, &version));
+  auto data = std::make_shared<QLRowBlock>(schema_);
+  RETURN_NOT_OK(AssembleData(rows, data.get()));
+  rows_ = std::move(rows);
+  cache_ = std::move(data);
+  cache_version_ = version;
+  cache_time_ = now;
+  ++num_rebuilds_;
+  *vtable = cache_;
+  return Status::OK();
+}
+
+Status YQLPartitionsVTable::BuildRows(PartitionRows* rows,
+                                      TabletLocationsMap::Version* version) const {
+  std::vector<TabletLocationsMap::Change> tablets;
+  master_->catalog_manager()->tablet_locations_map().GetAll(&tablets, version);
+  rows->reserve(tablets.size());
+  for (const auto& tablet : tablets) {
+    RETURN_NOT_OK(ApplyChange(tablet, rows));
+  }
+  return Status::OK();
+}
+
+Status YQLPartitionsVTable::ApplyChange(const TabletLocationsMap::Change& change,
+                                        PartitionRows* rows) const {
+  rows->erase(change.tablet_id);
+  if (!change.locations) {
+    return Status::OK();
+  }
+
+  CatalogManager* catalog_manager = master_->catalog_manager();
+  scoped_refptr<TableInfo> table = catalog_manager->GetTableInfo(change.table_id);
+  if (!table || !table->is_running()) {
+    return Status::OK();
+  }
+
+  // Get namespace for table.
+  NamespaceIdentifierPB nsId;
+  nsId.set_id(table->namespace_id());
+  scoped_refptr<NamespaceInfo> nsInfo;
+  RETURN_NOT_OK(catalog_manager->FindNamespace(nsId, &nsInfo));
+
+  // Hide redis table from YQL.
+  if (nsInfo->name() == common::kRedisKeyspaceName && table->name() == common::kRedisTableName) {
+    return Status::OK();
+  }
+
+  const TabletLocationsPB& tabletLocationsPB = *change.locations;
+  const PartitionPB& partition = tabletLocationsPB.partition();
+  PartitionRow partition_row{
+      nsInfo->name(), table->name(), partition.partition_key_start(), QLRow(row_schema_)};
+  QLRow& row = partition_row.row;
+  RETURN_NOT_OK(SetColumnValue(kKeyspaceName, nsInfo->name(), &row));
+  RETURN_NOT_OK(SetColumnValue(kTableName, table->name(), &row));
+  RETURN_NOT_OK(SetColumnValue(kStartKey, partition.partition_key_start(), &row));
+  RETURN_NOT_OK(SetColumnValue(kEndKey, partition.partition_key_end(), &row));
+
+  // Note: tablet id is in host byte order.
+  Uuid uuid;
+  RETURN_NOT_OK(uuid.FromHexString(change.tablet_id));
+  RETURN_NOT_OK(SetColumnValue(kId, uuid, &row));
+
+  // Get replicas for tablet.
+  QLValuePB replica_addresses;
+  QLMapValuePB *map_value = replica_addresses.mutable_map_value();
+  for (const auto replica : tabletLocationsPB.replicas()) {
+    InetAddress addr;
+    RETURN_NOT_OK(addr.FromString(DesiredHostPort(replica.ts_info(), CloudInfoPB()).host()));
+    QLValue elem_key;
+    elem_key.set_inetaddress_value(addr);
+    *map_value->add_keys() = elem_key.value();
+
+    const string& role = consensus::RaftPeerPB::Role_Name(replica.role());
+    QLValue elem_value;
+    elem_value.set_string_value(role);
+    *map_value->add_values() = elem_value.value();
+  }
+  RETURN_NOT_OK(SetColumnValue(kReplicaAddresses, replica_addresses, &row));
+
+  rows->emplace(change.tablet_id, std::move(partition_row));
+  return Status::OK();
+}
+
+Status YQLPartitionsVTable::AssembleData(const PartitionRows& rows, QLRowBlock* vtable) const {
+  std::vector<const PartitionRow*> ordered_rows;
+  ordered_rows.reserve(rows.size());
+  for (const auto& p : rows) {
+    ordered_rows.push_back(&p.second);
+  }
+  std::sort(ordered_rows.begin(), ordered_rows.end(),
+            [](const PartitionRow* lhs, const PartitionRow* rhs) {
+    return std::tie(lhs->keyspace_name, lhs->table_name, lhs->start_key) <
+           std::tie(rhs->keyspace_name, rhs->table_name, rhs->start_key);
+  });
+  vtable->rows().reserve(ordered_rows.size());
+  for (const PartitionRow* partition_row : ordered_rows) {
+    RETURN_NOT_OK(vtable->AddRow(partition_row->row));
+  }
   return Status::OK();
 }
 
@@ -14,21 +14,81 @@
 #ifndef YB_MASTER_YQL_PARTITIONS_VTABLE_H
 #define YB_MASTER_YQL_PARTITIONS_VTABLE_H
 
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
 #include "yb/master/master.h"
+#include "yb/master/tablet_locations_map.h"
 #include "yb/master/yql_virtual_table.h"
 
+#include "yb/util/monotime.h"
+
 namespace yb {
 namespace master {
 
 // VTable implementation of system.partitions.
+//
+// Drivers query this table to refresh their topology, so its rows are cached and shared between
+// queries. The rows are kept per tablet and updated from the changes of the catalog manager's
+// tablet locations map, and all of them are rebuilt when the changes are not available or the
+// cache gets older than --partitions_vtable_cache_max_age_ms.
 class YQLPartitionsVTable : public YQLVirtualTable {
  public:
   explicit YQLPartitionsVTable(const Master* const master);
   CHECKED_STATUS RetrieveData(const QLReadRequestPB& request,
                               std::unique_ptr<QLRowBlock>* vtable) const;
+
+  CHECKED_STATUS RetrieveSharedData(const QLReadRequestPB& request,
+                                    std::shared_ptr<const QLRowBlock>* vtable) const override;
+
+  // Number of times all the cached rows were built.
+  uint64_t TEST_num_rebuilds() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return num_rebuilds_;
+  }
+
+  // Number of times the cached rows were updated with the changes of tablet locations.
+  uint64_t TEST_num_incremental_updates() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return num_incremental_updates_;
+  }
+
  protected:
   Schema CreateSchema() const;
  private:
+  // Row of a tablet with the columns it is ordered by.
+  struct PartitionRow {
+    std::string keyspace_name;
+    std::string table_name;
+    std::string start_key;
+    QLRow row;
+  };
+
+  typedef std::unordered_map<TabletId, PartitionRow> PartitionRows;
+
+  // Builds the rows of all tablets in the locations map.
+  CHECKED_STATUS BuildRows(PartitionRows* rows, TabletLocationsMap::Version* version) const;
+
+  // Sets the row of the changed tablet, or erases it if the tablet is removed or its table is not
+  // running.
+  CHECKED_STATUS ApplyChange(const TabletLocationsMap::Change& change, PartitionRows* rows) const;
+
+  // Fills 'vtable' with the rows, ordered by keyspace, table and start key.
+  CHECKED_STATUS AssembleData(const PartitionRows& rows, QLRowBlock* vtable) const;
+
+  // Schema of the rows.
+  const std::shared_ptr<const Schema> row_schema_;
+
+  // Serializes updates of the cache, so concurrent queries do not update it at the same time.
+  mutable std::mutex mutex_;
+  mutable PartitionRows rows_;
+  mutable std::shared_ptr<const QLRowBlock> cache_;
+  mutable TabletLocationsMap::Version cache_version_;
+  mutable MonoTime cache_time_;
+  mutable uint64_t num_rebuilds_ = 0;
+  mutable uint64_t num_incremental_updates_ = 0;
+
   static constexpr const char* const kKeyspaceName = "keyspace_name";
   static constexpr const char* const kTableName = "table_name";
   static constexpr const char* const kStartKey = "start_key";
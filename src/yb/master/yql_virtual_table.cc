@@ -36,31 +36,42 @@ CHECKED_STATUS YQLVirtualTable::GetIterator(
     const common::QLScanSpec& spec,
     std::unique_ptr<common::YQLRowwiseIteratorIf>* iter)
     const {
-  std::unique_ptr<QLRowBlock> vtable;
-  RETURN_NOT_OK(RetrieveData(request, &vtable));
+  std::shared_ptr<const QLRowBlock> vtable;
+  RETURN_NOT_OK(RetrieveSharedData(request, &vtable));
 
-  // If hashed column values are specified, filter by the hash key.
+  // If hashed column values are specified, filter by the hash key. The data could be shared, so
+  // the matching rows are copied instead of removing the others.
   if (!request.hashed_column_values().empty()) {
     const size_t num_hash_key_columns = schema_.num_hash_key_columns();
     const auto& hashed_column_values = request.hashed_column_values();
-    std::vector<QLRow>& rows = vtable->rows();
-    auto excluded_rows = std::remove_if(
-        rows.begin(), rows.end(),
-        [num_hash_key_columns, &hashed_column_values](const QLRow& row) -> bool {
-          for (size_t i = 0; i < num_hash_key_columns; i++) {
-            if (hashed_column_values.Get(i).value() != row.column(i)) {
-              return true;
-            }
-          }
-          return false;
-        });
-    rows.erase(excluded_rows, rows.end());
+    auto filtered = std::make_shared<QLRowBlock>(schema_);
+    for (const QLRow& row : vtable->rows()) {
+      bool matches = true;
+      for (size_t i = 0; i < num_hash_key_columns; i++) {
+        if (hashed_column_values.Get(i).value() != row.column(i)) {
+          matches = false;
+          break;
+        }
+      }
+      if (matches) {
+        RETURN_NOT_OK(filtered->AddRow(row));
+      }
+    }
+    vtable = std::move(filtered);
   }
 
   iter->reset(new YQLVTableIterator(std::move(vtable)));
   return Status::OK();
 }
 
+Status YQLVirtualTable::RetrieveSharedData(const QLReadRequestPB& request,
+                                           std::shared_ptr<const QLRowBlock>* vtable) const {
+  std::unique_ptr<QLRowBlock> data;
+  RETURN_NOT_OK(RetrieveData(request, &data));
+  *vtable = std::move(data);
+  return Status::OK();
+}
+
 CHECKED_STATUS YQLVirtualTable::BuildYQLScanSpec(
     const QLReadRequestPB& request,
     const ReadHybridTime& read_time,
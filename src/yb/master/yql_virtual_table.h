@@ -45,6 +45,11 @@ class YQLVirtualTable : public common::YQLStorageIf {
   virtual CHECKED_STATUS RetrieveData(const QLReadRequestPB& request,
                                       std::unique_ptr<QLRowBlock>* vtable) const = 0;
 
+  // Retrieves the same data as RetrieveData, for the iterator that does not modify it. Tables that
+  // cache their data override it to share the cached data between queries instead of copying it.
+  virtual CHECKED_STATUS RetrieveSharedData(const QLReadRequestPB& request,
+                                            std::shared_ptr<const QLRowBlock>* vtable) const;
+
   CHECKED_STATUS GetIterator(const QLReadRequestPB& request,
                              const Schema& projection,
                              const Schema& schema,
@@ -24,7 +24,7 @@ namespace master {
 // An iterator over a YQLVirtualTable.
 class YQLVTableIterator : public common::YQLRowwiseIteratorIf {
  public:
-  explicit YQLVTableIterator(const std::unique_ptr<QLRowBlock> vtable);
+  explicit YQLVTableIterator(std::shared_ptr<const QLRowBlock> vtable);
 
   void SkipRow() override;
 
@@ -41,7 +41,7 @@ class YQLVTableIterator : public common::YQLRowwiseIteratorIf {
  private:
   CHECKED_STATUS DoNextRow(const Schema& projection, QLTableRow* table_row) override;
 
-  std::unique_ptr<QLRowBlock> vtable_;
+  std::shared_ptr<const QLRowBlock> vtable_;
   size_t vtable_index_;
 };
 
@@ -43,6 +43,13 @@ struct CompactionFilterContext {
   bool is_manual_compaction;
 };
 
+// Key-value written to the output of a compaction, see CompactionFilter::GroupPrefix.
+struct CompactionGroupEntry {
+  // Internal key, i.e. the user key followed by the sequence number and the value type.
+  std::string key;
+  std::string value;
+};
+
 // CompactionFilter allows an application to modify/delete a key-value at
 // the time of compaction.
 
@@ -57,6 +64,13 @@ class CompactionFilter {
     bool is_manual_compaction;
     // Which column family this compaction is for.
     uint32_t column_family_id;
+    // Whether the output of this compaction goes to the bottommost level, i.e. there are no older
+    // versions of the keys in the range of the compaction outside of its inputs. Only set for level
+    // compactions.
+    bool is_bottommost_level = false;
+    // Smallest and largest user keys of each level of the compaction inputs, or of each file for
+    // level 0. Keys outside of the inputs could only be adjacent to these keys.
+    std::vector<Slice> input_boundary_user_keys;
   };
 
   virtual ~CompactionFilter() {}
@@ -130,6 +144,19 @@ class CompactionFilter {
   // using a snapshot.
   virtual bool IgnoreSnapshots() const { return false; }
 
+  // Filter decides on a single key-value, so it cannot merge several keys into one. To do that,
+  // the filter could group adjacent output keys. The compaction calls this method for every key it
+  // writes to the output, after the key was passed to Filter, unless the key already belongs to a
+  // group. A non-empty result, which should be a prefix of user_key, starts a group that consists
+  // of this key and all the following output keys with the same prefix. The compaction then passes
+  // the key-values of the group to CompactGroup before writing them to the output.
+  virtual Slice GroupPrefix(const Slice& user_key) const { return Slice(); }
+
+  // Called with the key-values of a group started by GroupPrefix, in the order of the compaction
+  // output. The filter could change values and remove entries, but should keep the remaining keys
+  // unchanged and in the same order.
+  virtual void CompactGroup(std::vector<CompactionGroupEntry>* entries) const {}
+
   // Returns a name that identifies this compaction filter.
   // The name will be printed to LOG file on start up for diagnosis.
   virtual const char* Name() const = 0;
@@ -144,6 +171,14 @@ class CompactionFilterFactory {
   virtual std::unique_ptr<CompactionFilter> CreateCompactionFilter(
       const CompactionFilter::Context& context) = 0;
 
+  // When a compaction is split into subcompactions, each of them gets its own compaction filter.
+  // If the filter decides on a key based on the keys preceding it, a subcompaction boundary should
+  // not separate such keys. This function returns the boundary that should be used instead of the
+  // given user key, which should be a prefix of it, i.e. not greater than it.
+  virtual Slice AdjustSubcompactionBoundary(const Slice& user_key) const {
+    return user_key;
+  }
+
   // Returns a name that identifies this compaction filter factory.
   virtual const char* Name() const = 0;
 };
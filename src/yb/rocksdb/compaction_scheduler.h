@@ -0,0 +1,130 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+#ifndef ROCKSDB_INCLUDE_ROCKSDB_COMPACTION_SCHEDULER_H
+#define ROCKSDB_INCLUDE_ROCKSDB_COMPACTION_SCHEDULER_H
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace rocksdb {
+
+class Env;
+
+// Background compaction work of a DB, submitted to CompactionScheduler.
+class CompactionTask {
+ public:
+  virtual ~CompactionTask() {}
+
+  // Executes the task on a thread of the LOW priority pool. When allow_large is false the task
+  // should not pick a large compaction, because the limit of the scheduler is reached.
+  virtual void Run(bool allow_large) = 0;
+
+  // Invoked instead of Run when the task is removed from the queue by Unschedule.
+  virtual void Abort() = 0;
+
+  // Tasks with greater priority are dispatched first. This and the following methods are invoked
+  // with the scheduler mutex held, so they should be cheap and must not acquire locks that could
+  // be held while submitting tasks.
+  virtual int Priority() const = 0;
+
+  // Whether the DB has small or large compactions that could be picked by this task.
+  virtual bool HasSmallCompaction() const = 0;
+  virtual bool HasLargeCompaction() const = 0;
+
+  virtual std::string ToString() const = 0;
+};
+
+// Queues compaction tasks of all DBs sharing it, i.e. of all tablets on a tablet server, and
+// dispatches them to the LOW priority pool of env in the order of their priorities. So a DB that
+// is close to write stall does not wait behind compactions of DBs that are not.
+//
+// At most max_running_compactions tasks run concurrently, and at most max_running_large_compactions
+// of them are allowed to pick large compactions (see DBOptions::compaction_size_threshold_bytes).
+// A task that has only large compactions stays in the queue while the large limit is reached.
+class CompactionScheduler : public std::enable_shared_from_this<CompactionScheduler> {
+ public:
+  struct TaskInfo {
+    std::string description;
+    int priority;
+    bool running;
+    bool large;
+    uint64_t age_micros;
+  };
+
+  CompactionScheduler(Env* env, int max_running_compactions, int max_running_large_compactions);
+
+  ~CompactionScheduler();
+
+  // Adds task to the queue. tag identifies the DB that owns the task.
+  void Submit(void* tag, std::unique_ptr<CompactionTask> task);
+
+  // Removes queued tasks of tag, invoking Abort on them. Returns number of removed tasks.
+  // Tasks that were already dispatched are not affected.
+  int Unschedule(void* tag);
+
+  // Returns running tasks, followed by queued ones in the order they would be dispatched.
+  std::vector<TaskInfo> DumpTasks() const;
+
+  int max_running_compactions() const { return max_running_compactions_; }
+  int max_running_large_compactions() const { return max_running_large_compactions_; }
+
+  // No copying allowed
+  CompactionScheduler(const CompactionScheduler&) = delete;
+  void operator=(const CompactionScheduler&) = delete;
+
+ private:
+  struct Entry {
+    void* tag;
+    std::unique_ptr<CompactionTask> task;
+    uint64_t submit_time_micros;
+    // Description and priority are captured on dispatch, because the DB could be destroyed
+    // as soon as the task finishes.
+    std::string description;
+    int priority = 0;
+    bool large = false;
+  };
+
+  typedef std::list<Entry> Entries;
+
+  struct RunArg {
+    std::shared_ptr<CompactionScheduler> scheduler;
+    Entries::iterator entry;
+  };
+
+  static void RunTask(void* arg);
+
+  void TaskFinished(Entries::iterator entry);
+
+  // Dispatches queued tasks while there are free slots. Should be invoked with mutex_ held.
+  void Dispatch();
+
+  // Returns the queued task that should be dispatched next, or queue_.end() if none of them
+  // could be dispatched now.
+  Entries::iterator PickNext();
+
+  Env* const env_;
+  const int max_running_compactions_;
+  const int max_running_large_compactions_;
+
+  mutable std::mutex mutex_;
+  Entries queue_;
+  Entries running_;
+  int num_running_large_ = 0;
+};
+
+}  // namespace rocksdb
+
+#endif // ROCKSDB_INCLUDE_ROCKSDB_COMPACTION_SCHEDULER_H
@@ -491,6 +491,24 @@ std::unique_ptr<CompactionFilter> Compaction::CreateCompactionFilter() const {
   context.is_full_compaction = is_full_compaction_;
   context.is_manual_compaction = is_manual_compaction_;
   context.column_family_id = cfd_->GetID();
+  // Only level compactions are reported as bottommost ones, the inputs of universal compactions
+  // are whole sorted runs, so they are major compactions only when they include all of them.
+  context.is_bottommost_level =
+      bottommost_level_ && cfd_->ioptions()->compaction_style == kCompactionStyleLevel;
+  for (const auto& input : inputs_) {
+    if (input.files.empty()) {
+      continue;
+    }
+    if (input.level == 0) {
+      for (const auto* f : input.files) {
+        context.input_boundary_user_keys.push_back(f->smallest.key.user_key());
+        context.input_boundary_user_keys.push_back(f->largest.key.user_key());
+      }
+    } else {
+      context.input_boundary_user_keys.push_back(input.files.front()->smallest.key.user_key());
+      context.input_boundary_user_keys.push_back(input.files.back()->largest.key.user_key());
+    }
+  }
   return cfd_->ioptions()->compaction_filter_factory->CreateCompactionFilter(
       context);
 }
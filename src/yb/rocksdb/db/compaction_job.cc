@@ -462,7 +462,18 @@ void CompactionJob::GenSubcompactionBoundaries() {
         continue;
       }
       if (sum >= mean) {
-        boundaries_.emplace_back(ExtractUserKey(ranges[i].range.limit));
+        Slice boundary = ExtractUserKey(ranges[i].range.limit);
+        if (cfd->ioptions()->compaction_filter_factory != nullptr) {
+          boundary = cfd->ioptions()->compaction_filter_factory->AdjustSubcompactionBoundary(
+              boundary);
+        }
+        // The adjusted boundary could fall into the range of the previous subcompaction, then the
+        // current range is added to it.
+        if (!boundaries_.empty() &&
+            cfd_comparator->Compare(boundary, boundaries_.back()) <= 0) {
+          continue;
+        }
+        boundaries_.emplace_back(boundary);
         sizes_.emplace_back(sum);
         subcompactions--;
         sum = 0;
@@ -674,6 +685,9 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
   auto c_iter = sub_compact->c_iter.get();
   c_iter->SeekToFirst();
   const auto& c_iter_stats = c_iter->iter_stats();
+  // Key-values of the current group and its user key prefix, see CompactionFilter::GroupPrefix.
+  std::vector<CompactionGroupEntry> group;
+  std::string group_prefix;
   // TODO(noetzli): check whether we could check !shutting_down_->... only
   // only occasionally (see diff D42687)
   while (status.ok() && !shutting_down_->load(std::memory_order_acquire) &&
@@ -688,12 +702,6 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
     if (end != nullptr &&
         cfd->user_comparator()->Compare(c_iter->user_key(), *end) >= 0) {
       break;
-    } else if (sub_compact->compaction->ShouldStopBefore(key) &&
-               sub_compact->builder != nullptr) {
-      status = FinishCompactionOutputFile(input->status(), sub_compact);
-      if (!status.ok()) {
-        break;
-      }
     }
 
     if (c_iter_stats.num_input_records % kRecordStatsEvery ==
@@ -703,40 +711,38 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
       RecordCompactionIOStats();
     }
 
-    // Open output file if necessary
-    if (sub_compact->builder == nullptr) {
-      status = OpenCompactionOutputFile(sub_compact);
+    if (!group.empty()) {
+      if (c_iter->user_key().starts_with(group_prefix)) {
+        group.push_back(CompactionGroupEntry{key.ToBuffer(), value.ToBuffer()});
+        c_iter->Next();
+        continue;
+      }
+      status = FlushCompactionGroup(*compaction_filter, input->status(), &group, sub_compact);
       if (!status.ok()) {
         break;
       }
     }
-    assert(sub_compact->builder != nullptr);
-    assert(sub_compact->current_output() != nullptr);
-    sub_compact->builder->Add(key, value);
-    auto boundaries = MakeFileBoundaryValues(db_options_.boundary_extractor.get(),
-                                             key,
-                                             value);
-    if (!boundaries) {
-      status = std::move(boundaries.status());
-      break;
+
+    if (compaction_filter != nullptr) {
+      const Slice prefix = compaction_filter->GroupPrefix(c_iter->user_key());
+      if (!prefix.empty()) {
+        group_prefix = prefix.ToBuffer();
+        group.push_back(CompactionGroupEntry{key.ToBuffer(), value.ToBuffer()});
+        c_iter->Next();
+        continue;
+      }
     }
-    auto& boundary_values = *boundaries;
-    sub_compact->current_output()->meta.UpdateBoundaries(std::move(boundary_values.key),
-                                                         boundary_values);
-    sub_compact->num_output_records++;
-
-    // Close output file if it is big enough
-    // TODO(aekmekji): determine if file should be closed earlier than this
-    // during subcompactions (i.e. if output size, estimated by input size, is
-    // going to be 1.2MB and max_output_file_size = 1MB, prefer to have 0.6MB
-    // and 0.6MB instead of 1MB and 0.2MB)
-    if (sub_compact->builder->TotalFileSize() >=
-        sub_compact->compaction->max_output_file_size()) {
-      status = FinishCompactionOutputFile(input->status(), sub_compact);
+
+    status = AddToCompactionOutput(key, value, input->status(), sub_compact);
+    if (!status.ok()) {
+      break;
     }
 
     c_iter->Next();
   }
+  if (status.ok() && !group.empty()) {
+    status = FlushCompactionGroup(*compaction_filter, input->status(), &group, sub_compact);
+  }
 
   sub_compact->num_input_records = c_iter_stats.num_input_records;
   sub_compact->compaction_job_stats.num_input_deletion_records =
@@ -784,6 +790,67 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
   sub_compact->status = status;
 }
 
+Status CompactionJob::AddToCompactionOutput(const Slice& key,
+                                            const Slice& value,
+                                            const Status& input_status,
+                                            SubcompactionState* sub_compact) {
+  if (sub_compact->compaction->ShouldStopBefore(key) &&
+      sub_compact->builder != nullptr) {
+    Status status = FinishCompactionOutputFile(input_status, sub_compact);
+    if (!status.ok()) {
+      return status;
+    }
+  }
+
+  // Open output file if necessary
+  if (sub_compact->builder == nullptr) {
+    Status status = OpenCompactionOutputFile(sub_compact);
+    if (!status.ok()) {
+      return status;
+    }
+  }
+  assert(sub_compact->builder != nullptr);
+  assert(sub_compact->current_output() != nullptr);
+  sub_compact->builder->Add(key, value);
+  auto boundaries = MakeFileBoundaryValues(db_options_.boundary_extractor.get(),
+                                           key,
+                                           value);
+  if (!boundaries) {
+    return std::move(boundaries.status());
+  }
+  auto& boundary_values = *boundaries;
+  sub_compact->current_output()->meta.UpdateBoundaries(std::move(boundary_values.key),
+                                                       boundary_values);
+  sub_compact->num_output_records++;
+
+  // Close output file if it is big enough
+  // TODO(aekmekji): determine if file should be closed earlier than this
+  // during subcompactions (i.e. if output size, estimated by input size, is
+  // going to be 1.2MB and max_output_file_size = 1MB, prefer to have 0.6MB
+  // and 0.6MB instead of 1MB and 0.2MB)
+  if (sub_compact->builder->TotalFileSize() >=
+      sub_compact->compaction->max_output_file_size()) {
+    return FinishCompactionOutputFile(input_status, sub_compact);
+  }
+  return Status::OK();
+}
+
+Status CompactionJob::FlushCompactionGroup(const CompactionFilter& compaction_filter,
+                                           const Status& input_status,
+                                           std::vector<CompactionGroupEntry>* group,
+                                           SubcompactionState* sub_compact) {
+  compaction_filter.CompactGroup(group);
+  Status status;
+  for (const auto& entry : *group) {
+    status = AddToCompactionOutput(entry.key, entry.value, input_status, sub_compact);
+    if (!status.ok()) {
+      break;
+    }
+  }
+  group->clear();
+  return status;
+}
+
 void CompactionJob::RecordDroppedKeys(
     const CompactionIteratorStats& c_iter_stats,
     CompactionJobStats* compaction_job_stats) {
@@ -107,6 +107,15 @@ class CompactionJob {
   // kv-pairs
   void ProcessKeyValueCompaction(SubcompactionState* sub_compact);
 
+  // Writes the key-value to the output of the subcompaction, switching to a new output file when
+  // necessary.
+  Status AddToCompactionOutput(const Slice& key, const Slice& value, const Status& input_status,
+                               SubcompactionState* sub_compact);
+  // Passes the group of key-values to the compaction filter and writes the result to the output.
+  Status FlushCompactionGroup(const CompactionFilter& compaction_filter,
+                              const Status& input_status,
+                              std::vector<CompactionGroupEntry>* group,
+                              SubcompactionState* sub_compact);
   Status FinishCompactionOutputFile(const Status& input_status,
                                     SubcompactionState* sub_compact);
   Status InstallCompactionResults(const MutableCFOptions& mutable_cf_options);
@@ -129,6 +129,29 @@ class ChangeFilter : public CompactionFilter {
   const char* Name() const override { return "ChangeFilter"; }
 };
 
+// Groups keys by their first character, except for 'b', and merges the values of each group into
+// its first key.
+class GroupFilter : public CompactionFilter {
+ public:
+  bool Filter(int level, const Slice& key, const Slice& value, std::string* new_value,
+              bool* value_changed) const override {
+    return false;
+  }
+
+  Slice GroupPrefix(const Slice& user_key) const override {
+    return user_key[0] == 'b' ? Slice() : Slice(user_key.data(), 1);
+  }
+
+  void CompactGroup(std::vector<CompactionGroupEntry>* entries) const override {
+    for (size_t i = 1; i != entries->size(); ++i) {
+      entries->front().value += (*entries)[i].value;
+    }
+    entries->resize(1);
+  }
+
+  const char* Name() const override { return "GroupFilter"; }
+};
+
 class KeepFilterFactory : public CompactionFilterFactory {
  public:
   explicit KeepFilterFactory(bool check_context = false,
@@ -223,6 +246,16 @@ class ConditionalFilterFactory : public CompactionFilterFactory {
   std::string filtered_value_;
 };
 
+class GroupFilterFactory : public CompactionFilterFactory {
+ public:
+  std::unique_ptr<CompactionFilter> CreateCompactionFilter(
+      const CompactionFilter::Context& context) override {
+    return std::unique_ptr<CompactionFilter>(new GroupFilter());
+  }
+
+  const char* Name() const override { return "GroupFilterFactory"; }
+};
+
 class ChangeFilterFactory : public CompactionFilterFactory {
  public:
   ChangeFilterFactory() {}
@@ -489,6 +522,33 @@ TEST_F(DBTestCompactionFilter, CompactionFilterWithValueChange) {
   } while (ChangeCompactOptions());
 }
 
+TEST_F(DBTestCompactionFilter, CompactionFilterGroups) {
+  Options options;
+  options.compaction_filter_factory = std::make_shared<GroupFilterFactory>();
+  options.disable_auto_compactions = true;
+  options.create_if_missing = true;
+  options = CurrentOptions(options);
+  DestroyAndReopen(options);
+
+  for (const auto& key : {"a1", "a2", "b1", "b2", "c1"}) {
+    ASSERT_OK(Put(key, key));
+  }
+  ASSERT_OK(Flush());
+  for (const auto& key : {"a3", "c2"}) {
+    ASSERT_OK(Put(key, key));
+  }
+  ASSERT_OK(Flush());
+
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ("a1a2a3", Get("a1"));
+  ASSERT_EQ("NOT_FOUND", Get("a2"));
+  ASSERT_EQ("NOT_FOUND", Get("a3"));
+  ASSERT_EQ("b1", Get("b1"));
+  ASSERT_EQ("b2", Get("b2"));
+  ASSERT_EQ("c1c2", Get("c1"));
+  ASSERT_EQ("NOT_FOUND", Get("c2"));
+}
+
 TEST_F(DBTestCompactionFilter, CompactionFilterWithMergeOperator) {
   std::string one, two, three, four;
   PutFixed64(&one, 1);
@@ -87,6 +87,7 @@
 #include "yb/rocksdb/port/port.h"
 #include "yb/rocksdb/cache.h"
 #include "yb/rocksdb/compaction_filter.h"
+#include "yb/rocksdb/compaction_scheduler.h"
 #include "yb/rocksdb/db.h"
 #include "yb/rocksdb/env.h"
 #include "yb/rocksdb/merge_operator.h"
@@ -379,6 +380,9 @@ DBImpl::~DBImpl() {
   // (to consider: moving all the waiting into CancelAllBackgroundWork(true))
   CancelAllBackgroundWork(false);
   int compactions_unscheduled = env_->UnSchedule(this, Env::Priority::LOW);
+  if (db_options_.compaction_scheduler) {
+    compactions_unscheduled += db_options_.compaction_scheduler->Unschedule(this);
+  }
   int flushes_unscheduled = env_->UnSchedule(this, Env::Priority::HIGH);
   mutex_.Lock();
   bg_compaction_scheduled_ -= compactions_unscheduled;
@@ -2662,18 +2666,113 @@ void DBImpl::MaybeScheduleFlushOrCompaction() {
     return;
   }
 
+  const auto& compaction_scheduler = db_options_.compaction_scheduler;
+  if (compaction_scheduler) {
+    UpdateCompactionSchedulerState();
+  }
+
   while (bg_compaction_scheduled_ < bg_compactions_allowed &&
          unscheduled_compactions_ > 0) {
+    bg_compaction_scheduled_++;
+    unscheduled_compactions_--;
+    if (compaction_scheduler) {
+      compaction_scheduler->Submit(this, std::make_unique<CompactionTaskImpl>(this));
+      continue;
+    }
     CompactionArg* ca = new CompactionArg;
     ca->db = this;
     ca->m = nullptr;
-    bg_compaction_scheduled_++;
-    unscheduled_compactions_--;
     env_->Schedule(&DBImpl::BGWorkCompaction, ca, Env::Priority::LOW, this,
                    &DBImpl::UnscheduleCallback);
   }
 }
 
+// Automatic compaction submitted to the compaction scheduler shared by several DBs. Must not touch
+// the DB after Run returns, because the DB could be destroyed at this point.
+class DBImpl::CompactionTaskImpl : public CompactionTask {
+ public:
+  explicit CompactionTaskImpl(DBImpl* db) : db_(db) {}
+
+  void Run(bool allow_large) override {
+    IOSTATS_SET_THREAD_POOL_ID(Env::Priority::LOW);
+    TEST_SYNC_POINT("DBImpl::BGWorkCompaction");
+    db_->BackgroundCallCompaction(nullptr /* arg */, allow_large);
+  }
+
+  void Abort() override {
+    TEST_SYNC_POINT("DBImpl::UnscheduleCallback");
+  }
+
+  int Priority() const override {
+    return db_->compaction_priority_.load(std::memory_order_acquire);
+  }
+
+  bool HasSmallCompaction() const override {
+    return db_->has_small_compaction_.load(std::memory_order_acquire);
+  }
+
+  bool HasLargeCompaction() const override {
+    return db_->has_large_compaction_.load(std::memory_order_acquire);
+  }
+
+  std::string ToString() const override {
+    return db_->dbname_;
+  }
+
+ private:
+  DBImpl* const db_;
+};
+
+namespace {
+
+// Priority weight of each percent of L0 files towards level0_slowdown_writes_trigger.
+constexpr int kCompactionPriorityPerStallPercent = 100;
+// Sorted runs, i.e. files that could be read by a point lookup, above this number do not increase
+// priority anymore, so read amplification never outweighs write stall risk.
+constexpr int kCompactionPriorityMaxSortedRuns = kCompactionPriorityPerStallPercent - 1;
+// Added to priority when writes to the DB are already delayed or stopped.
+constexpr int kCompactionPriorityWriteStall = 1000000;
+
+} // namespace
+
+void DBImpl::UpdateCompactionSchedulerState() {
+  mutex_.AssertHeld();
+
+  // Compactions of a DB that is closer to write slowdown go first, read amplification breaks ties.
+  int priority = 0;
+  for (auto cfd : *versions_->GetColumnFamilySet()) {
+    if (cfd->IsDropped()) {
+      continue;
+    }
+    const auto* vstorage = cfd->current()->storage_info();
+    const int num_l0_files = vstorage->NumLevelFiles(0);
+    int sorted_runs = num_l0_files;
+    for (int level = 1; level < vstorage->num_levels(); ++level) {
+      if (vstorage->NumLevelFiles(level) > 0) {
+        ++sorted_runs;
+      }
+    }
+    const int slowdown_trigger = cfd->GetLatestMutableCFOptions()->level0_slowdown_writes_trigger;
+    const int stall_percent =
+        slowdown_trigger > 0 ? std::min(num_l0_files * 100 / slowdown_trigger, 100) : 0;
+    priority = std::max(
+        priority,
+        stall_percent * kCompactionPriorityPerStallPercent +
+            std::min(sorted_runs, kCompactionPriorityMaxSortedRuns));
+  }
+  if (write_controller_.IsStopped() || write_controller_.NeedsDelay()) {
+    priority += kCompactionPriorityWriteStall;
+  }
+
+  compaction_priority_.store(priority, std::memory_order_release);
+  has_small_compaction_.store(!small_compaction_queue_.empty(), std::memory_order_release);
+  has_large_compaction_.store(
+      !large_compaction_queue_.empty() &&
+          BGCompactionsAllowed() >
+              num_running_large_compactions() + db_options_.num_reserved_small_compaction_threads,
+      std::memory_order_release);
+}
+
 int DBImpl::BGCompactionsAllowed() const {
   if (write_controller_.NeedSpeedupCompaction()) {
     return db_options_.max_background_compactions;
@@ -2911,7 +3010,7 @@ void DBImpl::BackgroundCallFlush() {
   }
 }
 
-void DBImpl::BackgroundCallCompaction(void* arg) {
+void DBImpl::BackgroundCallCompaction(void* arg, bool allow_large_compaction) {
   bool made_progress = false;
   ManualCompaction* m = reinterpret_cast<ManualCompaction*>(arg);
   JobContext job_context(next_job_id_.fetch_add(1), true);
@@ -2926,7 +3025,7 @@ void DBImpl::BackgroundCallCompaction(void* arg) {
 
     assert(bg_compaction_scheduled_);
     Status s =
-        BackgroundCompaction(&made_progress, &job_context, &log_buffer, m);
+        BackgroundCompaction(&made_progress, &job_context, &log_buffer, m, allow_large_compaction);
     TEST_SYNC_POINT("BackgroundCallCompaction:1");
     if (!s.ok() && !s.IsShutdownInProgress()) {
       // Wait a little bit before retrying background compaction in
@@ -2997,7 +3096,8 @@ void DBImpl::BackgroundCallCompaction(void* arg) {
 
 Status DBImpl::BackgroundCompaction(bool* made_progress,
                                     JobContext* job_context,
-                                    LogBuffer* log_buffer, void* arg) {
+                                    LogBuffer* log_buffer, void* arg,
+                                    bool allow_large_compaction) {
   ManualCompaction* manual_compaction =
       reinterpret_cast<ManualCompaction*>(arg);
   *made_progress = false;
@@ -3061,7 +3161,7 @@ Status DBImpl::BackgroundCompaction(bool* made_progress,
     }
   } else if (!IsEmptyCompactionQueue()) {
     // cfd is referenced here
-    if (!large_compaction_queue_.empty() && BGCompactionsAllowed() >
+    if (allow_large_compaction && !large_compaction_queue_.empty() && BGCompactionsAllowed() >
           num_running_large_compactions() + db_options_.num_reserved_small_compaction_threads) {
       c.reset(PopFirstFromLargeCompactionQueue());
       is_large_compaction = true;
@@ -4600,8 +4700,8 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
     // 3. Deletes or SingleDeletes are not okay if filtering deletes
     //    (controlled by both batch and memtable setting)
     // 4. Merges are not okay
-    // 5. YugaByte-specific user-specified sequence numbers are currently not compatible with
-    //    parallel memtable writes.
+    // 5. YugaByte-specific user frontiers of batches are merged into the memtable under its own
+    //    lock, see MemTable::UpdateFrontiers.
     //
     // Rules 1..3 are enforced by checking the options
     // during startup (CheckConcurrentWritesSupported), so if
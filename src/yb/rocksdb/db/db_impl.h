@@ -604,10 +604,17 @@ class DBImpl : public DB {
   static void BGWorkCompaction(void* arg);
   static void BGWorkFlush(void* db);
   static void UnscheduleCallback(void* arg);
-  void BackgroundCallCompaction(void* arg);
+  // allow_large_compaction is false when the compaction scheduler does not allow to pick a large
+  // compaction, see CompactionScheduler.
+  void BackgroundCallCompaction(void* arg, bool allow_large_compaction = true);
   void BackgroundCallFlush();
   Status BackgroundCompaction(bool* madeProgress, JobContext* job_context,
-                              LogBuffer* log_buffer, void* m = 0);
+                              LogBuffer* log_buffer, void* m = 0,
+                              bool allow_large_compaction = true);
+
+  // Updates the state used by db_options_.compaction_scheduler to prioritize compactions of this
+  // DB, see CompactionTaskImpl.
+  void UpdateCompactionSchedulerState();
   Status BackgroundFlush(bool* madeProgress, JobContext* job_context,
                          LogBuffer* log_buffer);
 
@@ -842,6 +849,15 @@ class DBImpl : public DB {
   // stores the number of large compaction that are currently running
   int num_running_large_compactions_;
 
+  // Compaction task submitted to db_options_.compaction_scheduler.
+  class CompactionTaskImpl;
+
+  // State of this DB exposed to db_options_.compaction_scheduler, updated by
+  // UpdateCompactionSchedulerState. Atomics because the scheduler reads them without mutex_.
+  std::atomic<int> compaction_priority_{0};
+  std::atomic<bool> has_small_compaction_{false};
+  std::atomic<bool> has_large_compaction_{false};
+
   // number of background memtable flush jobs, submitted to the HIGH pool
   int bg_flush_scheduled_;
 
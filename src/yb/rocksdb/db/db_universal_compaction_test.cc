@@ -89,6 +89,8 @@ class KeepFilterFactory : public CompactionFilterFactory {
     if (check_context_) {
       EXPECT_EQ(expect_full_compaction_.load(), context.is_full_compaction);
       EXPECT_EQ(expect_manual_compaction_.load(), context.is_manual_compaction);
+      // Universal compactions are never treated as bottommost ones, see Compaction.
+      EXPECT_FALSE(context.is_bottommost_level);
     }
     return std::unique_ptr<CompactionFilter>(new KeepFilter());
   }
@@ -30,6 +30,7 @@
 #include <deque>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -45,6 +46,7 @@
 #include "yb/rocksdb/util/dynamic_bloom.h"
 #include "yb/rocksdb/util/instrumented_mutex.h"
 #include "yb/rocksdb/util/mutable_cf_options.h"
+#include "yb/rocksdb/util/mutexlock.h"
 
 namespace rocksdb {
 
@@ -333,7 +335,10 @@ class MemTable {
 
   const MemTableOptions* GetMemTableOptions() const { return &moptions_; }
 
+  // Could be invoked concurrently by writers of the same write group, when concurrent memtable
+  // writes are allowed.
   void UpdateFrontiers(const UserFrontiers& value) {
+    std::lock_guard<SpinMutex> lock(frontiers_mutex_);
     if (frontiers_) {
       frontiers_->Merge(value);
     } else {
@@ -394,6 +399,7 @@ class MemTable {
 
   Env* env_;
 
+  SpinMutex frontiers_mutex_;
   std::unique_ptr<UserFrontiers> frontiers_;
 
   // Returns a heuristic flush decision
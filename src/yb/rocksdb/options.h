@@ -48,6 +48,7 @@ class BoundaryValuesExtractor;
 class Cache;
 class CompactionFilter;
 class CompactionFilterFactory;
+class CompactionScheduler;
 class Comparator;
 class Env;
 enum InfoLogLevel : unsigned char;
@@ -1119,6 +1120,13 @@ struct DBOptions {
   // Default: nullptr (disabled)
   std::shared_ptr<MemoryMonitor> memory_monitor;
 
+  // Shared CompactionScheduler, automatic compactions are submitted to it instead of the LOW
+  // priority thread pool of env. In this case the pool is shared with other DBs according to
+  // priorities of their compactions, see CompactionScheduler.
+  //
+  // Default: nullptr (disabled)
+  std::shared_ptr<CompactionScheduler> compaction_scheduler;
+
   // Specify the file access pattern once a compaction is started.
   // It will be applied to all input files of a compaction.
   // Default: NORMAL
@@ -0,0 +1,149 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/rocksdb/compaction_scheduler.h"
+
+#include <algorithm>
+
+#include "yb/rocksdb/env.h"
+#include "yb/rocksdb/util/sync_point.h"
+
+namespace rocksdb {
+
+CompactionScheduler::CompactionScheduler(
+    Env* env, int max_running_compactions, int max_running_large_compactions)
+    : env_(env),
+      max_running_compactions_(std::max(max_running_compactions, 1)),
+      max_running_large_compactions_(
+          std::min(std::max(max_running_large_compactions, 1), max_running_compactions_)) {
+  env_->IncBackgroundThreadsIfNeeded(max_running_compactions_, Env::Priority::LOW);
+}
+
+CompactionScheduler::~CompactionScheduler() {
+  // DBs unschedule their tasks on destruction, and dispatched tasks retain the scheduler.
+  assert(queue_.empty());
+  assert(running_.empty());
+}
+
+void CompactionScheduler::Submit(void* tag, std::unique_ptr<CompactionTask> task) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  queue_.emplace_back();
+  auto& entry = queue_.back();
+  entry.tag = tag;
+  entry.task = std::move(task);
+  entry.submit_time_micros = env_->NowMicros();
+  Dispatch();
+}
+
+int CompactionScheduler::Unschedule(void* tag) {
+  Entries removed;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = queue_.begin(); it != queue_.end();) {
+      auto next = std::next(it);
+      if (it->tag == tag) {
+        removed.splice(removed.end(), queue_, it);
+      }
+      it = next;
+    }
+  }
+  for (auto& entry : removed) {
+    entry.task->Abort();
+  }
+  return static_cast<int>(removed.size());
+}
+
+CompactionScheduler::Entries::iterator CompactionScheduler::PickNext() {
+  const bool large_allowed = num_running_large_ < max_running_large_compactions_;
+  auto result = queue_.end();
+  int best_priority = 0;
+  // Entries with equal priority are dispatched in the order of submission.
+  for (auto it = queue_.begin(); it != queue_.end(); ++it) {
+    if (!large_allowed && !it->task->HasSmallCompaction() && it->task->HasLargeCompaction()) {
+      continue;
+    }
+    const int priority = it->task->Priority();
+    if (result == queue_.end() || priority > best_priority) {
+      result = it;
+      best_priority = priority;
+    }
+  }
+  return result;
+}
+
+void CompactionScheduler::Dispatch() {
+  while (!queue_.empty() && running_.size() < static_cast<size_t>(max_running_compactions_)) {
+    auto it = PickNext();
+    if (it == queue_.end()) {
+      break;
+    }
+    it->description = it->task->ToString();
+    it->priority = it->task->Priority();
+    it->large = num_running_large_ < max_running_large_compactions_ &&
+                it->task->HasLargeCompaction();
+    if (it->large) {
+      ++num_running_large_;
+    }
+    running_.splice(running_.end(), queue_, it);
+    env_->Schedule(&CompactionScheduler::RunTask,
+                   new RunArg{shared_from_this(), it},
+                   Env::Priority::LOW);
+  }
+}
+
+void CompactionScheduler::RunTask(void* arg) {
+  std::unique_ptr<RunArg> run_arg(static_cast<RunArg*>(arg));
+  TEST_SYNC_POINT("CompactionScheduler::RunTask");
+  run_arg->entry->task->Run(run_arg->entry->large);
+  run_arg->scheduler->TaskFinished(run_arg->entry);
+}
+
+void CompactionScheduler::TaskFinished(Entries::iterator entry) {
+  std::unique_ptr<CompactionTask> task;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (entry->large) {
+      --num_running_large_;
+    }
+    // The task is destroyed outside of the mutex.
+    task = std::move(entry->task);
+    running_.erase(entry);
+    Dispatch();
+  }
+}
+
+std::vector<CompactionScheduler::TaskInfo> CompactionScheduler::DumpTasks() const {
+  std::vector<TaskInfo> result;
+  const auto now = env_->NowMicros();
+  std::lock_guard<std::mutex> lock(mutex_);
+  result.reserve(running_.size() + queue_.size());
+  for (const auto& entry : running_) {
+    result.push_back(TaskInfo{
+        entry.description, entry.priority, true /* running */, entry.large,
+        now - entry.submit_time_micros});
+  }
+  const size_t num_running = result.size();
+  for (const auto& entry : queue_) {
+    result.push_back(TaskInfo{
+        entry.task->ToString(), entry.task->Priority(), false /* running */,
+        entry.task->HasLargeCompaction() && !entry.task->HasSmallCompaction(),
+        now - entry.submit_time_micros});
+  }
+  std::stable_sort(result.begin() + num_running, result.end(),
+                   [](const TaskInfo& lhs, const TaskInfo& rhs) {
+    return lhs.priority > rhs.priority;
+  });
+  return result;
+}
+
+}  // namespace rocksdb
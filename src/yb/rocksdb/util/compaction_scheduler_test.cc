@@ -0,0 +1,170 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "yb/rocksdb/compaction_scheduler.h"
+#include "yb/rocksdb/env.h"
+#include "yb/rocksdb/util/testharness.h"
+
+#include "yb/util/countdown_latch.h"
+#include "yb/util/monotime.h"
+
+namespace rocksdb {
+
+namespace {
+
+struct TestState {
+  std::mutex mutex;
+  std::vector<std::string> executed;
+  std::vector<bool> allow_large;
+  std::atomic<int> aborted{0};
+};
+
+class TestTask : public CompactionTask {
+ public:
+  TestTask(std::string name, int priority, bool small, bool large, TestState* state,
+           yb::CountDownLatch* latch = nullptr)
+      : name_(std::move(name)), priority_(priority), small_(small), large_(large), state_(state),
+        latch_(latch) {}
+
+  void Run(bool allow_large) override {
+    if (latch_) {
+      latch_->Wait();
+    }
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    state_->executed.push_back(name_);
+    state_->allow_large.push_back(allow_large);
+  }
+
+  void Abort() override {
+    ++state_->aborted;
+  }
+
+  int Priority() const override { return priority_; }
+  bool HasSmallCompaction() const override { return small_; }
+  bool HasLargeCompaction() const override { return large_; }
+  std::string ToString() const override { return name_; }
+
+ private:
+  const std::string name_;
+  const int priority_;
+  const bool small_;
+  const bool large_;
+  TestState* const state_;
+  yb::CountDownLatch* const latch_;
+};
+
+void WaitExecuted(TestState* state, size_t count) {
+  auto deadline = yb::MonoTime::Now() + yb::MonoDelta::FromSeconds(10);
+  for (;;) {
+    {
+      std::lock_guard<std::mutex> lock(state->mutex);
+      if (state->executed.size() >= count) {
+        return;
+      }
+    }
+    ASSERT_TRUE(yb::MonoTime::Now() < deadline);
+    Env::Default()->SleepForMicroseconds(1000);
+  }
+}
+
+} // namespace
+
+class CompactionSchedulerTest : public testing::Test {
+};
+
+TEST_F(CompactionSchedulerTest, Priority) {
+  TestState state;
+  yb::CountDownLatch latch(1);
+  auto scheduler = std::make_shared<CompactionScheduler>(Env::Default(), 1, 1);
+  int tag = 0;
+
+  // Occupies the only slot, so the following tasks are queued.
+  scheduler->Submit(&tag, std::make_unique<TestTask>("blocker", 0, true, false, &state, &latch));
+  scheduler->Submit(&tag, std::make_unique<TestTask>("low", 1, true, false, &state));
+  scheduler->Submit(&tag, std::make_unique<TestTask>("high", 10, true, false, &state));
+  scheduler->Submit(&tag, std::make_unique<TestTask>("low2", 1, true, false, &state));
+
+  auto tasks = scheduler->DumpTasks();
+  ASSERT_EQ(4, tasks.size());
+  ASSERT_EQ("blocker", tasks[0].description);
+  ASSERT_TRUE(tasks[0].running);
+  ASSERT_EQ("high", tasks[1].description);
+  ASSERT_FALSE(tasks[1].running);
+
+  latch.CountDown();
+  WaitExecuted(&state, 4);
+  std::vector<std::string> expected = {"blocker", "high", "low", "low2"};
+  ASSERT_EQ(expected, state.executed);
+}
+
+TEST_F(CompactionSchedulerTest, LargeCompactionsLimit) {
+  TestState state;
+  yb::CountDownLatch latch(1);
+  auto scheduler = std::make_shared<CompactionScheduler>(Env::Default(), 2, 1);
+  int tag = 0;
+
+  scheduler->Submit(&tag, std::make_unique<TestTask>("large1", 0, false, true, &state, &latch));
+  // Has only large compactions, so waits for the first one even though there is a free slot.
+  scheduler->Submit(&tag, std::make_unique<TestTask>("large2", 10, false, true, &state));
+  // Runs in the free slot, but is not allowed to pick a large compaction.
+  scheduler->Submit(&tag, std::make_unique<TestTask>("mixed", 1, true, true, &state));
+
+  WaitExecuted(&state, 1);
+  {
+    std::lock_guard<std::mutex> lock(state.mutex);
+    ASSERT_EQ("mixed", state.executed[0]);
+    ASSERT_FALSE(state.allow_large[0]);
+  }
+
+  latch.CountDown();
+  WaitExecuted(&state, 3);
+  ASSERT_EQ("large1", state.executed[1]);
+  ASSERT_TRUE(state.allow_large[1]);
+  ASSERT_EQ("large2", state.executed[2]);
+  ASSERT_TRUE(state.allow_large[2]);
+}
+
+TEST_F(CompactionSchedulerTest, Unschedule) {
+  TestState state;
+  yb::CountDownLatch latch(1);
+  auto scheduler = std::make_shared<CompactionScheduler>(Env::Default(), 1, 1);
+  int tag1 = 0;
+  int tag2 = 0;
+
+  scheduler->Submit(&tag1, std::make_unique<TestTask>("blocker", 0, true, false, &state, &latch));
+  scheduler->Submit(&tag1, std::make_unique<TestTask>("task1", 0, true, false, &state));
+  scheduler->Submit(&tag2, std::make_unique<TestTask>("task2", 0, true, false, &state));
+  scheduler->Submit(&tag1, std::make_unique<TestTask>("task3", 0, true, false, &state));
+
+  // Running task is not affected.
+  ASSERT_EQ(2, scheduler->Unschedule(&tag1));
+  ASSERT_EQ(2, state.aborted.load());
+
+  latch.CountDown();
+  WaitExecuted(&state, 2);
+  std::vector<std::string> expected = {"blocker", "task2"};
+  ASSERT_EQ(expected, state.executed);
+}
+
+}  // namespace rocksdb
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
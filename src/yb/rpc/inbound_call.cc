@@ -83,6 +83,7 @@ InboundCall::InboundCall(ConnectionPtr conn, CallProcessedListener call_processe
     : trace_(new Trace),
       conn_(std::move(conn)),
       call_processed_listener_(std::move(call_processed_listener)) {
+  trace_->MaybeSample();
   TRACE_TO(trace_, "Created InboundCall");
 }
 
@@ -140,8 +141,11 @@ void InboundCall::RecordHandlingStarted(scoped_refptr<Histogram> incoming_queue_
   LOG_IF_WITH_PREFIX(DFATAL, timing_.time_handled.Initialized()) << "Already marked as started";
   timing_.time_handled = MonoTime::Now();
   VLOG_WITH_PREFIX(4) << "Handling";
-  incoming_queue_time->Increment(
-      timing_.time_handled.GetDeltaSince(timing_.time_received).ToMicroseconds());
+  auto time_in_queue = timing_.time_handled.GetDeltaSince(timing_.time_received);
+  incoming_queue_time->Increment(time_in_queue.ToMicroseconds());
+  if (trace_->sampled()) {
+    trace_->RecordStage(TraceStage::kRpcQueue, time_in_queue);
+  }
 }
 
 MonoDelta InboundCall::GetTimeInQueue() const {
@@ -70,6 +70,7 @@
 #include "yb/util/rolling_log.h"
 #include "yb/util/spinlock_profiling.h"
 #include "yb/util/thread.h"
+#include "yb/util/trace.h"
 #include "yb/util/version_info.h"
 
 DEFINE_int32(num_reactor_threads, -1,
@@ -183,6 +184,7 @@ Status RpcServerBase::Init() {
   glog_metrics_.reset(new ScopedGLogMetrics(metric_entity_));
   tcmalloc::RegisterMetrics(metric_entity_);
   RegisterSpinLockContentionMetrics(metric_entity_);
+  RegisterTraceStageMetrics(metric_entity_);
 
   InitSpinLockContentionProfiling();
 
@@ -0,0 +1,158 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/tablet/index_update_batcher.h"
+
+#include <iterator>
+#include <unordered_map>
+
+#include "yb/client/client.h"
+#include "yb/client/yb_op.h"
+
+#include "yb/util/flag_tags.h"
+
+DEFINE_int32(index_update_max_concurrent_flushes, 2,
+             "Max number of concurrent flushes of secondary index updates per tablet. Index "
+             "updates of write operations that arrive while this number of flushes is in "
+             "progress are sent together in the next flush.");
+TAG_FLAG(index_update_max_concurrent_flushes, advanced);
+TAG_FLAG(index_update_max_concurrent_flushes, runtime);
+
+DEFINE_int32(index_update_max_batch_ops, 1024,
+             "Max number of secondary index updates sent in a single flush. Write operations "
+             "whose updates do not fit wait for the next flush, unless their updates alone "
+             "exceed the limit.");
+TAG_FLAG(index_update_max_batch_ops, advanced);
+TAG_FLAG(index_update_max_batch_ops, runtime);
+
+DEFINE_test_flag(bool, index_update_fail_apply_in_tests, false,
+                 "Fail adding index updates to the session, to test the failure path.");
+
+namespace yb {
+namespace tablet {
+
+IndexUpdateBatcher::IndexUpdateBatcher(client::YBClientPtr client) : client_(std::move(client)) {
+}
+
+IndexUpdateBatcher::~IndexUpdateBatcher() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  LOG_IF(DFATAL, !pending_.empty() || running_flushes_ != 0)
+      << "Destroying index update batcher with " << pending_.size() << " pending updates and "
+      << running_flushes_ << " running flushes";
+}
+
+void IndexUpdateBatcher::Apply(
+    std::vector<client::YBqlWriteOpPtr> ops, StdStatusCallback callback) {
+  Entries entries;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_.push_back(Entry{std::move(ops), std::move(callback)});
+    if (running_flushes_ >= std::max(FLAGS_index_update_max_concurrent_flushes, 1)) {
+      return;
+    }
+    ++running_flushes_;
+    entries = TakePendingUnlocked();
+  }
+  Flush(std::move(entries));
+}
+
+IndexUpdateBatcher::Entries IndexUpdateBatcher::TakePendingUnlocked() {
+  const auto max_ops = static_cast<size_t>(std::max(FLAGS_index_update_max_batch_ops, 1));
+  size_t num_ops = 0;
+  auto end = pending_.begin();
+  // Always take at least one entry, so write operations with many index updates still make
+  // progress.
+  while (end != pending_.end() &&
+         (end == pending_.begin() || num_ops + end->ops.size() <= max_ops)) {
+    num_ops += end->ops.size();
+    ++end;
+  }
+  Entries result(std::make_move_iterator(pending_.begin()), std::make_move_iterator(end));
+  pending_.erase(pending_.begin(), end);
+  return result;
+}
+
+void IndexUpdateBatcher::Flush(Entries entries) {
+  VLOG(3) << "Flushing index updates of " << entries.size() << " write operations";
+  num_flushes_.fetch_add(1, std::memory_order_acq_rel);
+
+  auto session = std::make_shared<client::YBSession>(client_);
+  auto shared_entries = std::make_shared<Entries>(std::move(entries));
+  for (auto& entry : *shared_entries) {
+    for (const auto& op : entry.ops) {
+      auto status = PREDICT_FALSE(FLAGS_index_update_fail_apply_in_tests)
+          ? STATUS(IllegalState, "Failed to apply index update in tests")
+          : session->Apply(op);
+      if (!status.ok()) {
+        // Ops that were already applied are flushed anyway, but the operation fails.
+        entry.callback(status);
+        entry.callback = nullptr;
+        break;
+      }
+    }
+  }
+
+  session->FlushAsync([self = shared_from_this(), session, shared_entries](const Status& status) {
+    self->FlushDone(session, shared_entries.get(), status);
+  });
+}
+
+void IndexUpdateBatcher::FlushDone(
+    const client::YBSessionPtr& session, Entries* entries, const Status& status) {
+  std::vector<Status> statuses(entries->size(), status);
+  // When any error occurs during the dispatching of YBOperation, YBSession saves the error and
+  // returns IOError. When it happens, attribute errors to the operations that caused them.
+  if (status.IsIOError()) {
+    std::unordered_map<const client::YBOperation*, size_t> op_to_entry;
+    for (size_t i = 0; i != entries->size(); ++i) {
+      statuses[i] = Status::OK();
+      for (const auto& op : (*entries)[i].ops) {
+        op_to_entry.emplace(op.get(), i);
+      }
+    }
+    for (const auto& error : session->GetPendingErrors()) {
+      auto it = op_to_entry.find(&error->failed_op());
+      if (it == op_to_entry.end()) {
+        LOG(DFATAL) << "Error for unknown index update: " << error->status();
+        continue;
+      }
+      // Report just the first error seen.
+      if (statuses[it->second].ok()) {
+        statuses[it->second] = error->status();
+      }
+    }
+  }
+
+  Entries next_entries;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (pending_.empty()) {
+      --running_flushes_;
+    } else {
+      next_entries = TakePendingUnlocked();
+    }
+  }
+  if (!next_entries.empty()) {
+    Flush(std::move(next_entries));
+  }
+
+  for (size_t i = 0; i != entries->size(); ++i) {
+    auto& callback = (*entries)[i].callback;
+    if (callback) {
+      callback(statuses[i]);
+    }
+  }
+}
+
+} // namespace tablet
+} // namespace yb
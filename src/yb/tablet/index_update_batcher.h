@@ -0,0 +1,78 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_TABLET_INDEX_UPDATE_BATCHER_H
+#define YB_TABLET_INDEX_UPDATE_BATCHER_H
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "yb/client/client_fwd.h"
+
+#include "yb/util/status.h"
+#include "yb/util/status_callback.h"
+
+namespace yb {
+namespace tablet {
+
+// Coalesces non-transactional secondary index updates of concurrent write operations of a tablet
+// into shared YBSession flushes, so the client batcher sends a single RPC per index tablet for
+// all of them.
+//
+// Updates are sent immediately when less than --index_update_max_concurrent_flushes flushes are in
+// progress. Otherwise they are accumulated and sent together when one of the flushes completes.
+// A single flush takes at most --index_update_max_batch_ops ops, the rest wait for the next one.
+class IndexUpdateBatcher : public std::enable_shared_from_this<IndexUpdateBatcher> {
+ public:
+  explicit IndexUpdateBatcher(client::YBClientPtr client);
+
+  ~IndexUpdateBatcher();
+
+  // Sends index write ops, callback is invoked with the first error of those ops, or with OK
+  // status when all of them were applied.
+  void Apply(std::vector<client::YBqlWriteOpPtr> ops, StdStatusCallback callback);
+
+  size_t TEST_num_flushes() const {
+    return num_flushes_.load(std::memory_order_acquire);
+  }
+
+ private:
+  struct Entry {
+    std::vector<client::YBqlWriteOpPtr> ops;
+    StdStatusCallback callback;
+  };
+
+  typedef std::vector<Entry> Entries;
+
+  // Takes pending entries for the next flush, up to --index_update_max_batch_ops ops.
+  Entries TakePendingUnlocked();
+
+  void Flush(Entries entries);
+  void FlushDone(const client::YBSessionPtr& session, Entries* entries, const Status& status);
+
+  client::YBClientPtr client_;
+
+  std::mutex mutex_;
+  std::deque<Entry> pending_;
+  int running_flushes_ = 0;
+
+  std::atomic<size_t> num_flushes_{0};
+};
+
+} // namespace tablet
+} // namespace yb
+
+#endif // YB_TABLET_INDEX_UPDATE_BATCHER_H
@@ -217,6 +217,9 @@ Status OperationDriver::PrepareAndStart() {
   if (operation_) {
     RETURN_NOT_OK(operation_->Prepare());
   }
+  if (trace_->sampled()) {
+    trace_->RecordStage(TraceStage::kPrepare, MonoTime::Now() - start_time_);
+  }
 
   // Only take the lock long enough to take a local copy of the
   // replication state and set our prepare state. This ensures that
@@ -257,6 +260,7 @@ Status OperationDriver::PrepareAndStart() {
   switch (repl_state_copy) {
     case NOT_REPLICATING:
     {
+      replicate_stage_timer_.Start(trace_.get());
       {
         std::lock_guard<simple_spinlock> lock(lock_);
         replication_state_ = REPLICATING;
@@ -368,6 +372,7 @@ void OperationDriver::ReplicationFinished(const Status& status) {
   // the operation, i.e. ApplyTask() will never be called and the operation will never be applied to
   // the tablet.
   if (prepare_state_copy == PREPARED) {
+    replicate_stage_timer_.Finish();
     // We likely need to do cleanup if this fails so for now just
     // CHECK_OK
     CHECK_OK(ApplyOperation());
@@ -436,7 +441,10 @@ void OperationDriver::ApplyTask() {
   scoped_refptr<OperationDriver> ref(this);
 
   {
-    CHECK_OK(operation_->Apply());
+    {
+      ScopedTraceStage apply_stage(TraceStage::kApply);
+      CHECK_OK(operation_->Apply());
+    }
 
     operation_->PreCommit();
 
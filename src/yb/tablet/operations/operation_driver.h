@@ -288,6 +288,9 @@ class OperationDriver : public RefCountedThreadSafe<OperationDriver>,
   // This is used for debugging only, not any actual operation ordering.
   MicrosecondsInt64 prepare_physical_hybrid_time_;
 
+  // Measures replication of leader operations, from preparation until ReplicationFinished.
+  TraceStageTimer replicate_stage_timer_{TraceStage::kReplicate};
+
   TableType table_type_;
 
   MvccManager* mvcc_ = nullptr;
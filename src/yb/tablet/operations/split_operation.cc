@@ -0,0 +1,83 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/tablet/operations/split_operation.h"
+
+#include <glog/logging.h>
+
+#include "yb/server/hybrid_clock.h"
+#include "yb/tablet/tablet.h"
+#include "yb/tserver/tserver_admin.pb.h"
+#include "yb/util/trace.h"
+
+namespace yb {
+namespace tablet {
+
+using consensus::ReplicateMsg;
+using consensus::SPLIT_OP;
+using consensus::DriverType;
+using strings::Substitute;
+
+string SplitOperationState::ToString() const {
+  return Format("SplitOperationState [hybrid_time=$0, request=$1]",
+                hybrid_time_even_if_unset(),
+                request_ ? request_->ShortDebugString() : "<NULL>");
+}
+
+SplitOperation::SplitOperation(std::unique_ptr<SplitOperationState> state, DriverType type)
+    : Operation(std::move(state), type, OperationType::kSplit) {
+}
+
+consensus::ReplicateMsgPtr SplitOperation::NewReplicateMsg() {
+  auto result = std::make_shared<ReplicateMsg>();
+  result->set_op_type(SPLIT_OP);
+  result->mutable_split_request()->CopyFrom(*state()->request());
+  return result;
+}
+
+Status SplitOperation::Prepare() {
+  // Writes prepared after this point would be replicated after the split operation, so the leader
+  // stops accepting them. Followers set the flag as well, so that they reject writes in case they
+  // become leaders before the split is applied.
+  state()->tablet()->SetSplitRequested(true);
+  return Status::OK();
+}
+
+void SplitOperation::DoStart() {
+  state()->TrySetHybridTimeFromClock();
+
+  TRACE("START SPLIT: hybrid time: $0",
+        server::HybridClock::GetPhysicalValueMicros(state()->hybrid_time()));
+}
+
+Status SplitOperation::Apply() {
+  TRACE("APPLY SPLIT: started");
+
+  RETURN_NOT_OK(state()->tablet()->ApplySplit(state()));
+
+  TRACE("APPLY SPLIT: finished");
+  return Status::OK();
+}
+
+void SplitOperation::Finish(OperationResult result) {
+  if (result == Operation::ABORTED) {
+    state()->tablet()->SetSplitRequested(false);
+  }
+}
+
+string SplitOperation::ToString() const {
+  return Substitute("SplitOperation [state=$0]", state()->ToString());
+}
+
+}  // namespace tablet
+}  // namespace yb
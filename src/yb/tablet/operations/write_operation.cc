@@ -86,6 +86,12 @@ consensus::ReplicateMsgPtr WriteOperation::NewReplicateMsg() {
 
 Status WriteOperation::Prepare() {
   TRACE_EVENT0("txn", "WriteOperation::Prepare");
+  if (type() == consensus::LEADER && state()->tablet()->split_requested()) {
+    // The write would be replicated after the split operation, so it would be lost.
+    auto status = STATUS(IllegalState, "Tablet split has been requested");
+    state()->completion_callback()->set_error(status, tserver::TabletServerErrorPB::TABLET_SPLIT);
+    return status;
+  }
   return Status::OK();
 }
 
@@ -174,6 +180,23 @@ void WriteOperation::DoStartSynchronization(const Status& status) {
   context_.StartExecution(std::move(self));
 }
 
+void WriteOperation::SaveRequestForRestart() {
+  request_for_restart_ = std::make_unique<WriteRequestPB>(*request());
+}
+
+void WriteOperation::PrepareForRestart() {
+  DCHECK(can_restart());
+  // Doc operations refer to the responses, so they are dropped first.
+  doc_ops_.clear();
+  restart_read_ht_ = HybridTime();
+  conflict_blockers_.clear();
+  request()->CopyFrom(*request_for_restart_);
+  auto* response = state()->response();
+  response->clear_redis_response_batch();
+  response->clear_ql_response_batch();
+  response->clear_pgsql_response_batch();
+}
+
 WriteOperationState::WriteOperationState(Tablet* tablet,
                                          const tserver::WriteRequestPB *request,
                                          tserver::WriteResponsePB *response)
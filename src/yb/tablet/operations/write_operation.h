@@ -41,6 +41,7 @@
 #include "yb/rocksdb/write_batch.h"
 
 #include "yb/common/schema.h"
+#include "yb/common/transaction.h"
 
 #include "yb/docdb/doc_operation.h"
 #include "yb/docdb/shared_lock_manager_fwd.h"
@@ -270,6 +271,30 @@ class WriteOperation : public Operation {
     return doc_ops_;
   }
 
+  // Keeps a copy of the request, so the operation could be restarted after waiting for
+  // conflicting transactions.
+  void SaveRequestForRestart();
+
+  bool can_restart() const {
+    return request_for_restart_ != nullptr;
+  }
+
+  // Restores the request saved by SaveRequestForRestart and drops results of the previous attempt.
+  void PrepareForRestart();
+
+  // Higher priority transactions that this operation should wait for before it is restarted.
+  TransactionIdSet& conflict_blockers() {
+    return conflict_blockers_;
+  }
+
+  MonoTime conflict_wait_deadline() const {
+    return conflict_wait_deadline_;
+  }
+
+  void set_conflict_wait_deadline(MonoTime value) {
+    conflict_wait_deadline_ = value;
+  }
+
   static void StartSynchronization(
       std::unique_ptr<WriteOperation> operation, const Status& status) {
     // We release here, because DoStartSynchronization takes ownership on this.
@@ -291,6 +316,11 @@ class WriteOperation : public Operation {
 
   docdb::DocOperations doc_ops_;
 
+  std::unique_ptr<tserver::WriteRequestPB> request_for_restart_;
+  TransactionIdSet conflict_blockers_;
+  // Time after which the operation stops waiting for conflicting transactions.
+  MonoTime conflict_wait_deadline_;
+
   Tablet* tablet() { return state()->tablet(); }
 
   DISALLOW_COPY_AND_ASSIGN(WriteOperation);
@@ -197,9 +197,11 @@ void PreparerImpl::ProcessItem(OperationDriver* item) {
     // AlterSchemaOperation::Prepare calls Tablet::CreatePreparedAlterSchema, which acquires the
     // schema lock. Because of this, we must not attempt to process two AlterSchemaOperations in
     // one batch, otherwise we'll deadlock. Furthermore, for simplicity, we choose to process each
-    // AlterSchemaOperation in a batch of its own.
+    // AlterSchemaOperation in a batch of its own. SplitOperation gets its own batch too, so that
+    // every write that follows it in the log is prepared after the tablet stops accepting writes.
     auto operation_type = item->operation_type();
     const bool apply_separately = operation_type == OperationType::kAlterSchema ||
+                                  operation_type == OperationType::kSplit ||
                                   operation_type == OperationType::kEmpty;
     const int64_t bound_term = apply_separately ? -1 : item->consensus_round()->bound_term();
 
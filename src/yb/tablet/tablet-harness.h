@@ -92,6 +92,7 @@ class TabletHarness {
     string root_dir;
     TableType table_type;
     bool enable_metrics;
+    TabletOptions tablet_options;
   };
 
   TabletHarness(const Schema& schema, Options options)
@@ -126,14 +127,13 @@ class TabletHarness {
     }
 
     clock_ = server::LogicalClock::CreateStartingAt(HybridTime::kInitial);
-    TabletOptions tablet_options;
     tablet_.reset(new TabletClass(metadata,
                                   std::shared_future<client::YBClientPtr>(),
                                   clock_,
                                   std::shared_ptr<MemTracker>(),
                                   metrics_registry_.get(),
                                   new log::LogAnchorRegistry(),
-                                  tablet_options,
+                                  options_.tablet_options,
                                   nullptr /* transaction_participant_context */,
                                   client::LocalTabletFilter(),
                                   nullptr /* transaction_coordinator_context */));
@@ -48,6 +48,7 @@ void YBTabletTest::CreateTestTablet(const std::string& root_dir) {
   string dir = root_dir.empty() ? GetTestPath("fs_root") : root_dir;
   TabletHarness::Options opts(dir);
   opts.enable_metrics = true;
+  opts.tablet_options = tablet_options_;
   opts.table_type = table_type_;
   bool first_time = harness_ == NULL;
   harness_.reset(new TabletHarness(schema_, opts));
@@ -101,6 +101,8 @@ class YBTabletTest : public YBTest {
   const Schema schema_;
   const Schema client_schema_;
   TableType table_type_;
+  // Options the tablet is created with by CreateTestTablet.
+  TabletOptions tablet_options_;
 
   std::unique_ptr<TabletHarness> harness_;
 };
@@ -32,6 +32,9 @@
 
 #include <time.h>
 
+#include <atomic>
+#include <thread>
+
 #include <glog/logging.h>
 
 #include "yb/common/row.h"
@@ -44,6 +47,7 @@
 #include "yb/tablet/tablet-test-base.h"
 #include "yb/util/slice.h"
 #include "yb/util/test_macros.h"
+#include "yb/util/threadpool.h"
 
 // Include client header so we can access YBTableType.
 #include "yb/client/client.h"
@@ -61,6 +65,23 @@ using fs::ReadableBlock;
 DEFINE_int32(testiterator_num_inserts, 1000,
              "Number of rows inserted in TestRowIterator/TestInsert");
 
+DEFINE_int32(test_active_readers_max_threads, 64,
+             "Max number of concurrent readers in TestActiveReadersScaling");
+
+DEFINE_int32(test_active_readers_duration_ms, 100,
+             "Time spent on each number of concurrent readers in TestActiveReadersScaling");
+
+DEFINE_int32(test_memtable_insert_batch_size, 2000,
+             "Number of rows in a write batch in TestParallelMemtableInsert");
+
+DEFINE_int32(test_memtable_insert_num_batches, 100,
+             "Number of write batches written with each number of parts in "
+             "TestParallelMemtableInsert");
+
+DECLARE_bool(rocksdb_allow_concurrent_memtable_write);
+DECLARE_int32(tablet_memtable_insert_part_min_kv_pairs);
+DECLARE_int32(tablet_memtable_insert_max_parts);
+
 static_assert(to_underlying(TableType::YQL_TABLE_TYPE) ==
                   to_underlying(client::YBTableType::YQL_TABLE_TYPE),
               "Numeric code for YQL_TABLE_TYPE table type must be consistent");
@@ -214,5 +235,102 @@ TYPED_TEST(TestTablet, TestFlushedOpId) {
   ASSERT_EQ(id.index, start_index + 2*kCount);
 }
 
+// Readers may be unregistered by a different thread than the one that registered them, and the
+// oldest read point should cover readers of all threads.
+TYPED_TEST(TestTablet, TestActiveReaders) {
+  auto tablet = this->tablet().get();
+  AbstractTablet* readers = tablet;
+  const HybridTime now = tablet->clock()->Now();
+  const HybridTime older(now.ToUint64() - 10);
+
+  readers->RegisterReaderTimestamp(now);
+  std::thread([readers, older] { readers->RegisterReaderTimestamp(older); }).join();
+  ASSERT_EQ(older, tablet->OldestReadPoint());
+
+  readers->UnregisterReader(older);
+  ASSERT_EQ(now, tablet->OldestReadPoint());
+
+  std::thread([readers, now] { readers->UnregisterReader(now); }).join();
+  ASSERT_EQ(tablet->mvcc_manager()->LastReplicatedHybridTime(), tablet->OldestReadPoint());
+}
+
+// Measures read operation registration throughput with a growing number of concurrent readers.
+TYPED_TEST(TestTablet, TestActiveReadersScaling) {
+  auto tablet = this->tablet().get();
+  for (int num_threads = 1; num_threads <= FLAGS_test_active_readers_max_threads;
+       num_threads *= 2) {
+    std::atomic<bool> stop(false);
+    std::atomic<int64_t> num_reads(0);
+    std::vector<std::thread> threads;
+    for (int i = 0; i != num_threads; ++i) {
+      threads.emplace_back([tablet, &stop, &num_reads] {
+        int64_t reads = 0;
+        while (!stop.load(std::memory_order_acquire)) {
+          ScopedReadOperation read_operation(
+              tablet, RequireLease::kFalse, ReadHybridTime::SingleTime(tablet->clock()->Now()));
+          ++reads;
+        }
+        num_reads += reads;
+      });
+    }
+    std::this_thread::sleep_for(
+        std::chrono::milliseconds(FLAGS_test_active_readers_duration_ms));
+    const HybridTime oldest_read_point = tablet->OldestReadPoint();
+    stop.store(true, std::memory_order_release);
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    ASSERT_TRUE(oldest_read_point.is_valid());
+    LOG(INFO) << num_threads << " threads: "
+              << num_reads * 1000 / FLAGS_test_active_readers_duration_ms << " reads/s";
+  }
+  ASSERT_EQ(tablet->mvcc_manager()->LastReplicatedHybridTime(), tablet->OldestReadPoint());
+}
+
+// Measures write throughput with large write batches split into a growing number of parts that
+// are inserted into the memtable concurrently, and checks that the op id is flushed correctly.
+// Reported rates are of the whole tablet write path, not of the memtable insertion alone.
+TYPED_TEST(TestTablet, TestParallelMemtableInsert) {
+  FLAGS_rocksdb_allow_concurrent_memtable_write = true;
+  FLAGS_tablet_memtable_insert_part_min_kv_pairs = 16;
+  std::unique_ptr<ThreadPool> pool;
+  ASSERT_OK(ThreadPoolBuilder("memtable-insert").set_max_queue_size(0).Build(&pool));
+  this->tablet_options_.memtable_insert_pool = std::move(pool);
+  this->TabletReOpen();
+
+  auto tablet = this->tablet().get();
+  LocalTabletWriter writer(tablet);
+  ASSERT_OK(this->InsertTestRow(&writer, 0, 0));
+  ASSERT_OK(tablet->Flush(FlushMode::kSync));
+  const int64_t start_index = ASSERT_RESULT(tablet->MaxPersistentOpId()).regular.index;
+
+  // The same keys are rewritten by every batch, because key space of some setups is small.
+  const int batch_size = static_cast<int>(std::min<uint64_t>(
+      FLAGS_test_memtable_insert_batch_size, this->setup_.GetMaxRows()));
+  int64_t num_batches = 0;
+  // Batches are not split into 2 parts.
+  for (int max_parts : {1, 3, 4, 8}) {
+    FLAGS_tablet_memtable_insert_max_parts = max_parts;
+    auto start = MonoTime::Now();
+    for (int i = 0; i != FLAGS_test_memtable_insert_num_batches; ++i) {
+      LocalTabletWriter::Batch batch;
+      for (int key = 0; key != batch_size; ++key) {
+        this->setup_.BuildRow(batch.Add(), key, max_parts);
+      }
+      ASSERT_OK(writer.WriteBatch(&batch));
+      ++num_batches;
+    }
+    auto passed = MonoTime::Now() - start;
+    LOG(INFO) << max_parts << " parts: "
+              << batch_size * FLAGS_test_memtable_insert_num_batches / passed.ToSeconds()
+              << " rows/s";
+  }
+
+  this->VerifyTestRows(0, batch_size);
+  ASSERT_OK(tablet->Flush(FlushMode::kSync));
+  const int64_t flushed_index = ASSERT_RESULT(tablet->MaxPersistentOpId()).regular.index;
+  ASSERT_EQ(start_index + num_batches, flushed_index);
+}
+
 } // namespace tablet
 } // namespace yb
@@ -38,6 +38,7 @@
 #include <memory>
 #include <mutex>
 #include <ostream>
+#include <thread>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -86,16 +87,20 @@
 #include "yb/rocksutil/yb_rocksdb_logger.h"
 #include "yb/server/hybrid_clock.h"
 
+#include "yb/tablet/index_update_batcher.h"
 #include "yb/tablet/maintenance_manager.h"
 #include "yb/tablet/tablet_metrics.h"
 #include "yb/tablet/tablet_retention_policy.h"
 #include "yb/tablet/transaction_coordinator.h"
 #include "yb/tablet/transaction_participant.h"
 #include "yb/tablet/operations/alter_schema_operation.h"
+#include "yb/tablet/operations/split_operation.h"
 #include "yb/tablet/operations/truncate_operation.h"
 #include "yb/tablet/operations/write_operation.h"
 #include "yb/tablet/tablet_options.h"
+#include "yb/tablet/tablet_splitter.h"
 #include "yb/util/bloom_filter.h"
+#include "yb/util/countdown_latch.h"
 #include "yb/util/debug/trace_event.h"
 #include "yb/util/enums.h"
 #include "yb/util/env.h"
@@ -106,6 +111,7 @@
 #include "yb/util/metrics.h"
 #include "yb/util/slice.h"
 #include "yb/util/stopwatch.h"
+#include "yb/util/threadpool.h"
 #include "yb/util/trace.h"
 #include "yb/util/url-coding.h"
 
@@ -141,6 +147,44 @@ DEFINE_int32(intents_flush_max_delay_ms, 2000,
              "Max time to wait for regular db to flush during flush of intents. "
              "After this time flush of regular db will be forced.");
 
+DEFINE_int32(txn_max_apply_batch_records, 100000,
+             "Max number of intents applied in a single write batch. Bigger transactions are "
+             "applied in several batches. 0 means no limit.");
+TAG_FLAG(txn_max_apply_batch_records, advanced);
+TAG_FLAG(txn_max_apply_batch_records, runtime);
+
+DEFINE_test_flag(int32, txn_apply_stop_after_batches_in_tests, 0,
+                 "Stop applying a transaction after this number of batches, leaving the rest of "
+                 "its intents in place as if the tablet server crashed. 0 means never stop.");
+
+DEFINE_int32(tablet_memtable_insert_part_min_kv_pairs, 128,
+             "Min number of key value pairs in a part of a non-transactional write batch, when "
+             "the batch is split into parts that are inserted into the memtable concurrently. "
+             "Used only when rocksdb_allow_concurrent_memtable_write is set.");
+TAG_FLAG(tablet_memtable_insert_part_min_kv_pairs, advanced);
+TAG_FLAG(tablet_memtable_insert_part_min_kv_pairs, runtime);
+
+DEFINE_int32(tablet_memtable_insert_max_parts, 4,
+             "Max number of parts a non-transactional write batch is split into for concurrent "
+             "memtable insertion. Batches are not split into less than 3 parts, so values below 3 "
+             "disable splitting.");
+TAG_FLAG(tablet_memtable_insert_max_parts, advanced);
+TAG_FLAG(tablet_memtable_insert_max_parts, runtime);
+
+DEFINE_int32(transaction_conflict_wait_ms, 0,
+             "Maximum time in milliseconds a write of a transaction waits for conflicting "
+             "transactions with higher priority to commit or abort before failing with a "
+             "conflict. The write does not hold its locks while it waits, and never waits past "
+             "its own deadline. If set to zero, the conflict is reported immediately.");
+TAG_FLAG(transaction_conflict_wait_ms, evolving);
+TAG_FLAG(transaction_conflict_wait_ms, runtime);
+
+DEFINE_int32(transaction_conflict_wait_poll_ms, 100,
+             "While waiting for conflicting transactions, how often in milliseconds the write "
+             "runs conflict resolution again, in case this tablet was not notified about their "
+             "completion.");
+TAG_FLAG(transaction_conflict_wait_poll_ms, advanced);
+
 using namespace std::placeholders;
 
 using std::shared_ptr;
@@ -356,6 +400,7 @@ Tablet::Tablet(
   // Create index table metadata cache for secondary index update.
   if (!metadata_->index_map().empty()) {
     metadata_cache_.emplace(client_future_.get());
+    index_update_batcher_ = std::make_shared<IndexUpdateBatcher>(client_future_.get());
   }
 
   // If this is a unique index tablet, set up the index primary key schema.
@@ -473,7 +518,8 @@ std::string Tablet::LogPrefix() const {
 
 Status Tablet::OpenKeyValueTablet() {
   rocksdb::Options rocksdb_options;
-  docdb::InitRocksDBOptions(&rocksdb_options, tablet_id(), rocksdb_statistics_, tablet_options_);
+  docdb::InitRocksDBOptions(&rocksdb_options, tablet_id(), rocksdb_statistics_, tablet_options_,
+                            metadata_->schema().table_properties());
 
   // Install the history cleanup handler. Note that TabletRetentionPolicy is going to hold a raw ptr
   // to this tablet. So, we ensure that rocksdb_ is reset before this tablet gets destroyed.
@@ -619,6 +665,25 @@ void Tablet::ApplyRowOperations(WriteOperationState* operation_state) {
   ApplyKeyValueRowOperations(put_batch, &frontiers, operation_state->hybrid_time());
 }
 
+bool Tablet::PrepareReplayedRowOperations(
+    const WriteOperationState& operation_state, rocksdb::WriteBatch* write_batch) {
+  const KeyValueWriteBatchPB& put_batch = operation_state.request()->write_batch();
+  if (put_batch.has_transaction()) {
+    return false;
+  }
+  last_committed_write_index_.store(operation_state.op_id().index(), std::memory_order_release);
+  if (put_batch.kv_pairs_size() != 0) {
+    PrepareNonTransactionWriteBatch(put_batch, operation_state.hybrid_time(), write_batch);
+  }
+  return true;
+}
+
+void Tablet::WriteReplayedBatch(const docdb::ConsensusFrontiers& frontiers,
+                                HybridTime hybrid_time,
+                                rocksdb::WriteBatch* write_batch) {
+  WriteBatch(&frontiers, hybrid_time, write_batch, regular_db_.get());
+}
+
 Status Tablet::CreateCheckpoint(const std::string& dir) {
   ScopedPendingOperation scoped_read_operation(&pending_op_counter_);
   RETURN_NOT_OK(scoped_read_operation);
@@ -701,11 +766,71 @@ void Tablet::ApplyKeyValueRowOperations(const KeyValueWriteBatchPB& put_batch,
     PrepareTransactionWriteBatch(put_batch, hybrid_time, &write_batch);
     WriteBatch(frontiers, hybrid_time, &write_batch, intents_db_.get());
   } else {
+    const int num_parts = NumMemtableInsertParts(put_batch.kv_pairs_size());
+    if (num_parts > 1) {
+      WriteNonTransactionBatchInParts(put_batch, frontiers, hybrid_time, num_parts);
+      return;
+    }
     PrepareNonTransactionWriteBatch(put_batch, hybrid_time, &write_batch);
     WriteBatch(frontiers, hybrid_time, &write_batch, regular_db_.get());
   }
 }
 
+int Tablet::NumMemtableInsertParts(int num_kv_pairs) const {
+  if (!tablet_options_.memtable_insert_pool) {
+    return 1;
+  }
+  const int part_min_kv_pairs = std::max(FLAGS_tablet_memtable_insert_part_min_kv_pairs, 1);
+  const int num_parts =
+      std::min(num_kv_pairs / part_min_kv_pairs, FLAGS_tablet_memtable_insert_max_parts);
+  // The last part is written after all others, so there is nothing to write concurrently with the
+  // first part unless there are at least 3 parts.
+  return num_parts >= 3 ? num_parts : 1;
+}
+
+// All parts but the last one are prepared and written concurrently, so RocksDB inserts them into
+// the memtable in parallel. They carry only the hybrid time of the operation. The last part is
+// written after all others were written and carries the op id, so if the op id is flushed, then
+// the whole batch is flushed. Otherwise the operation is replayed during bootstrap, and that is
+// idempotent because keys of parts are the same as keys of the whole batch.
+//
+// The pool does not queue tasks, so when all its threads are busy with parts of other batches, a
+// part is written inline instead of waiting for a thread.
+void Tablet::WriteNonTransactionBatchInParts(const KeyValueWriteBatchPB& put_batch,
+                                             const rocksdb::UserFrontiers* frontiers,
+                                             HybridTime hybrid_time,
+                                             int num_parts) {
+  docdb::ConsensusFrontiers partial_frontiers;
+  set_hybrid_time(hybrid_time, &partial_frontiers);
+
+  const int num_kv_pairs = put_batch.kv_pairs_size();
+  auto write_part = [this, &put_batch, hybrid_time, num_kv_pairs, num_parts](
+      int part, const rocksdb::UserFrontiers* part_frontiers) {
+    rocksdb::WriteBatch write_batch;
+    docdb::PrepareNonTransactionWriteBatch(
+        put_batch, num_kv_pairs * part / num_parts, num_kv_pairs * (part + 1) / num_parts,
+        hybrid_time, &write_batch);
+    WriteBatch(part_frontiers, hybrid_time, &write_batch, regular_db_.get());
+  };
+
+  CountDownLatch latch(num_parts - 2);
+  for (int part = 1; part < num_parts - 1; ++part) {
+    auto task = [&write_part, &partial_frontiers, &latch, part] {
+      write_part(part, &partial_frontiers);
+      latch.CountDown();
+    };
+    auto status = tablet_options_.memtable_insert_pool->SubmitFunc(task);
+    if (!status.ok()) {
+      VLOG_WITH_PREFIX(3) << "Writing part " << part << " inline: " << status;
+      task();
+    }
+  }
+  write_part(0, &partial_frontiers);
+  latch.Wait();
+
+  write_part(num_parts - 1, frontiers);
+}
+
 void Tablet::WriteBatch(const rocksdb::UserFrontiers* frontiers,
                         HybridTime hybrid_time,
                         rocksdb::WriteBatch* write_batch,
@@ -787,6 +912,7 @@ Status Tablet::HandleRedisReadRequest(MonoTime deadline,
   RETURN_NOT_OK(scoped_read_operation);
 
   ScopedTabletMetricsTracker metrics_tracker(metrics_->redis_read_latency);
+  ScopedTraceStage trace_stage(TraceStage::kRocksDBRead);
 
   docdb::RedisReadOperation doc_op(
       redis_read_request, {regular_db_.get(), intents_db_.get()}, deadline, read_time);
@@ -806,6 +932,7 @@ Status Tablet::HandleQLReadRequest(
   ScopedPendingOperation scoped_read_operation(&pending_op_counter_);
   RETURN_NOT_OK(scoped_read_operation);
   ScopedTabletMetricsTracker metrics_tracker(metrics_->ql_read_latency);
+  ScopedTraceStage trace_stage(TraceStage::kRocksDBRead);
 
   if (metadata()->schema_version() != ql_read_request.schema_version()) {
     result->response.set_status(QLResponsePB::YQL_STATUS_SCHEMA_VERSION_MISMATCH);
@@ -815,6 +942,31 @@ Status Tablet::HandleQLReadRequest(
   Result<TransactionOperationContextOpt> txn_op_ctx =
       CreateTransactionOperationContext(transaction_metadata);
   RETURN_NOT_OK(txn_op_ctx);
+
+  // A tablet created by a split shares the data of the other half of its parent until it is
+  // compacted away, so scans are limited to the partition of the tablet.
+  if (ql_read_request.hashed_column_values().empty() && metadata_->split_op_id()) {
+    QLReadRequestPB bounded_request(ql_read_request);
+    const auto& partition = metadata_->partition();
+    if (!partition.partition_key_start().empty()) {
+      const auto start_hash_code =
+          PartitionSchema::DecodeMultiColumnHashValue(partition.partition_key_start());
+      if (!bounded_request.has_hash_code() || bounded_request.hash_code() < start_hash_code) {
+        bounded_request.set_hash_code(start_hash_code);
+      }
+    }
+    if (!partition.partition_key_end().empty()) {
+      // max_hash_code is inclusive.
+      const auto end_hash_code =
+          PartitionSchema::DecodeMultiColumnHashValue(partition.partition_key_end()) - 1;
+      if (!bounded_request.has_max_hash_code() || bounded_request.max_hash_code() > end_hash_code) {
+        bounded_request.set_max_hash_code(end_hash_code);
+      }
+    }
+    return AbstractTablet::HandleQLReadRequest(
+        deadline, read_time, bounded_request, *txn_op_ctx, result);
+  }
+
   return AbstractTablet::HandleQLReadRequest(
       deadline, read_time, ql_read_request, *txn_op_ctx, result);
 }
@@ -899,6 +1051,10 @@ void Tablet::KeyValueBatchFromQLWriteBatch(std::unique_ptr<WriteOperation> opera
     }
   }
   auto status = StartDocWriteOperation(operation.get());
+  if (status.ok() && !operation->conflict_blockers().empty()) {
+    WaitForConflictingTransactions(std::move(operation));
+    return;
+  }
   if (operation->restart_read_ht().is_valid()) {
     WriteOperation::StartSynchronization(std::move(operation), Status::OK());
     return;
@@ -942,7 +1098,7 @@ void Tablet::UpdateQLIndexes(std::unique_ptr<WriteOperation> operation) {
   YBClientPtr client;
   client::YBSessionPtr session;
   client::YBTransactionPtr txn;
-  std::vector<std::pair<std::shared_ptr<client::YBqlWriteOp>, QLWriteOperation*>> index_ops;
+  IndexOps index_ops;
   const ChildTransactionDataPB* child_transaction_data = nullptr;
   for (auto& doc_op : operation->doc_ops()) {
     auto* write_op = static_cast<QLWriteOperation*>(doc_op.get());
@@ -951,8 +1107,10 @@ void Tablet::UpdateQLIndexes(std::unique_ptr<WriteOperation> operation) {
     }
     if (!client) {
       client = client_future_.get();
-      session = std::make_shared<YBSession>(client);
       if (write_op->request().has_child_transaction_data()) {
+        // Transactional index updates are written in a child transaction of the write operation,
+        // so they could not be batched with updates of other operations.
+        session = std::make_shared<YBSession>(client);
         child_transaction_data = &write_op->request().child_transaction_data();
         if (!transaction_manager_) {
           auto status = STATUS(Corruption, "Transaction manager is not present for index update");
@@ -999,20 +1157,41 @@ void Tablet::UpdateQLIndexes(std::unique_ptr<WriteOperation> operation) {
       shared_ptr<client::YBqlWriteOp> index_op(index_table->NewQLWrite());
       index_op->mutable_request()->Swap(&pair.second);
       index_op->mutable_request()->MergeFrom(pair.second);
-      status = session->Apply(index_op);
-      if (!status.ok()) {
-        operation->state()->completion_callback()->CompleteWithStatus(status);
-        return;
+      if (session) {
+        status = session->Apply(index_op);
+        if (!status.ok()) {
+          operation->state()->completion_callback()->CompleteWithStatus(status);
+          return;
+        }
       }
       index_ops.emplace_back(std::move(index_op), write_op);
     }
   }
 
-  if (!session) {
+  if (index_ops.empty()) {
     CompleteQLWriteBatch(std::move(operation), Status::OK());
     return;
   }
 
+  if (!session) {
+    std::vector<client::YBqlWriteOpPtr> ops;
+    ops.reserve(index_ops.size());
+    for (const auto& pair : index_ops) {
+      ops.push_back(pair.first);
+    }
+    index_update_batcher_->Apply(
+        std::move(ops),
+        [this, op = operation.release(), index_ops = std::move(index_ops)](const Status& status) {
+      std::unique_ptr<WriteOperation> operation(op);
+      if (PREDICT_FALSE(!status.ok())) {
+        operation->state()->completion_callback()->CompleteWithStatus(status);
+        return;
+      }
+      CompleteQLIndexUpdates(std::move(operation), index_ops, nullptr /* child_result */);
+    });
+    return;
+  }
+
   session->FlushAsync(
       [this, op = operation.release(), session, txn, index_ops = std::move(index_ops)]
           (const Status& status) {
@@ -1032,34 +1211,35 @@ void Tablet::UpdateQLIndexes(std::unique_ptr<WriteOperation> operation) {
       return;
     }
 
-    ChildTransactionResultPB child_result;
-    if (txn) {
-      auto finish_result = txn->FinishChild();
-      if (!finish_result.ok()) {
-        operation->state()->completion_callback()->CompleteWithStatus(finish_result.status());
-        return;
-      }
-      child_result = std::move(*finish_result);
+    auto finish_result = txn->FinishChild();
+    if (!finish_result.ok()) {
+      operation->state()->completion_callback()->CompleteWithStatus(finish_result.status());
+      return;
     }
+    CompleteQLIndexUpdates(std::move(operation), index_ops, &*finish_result);
+  });
+}
 
-    // Check the responses of the index write ops.
-    for (const auto& pair : index_ops) {
-      shared_ptr<client::YBqlWriteOp> index_op = pair.first;
-      auto* response = pair.second->response();
-      DCHECK_ONLY_NOTNULL(response);
-      auto* index_response = index_op->mutable_response();
-
-      if (index_response->status() != QLResponsePB::YQL_STATUS_OK) {
-        response->set_status(index_response->status());
-        response->set_error_message(std::move(index_response->error_message()));
-      }
-      if (txn) {
-        *response->mutable_child_transaction_result() = child_result;
-      }
+void Tablet::CompleteQLIndexUpdates(std::unique_ptr<WriteOperation> operation,
+                                    const IndexOps& index_ops,
+                                    const ChildTransactionResultPB* child_result) {
+  // Check the responses of the index write ops.
+  for (const auto& pair : index_ops) {
+    shared_ptr<client::YBqlWriteOp> index_op = pair.first;
+    auto* response = pair.second->response();
+    DCHECK_ONLY_NOTNULL(response);
+    auto* index_response = index_op->mutable_response();
+
+    if (index_response->status() != QLResponsePB::YQL_STATUS_OK) {
+      response->set_status(index_response->status());
+      response->set_error_message(std::move(index_response->error_message()));
     }
+    if (child_result) {
+      *response->mutable_child_transaction_result() = *child_result;
+    }
+  }
 
-    CompleteQLWriteBatch(std::move(operation), Status::OK());
-  });
+  CompleteQLWriteBatch(std::move(operation), Status::OK());
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -1074,6 +1254,7 @@ Status Tablet::HandlePgsqlReadRequest(
   RETURN_NOT_OK(scoped_read_operation);
   // TODO(neil) Work on metrics for PGSQL.
   // ScopedTabletMetricsTracker metrics_tracker(metrics_->pgsql_read_latency);
+  ScopedTraceStage trace_stage(TraceStage::kRocksDBRead);
 
   if (metadata()->schema_version() != pgsql_read_request.schema_version()) {
     result->response.set_status(PgsqlResponsePB::PGSQL_STATUS_SCHEMA_VERSION_MISMATCH);
@@ -1141,7 +1322,7 @@ Status Tablet::KeyValueBatchFromPgsqlWriteBatch(WriteOperation* operation) {
     }
   }
   RETURN_NOT_OK(StartDocWriteOperation(operation));
-  if (operation->restart_read_ht().is_valid()) {
+  if (operation->restart_read_ht().is_valid() || !operation->conflict_blockers().empty()) {
     return Status::OK();
   }
   for (size_t i = 0; i < doc_ops.size(); i++) {
@@ -1160,6 +1341,12 @@ Status Tablet::KeyValueBatchFromPgsqlWriteBatch(WriteOperation* operation) {
 void Tablet::AcquireLocksAndPerformDocOperations(std::unique_ptr<WriteOperation> operation) {
   WriteRequestPB* key_value_write_request = operation->state()->mutable_request();
 
+  if (FLAGS_transaction_conflict_wait_ms > 0 && !operation->can_restart() &&
+      table_type_ != TableType::REDIS_TABLE_TYPE &&
+      key_value_write_request->write_batch().has_transaction()) {
+    operation->SaveRequestForRestart();
+  }
+
   switch (table_type_) {
     case TableType::REDIS_TABLE_TYPE: {
       auto status = KeyValueBatchFromRedisWriteBatch(operation.get());
@@ -1173,6 +1360,10 @@ void Tablet::AcquireLocksAndPerformDocOperations(std::unique_ptr<WriteOperation>
     }
     case TableType::PGSQL_TABLE_TYPE: {
       auto status = KeyValueBatchFromPgsqlWriteBatch(operation.get());
+      if (status.ok() && !operation->conflict_blockers().empty()) {
+        WaitForConflictingTransactions(std::move(operation));
+        return;
+      }
       WriteOperation::StartSynchronization(std::move(operation), status);
       return;
     }
@@ -1186,6 +1377,49 @@ void Tablet::AcquireLocksAndPerformDocOperations(std::unique_ptr<WriteOperation>
   FATAL_INVALID_ENUM_VALUE(TableType, table_type_);
 }
 
+void Tablet::WaitForConflictingTransactions(std::unique_ptr<WriteOperation> operation) {
+  // Keep the tablet from shutting down while the operation waits.
+  ScopedPendingOperation scoped_operation(&pending_op_counter_);
+  if (!scoped_operation.ok()) {
+    WriteOperation::StartSynchronization(std::move(operation), MoveStatus(scoped_operation));
+    return;
+  }
+  auto waiter = FullyDecodeTransactionId(
+      operation->request()->write_batch().transaction().transaction_id());
+  if (!waiter.ok()) {
+    WriteOperation::StartSynchronization(std::move(operation), waiter.status());
+    return;
+  }
+  auto deadline = MonoTime::Earliest(
+      operation->conflict_wait_deadline(),
+      MonoTime::Now() + MonoDelta::FromMilliseconds(FLAGS_transaction_conflict_wait_poll_ms));
+  auto blockers = std::move(operation->conflict_blockers());
+  operation->conflict_blockers().clear();
+
+  // std::function requires copyable functor, so the operation is shared with the callback.
+  auto waiting = std::make_shared<std::pair<std::unique_ptr<WriteOperation>,
+                                            ScopedPendingOperation>>(
+      std::move(operation), std::move(scoped_operation));
+  auto status = transaction_participant_->WaitForTransactions(
+      *waiter, blockers, deadline, [this, waiting](const Status& status) {
+        auto operation = std::move(waiting->first);
+        if (!status.ok()) {
+          WriteOperation::StartSynchronization(std::move(operation), status);
+          return;
+        }
+        VLOG_WITH_PREFIX(2) << "Restarting write after waiting for conflicting transactions: "
+                            << operation->ToString();
+        operation->PrepareForRestart();
+        AcquireLocksAndPerformDocOperations(std::move(operation));
+      });
+  if (!status.ok()) {
+    if (status.IsTryAgain()) {
+      metrics_->transaction_conflicts->Increment();
+    }
+    WriteOperation::StartSynchronization(std::move(waiting->first), status);
+  }
+}
+
 Status Tablet::Flush(FlushMode mode, FlushFlags flags) {
   TRACE_EVENT0("tablet", "Tablet::Flush");
 
@@ -1227,23 +1461,50 @@ Status Tablet::ImportData(const std::string& source_dir) {
 // We apply intents using by iterating over whole transaction reverse index.
 // Using value of reverse index record we find original intent record and apply it.
 // After that we delete both intent record and reverse index record.
+//
+// Big transactions are applied in batches of at most FLAGS_txn_max_apply_batch_records intents.
+// Only the last batch of regular records carries the op id of the apply, so the apply is replayed
+// during bootstrap unless it was completely flushed to regular DB. Intents are removed in the same
+// batches, so after a crash in the middle of the apply only intents that are still present are
+// replayed. Applied records keep the write id stored in the intent, so replay is idempotent.
 // TODO(dtxn) use separate thread for applying intents.
-// TODO(dtxn) use multiple batches when applying really big transaction.
 Status Tablet::ApplyIntents(const TransactionApplyData& data) {
-  rocksdb::WriteBatch regular_write_batch;
-  rocksdb::WriteBatch intents_write_batch;
-  RETURN_NOT_OK(docdb::PrepareApplyIntentsBatch(
-      data.transaction_id, data.commit_ht,
-      &regular_write_batch, intents_db_.get(), &intents_write_batch));
-
   // data.hybrid_time contains transaction commit time.
   // We don't set transaction field of put_batch, otherwise we would write another bunch of intents.
   docdb::ConsensusFrontiers frontiers;
   set_op_id({data.op_id.term(), data.op_id.index()}, &frontiers);
   set_hybrid_time(data.log_ht, &frontiers);
-  WriteBatch(&frontiers, data.commit_ht, &regular_write_batch, regular_db_.get());
-  WriteBatch(&frontiers, data.commit_ht, &intents_write_batch, intents_db_.get());
-  return Status::OK();
+
+  docdb::ConsensusFrontiers partial_frontiers;
+  set_hybrid_time(data.log_ht, &partial_frontiers);
+
+  const size_t max_records = std::max(FLAGS_txn_max_apply_batch_records, 0);
+  docdb::ApplyTransactionState apply_state;
+  int num_batches = 0;
+  for (;;) {
+    rocksdb::WriteBatch regular_write_batch;
+    rocksdb::WriteBatch intents_write_batch;
+    RETURN_NOT_OK(docdb::PrepareApplyIntentsBatch(
+        data.transaction_id, data.commit_ht,
+        &regular_write_batch, intents_db_.get(), &intents_write_batch, &apply_state,
+        max_records));
+
+    const bool last_batch = !apply_state.active();
+    WriteBatch(last_batch ? &frontiers : &partial_frontiers, data.commit_ht, &regular_write_batch,
+               regular_db_.get());
+    WriteBatch(&frontiers, data.commit_ht, &intents_write_batch, intents_db_.get());
+    if (last_batch) {
+      return Status::OK();
+    }
+    if (++num_batches == FLAGS_txn_apply_stop_after_batches_in_tests) {
+      LOG_WITH_PREFIX(WARNING) << "Stop applying " << data.transaction_id << " after "
+                               << num_batches << " batches";
+      return Status::OK();
+    }
+    VLOG_WITH_PREFIX(2) << "Applied batch of " << regular_write_batch.Count() << " records of "
+                        << data.transaction_id << ", continue from write id "
+                        << apply_state.write_id;
+  }
 }
 
 CHECKED_STATUS Tablet::RemoveIntents(const TransactionId& id) {
@@ -1345,6 +1606,9 @@ Status Tablet::AlterSchema(AlterSchemaOperationState *operation_state) {
                                    local_tablet_filter_);
     }
     metadata_cache_.emplace(client_future_.get());
+    if (!index_update_batcher_) {
+      index_update_batcher_ = std::make_shared<IndexUpdateBatcher>(client_future_.get());
+    }
   }
 
   // Flush the updated schema metadata to disk.
@@ -1398,7 +1662,8 @@ Status Tablet::Truncate(TruncateOperationState *state) {
   const string db_dir = regular_db_->GetName();
 
   rocksdb::Options rocksdb_options;
-  docdb::InitRocksDBOptions(&rocksdb_options, tablet_id(), rocksdb_statistics_, tablet_options_);
+  docdb::InitRocksDBOptions(&rocksdb_options, tablet_id(), rocksdb_statistics_, tablet_options_,
+                            metadata_->schema().table_properties());
 
   Status intents_status;
   if (intents_db_) {
@@ -1435,6 +1700,13 @@ Status Tablet::Truncate(TruncateOperationState *state) {
   return Status::OK();
 }
 
+Status Tablet::ApplySplit(SplitOperationState* state) {
+  if (!tablet_options_.tablet_splitter) {
+    return STATUS(NotSupported, "Tablet splitting is not supported");
+  }
+  return tablet_options_.tablet_splitter->ApplyTabletSplit(state);
+}
+
 void Tablet::UpdateMonotonicCounter(int64_t value) {
   int64_t counter = monotonic_counter_;
   while (true) {
@@ -1556,6 +1828,21 @@ Status Tablet::TEST_SwitchMemtable() {
   return Status::OK();
 }
 
+bool Tablet::CanWaitForConflicts(WriteOperation* operation) {
+  if (!operation->can_restart()) {
+    return false;
+  }
+  auto now = MonoTime::Now();
+  if (!operation->conflict_wait_deadline().Initialized()) {
+    auto deadline = now + MonoDelta::FromMilliseconds(FLAGS_transaction_conflict_wait_ms);
+    if (operation->deadline().Initialized()) {
+      deadline = MonoTime::Earliest(deadline, operation->deadline());
+    }
+    operation->set_conflict_wait_deadline(deadline);
+  }
+  return now < operation->conflict_wait_deadline();
+}
+
 Status Tablet::StartDocWriteOperation(WriteOperation* operation) {
   auto write_batch = operation->request()->mutable_write_batch();
   auto isolation_level = GetIsolationLevel(*write_batch, transaction_participant_.get());
@@ -1608,7 +1895,12 @@ Status Tablet::StartDocWriteOperation(WriteOperation* operation) {
   if (*isolation_level != IsolationLevel::NON_TRANSACTIONAL) {
     RETURN_NOT_OK(docdb::ResolveTransactionConflicts(
         *write_batch, clock_->Now(), {regular_db_.get(), intents_db_.get()},
-        transaction_participant_.get(), metrics_->transaction_conflicts.get()));
+        transaction_participant_.get(), metrics_->transaction_conflicts.get(),
+        CanWaitForConflicts(operation) ? &operation->conflict_blockers() : nullptr));
+    if (!operation->conflict_blockers().empty()) {
+      // Locks are released when we return, so the transactions we wait for are not blocked by us.
+      return Status::OK();
+    }
   }
   operation->state()->ReplaceDocDBLocks(std::move(keys_locked));
 
@@ -1645,25 +1937,49 @@ HybridTime Tablet::DoGetSafeTime(
   return mvcc_.SafeTime(min_allowed, deadline, ht_lease);
 }
 
+size_t Tablet::CurrentActiveReadersShard() {
+  static thread_local size_t shard = std::hash<std::thread::id>()(std::this_thread::get_id()) %
+                                     kNumActiveReadersShards;
+  return shard;
+}
+
 HybridTime Tablet::OldestReadPoint() const {
-  std::lock_guard<std::mutex> lock(active_readers_mutex_);
-  if (active_readers_cnt_.empty()) {
+  HybridTime result = HybridTime::kMax;
+  for (const auto& shard : active_readers_) {
+    std::lock_guard<simple_spinlock> lock(shard.lock);
+    if (!shard.readers_cnt.empty()) {
+      result = std::min(result, shard.readers_cnt.begin()->first);
+    }
+  }
+  if (result == HybridTime::kMax) {
     return mvcc_.LastReplicatedHybridTime();
   }
-  return active_readers_cnt_.begin()->first;
+  return result;
 }
 
 void Tablet::RegisterReaderTimestamp(HybridTime read_point) {
-  std::lock_guard<std::mutex> lock(active_readers_mutex_);
-  active_readers_cnt_[read_point]++;
+  auto& shard = active_readers_[CurrentActiveReadersShard()];
+  std::lock_guard<simple_spinlock> lock(shard.lock);
+  shard.readers_cnt[read_point]++;
 }
 
 void Tablet::UnregisterReader(HybridTime timestamp) {
-  std::lock_guard<std::mutex> lock(active_readers_mutex_);
-  active_readers_cnt_[timestamp]--;
-  if (active_readers_cnt_[timestamp] == 0) {
-    active_readers_cnt_.erase(timestamp);
+  // Readers are usually unregistered by the thread that registered them. Otherwise any shard
+  // holding a reader with the same timestamp will do, since only the counts per timestamp matter.
+  const size_t current_shard = CurrentActiveReadersShard();
+  for (size_t i = 0; i != kNumActiveReadersShards; ++i) {
+    auto& shard = active_readers_[(current_shard + i) % kNumActiveReadersShards];
+    std::lock_guard<simple_spinlock> lock(shard.lock);
+    auto it = shard.readers_cnt.find(timestamp);
+    if (it == shard.readers_cnt.end()) {
+      continue;
+    }
+    if (--it->second == 0) {
+      shard.readers_cnt.erase(it);
+    }
+    return;
   }
+  LOG_WITH_PREFIX(DFATAL) << "Unregistering unknown reader: " << timestamp;
 }
 
 namespace {
@@ -1695,6 +2011,23 @@ void Tablet::ForceRocksDBCompactInTest() {
   }
 }
 
+Status Tablet::CompactParentData() {
+  ScopedPendingOperation scoped_operation(&pending_op_counter_);
+  RETURN_NOT_OK(scoped_operation);
+
+  if (!metadata_->has_parent_data()) {
+    return Status::OK();
+  }
+
+  // A full compaction drops the keys outside of the partition of this tablet, see
+  // TabletRetentionPolicy::GetKeyBounds.
+  LOG_WITH_PREFIX(INFO) << "Compacting data inherited from the parent tablet";
+  RETURN_NOT_OK(regular_db_->CompactRange(
+      rocksdb::CompactRangeOptions(), /* begin = */ nullptr, /* end = */ nullptr));
+  metadata_->SetParentDataCompacted(true);
+  return metadata_->Flush();
+}
+
 std::string Tablet::DocDBDumpStrInTest() {
   return docdb::DocDBDebugDumpToStr(regular_db_.get());
 }
@@ -32,6 +32,7 @@
 #ifndef YB_TABLET_TABLET_H_
 #define YB_TABLET_TABLET_H_
 
+#include <array>
 #include <iosfwd>
 #include <map>
 #include <memory>
@@ -62,6 +63,7 @@
 #include "yb/gutil/atomicops.h"
 #include "yb/gutil/gscoped_ptr.h"
 #include "yb/gutil/macros.h"
+#include "yb/gutil/port.h"
 
 #include "yb/rpc/rpc_fwd.h"
 
@@ -110,7 +112,9 @@ class MaintenanceOpStats;
 namespace tablet {
 
 class AlterSchemaOperationState;
+class IndexUpdateBatcher;
 class ScopedReadOperation;
+class SplitOperationState;
 struct TabletMetrics;
 struct TransactionApplyData;
 class TransactionCoordinator;
@@ -272,6 +276,18 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   // Apply all of the row operations associated with this transaction.
   void ApplyRowOperations(WriteOperationState* operation_state);
 
+  // Used by bootstrap to write replayed operations in big batches. Appends the row operations of a
+  // non-transactional write to write_batch and returns true. Returns false for transactional
+  // writes, which should be applied by ApplyRowOperations.
+  bool PrepareReplayedRowOperations(
+      const WriteOperationState& operation_state, rocksdb::WriteBatch* write_batch);
+
+  // Writes a batch prepared by PrepareReplayedRowOperations to the regular DB. frontiers span the
+  // op ids and hybrid times of all the operations in the batch.
+  void WriteReplayedBatch(const docdb::ConsensusFrontiers& frontiers,
+                          HybridTime hybrid_time,
+                          rocksdb::WriteBatch* write_batch);
+
   // Apply a set of RocksDB row operations.
   // If rocksdb_write_batch is specified it could contain preencoded RocksDB operations.
   void ApplyKeyValueRowOperations(
@@ -284,6 +300,15 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
                   rocksdb::WriteBatch* write_batch,
                   rocksdb::DB* dest_db);
 
+  // Returns number of parts a non-transactional batch with num_kv_pairs key value pairs is split
+  // into for concurrent memtable insertion. 1 means that the batch is written as a whole.
+  int NumMemtableInsertParts(int num_kv_pairs) const;
+
+  void WriteNonTransactionBatchInParts(const docdb::KeyValueWriteBatchPB& put_batch,
+                                       const rocksdb::UserFrontiers* frontiers,
+                                       HybridTime hybrid_time,
+                                       int num_parts);
+
   //------------------------------------------------------------------------------------------------
   // Redis Request Processing.
   // Takes a Redis WriteRequestPB as input with its redis_write_batch.
@@ -364,6 +389,18 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   // Truncate this tablet by resetting the content of RocksDB.
   CHECKED_STATUS Truncate(TruncateOperationState* state);
 
+  // Creates the tablets that take over the halves of the partition of this tablet.
+  CHECKED_STATUS ApplySplit(SplitOperationState* state);
+
+  // Set once a split operation has been prepared, the leader rejects new writes after that.
+  void SetSplitRequested(bool value) {
+    split_requested_.store(value, std::memory_order_release);
+  }
+
+  bool split_requested() const {
+    return split_requested_.load(std::memory_order_acquire);
+  }
+
   // Verbosely dump this entire tablet to the logs. This is only
   // really useful when debugging unit tests failures where the tablet
   // has a very small number of rows.
@@ -458,6 +495,10 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
 
   void ForceRocksDBCompactInTest();
 
+  // Runs a full compaction of a tablet created by a split, so that it drops the data of the other
+  // half of the parent partition and reports its actual size from then on.
+  CHECKED_STATUS CompactParentData();
+
   std::string DocDBDumpStrInTest();
 
   // Returns last committed write index.
@@ -494,6 +535,14 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
 
   CHECKED_STATUS StartDocWriteOperation(WriteOperation* operation);
 
+  // Returns true if a write that conflicts with higher priority transactions could wait for them
+  // instead of failing. Starts the wait period of the operation on the first call.
+  bool CanWaitForConflicts(WriteOperation* operation);
+
+  // Waits until one of the transactions in the conflict blockers of operation is resolved, then
+  // restarts the operation.
+  void WaitForConflictingTransactions(std::unique_ptr<WriteOperation> operation);
+
   CHECKED_STATUS OpenKeyValueTablet();
   virtual CHECKED_STATUS CreateTabletDirectories(const string& db_dir, FsManager* fs);
 
@@ -545,6 +594,8 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   // Used for tests only.
   std::string last_rocksdb_checkpoint_dir_;
 
+  std::atomic<bool> split_requested_{false};
+
   // Lock protecting access to the 'components_' member (i.e the rowsets in the tablet)
   //
   // Shared mode:
@@ -578,10 +629,19 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
 
   MvccManager mvcc_;
 
-  // Maps a timestamp to the number active readers with that timestamp.
-  // TODO(ENG-961): Check if this is a point of contention. If so, shard it as suggested in D1219.
-  std::map<HybridTime, int64_t> active_readers_cnt_;
-  mutable std::mutex active_readers_mutex_;
+  // Maps a timestamp to the number active readers with that timestamp. Readers are registered in
+  // the shard of the registering thread, so concurrent readers do not contend on a single lock.
+  // The oldest read point is only needed by compactions, which combine all the shards.
+  struct ActiveReadersShard {
+    mutable simple_spinlock lock;
+    std::map<HybridTime, int64_t> readers_cnt;
+  } CACHELINE_ALIGNED;
+
+  static constexpr size_t kNumActiveReadersShards = 32;
+
+  static size_t CurrentActiveReadersShard();
+
+  std::array<ActiveReadersShard, kNumActiveReadersShards> active_readers_;
 
   // Lock protecting the selection of rowsets for compaction.
   // Only one thread may run the compaction selection algorithm at a time
@@ -655,6 +715,7 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   // Created only when secondary indexes are present.
   boost::optional<client::TransactionManager> transaction_manager_;
   boost::optional<client::YBMetaDataCache> metadata_cache_;
+  std::shared_ptr<IndexUpdateBatcher> index_update_batcher_;
 
   // Created only if it is a unique index tablet.
   boost::optional<Schema> unique_index_key_schema_;
@@ -671,7 +732,13 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   HybridTime DoGetSafeTime(
       RequireLease require_lease, HybridTime min_allowed, MonoTime deadline) const override;
 
+  typedef std::vector<std::pair<client::YBqlWriteOpPtr, docdb::QLWriteOperation*>> IndexOps;
+
   void UpdateQLIndexes(std::unique_ptr<WriteOperation> operation);
+  // Copies statuses of index updates to responses of the write operation and completes it.
+  void CompleteQLIndexUpdates(std::unique_ptr<WriteOperation> operation,
+                              const IndexOps& index_ops,
+                              const ChildTransactionResultPB* child_result);
   void CompleteQLWriteBatch(std::unique_ptr<WriteOperation> operation, const Status& status);
 
   Result<bool> IntentsDbFlushFilter(const rocksdb::MemTable& memtable);
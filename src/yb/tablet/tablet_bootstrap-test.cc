@@ -43,6 +43,7 @@
 #include "yb/tablet/tablet_bootstrap_if.h"
 #include "yb/tablet/tablet-test-util.h"
 #include "yb/tablet/tablet_metadata.h"
+#include "yb/util/size_literals.h"
 #include "yb/util/tostring.h"
 #include "yb/tablet/tablet_options.h"
 
@@ -50,6 +51,21 @@ using std::shared_ptr;
 using std::string;
 using std::vector;
 
+using namespace yb::size_literals;
+
+DEFINE_int32(bootstrap_test_num_segments, 8,
+             "Number of log segments replayed by TestReplayManySegments.");
+DEFINE_int32(bootstrap_test_ops_per_segment, 200,
+             "Number of write operations per log segment in TestReplayManySegments.");
+DEFINE_int32(bootstrap_test_value_size, 64,
+             "Size of the string value written by each operation in TestReplayManySegments.");
+DEFINE_int64(bootstrap_test_log_size_mb, 0,
+             "Total size of the values written by TestReplayManySegments. When set, overrides "
+             "--bootstrap_test_num_segments.");
+
+DECLARE_int32(bootstrap_log_read_ahead_segments);
+DECLARE_int64(bootstrap_replay_batch_size_bytes);
+
 namespace yb {
 
 namespace log {
@@ -338,5 +354,61 @@ TEST_F(BootstrapTest, TestConsensusOnlyOperationOutOfOrderHybridTime) {
   ASSERT_EQ(1, results.size());
 }
 
+// Replays a log consisting of many segments. Could be used as a benchmark of log replay by
+// increasing --bootstrap_test_log_size_mb (up to gigabytes), --bootstrap_test_ops_per_segment and
+// --bootstrap_test_value_size and comparing the replay rate with different values of
+// --bootstrap_log_read_ahead_segments and --bootstrap_replay_batch_size_bytes.
+TEST_F(BootstrapTest, TestReplayManySegments) {
+  BuildLog();
+
+  const string value(FLAGS_bootstrap_test_value_size, 'x');
+  int num_segments = FLAGS_bootstrap_test_num_segments;
+  if (FLAGS_bootstrap_test_log_size_mb > 0) {
+    const int64_t bytes_per_segment =
+        static_cast<int64_t>(FLAGS_bootstrap_test_ops_per_segment) * value.size();
+    num_segments = static_cast<int>(
+        (FLAGS_bootstrap_test_log_size_mb * 1_MB + bytes_per_segment - 1) / bytes_per_segment);
+  }
+  OpId committed_op_id = MakeOpId(0, 0);
+  for (int segment = 0; segment != num_segments; ++segment) {
+    for (int i = 0; i != FLAGS_bootstrap_test_ops_per_segment; ++i) {
+      const OpId op_id = MakeOpId(1, current_index_);
+      // Sync the last operation of the segment, so the log could be rolled over.
+      const bool sync = i + 1 == FLAGS_bootstrap_test_ops_per_segment;
+      AppendReplicateBatch(op_id, committed_op_id, {TupleForAppend(current_index_, 0, value)}, sync);
+      committed_op_id = op_id;
+      ++current_index_;
+    }
+    ASSERT_OK(RollLog());
+  }
+  const int64_t total_ops =
+      static_cast<int64_t>(num_segments) * FLAGS_bootstrap_test_ops_per_segment;
+  const double total_mb = static_cast<double>(total_ops) * value.size() / 1_MB;
+
+  ConsensusBootstrapInfo boot_info;
+  shared_ptr<TabletClass> tablet;
+  auto start = MonoTime::Now();
+  ASSERT_OK(BootstrapTestTablet(-1, -1, &tablet, &boot_info));
+  auto passed = MonoTime::Now() - start;
+  LOG(INFO) << "Replayed " << total_ops << " operations (" << total_mb << " MB of values) from "
+            << num_segments << " segments with read ahead of "
+            << FLAGS_bootstrap_log_read_ahead_segments << " segments and batches of "
+            << FLAGS_bootstrap_replay_batch_size_bytes << " bytes in " << passed << ": "
+            << total_ops / passed.ToSeconds() << " ops/s, "
+            << total_mb / passed.ToSeconds() << " MB/s";
+
+  // The last operation is not known to be committed, so it is not applied. Rows are only counted,
+  // so the check does not need memory proportional to the size of the log.
+  ASSERT_EQ(1, boot_info.orphaned_replicates.size());
+  auto iter = ASSERT_RESULT(tablet->NewRowIterator(schema_, boost::none));
+  int64_t num_rows = 0;
+  QLTableRow row;
+  while (iter->HasNext()) {
+    ASSERT_OK(iter->NextRow(&row));
+    ++num_rows;
+  }
+  ASSERT_EQ(total_ops - 1, num_rows);
+}
+
 } // namespace tablet
 } // namespace yb
@@ -31,6 +31,9 @@
 //
 #include "yb/tablet/tablet_bootstrap.h"
 
+#include <deque>
+#include <future>
+
 #include "yb/consensus/consensus.h"
 #include "yb/consensus/log_anchor_registry.h"
 #include "yb/consensus/log_reader.h"
@@ -38,6 +41,7 @@
 #include "yb/tablet/tablet.h"
 #include "yb/tablet/tablet_peer.h"
 #include "yb/tablet/operations/alter_schema_operation.h"
+#include "yb/tablet/operations/split_operation.h"
 #include "yb/tablet/operations/truncate_operation.h"
 #include "yb/tablet/operations/update_txn_operation.h"
 #include "yb/tablet/operations/write_operation.h"
@@ -45,7 +49,12 @@
 #include "yb/util/flag_tags.h"
 #include "yb/util/opid.h"
 #include "yb/util/logging.h"
+#include "yb/util/mem_tracker.h"
+#include "yb/util/size_literals.h"
 #include "yb/util/stopwatch.h"
+#include "yb/util/threadpool.h"
+
+using namespace yb::size_literals;
 
 DEFINE_bool(skip_remove_old_recovery_dir, false,
             "Skip removing WAL recovery dir after startup. (useful for debugging)");
@@ -55,6 +64,18 @@ DEFINE_test_flag(double, fault_crash_during_log_replay, 0.0,
                  "Fraction of the time when the tablet will crash immediately "
                  "after processing a log entry during log replay.");
 
+DEFINE_int32(bootstrap_log_read_ahead_segments, 2,
+             "Number of WAL segments that are read and decoded on background threads ahead of "
+             "the segment being replayed during tablet bootstrap. 0 means that segments are read "
+             "on the replaying thread.");
+TAG_FLAG(bootstrap_log_read_ahead_segments, advanced);
+
+DEFINE_int64(bootstrap_replay_batch_size_bytes, 16_MB,
+             "Non-transactional writes replayed during tablet bootstrap are accumulated and "
+             "written to RocksDB in batches of about this size. 0 means that every replayed "
+             "write is written separately.");
+TAG_FLAG(bootstrap_replay_batch_size_bytes, advanced);
+
 DECLARE_uint64(max_clock_sync_error_usec);
 
 namespace yb {
@@ -317,6 +338,21 @@ Status TabletBootstrap::Bootstrap(shared_ptr<TabletClass>* rebuilt_tablet,
     return Status::OK();
   }
 
+  // A tablet created by a split starts with the data of its parent and an empty log, which
+  // continues the log of the parent right after the split operation.
+  const auto split_op_id = meta_->split_op_id();
+  if (has_blocks && !needs_recovery && split_op_id) {
+    LOG_WITH_PREFIX(INFO) << "Tablet created by split at " << split_op_id << ". Creating new log.";
+    RETURN_NOT_OK_PREPEND(OpenNewLog(), "Failed to open new log");
+    tablet_->mvcc_manager()->SetLastReplicated(VERIFY_RESULT(tablet_->MaxPersistentHybridTime()));
+    RETURN_NOT_OK(FinishBootstrap("Opened a new log for a tablet created by split",
+                                  rebuilt_log,
+                                  rebuilt_tablet));
+    consensus_info->last_id = split_op_id.ToPB<consensus::OpId>();
+    consensus_info->last_committed_id = split_op_id.ToPB<consensus::OpId>();
+    return Status::OK();
+  }
+
   // If there were blocks, there must be segments to replay. This is required by Raft, since we
   // always need to know the term and index of the last logged op in order to vote, know how to
   // respond to AppendEntries(), etc.
@@ -615,6 +651,9 @@ Status TabletBootstrap::HandleOperation(consensus::OperationType op_type,
     case consensus::TRUNCATE_OP:
       return PlayTruncateRequest(replicate);
 
+    case consensus::SPLIT_OP:
+      return PlaySplitRequest(replicate);
+
     case consensus::NO_OP:
       return PlayNoOpRequest(replicate);
 
@@ -638,6 +677,10 @@ Status TabletBootstrap::HandleEntryPair(ReplayState* state, LogEntryPB* replicat
   ReplicateMsg* replicate = replicate_entry->mutable_replicate();
   const auto op_type = replicate_entry->replicate().op_type();
 
+  if (op_type != consensus::WRITE_OP) {
+    WriteReplayedBatch();
+  }
+
   int64_t flushed_index;
   if (op_type == consensus::UPDATE_TRANSACTION_OP) {
     if (replicate->transaction_state().status() == TransactionStatus::APPLYING) {
@@ -694,6 +737,128 @@ void TabletBootstrap::DumpReplayStateToLog(const ReplayState& state) {
   }
 }
 
+namespace {
+
+// Entries of a log segment, decoded by SegmentReadAhead.
+struct SegmentEntries {
+  log::LogEntries entries;
+  yb::OpId committed_op_id;
+  Status read_status;
+};
+
+SegmentEntries ReadSegmentEntries(const scoped_refptr<ReadableLogSegment>& segment) {
+  SegmentEntries result;
+  // TODO: Optimize this to not read the whole thing into memory?
+  result.read_status = segment->ReadEntries(
+      &result.entries, nullptr /* end_offset */, &result.committed_op_id);
+  return result;
+}
+
+// Reads and decodes log segments on a thread pool, up to read_ahead segments ahead of the segment
+// being replayed, so reading of the following segments overlaps with the replay. The pool and the
+// memory tracker are shared by all the tablets bootstrapped by a server. A segment is read ahead
+// only if its size could be consumed from the memory tracker, otherwise it is read on the
+// replaying thread when it is needed.
+class SegmentReadAhead {
+ public:
+  SegmentReadAhead(const log::SegmentSequence& segments, int read_ahead, ThreadPool* pool,
+                   std::shared_ptr<MemTracker> mem_tracker)
+      : segments_(segments), read_ahead_(std::max(read_ahead, 0)), pool_(pool),
+        mem_tracker_(std::move(mem_tracker)) {}
+
+  ~SegmentReadAhead() {
+    ReleaseMemory(consumed_bytes_);
+  }
+
+  CHECKED_STATUS Init() {
+    if (read_ahead_ == 0) {
+      pool_ = nullptr;
+      return Status::OK();
+    }
+    if (pool_) {
+      return Status::OK();
+    }
+    RETURN_NOT_OK(ThreadPoolBuilder("log-read-ahead")
+        .set_max_threads(static_cast<int>(read_ahead_))
+        .Build(&own_pool_));
+    pool_ = own_pool_.get();
+    return Status::OK();
+  }
+
+  // Returns entries of the next segment, blocking until they are read.
+  SegmentEntries Next() {
+    // The previously returned segment has been replayed.
+    ReleaseMemory(replayed_bytes_);
+    replayed_bytes_ = 0;
+
+    ScheduleReads();
+    if (pending_.empty()) {
+      return ReadSegmentEntries(segments_[next_to_read_++]);
+    }
+    auto result = pending_.front().entries.get();
+    replayed_bytes_ = pending_.front().bytes;
+    pending_.pop_front();
+    // Keep read_ahead_ segments in flight while this one is replayed.
+    ScheduleReads();
+    return result;
+  }
+
+ private:
+  struct PendingRead {
+    std::future<SegmentEntries> entries;
+    int64_t bytes;
+  };
+
+  void ScheduleReads() {
+    if (!pool_) {
+      return;
+    }
+    while (next_to_read_ < segments_.size() && pending_.size() < read_ahead_ + 1) {
+      auto segment = segments_[next_to_read_];
+      const int64_t bytes = segment->file_size();
+      if (mem_tracker_ && !mem_tracker_->TryConsume(bytes)) {
+        VLOG(1) << "Not reading " << segment->path() << " ahead, memory limit of "
+                << mem_tracker_->ToString() << " reached";
+        return;
+      }
+      consumed_bytes_ += bytes;
+      ++next_to_read_;
+      auto promise = std::make_shared<std::promise<SegmentEntries>>();
+      pending_.push_back({promise->get_future(), bytes});
+      auto task = [segment, promise] {
+        promise->set_value(ReadSegmentEntries(segment));
+      };
+      auto status = pool_->SubmitFunc(task);
+      if (!status.ok()) {
+        LOG(WARNING) << "Failed to schedule read of " << segment->path() << ": " << status;
+        task();
+      }
+    }
+  }
+
+  void ReleaseMemory(int64_t bytes) {
+    if (mem_tracker_ && bytes) {
+      mem_tracker_->Release(bytes);
+      consumed_bytes_ -= bytes;
+    }
+  }
+
+  const log::SegmentSequence& segments_;
+  const size_t read_ahead_;
+  ThreadPool* pool_;
+  std::shared_ptr<MemTracker> mem_tracker_;
+  size_t next_to_read_ = 0;
+  std::deque<PendingRead> pending_;
+  // Bytes consumed from mem_tracker_ by the segments read ahead, including the one being replayed.
+  int64_t consumed_bytes_ = 0;
+  int64_t replayed_bytes_ = 0;
+  // Pool created for this bootstrap when no shared pool is specified. Declared last, so it is shut
+  // down, waiting for running reads, before pending_ is destroyed.
+  std::unique_ptr<ThreadPool> own_pool_;
+};
+
+} // namespace
+
 Status TabletBootstrap::PlaySegments(ConsensusBootstrapInfo* consensus_info) {
   auto flushed_op_id = VERIFY_RESULT(tablet_->MaxPersistentOpId());
 
@@ -717,14 +882,17 @@ Status TabletBootstrap::PlaySegments(ConsensusBootstrapInfo* consensus_info) {
   // from the log we're reading into the log we're writing.
   RETURN_NOT_OK_PREPEND(OpenNewLog(), "Failed to open new log");
 
+  SegmentReadAhead read_ahead(segments, FLAGS_bootstrap_log_read_ahead_segments,
+                              data_.read_ahead_pool, data_.read_ahead_mem_tracker);
+  RETURN_NOT_OK(read_ahead.Init());
+
   int segment_count = 0;
   yb::OpId last_committed_op_id;
   for (const scoped_refptr<ReadableLogSegment>& segment : segments) {
-    log::LogEntries entries;
-    // TODO: Optimize this to not read the whole thing into memory?
-    yb::OpId committed_op_id;
-    Status read_status = segment->ReadEntries(&entries, nullptr /* end_offset */, &committed_op_id);
-    last_committed_op_id = std::max(last_committed_op_id, committed_op_id);
+    auto segment_entries = read_ahead.Next();
+    auto& entries = segment_entries.entries;
+    const auto& read_status = segment_entries.read_status;
+    last_committed_op_id = std::max(last_committed_op_id, segment_entries.committed_op_id);
     for (int entry_idx = 0; entry_idx < entries.size(); ++entry_idx) {
       Status s = HandleEntry(&state, &entries[entry_idx]);
       if (!s.ok()) {
@@ -782,6 +950,20 @@ Status TabletBootstrap::PlaySegments(ConsensusBootstrapInfo* consensus_info) {
     }
   }
 
+  WriteReplayedBatch();
+
+  // The log of a tablet created by a split starts right after the split operation, which is the
+  // last operation already reflected in the tablet data.
+  const auto split_op_id = meta_->split_op_id();
+  if (split_op_id) {
+    if (split_op_id.index > state.prev_op_id.index()) {
+      state.prev_op_id = split_op_id.ToPB<consensus::OpId>();
+    }
+    if (split_op_id.index > state.committed_op_id.index()) {
+      state.committed_op_id = split_op_id.ToPB<consensus::OpId>();
+    }
+  }
+
   LOG_WITH_PREFIX(INFO) << "Dumping replay state to log at the end of " << __FUNCTION__;
   DumpReplayStateToLog(state);
 
@@ -824,11 +1006,40 @@ void TabletBootstrap::PlayWriteRequest(ReplicateMsg* replicate_msg) {
   // Use committed OpId for mem store anchoring.
   operation_state.mutable_op_id()->CopyFrom(replicate_msg->id());
 
-  tablet_->ApplyRowOperations(&operation_state);
+  if (FLAGS_bootstrap_replay_batch_size_bytes > 0 &&
+      tablet_->PrepareReplayedRowOperations(operation_state, &replayed_write_batch_)) {
+    const yb::OpId op_id = yb::OpId::FromPB(replicate_msg->id());
+    if (num_replayed_writes_++ == 0) {
+      replayed_frontiers_.Smallest().set_op_id(op_id);
+      replayed_frontiers_.Smallest().set_hybrid_time(operation_state.hybrid_time());
+    }
+    replayed_frontiers_.Largest().set_op_id(op_id);
+    replayed_frontiers_.Largest().set_hybrid_time(operation_state.hybrid_time());
+    if (static_cast<int64_t>(replayed_write_batch_.GetDataSize()) >=
+            FLAGS_bootstrap_replay_batch_size_bytes) {
+      WriteReplayedBatch();
+    }
+  } else {
+    WriteReplayedBatch();
+    tablet_->ApplyRowOperations(&operation_state);
+  }
 
   tablet_->mvcc_manager()->Replicated(operation_state.hybrid_time());
 }
 
+void TabletBootstrap::WriteReplayedBatch() {
+  if (num_replayed_writes_ == 0) {
+    return;
+  }
+  VLOG_WITH_PREFIX(2) << "Writing " << num_replayed_writes_ << " replayed operations, "
+                      << replayed_write_batch_.GetDataSize() << " bytes: "
+                      << replayed_frontiers_.ToString();
+  tablet_->WriteReplayedBatch(
+      replayed_frontiers_, replayed_frontiers_.Largest().hybrid_time(), &replayed_write_batch_);
+  replayed_write_batch_.Clear();
+  num_replayed_writes_ = 0;
+}
+
 Status TabletBootstrap::PlayAlterSchemaRequest(ReplicateMsg* replicate_msg) {
   AlterSchemaRequestPB* alter_schema = replicate_msg->mutable_alter_schema_request();
 
@@ -892,6 +1103,22 @@ Status TabletBootstrap::PlayTruncateRequest(ReplicateMsg* replicate_msg) {
   return Status::OK();
 }
 
+Status TabletBootstrap::PlaySplitRequest(ReplicateMsg* replicate_msg) {
+  if (meta_->has_been_split()) {
+    // The new tablets have been already created, nothing left to do.
+    return Status::OK();
+  }
+
+  SplitOperationState operation_state(tablet_.get(), replicate_msg->mutable_split_request());
+  operation_state.mutable_op_id()->CopyFrom(replicate_msg->id());
+  operation_state.set_hybrid_time(HybridTime(replicate_msg->hybrid_time()));
+
+  tablet_->SetSplitRequested(true);
+  RETURN_NOT_OK_PREPEND(tablet_->ApplySplit(&operation_state), "Failed to Split:");
+
+  return Status::OK();
+}
+
 Status TabletBootstrap::PlayUpdateTransactionRequest(
     ReplicateMsg* replicate_msg, AlreadyApplied already_applied) {
   DCHECK(replicate_msg->has_hybrid_time());
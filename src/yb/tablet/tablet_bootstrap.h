@@ -36,6 +36,8 @@
 #include "yb/consensus/consensus_meta.h"
 #include "yb/consensus/opid_util.h"
 #include "yb/consensus/log_reader.h"
+#include "yb/docdb/consensus_frontier.h"
+#include "yb/rocksdb/write_batch.h"
 #include "yb/util/threadpool.h"
 
 namespace yb {
@@ -113,6 +115,10 @@ class TabletBootstrap {
 
   void PlayWriteRequest(consensus::ReplicateMsg* replicate_msg);
 
+  // Writes the non-transactional writes accumulated by PlayWriteRequest to the tablet. Called
+  // before any other operation is played, so the order of operations is preserved.
+  void WriteReplayedBatch();
+
   CHECKED_STATUS PlayUpdateTransactionRequest(
       consensus::ReplicateMsg* replicate_msg, AlreadyApplied already_applied);
 
@@ -124,6 +130,8 @@ class TabletBootstrap {
 
   CHECKED_STATUS PlayTruncateRequest(consensus::ReplicateMsg* replicate_msg);
 
+  CHECKED_STATUS PlaySplitRequest(consensus::ReplicateMsg* replicate_msg);
+
   void DumpReplayStateToLog(const ReplayState& state);
 
   // Handlers for each type of message seen in the log during replay.
@@ -186,6 +194,12 @@ class TabletBootstrap {
 
   HybridTime rocksdb_last_entry_hybrid_time_ = HybridTime::kMin;
 
+  // Non-transactional writes replayed since the last WriteReplayedBatch, with the op ids and
+  // hybrid times of the first and the last of them.
+  rocksdb::WriteBatch replayed_write_batch_;
+  docdb::ConsensusFrontiers replayed_frontiers_;
+  size_t num_replayed_writes_ = 0;
+
  private:
   DISALLOW_COPY_AND_ASSIGN(TabletBootstrap);
 };
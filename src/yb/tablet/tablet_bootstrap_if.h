@@ -123,6 +123,12 @@ struct BootstrapTabletData {
   client::LocalTabletFilter local_tablet_filter;
   TransactionCoordinatorContext* transaction_coordinator_context;
   ThreadPool* append_pool;
+  // Pool used to read log segments ahead of the replay, shared by all the tablets bootstrapped by
+  // the server. A pool is created for the bootstrap when it is not specified.
+  ThreadPool* read_ahead_pool = nullptr;
+  // Accounts for the log segments read ahead of the replay, nothing is read ahead while its limit
+  // is exceeded.
+  std::shared_ptr<MemTracker> read_ahead_mem_tracker;
 };
 
 // Bootstraps a tablet, initializing it with the provided metadata. If the tablet
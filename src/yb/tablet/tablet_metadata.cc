@@ -386,6 +386,15 @@ Status TabletMetadata::LoadFromSuperBlock(const TabletSuperBlockPB& superblock)
     } else {
       tombstone_last_logged_opid_ = OpId();
     }
+
+    if (superblock.has_split_op_id()) {
+      split_op_id_ = yb::OpId::FromPB(superblock.split_op_id());
+    } else {
+      split_op_id_ = OpId();
+    }
+    split_child_tablet_ids_.assign(superblock.split_child_tablet_ids().begin(),
+                                   superblock.split_child_tablet_ids().end());
+    parent_data_compacted_ = superblock.parent_data_compacted();
   }
 
   // Now is a good time to clean up any orphaned blocks that may have been
@@ -565,6 +574,15 @@ Status TabletMetadata::ToSuperBlockUnlocked(TabletSuperBlockPB* super_block) con
   if (tombstone_last_logged_opid_) {
     tombstone_last_logged_opid_.ToPB(pb.mutable_tombstone_last_logged_opid());
   }
+  if (split_op_id_) {
+    split_op_id_.ToPB(pb.mutable_split_op_id());
+  }
+  for (const auto& tablet_id : split_child_tablet_ids_) {
+    pb.add_split_child_tablet_ids(tablet_id);
+  }
+  if (parent_data_compacted_) {
+    pb.set_parent_data_compacted(true);
+  }
 
   for (const BlockId& block_id : orphaned_blocks_) {
     block_id.CopyToPB(pb.mutable_orphaned_blocks()->Add());
@@ -649,6 +667,41 @@ void TabletMetadata::set_tablet_data_state(TabletDataState state) {
   tablet_data_state_ = state;
 }
 
+void TabletMetadata::SetSplitOpId(const yb::OpId& split_op_id) {
+  std::lock_guard<LockType> l(data_lock_);
+  split_op_id_ = split_op_id;
+}
+
+yb::OpId TabletMetadata::split_op_id() const {
+  std::lock_guard<LockType> l(data_lock_);
+  return split_op_id_;
+}
+
+void TabletMetadata::SetSplitChildTabletIds(std::vector<std::string> tablet_ids) {
+  std::lock_guard<LockType> l(data_lock_);
+  split_child_tablet_ids_ = std::move(tablet_ids);
+}
+
+std::vector<std::string> TabletMetadata::split_child_tablet_ids() const {
+  std::lock_guard<LockType> l(data_lock_);
+  return split_child_tablet_ids_;
+}
+
+bool TabletMetadata::has_been_split() const {
+  std::lock_guard<LockType> l(data_lock_);
+  return !split_child_tablet_ids_.empty();
+}
+
+void TabletMetadata::SetParentDataCompacted(bool value) {
+  std::lock_guard<LockType> l(data_lock_);
+  parent_data_compacted_ = value;
+}
+
+bool TabletMetadata::has_parent_data() const {
+  std::lock_guard<LockType> l(data_lock_);
+  return split_op_id_ && !parent_data_compacted_;
+}
+
 string TabletMetadata::LogPrefix() const {
   return Substitute("T $0 P $1: ", tablet_id_, fs_manager_->uuid());
 }
@@ -256,6 +256,22 @@ class TabletMetadata : public RefCountedThreadSafe<TabletMetadata> {
 
   yb::OpId tombstone_last_logged_opid() const { return tombstone_last_logged_opid_; }
 
+  // The OpId of the split operation that created this tablet, empty for tablets that were not
+  // created by a split.
+  void SetSplitOpId(const yb::OpId& split_op_id);
+  yb::OpId split_op_id() const;
+
+  // Tablets that took over the partition of this tablet after it has been split, empty for tablets
+  // that have not been split.
+  void SetSplitChildTabletIds(std::vector<std::string> tablet_ids);
+  std::vector<std::string> split_child_tablet_ids() const;
+  bool has_been_split() const;
+
+  // Whether this tablet was created by a split and still holds files inherited from its parent,
+  // i.e. its on-disk size also accounts for the other half of the parent partition.
+  void SetParentDataCompacted(bool value);
+  bool has_parent_data() const;
+
   // Loads the currently-flushed superblock from disk into the given protobuf.
   CHECKED_STATUS ReadSuperBlockFromDisk(TabletSuperBlockPB* superblock) const;
 
@@ -388,6 +404,11 @@ class TabletMetadata : public RefCountedThreadSafe<TabletMetadata> {
   // tombstoned. Has no meaning for non-tombstoned tablets.
   yb::OpId tombstone_last_logged_opid_;
 
+  // See split_op_id() and split_child_tablet_ids().
+  yb::OpId split_op_id_;
+  std::vector<std::string> split_child_tablet_ids_;
+  bool parent_data_compacted_ = false;
+
   // If this counter is > 0 then Flush() will not write any data to
   // disk.
   int32_t num_flush_pins_ = 0;
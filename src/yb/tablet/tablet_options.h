@@ -15,17 +15,28 @@
 
 namespace rocksdb {
 class Cache;
+class CompactionScheduler;
 class EventListener;
 class MemoryMonitor;
 }
 
 namespace yb {
+
+class ThreadPool;
+
 namespace tablet {
 
+class TabletSplitter;
+
 struct TabletOptions {
   std::shared_ptr<rocksdb::Cache> block_cache;
   std::shared_ptr<rocksdb::MemoryMonitor> memory_monitor;
+  std::shared_ptr<rocksdb::CompactionScheduler> compaction_scheduler;
   std::vector<std::shared_ptr<rocksdb::EventListener>> listeners;
+  // Used to insert parts of large write batches into the memtable concurrently, when set.
+  std::shared_ptr<ThreadPool> memtable_insert_pool;
+  // Creates the new tablets when a tablet is split, splitting is not supported when not set.
+  TabletSplitter* tablet_splitter = nullptr;
 };
 
 } // namespace tablet
@@ -66,6 +66,7 @@ using yb::consensus::StateChangeContext;
 namespace yb {
 
 namespace consensus {
+class MultiRaftManager;
 class RaftConsensus;
 }
 
@@ -116,7 +117,8 @@ class TabletPeer : public consensus::ReplicaOperationFactory,
                                 const scoped_refptr<MetricEntity> &metric_entity,
                                 ThreadPool* raft_pool,
                                 ThreadPool* tablet_prepare_pool,
-                                rpc::ThreadPool* service_thread_pool);
+                                rpc::ThreadPool* service_thread_pool,
+                                consensus::MultiRaftManager* multi_raft_manager = nullptr);
 
   // Starts the TabletPeer, making it available for Write()s. If this
   // TabletPeer is part of a consensus configuration this will connect it to other peers
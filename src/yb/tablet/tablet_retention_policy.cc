@@ -13,6 +13,7 @@
 
 #include "yb/gutil/ref_counted.h"
 #include "yb/common/schema.h"
+#include "yb/docdb/value_type.h"
 #include "yb/server/hybrid_clock.h"
 #include "yb/tablet/tablet.h"
 #include "yb/tablet/tablet_retention_policy.h"
@@ -55,5 +56,24 @@ MonoDelta TabletRetentionPolicy::GetTableTTL() {
   return TableTTL(tablet_->metadata()->schema());
 }
 
+docdb::KeyBounds TabletRetentionPolicy::GetKeyBounds() {
+  docdb::KeyBounds result;
+  const auto* metadata = tablet_->metadata();
+  // Only a tablet created by a split contains keys outside of its partition. The hash partition key
+  // is the big-endian hash value that follows the hash marker at the start of each DocDB key.
+  if (!metadata->split_op_id()) {
+    return result;
+  }
+  const auto& partition = metadata->partition();
+  const char hash_marker = static_cast<char>(docdb::ValueType::kUInt16Hash);
+  if (!partition.partition_key_start().empty()) {
+    result.lower = hash_marker + partition.partition_key_start();
+  }
+  if (!partition.partition_key_end().empty()) {
+    result.upper = hash_marker + partition.partition_key_end();
+  }
+  return result;
+}
+
 }  // namespace tablet
 }  // namespace yb
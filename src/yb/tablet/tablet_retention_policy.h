@@ -30,6 +30,7 @@ class TabletRetentionPolicy : public docdb::HistoryRetentionPolicy {
   HybridTime GetHistoryCutoff() override;
   ColumnIdsPtr GetDeletedColumns() override;
   MonoDelta GetTableTTL() override;
+  docdb::KeyBounds GetKeyBounds() override;
 
  private:
   const Tablet* tablet_;
@@ -0,0 +1,39 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_TABLET_TABLET_SPLITTER_H
+#define YB_TABLET_TABLET_SPLITTER_H
+
+#include "yb/util/status.h"
+
+namespace yb {
+namespace tablet {
+
+class SplitOperationState;
+
+// Creates the tablets that take over the partition of a tablet being split. Implemented by the
+// component that manages the tablets of a server.
+class TabletSplitter {
+ public:
+  virtual ~TabletSplitter() {}
+
+  // Called when the split operation is applied. Must be idempotent, because the operation is
+  // applied again during bootstrap in case the server restarts before the split is recorded in
+  // the metadata of the tablet being split.
+  virtual CHECKED_STATUS ApplyTabletSplit(SplitOperationState* state) = 0;
+};
+
+}  // namespace tablet
+}  // namespace yb
+
+#endif  // YB_TABLET_TABLET_SPLITTER_H
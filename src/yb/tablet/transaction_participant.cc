@@ -29,12 +29,15 @@
 
 #include "yb/rocksdb/write_batch.h"
 
+#include "yb/client/client.h"
 #include "yb/client/transaction_rpc.h"
 
 #include "yb/docdb/docdb_rocksdb_util.h"
 #include "yb/docdb/docdb.h"
 
+#include "yb/rpc/messenger.h"
 #include "yb/rpc/rpc.h"
+#include "yb/rpc/scheduler.h"
 #include "yb/rpc/thread_pool.h"
 
 #include "yb/tablet/operations/update_txn_operation.h"
@@ -654,11 +657,15 @@ std::string TransactionApplyData::ToString() const {
 class TransactionParticipant::Impl : public RunningTransactionContext {
  public:
   explicit Impl(TransactionParticipantContext* context, TransactionIntentApplier* applier)
-      : RunningTransactionContext(context, applier), log_prefix_(context->tablet_id() + ": ") {
+      : RunningTransactionContext(context, applier), log_prefix_(context->tablet_id() + ": "),
+        wait_queue_(&context->thread_pool(), [this]() -> rpc::Scheduler& {
+          return client()->messenger()->scheduler();
+        }) {
     LOG_WITH_PREFIX(INFO) << "Start";
   }
 
   ~Impl() {
+    wait_queue_.Shutdown();
     transactions_.clear();
     rpcs_.Shutdown();
   }
@@ -964,6 +971,21 @@ class TransactionParticipant::Impl : public RunningTransactionContext {
     db_ = db;
   }
 
+  CHECKED_STATUS WaitForTransactions(
+      const TransactionId& waiter, const TransactionIdSet& blockers, MonoTime deadline,
+      TransactionWaitQueue::WaitCallback callback) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // A blocker could be resolved after conflict resolution has seen its intents, then nobody
+    // would resume us, so retry right away.
+    for (const auto& blocker : blockers) {
+      if (transactions_.find(blocker) == transactions_.end()) {
+        deadline = MonoTime::Now();
+        break;
+      }
+    }
+    return wait_queue_.Wait(waiter, blockers, deadline, std::move(callback));
+  }
+
   TransactionParticipantContext* participant_context() const {
     return &participant_context_;
   }
@@ -996,6 +1018,10 @@ class TransactionParticipant::Impl : public RunningTransactionContext {
   }
 
   bool RemoveUnlocked(const Transactions::iterator& it) {
+    // Transaction is resolved at this point, so transactions blocked by its intents could retry
+    // conflict resolution.
+    wait_queue_.Resolved((**it).id());
+
     if (running_requests_.empty()) {
       transactions_.erase(it);
       VLOG_WITH_PREFIX(2) << "Cleaned transaction: " << (**it).id()
@@ -1133,6 +1159,9 @@ class TransactionParticipant::Impl : public RunningTransactionContext {
   // Queue of transaction ids that should be cleaned, paired with request that should be completed
   // in order to be able to do clean.
   std::deque<CleanupQueueEntry> cleanup_queue_;
+
+  // Write requests of transactions blocked by intents of running transactions.
+  TransactionWaitQueue wait_queue_;
 };
 
 TransactionParticipant::TransactionParticipant(
@@ -1195,6 +1224,12 @@ void TransactionParticipant::Cleanup(TransactionIdSet&& set) {
   return impl_->Cleanup(std::move(set), this);
 }
 
+Status TransactionParticipant::WaitForTransactions(
+    const TransactionId& waiter, const TransactionIdSet& blockers, MonoTime deadline,
+    TransactionWaitQueue::WaitCallback callback) {
+  return impl_->WaitForTransactions(waiter, blockers, deadline, std::move(callback));
+}
+
 CHECKED_STATUS TransactionParticipant::ProcessApply(const TransactionApplyData& data) {
   return impl_->ProcessApply(data);
 }
@@ -34,6 +34,8 @@
 
 #include "yb/server/server_fwd.h"
 
+#include "yb/tablet/transaction_wait_queue.h"
+
 #include "yb/util/opid.pb.h"
 #include "yb/util/result.h"
 
@@ -127,6 +129,13 @@ class TransactionParticipant : public TransactionStatusManager {
 
   void Cleanup(TransactionIdSet&& set) override;
 
+  // Invokes callback once one of blockers is committed or aborted in this tablet, or deadline
+  // passes, so the write request of waiter could run conflict resolution again.
+  // Returns TryAgain without waiting if waiting would cause a deadlock.
+  CHECKED_STATUS WaitForTransactions(
+      const TransactionId& waiter, const TransactionIdSet& blockers, MonoTime deadline,
+      TransactionWaitQueue::WaitCallback callback);
+
   CHECKED_STATUS ProcessApply(const TransactionApplyData& data);
 
   // Used to pass arguments to ProcessReplicated.
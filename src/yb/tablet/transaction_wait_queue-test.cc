@@ -0,0 +1,126 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <future>
+
+#include <boost/optional.hpp>
+
+#include <gtest/gtest.h>
+
+#include "yb/rpc/messenger.h"
+#include "yb/rpc/thread_pool.h"
+
+#include "yb/tablet/transaction_wait_queue.h"
+
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+using namespace std::literals;
+
+namespace yb {
+namespace tablet {
+
+class TransactionWaitQueueTest : public YBTest {
+ protected:
+  void SetUp() override {
+    YBTest::SetUp();
+    messenger_ = ASSERT_RESULT(rpc::MessengerBuilder("test").Build());
+    wait_queue_.emplace(&thread_pool_, [this]() -> rpc::Scheduler& {
+      return messenger_->scheduler();
+    });
+  }
+
+  void TearDown() override {
+    wait_queue_.reset();
+    messenger_->Shutdown();
+    YBTest::TearDown();
+  }
+
+  // Registers waiter and returns future that is ready once it is resumed.
+  std::future<Status> Wait(
+      const TransactionId& waiter, const TransactionIdSet& blockers, MonoDelta timeout) {
+    auto promise = std::make_shared<std::promise<Status>>();
+    auto status = wait_queue_->Wait(
+        waiter, blockers, MonoTime::Now() + timeout, [promise](const Status& status) {
+          promise->set_value(status);
+        });
+    if (!status.ok()) {
+      promise->set_value(status);
+    }
+    return promise->get_future();
+  }
+
+  rpc::ThreadPool thread_pool_{"test", 100UL, 4UL};
+  std::shared_ptr<rpc::Messenger> messenger_;
+  boost::optional<TransactionWaitQueue> wait_queue_;
+};
+
+TEST_F(TransactionWaitQueueTest, ResumedAtDeadline) {
+  auto waiter = GenerateTransactionId();
+  auto blocker = GenerateTransactionId();
+  auto future = Wait(waiter, {blocker}, 50ms);
+  ASSERT_EQ(std::future_status::ready, future.wait_for(10s));
+  ASSERT_OK(future.get());
+  ASSERT_EQ(0, wait_queue_->TEST_NumWaiters());
+}
+
+TEST_F(TransactionWaitQueueTest, ResumedWhenBlockerResolved) {
+  auto waiter = GenerateTransactionId();
+  auto blocker = GenerateTransactionId();
+  auto future = Wait(waiter, {blocker}, 30s);
+  ASSERT_EQ(1, wait_queue_->TEST_NumWaiters());
+
+  // Resolving an unrelated transaction does not resume the waiter.
+  wait_queue_->Resolved(GenerateTransactionId());
+  ASSERT_EQ(std::future_status::timeout, future.wait_for(50ms));
+  ASSERT_EQ(1, wait_queue_->TEST_NumWaiters());
+
+  wait_queue_->Resolved(blocker);
+  ASSERT_EQ(std::future_status::ready, future.wait_for(10s));
+  ASSERT_OK(future.get());
+  ASSERT_EQ(0, wait_queue_->TEST_NumWaiters());
+}
+
+TEST_F(TransactionWaitQueueTest, DetectsDeadlock) {
+  auto first = GenerateTransactionId();
+  auto second = GenerateTransactionId();
+  auto third = GenerateTransactionId();
+  // first -> second -> third, so third waiting for first closes the cycle.
+  auto first_future = Wait(first, {second}, 30s);
+  auto second_future = Wait(second, {third}, 30s);
+  ASSERT_EQ(2, wait_queue_->TEST_NumWaiters());
+
+  auto deadlock_status = Wait(third, {first}, 30s).get();
+  ASSERT_TRUE(deadlock_status.IsTryAgain()) << deadlock_status;
+
+  wait_queue_->Resolved(third);
+  ASSERT_OK(second_future.get());
+  wait_queue_->Resolved(second);
+  ASSERT_OK(first_future.get());
+}
+
+TEST_F(TransactionWaitQueueTest, Shutdown) {
+  auto waiter = GenerateTransactionId();
+  auto future = Wait(waiter, {GenerateTransactionId()}, 30s);
+  wait_queue_->Shutdown();
+  ASSERT_EQ(std::future_status::ready, future.wait_for(0s));
+  auto status = future.get();
+  ASSERT_TRUE(status.IsAborted()) << status;
+
+  status = Wait(waiter, {GenerateTransactionId()}, 30s).get();
+  ASSERT_TRUE(status.IsAborted()) << status;
+  ASSERT_EQ(0, wait_queue_->TEST_NumWaiters());
+}
+
+} // namespace tablet
+} // namespace yb
@@ -0,0 +1,249 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/tablet/transaction_wait_queue.h"
+
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <glog/logging.h>
+
+#include "yb/rpc/scheduler.h"
+#include "yb/rpc/thread_pool.h"
+
+namespace yb {
+namespace tablet {
+
+namespace {
+
+typedef TransactionWaitQueue::WaitCallback WaitCallback;
+
+struct Waiter {
+  TransactionId id;
+  TransactionIdSet blockers;
+  WaitCallback callback;
+  rpc::ScheduledTaskId timer_id = rpc::kUninitializedScheduledTaskId;
+  bool registered = true;
+};
+
+typedef std::shared_ptr<Waiter> WaiterPtr;
+
+// Runs callback of resumed waiter in thread pool, because conflict resolution could block.
+class ResumeTask final : public rpc::ThreadPoolTask {
+ public:
+  explicit ResumeTask(WaitCallback callback) : callback_(std::move(callback)) {}
+
+  void Run() override {
+    callback_(Status::OK());
+  }
+
+  void Done(const Status& status) override {
+    if (!status.ok()) {
+      callback_(status);
+    }
+    delete this;
+  }
+
+ private:
+  WaitCallback callback_;
+};
+
+template <class Map>
+void EraseEntry(Map* map, const TransactionId& key, const WaiterPtr& value) {
+  auto range = map->equal_range(key);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (it->second == value) {
+      map->erase(it);
+      return;
+    }
+  }
+  LOG(DFATAL) << "Wait queue entry not found: " << key;
+}
+
+} // namespace
+
+class TransactionWaitQueue::Impl : public std::enable_shared_from_this<Impl> {
+ public:
+  Impl(rpc::ThreadPool* thread_pool, std::function<rpc::Scheduler&()> scheduler_provider)
+      : thread_pool_(*thread_pool), scheduler_provider_(std::move(scheduler_provider)) {}
+
+  ~Impl() {
+    LOG_IF(DFATAL, !waiters_.empty()) << "Destroying wait queue with " << waiters_.size()
+                                      << " waiters";
+  }
+
+  CHECKED_STATUS Wait(
+      const TransactionId& waiter, const TransactionIdSet& blockers, MonoTime deadline,
+      WaitCallback callback) {
+    auto entry = std::make_shared<Waiter>();
+    entry->id = waiter;
+    entry->blockers = blockers;
+    entry->callback = std::move(callback);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (closing_) {
+        return STATUS(Aborted, "Transaction wait queue is shutting down");
+      }
+      if (HasPathToUnlocked(blockers, waiter)) {
+        return STATUS_FORMAT(TryAgain, "Deadlock detected while $0 waits for $1", waiter, blockers);
+      }
+      waiters_.emplace(waiter, entry);
+      for (const auto& blocker : blockers) {
+        waiters_by_blocker_.emplace(blocker, entry);
+      }
+    }
+
+    std::weak_ptr<Impl> weak_self = shared_from_this();
+    std::weak_ptr<Waiter> weak_entry = entry;
+    auto timer_id = scheduler_provider_().Schedule(
+        [weak_self, weak_entry](const Status&) {
+          auto self = weak_self.lock();
+          auto entry = weak_entry.lock();
+          if (self && entry) {
+            self->Resume(entry, Status::OK());
+          }
+        },
+        deadline.ToSteadyTimePoint());
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    entry->timer_id = timer_id;
+    return Status::OK();
+  }
+
+  void Resolved(const TransactionId& id) {
+    std::vector<WaiterPtr> resumed;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto range = waiters_by_blocker_.equal_range(id);
+      for (auto it = range.first; it != range.second; ++it) {
+        resumed.push_back(it->second);
+      }
+    }
+    for (const auto& entry : resumed) {
+      Resume(entry, Status::OK());
+    }
+  }
+
+  void Shutdown() {
+    std::vector<WaiterPtr> resumed;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      closing_ = true;
+      for (const auto& p : waiters_) {
+        resumed.push_back(p.second);
+      }
+    }
+    for (const auto& entry : resumed) {
+      Resume(entry, STATUS(Aborted, "Transaction wait queue is shutting down"));
+    }
+  }
+
+  size_t NumWaiters() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return waiters_.size();
+  }
+
+ private:
+  // Unregisters entry and invokes its callback, if it was not resumed yet.
+  void Resume(const WaiterPtr& entry, const Status& status) {
+    WaitCallback callback;
+    rpc::ScheduledTaskId timer_id;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!entry->registered) {
+        return;
+      }
+      entry->registered = false;
+      EraseEntry(&waiters_, entry->id, entry);
+      for (const auto& blocker : entry->blockers) {
+        EraseEntry(&waiters_by_blocker_, blocker, entry);
+      }
+      callback = std::move(entry->callback);
+      timer_id = entry->timer_id;
+    }
+
+    if (timer_id != rpc::kUninitializedScheduledTaskId) {
+      scheduler_provider_().Abort(timer_id);
+    }
+    if (!status.ok()) {
+      callback(status);
+      return;
+    }
+    thread_pool_.Enqueue(new ResumeTask(std::move(callback)));
+  }
+
+  // Returns true if one of blockers waits, directly or transitively, for waiter.
+  bool HasPathToUnlocked(const TransactionIdSet& blockers, const TransactionId& waiter) const {
+    TransactionIdSet visited;
+    std::vector<TransactionId> queue(blockers.begin(), blockers.end());
+    while (!queue.empty()) {
+      auto id = queue.back();
+      queue.pop_back();
+      if (id == waiter) {
+        return true;
+      }
+      if (!visited.insert(id).second) {
+        continue;
+      }
+      auto range = waiters_.equal_range(id);
+      for (auto it = range.first; it != range.second; ++it) {
+        queue.insert(queue.end(), it->second->blockers.begin(), it->second->blockers.end());
+      }
+    }
+    return false;
+  }
+
+  rpc::ThreadPool& thread_pool_;
+  std::function<rpc::Scheduler&()> scheduler_provider_;
+
+  mutable std::mutex mutex_;
+  bool closing_ = false;
+
+  // Waiters by transaction id of the waiter. The same transaction could wait in several
+  // concurrent write requests.
+  std::unordered_multimap<TransactionId, WaiterPtr, TransactionIdHash> waiters_;
+
+  // Waiters by transaction id of the blocker.
+  std::unordered_multimap<TransactionId, WaiterPtr, TransactionIdHash> waiters_by_blocker_;
+};
+
+TransactionWaitQueue::TransactionWaitQueue(
+    rpc::ThreadPool* thread_pool, std::function<rpc::Scheduler&()> scheduler_provider)
+    : impl_(std::make_shared<Impl>(thread_pool, std::move(scheduler_provider))) {
+}
+
+TransactionWaitQueue::~TransactionWaitQueue() {
+  impl_->Shutdown();
+}
+
+Status TransactionWaitQueue::Wait(
+    const TransactionId& waiter, const TransactionIdSet& blockers, MonoTime deadline,
+    WaitCallback callback) {
+  return impl_->Wait(waiter, blockers, deadline, std::move(callback));
+}
+
+void TransactionWaitQueue::Resolved(const TransactionId& id) {
+  impl_->Resolved(id);
+}
+
+void TransactionWaitQueue::Shutdown() {
+  impl_->Shutdown();
+}
+
+size_t TransactionWaitQueue::TEST_NumWaiters() const {
+  return impl_->NumWaiters();
+}
+
+} // namespace tablet
+} // namespace yb
@@ -0,0 +1,74 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_TABLET_TRANSACTION_WAIT_QUEUE_H
+#define YB_TABLET_TRANSACTION_WAIT_QUEUE_H
+
+#include <functional>
+#include <memory>
+
+#include "yb/common/transaction.h"
+
+#include "yb/rpc/rpc_fwd.h"
+
+#include "yb/util/monotime.h"
+#include "yb/util/status.h"
+
+namespace yb {
+namespace tablet {
+
+// Queue of write requests that are blocked by conflicting intents of other transactions in the
+// same tablet. Instead of failing with a conflict, a write request of lower priority transaction
+// releases its locks and waits until one of the transactions it conflicts with is resolved, i.e.
+// committed and applied or aborted and cleaned up. After that it runs conflict resolution again.
+//
+// Waits-for edges are also used to detect deadlocks between transactions waiting in this tablet.
+class TransactionWaitQueue {
+ public:
+  // Invoked with OK when the waiter should run conflict resolution again, i.e. one of its blockers
+  // was resolved or the deadline passed. Invoked with an error when the waiter could not be
+  // resumed, for instance because the queue is shutting down.
+  typedef std::function<void(const Status&)> WaitCallback;
+
+  // Callbacks are invoked in thread_pool, deadlines are tracked by the scheduler returned by
+  // scheduler_provider.
+  TransactionWaitQueue(
+      rpc::ThreadPool* thread_pool, std::function<rpc::Scheduler&()> scheduler_provider);
+  ~TransactionWaitQueue();
+
+  TransactionWaitQueue(const TransactionWaitQueue&) = delete;
+  void operator=(const TransactionWaitQueue&) = delete;
+
+  // Registers waiter, so callback is invoked once one of blockers is resolved or the deadline
+  // passes. Returns TryAgain without registering if waiting would create a deadlock.
+  CHECKED_STATUS Wait(
+      const TransactionId& waiter, const TransactionIdSet& blockers, MonoTime deadline,
+      WaitCallback callback);
+
+  // Resumes all requests waiting for the specified transaction.
+  void Resolved(const TransactionId& id);
+
+  // Fails all waiting requests. Requests that are added after this call fail right away.
+  void Shutdown();
+
+  size_t TEST_NumWaiters() const;
+
+ private:
+  class Impl;
+  std::shared_ptr<Impl> impl_;
+};
+
+} // namespace tablet
+} // namespace yb
+
+#endif // YB_TABLET_TRANSACTION_WAIT_QUEUE_H
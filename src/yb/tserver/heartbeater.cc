@@ -35,6 +35,7 @@
 #include <memory>
 #include <vector>
 #include <mutex>
+#include <unordered_map>
 
 #include <gflags/gflags.h>
 #include <glog/logging.h>
@@ -48,6 +49,7 @@
 #include "yb/server/server_base.proxy.h"
 #include "yb/server/webserver.h"
 #include "yb/tablet/tablet.h"
+#include "yb/tablet/tablet_metrics.h"
 #include "yb/tserver/tablet_server.h"
 #include "yb/tserver/tablet_server_options.h"
 #include "yb/tserver/ts_tablet_manager.h"
@@ -183,6 +185,9 @@ class Heartbeater::Thread {
   uint64_t prev_reads_;
   uint64_t prev_writes_;
 
+  // Stores the read and write ops of each tablet for computing per-tablet iops.
+  std::unordered_map<TabletId, std::pair<uint64_t, uint64_t>> prev_tablet_ops_;
+
   MonoTime start_time_;
 
   DISALLOW_COPY_AND_ASSIGN(Thread);
@@ -383,7 +388,11 @@ Status Heartbeater::Thread::TryHeartbeat() {
     }
 #endif
 
+    MonoDelta diff = MonoTime::Now() - prev_tserver_metrics_submission_;
+    double_t div = diff.ToSeconds();
+
     // Get the Total SST file sizes and set it in the proto buf
+    std::unordered_map<TabletId, std::pair<uint64_t, uint64_t>> tablet_ops;
     std::vector<shared_ptr<yb::tablet::TabletPeer> > tablet_peers;
     uint64_t total_file_sizes = 0;
     uint64_t uncompressed_file_sizes = 0;
@@ -392,10 +401,37 @@ Status Heartbeater::Thread::TryHeartbeat() {
       shared_ptr<yb::tablet::TabletPeer> tablet_peer = *it;
       if (tablet_peer) {
         shared_ptr<yb::tablet::TabletClass> tablet_class = tablet_peer->shared_tablet();
-        total_file_sizes += (tablet_class) ? tablet_class->GetTotalSSTFileSizes() : 0;
+        const uint64_t tablet_file_sizes =
+            (tablet_class) ? tablet_class->GetTotalSSTFileSizes() : 0;
+        total_file_sizes += tablet_file_sizes;
         uncompressed_file_sizes += (tablet_class) ? tablet_class->GetUncompressedSSTFileSizes() : 0;
+
+        auto* tablet_metrics = req.add_tablet_metrics();
+        tablet_metrics->set_tablet_id(tablet_peer->tablet_id());
+        tablet_metrics->set_is_leader(
+            tablet_peer->LeaderStatus() != consensus::Consensus::LeaderStatus::NOT_LEADER);
+        tablet_metrics->set_total_sst_file_size(tablet_file_sizes);
+        if (tablet_class && tablet_class->metadata()->has_parent_data()) {
+          tablet_metrics->set_has_parent_data(true);
+        }
+
+        tablet::TabletMetrics* metrics = tablet_class ? tablet_class->metrics() : nullptr;
+        if (metrics) {
+          const uint64_t tablet_reads = metrics->ql_read_latency->TotalCount() +
+                                        metrics->redis_read_latency->TotalCount();
+          const uint64_t tablet_writes = metrics->write_lock_latency->TotalCount();
+          tablet_ops.emplace(tablet_peer->tablet_id(), std::make_pair(tablet_reads, tablet_writes));
+          auto prev = prev_tablet_ops_.find(tablet_peer->tablet_id());
+          if (div > 0 && prev != prev_tablet_ops_.end()) {
+            tablet_metrics->set_read_ops_per_sec(
+                static_cast<double>(tablet_reads - prev->second.first) / div);
+            tablet_metrics->set_write_ops_per_sec(
+                static_cast<double>(tablet_writes - prev->second.second) / div);
+          }
+        }
       }
     }
+    prev_tablet_ops_.swap(tablet_ops);
     req.mutable_metrics()->set_total_sst_file_size(total_file_sizes);
     req.mutable_metrics()->set_uncompressed_sst_file_size(uncompressed_file_sizes);
 
@@ -409,9 +445,6 @@ Status Heartbeater::Thread::TryHeartbeat() {
     uint64_t num_writes = (writes_hist != nullptr) ? writes_hist->TotalCount() : 0;
 
     // Calculate the read and write ops per second.
-    MonoDelta diff = MonoTime::Now() - prev_tserver_metrics_submission_;
-    double_t div = diff.ToSeconds();
-
     double rops_per_sec = (div > 0 && num_reads > 0) ?
         (static_cast<double>(num_reads - prev_reads_) / div) : 0;
 
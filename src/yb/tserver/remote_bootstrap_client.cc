@@ -32,6 +32,8 @@
 
 #include "yb/tserver/remote_bootstrap_client.h"
 
+#include <unordered_set>
+
 #include <gflags/gflags.h>
 #include <glog/logging.h>
 
@@ -63,6 +65,7 @@
 #include "yb/util/net/net_util.h"
 #include "yb/util/net/rate_limiter.h"
 #include "yb/util/size_literals.h"
+#include "yb/util/threadpool.h"
 
 using namespace yb::size_literals;
 
@@ -110,6 +113,12 @@ DEFINE_int64(remote_boostrap_rate_limit_bytes_per_sec, 100_MB,
              "the total limit will be 2 * remote_boostrap_rate_limit_bytes_per_sec because a "
              "tserver or master can act both as a sender and receiver at the same time.");
 
+DEFINE_int32(remote_bootstrap_max_concurrent_file_downloads, 4,
+             "Maximum number of RocksDB files that a remote bootstrap session downloads "
+             "concurrently. The transmission rate limit is shared by all of these downloads.");
+TAG_FLAG(remote_bootstrap_max_concurrent_file_downloads, advanced);
+TAG_FLAG(remote_bootstrap_max_concurrent_file_downloads, runtime);
+
 DEFINE_int32(bytes_remote_bootstrap_durable_write_mb, 8,
              "Explicitly call fsync after downloading the specified amount of data in MB "
              "during a remote bootstrap session. If 0 fsync() is not called.");
@@ -141,6 +150,25 @@ using tablet::TabletSuperBlockPB;
 
 constexpr int kBytesReservedForMessageHeaders = 16384;
 std::atomic<int32_t> RemoteBootstrapClient::n_started_(0);
+std::atomic<int32_t> RemoteBootstrapClient::n_downloading_files_(0);
+
+namespace {
+
+class DownloadingFileCounter {
+ public:
+  explicit DownloadingFileCounter(std::atomic<int32_t>* counter) : counter_(counter) {
+    counter_->fetch_add(1, std::memory_order_acq_rel);
+  }
+
+  ~DownloadingFileCounter() {
+    counter_->fetch_sub(1, std::memory_order_acq_rel);
+  }
+
+ private:
+  std::atomic<int32_t>* counter_;
+};
+
+} // namespace
 
 RemoteBootstrapClient::RemoteBootstrapClient(std::string tablet_id,
                                              FsManager* fs_manager,
@@ -580,16 +608,23 @@ Status RemoteBootstrapClient::DownloadFile(
   RETURN_NOT_OK(fs_manager_->env()->CreateDirs(DirName(file_path)));
 
   if (file_pb.inode() != 0) {
-    auto it = inode2file_.find(file_pb.inode());
-    if (it != inode2file_.end()) {
+    std::string linked_file;
+    {
+      std::lock_guard<std::mutex> lock(inode2file_mutex_);
+      auto it = inode2file_.find(file_pb.inode());
+      if (it != inode2file_.end()) {
+        linked_file = it->second;
+      }
+    }
+    if (!linked_file.empty()) {
       VLOG_WITH_PREFIX(2) << "File with the same inode already found: " << file_path
-                          << " => " << it->second;
-      auto link_status = fs_manager_->env()->LinkFile(it->second, file_path);
+                          << " => " << linked_file;
+      auto link_status = fs_manager_->env()->LinkFile(linked_file, file_path);
       if (link_status.ok()) {
         return Status::OK();
       }
       // TODO fallback to copy.
-      LOG_WITH_PREFIX(ERROR) << "Failed to link file: " << file_path << " => " << it->second
+      LOG_WITH_PREFIX(ERROR) << "Failed to link file: " << file_path << " => " << linked_file
                              << ": " << link_status;
     }
   }
@@ -606,6 +641,7 @@ Status RemoteBootstrapClient::DownloadFile(
   VLOG_WITH_PREFIX(2) << "Downloaded file " << file_path;
 
   if (file_pb.inode() != 0) {
+    std::lock_guard<std::mutex> lock(inode2file_mutex_);
     inode2file_.emplace(file_pb.inode(), file_path);
   }
 
@@ -633,14 +669,25 @@ Status RemoteBootstrapClient::DownloadRocksDBFiles() {
 
   RETURN_NOT_OK(CreateTabletDirectories(rocksdb_dir, meta_->fs_manager()));
 
-  DataIdPB data_id;
-  data_id.set_type(DataIdPB::ROCKSDB_FILE);
+  // Files that share an inode with a previous file are hard linked to it, so they are handled
+  // after all other files are downloaded.
+  std::vector<const tablet::FilePB*> files;
+  std::vector<const tablet::FilePB*> linked_files;
+  std::unordered_set<uint64_t> inodes;
   for (auto const& file_pb : new_sb->rocksdb_files()) {
-    auto start = MonoTime::Now();
-    RETURN_NOT_OK(DownloadFile(file_pb, rocksdb_dir, &data_id));
-    auto elapsed = MonoTime::Now().GetDeltaSince(start);
-    LOG(INFO) << "Downloaded file " << file_pb.name() << " of size " << file_pb.size_bytes()
-              << " in " << elapsed.ToSeconds() << " seconds";
+    if (file_pb.inode() != 0 && !inodes.insert(file_pb.inode()).second) {
+      linked_files.push_back(&file_pb);
+    } else {
+      files.push_back(&file_pb);
+    }
+    // Create directories upfront, so concurrent downloads don't race creating them.
+    RETURN_NOT_OK(fs_manager_->env()->CreateDirs(
+        DirName(JoinPathSegments(rocksdb_dir, file_pb.name()))));
+  }
+
+  RETURN_NOT_OK(DownloadRocksDBFilesConcurrently(files, rocksdb_dir));
+  for (const auto* file_pb : linked_files) {
+    RETURN_NOT_OK(DownloadRocksDBFile(*file_pb, rocksdb_dir));
   }
 
   // To avoid adding new file type to remote bootstrap we move intents as subdir of regular DB.
@@ -659,6 +706,63 @@ Status RemoteBootstrapClient::DownloadRocksDBFiles() {
   return Status::OK();
 }
 
+Status RemoteBootstrapClient::DownloadRocksDBFilesConcurrently(
+    const std::vector<const tablet::FilePB*>& files, const std::string& dir) {
+  size_t max_concurrency = std::max(FLAGS_remote_bootstrap_max_concurrent_file_downloads, 1);
+  if (max_concurrency == 1 || files.size() <= 1) {
+    for (const auto* file_pb : files) {
+      RETURN_NOT_OK(DownloadRocksDBFile(*file_pb, dir));
+    }
+    return Status::OK();
+  }
+
+  std::unique_ptr<ThreadPool> pool;
+  RETURN_NOT_OK(ThreadPoolBuilder("rb-download")
+                    .set_max_threads(static_cast<int>(std::min(max_concurrency, files.size())))
+                    .Build(&pool));
+
+  std::mutex mutex;
+  Status result;
+  std::atomic<bool> failed{false};
+  for (const auto* file_pb : files) {
+    auto submit_status = pool->SubmitFunc([this, file_pb, &dir, &mutex, &result, &failed] {
+      // Don't start new downloads once one of them failed.
+      if (failed.load(std::memory_order_acquire)) {
+        return;
+      }
+      auto status = DownloadRocksDBFile(*file_pb, dir);
+      if (!status.ok()) {
+        failed.store(true, std::memory_order_release);
+        std::lock_guard<std::mutex> lock(mutex);
+        if (result.ok()) {
+          result = status;
+        }
+      }
+    });
+    if (!submit_status.ok()) {
+      failed.store(true, std::memory_order_release);
+      pool->Shutdown();
+      return submit_status;
+    }
+  }
+  pool->Wait();
+  pool->Shutdown();
+
+  return result;
+}
+
+Status RemoteBootstrapClient::DownloadRocksDBFile(
+    const tablet::FilePB& file_pb, const std::string& dir) {
+  DataIdPB data_id;
+  data_id.set_type(DataIdPB::ROCKSDB_FILE);
+  auto start = MonoTime::Now();
+  RETURN_NOT_OK(DownloadFile(file_pb, dir, &data_id));
+  auto elapsed = MonoTime::Now().GetDeltaSince(start);
+  LOG_WITH_PREFIX(INFO) << "Downloaded file " << file_pb.name() << " of size "
+                        << file_pb.size_bytes() << " in " << elapsed.ToSeconds() << " seconds";
+  return Status::OK();
+}
+
 Status RemoteBootstrapClient::DownloadWAL(uint64_t wal_segment_seqno) {
   VLOG_WITH_PREFIX(1) << "Downloading WAL segment with seqno " << wal_segment_seqno;
   DataIdPB data_id;
@@ -738,15 +842,19 @@ Status RemoteBootstrapClient::DownloadFile(const DataIdPB& data_id,
   int32_t max_length = std::min(FLAGS_remote_bootstrap_max_chunk_size,
                                 FLAGS_rpc_max_message_size - kBytesReservedForMessageHeaders);
 
+  DownloadingFileCounter downloading_file_counter(&n_downloading_files_);
   std::unique_ptr<RateLimiter> rate_limiter;
 
   if (FLAGS_remote_boostrap_rate_limit_bytes_per_sec > 0) {
     static auto rate_updater = []() {
-      if (n_started_.load(std::memory_order_acquire) < 1) {
-        YB_LOG_EVERY_N(ERROR, 100) << "Invalid number of remote bootstrap sessions: " << n_started_;
+      auto n_downloading_files = n_downloading_files_.load(std::memory_order_acquire);
+      if (n_downloading_files < 1) {
+        YB_LOG_EVERY_N(ERROR, 100) << "Invalid number of downloading files: "
+                                   << n_downloading_files;
         return static_cast<uint64_t>(FLAGS_remote_boostrap_rate_limit_bytes_per_sec);
       }
-      return static_cast<uint64_t>(FLAGS_remote_boostrap_rate_limit_bytes_per_sec / n_started_);
+      return static_cast<uint64_t>(
+          FLAGS_remote_boostrap_rate_limit_bytes_per_sec / n_downloading_files);
     };
 
     rate_limiter = std::make_unique<RateLimiter>(rate_updater);
@@ -773,29 +881,44 @@ Status RemoteBootstrapClient::DownloadFile(const DataIdPB& data_id,
       max_length = std::min(max_length, decltype(max_length)(max_size));
     }
     req.set_max_length(max_length);
+    req.set_data_in_sidecar(true);
 
     FetchDataResponsePB resp;
     auto status = rate_limiter->SendOrReceiveData([this, &req, &resp, &controller]() {
       return proxy_->FetchData(req, &resp, &controller);
-    }, [&resp]() { return resp.ByteSize(); });
+    }, [&resp, &controller]() {
+      // The chunk data is not a part of the response protobuf, when it is sent in a sidecar.
+      uint64_t size = resp.ByteSize();
+      Slice sidecar;
+      if (resp.chunk().has_data_sidecar_idx() &&
+          controller.GetSidecar(resp.chunk().data_sidecar_idx(), &sidecar).ok()) {
+        size += sidecar.size();
+      }
+      return size;
+    });
     RETURN_NOT_OK_UNWIND_PREPEND(status, controller, "Unable to fetch data from remote");
-    DCHECK_LE(resp.chunk().data().size(), max_length);
+
+    // Servers that don't support sidecars for this RPC send the data in the chunk itself.
+    Slice data(resp.chunk().data());
+    if (resp.chunk().has_data_sidecar_idx()) {
+      RETURN_NOT_OK(controller.GetSidecar(resp.chunk().data_sidecar_idx(), &data));
+    }
+    DCHECK_LE(data.size(), max_length);
 
     // Sanity-check for corruption.
-    RETURN_NOT_OK_PREPEND(VerifyData(offset, resp.chunk()),
+    RETURN_NOT_OK_PREPEND(VerifyData(offset, resp.chunk(), data),
                           Substitute("Error validating data item $0", data_id.ShortDebugString()));
 
     // Write the data.
-    RETURN_NOT_OK(appendable->Append(resp.chunk().data()));
-    VLOG(3) << "resp size: " << resp.ByteSize()
-            << ", chunk size: " << resp.chunk().data().size();
+    RETURN_NOT_OK(appendable->Append(data));
+    VLOG(3) << "resp size: " << resp.ByteSize() << ", chunk size: " << data.size();
 
-    if (offset + resp.chunk().data().size() == resp.chunk().total_data_length()) {
+    if (offset + data.size() == resp.chunk().total_data_length()) {
       done = true;
     }
-    offset += resp.chunk().data().size();
+    offset += data.size();
     if (FLAGS_bytes_remote_bootstrap_durable_write_mb != 0) {
-      periodic_sync_unsynced_bytes += resp.chunk().data().size();
+      periodic_sync_unsynced_bytes += data.size();
       if (periodic_sync_unsynced_bytes > FLAGS_bytes_remote_bootstrap_durable_write_mb * 1_MB) {
         RETURN_NOT_OK(appendable->Sync());
         periodic_sync_unsynced_bytes = 0;
@@ -808,7 +931,8 @@ Status RemoteBootstrapClient::DownloadFile(const DataIdPB& data_id,
   return Status::OK();
 }
 
-Status RemoteBootstrapClient::VerifyData(uint64_t offset, const DataChunkPB& chunk) {
+Status RemoteBootstrapClient::VerifyData(
+    uint64_t offset, const DataChunkPB& chunk, const Slice& data) {
   // Verify the offset is what we expected.
   if (offset != chunk.offset()) {
     return STATUS(InvalidArgument, "Offset did not match what was asked for",
@@ -816,11 +940,11 @@ Status RemoteBootstrapClient::VerifyData(uint64_t offset, const DataChunkPB& chu
   }
 
   // Verify the checksum.
-  uint32_t crc32 = crc::Crc32c(chunk.data().data(), chunk.data().length());
+  uint32_t crc32 = crc::Crc32c(data.data(), data.size());
   if (PREDICT_FALSE(crc32 != chunk.crc32())) {
     return STATUS(Corruption,
         Substitute("CRC32 does not match at offset $0 size $1: $2 vs $3",
-          offset, chunk.data().size(), crc32, chunk.crc32()));
+          offset, data.size(), crc32, chunk.crc32()));
   }
   return Status::OK();
 }
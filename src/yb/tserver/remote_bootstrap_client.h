@@ -35,6 +35,7 @@
 #include <atomic>
 #include <string>
 #include <memory>
+#include <mutex>
 #include <vector>
 #include <unordered_map>
 
@@ -46,6 +47,7 @@
 #include "yb/gutil/ref_counted.h"
 #include "yb/rpc/rpc_fwd.h"
 #include "yb/tserver/remote_bootstrap.pb.h"
+#include "yb/util/slice.h"
 #include "yb/util/status.h"
 
 namespace yb {
@@ -135,6 +137,7 @@ class RemoteBootstrapClient {
  protected:
   FRIEND_TEST(RemoteBootstrapRocksDBClientTest, TestBeginEndSession);
   FRIEND_TEST(RemoteBootstrapRocksDBClientTest, TestDownloadRocksDBFiles);
+  FRIEND_TEST(RemoteBootstrapRocksDBClientTest, TestDownloadRocksDBFilesSequentially);
 
   // Extract the embedded Status message from the given ErrorStatusPB.
   // The given ErrorStatusPB must extend RemoteBootstrapErrorPB.
@@ -182,7 +185,14 @@ class RemoteBootstrapClient {
 
   CHECKED_STATUS DownloadRocksDBFiles();
 
-  CHECKED_STATUS VerifyData(uint64_t offset, const DataChunkPB& resp);
+  // Downloads files, up to --remote_bootstrap_max_concurrent_file_downloads of them concurrently.
+  // Files should not share inodes, and their directories should already exist.
+  CHECKED_STATUS DownloadRocksDBFilesConcurrently(
+      const std::vector<const tablet::FilePB*>& files, const std::string& dir);
+
+  CHECKED_STATUS DownloadRocksDBFile(const tablet::FilePB& file_pb, const std::string& dir);
+
+  CHECKED_STATUS VerifyData(uint64_t offset, const DataChunkPB& chunk, const Slice& data);
 
   CHECKED_STATUS DownloadFile(
       const tablet::FilePB& file_pb, const std::string& dir, DataIdPB* data_id);
@@ -200,6 +210,10 @@ class RemoteBootstrapClient {
   // Total number of remote bootstrap sessions. Used to calculate the transmission rate across all
   // the sessions.
   static std::atomic<int32_t> n_started_;
+  // Total number of files that are being downloaded by all the remote bootstrap sessions. Files of
+  // the same session could be downloaded concurrently, so the transmission rate is divided among
+  // the files rather than among the sessions.
+  static std::atomic<int32_t> n_downloading_files_;
   bool downloaded_wal_;     // WAL segments downloaded.
   bool downloaded_blocks_;  // Data blocks downloaded.
   bool downloaded_rocksdb_files_;
@@ -230,6 +244,7 @@ class RemoteBootstrapClient {
   bool succeeded_;
 
  private:
+  std::mutex inode2file_mutex_;
   std::unordered_map<uint64_t, std::string> inode2file_;
 
   DISALLOW_COPY_AND_ASSIGN(RemoteBootstrapClient);
@@ -18,6 +18,9 @@
 
 using std::shared_ptr;
 
+DECLARE_int32(remote_bootstrap_max_chunk_size);
+DECLARE_int32(remote_bootstrap_max_concurrent_file_downloads);
+
 namespace yb {
 namespace tserver {
 
@@ -33,6 +36,41 @@ class RemoteBootstrapRocksDBClientTest : public RemoteBootstrapClientTest {
   void SetUp() override {
     RemoteBootstrapClientTest::SetUp();
   }
+
+ protected:
+  // Verify that the client has the same RocksDB files that the leader has.
+  void VerifyDownloadedRocksDBFiles() {
+    auto tablet_peer_checkpoint_dir = tablet_peer_->tablet()->GetLastRocksDBCheckpointDirForTest();
+
+    vector<std::string> rocksdb_files;
+    ASSERT_OK(fs_manager_->ListDir(meta_->rocksdb_dir(), &rocksdb_files));
+
+    vector<std::string> tablet_peer_checkpoint_files;
+    ASSERT_OK(tablet_peer_->tablet_metadata()->fs_manager()->ListDir(
+        tablet_peer_checkpoint_dir, &tablet_peer_checkpoint_files));
+
+    ASSERT_EQ(rocksdb_files.size(), tablet_peer_checkpoint_files.size());
+    std::sort(rocksdb_files.begin(), rocksdb_files.end());
+    std::sort(tablet_peer_checkpoint_files.begin(), tablet_peer_checkpoint_files.end());
+    // Verify that the client has the same files that the leader has.
+    for (int i = 0; i < rocksdb_files.size(); ++i) {
+      auto local_rocksdb_file = rocksdb_files[i];
+      auto tablet_peer_rocksdb_file = tablet_peer_checkpoint_files[i];
+      ASSERT_EQ(local_rocksdb_file, tablet_peer_rocksdb_file);
+
+      if (local_rocksdb_file == "." || local_rocksdb_file == "..") {
+        continue;
+      }
+
+      auto local_rocksdb_file_path = JoinPathSegments(meta_->rocksdb_dir(), local_rocksdb_file);
+      auto tablet_peer_rocksdb_file_path = JoinPathSegments(tablet_peer_checkpoint_dir,
+                                                            tablet_peer_rocksdb_file);
+
+      LOG(INFO) << "Comparing file " << local_rocksdb_file_path
+                << " and file " << tablet_peer_rocksdb_file_path;
+      ASSERT_OK(CompareFileContents(local_rocksdb_file_path, tablet_peer_rocksdb_file_path));
+    }
+  }
 };
 
 // Basic begin / end remote bootstrap session.
@@ -46,36 +84,17 @@ TEST_F(RemoteBootstrapRocksDBClientTest, TestBeginEndSession) {
 TEST_F(RemoteBootstrapRocksDBClientTest, TestDownloadRocksDBFiles) {
   TabletStatusListener listener(meta_);
   ASSERT_OK(client_->DownloadRocksDBFiles());
-  auto tablet_peer_checkpoint_dir = tablet_peer_->tablet()->GetLastRocksDBCheckpointDirForTest();
-
-  vector<std::string> rocksdb_files;
-  ASSERT_OK(fs_manager_->ListDir(meta_->rocksdb_dir(), &rocksdb_files));
-
-  vector<std::string> tablet_peer_checkpoint_files;
-  ASSERT_OK(tablet_peer_->tablet_metadata()->fs_manager()->ListDir(tablet_peer_checkpoint_dir,
-                                                                   &tablet_peer_checkpoint_files));
-
-  ASSERT_EQ(rocksdb_files.size(), tablet_peer_checkpoint_files.size());
-  std::sort(rocksdb_files.begin(), rocksdb_files.end());
-  std::sort(tablet_peer_checkpoint_files.begin(), tablet_peer_checkpoint_files.end());
-  // Verify that the client has the same files that the leader has.
-  for (int i = 0; i < rocksdb_files.size(); ++i) {
-    auto local_rocksdb_file = rocksdb_files[i];
-    auto tablet_peer_rocksdb_file = tablet_peer_checkpoint_files[i];
-    ASSERT_EQ(local_rocksdb_file, tablet_peer_rocksdb_file);
-
-    if (local_rocksdb_file == "." || local_rocksdb_file == "..") {
-      continue;
-    }
-
-    auto local_rocksdb_file_path = JoinPathSegments(meta_->rocksdb_dir(), local_rocksdb_file);
-    auto tablet_peer_rocksdb_file_path = JoinPathSegments(tablet_peer_checkpoint_dir,
-                                                          tablet_peer_rocksdb_file);
+  ASSERT_NO_FATALS(VerifyDownloadedRocksDBFiles());
+}
 
-    LOG(INFO) << "Comparing file " << local_rocksdb_file_path
-              << " and file " << tablet_peer_rocksdb_file_path;
-    ASSERT_OK(CompareFileContents(local_rocksdb_file_path, tablet_peer_rocksdb_file_path));
-  }
+// Download RocksDB files one by one, in chunks small enough for each file to take multiple
+// FetchData calls.
+TEST_F(RemoteBootstrapRocksDBClientTest, TestDownloadRocksDBFilesSequentially) {
+  FLAGS_remote_bootstrap_max_concurrent_file_downloads = 1;
+  FLAGS_remote_bootstrap_max_chunk_size = 1024;
+  TabletStatusListener listener(meta_);
+  ASSERT_OK(client_->DownloadRocksDBFiles());
+  ASSERT_NO_FATALS(VerifyDownloadedRocksDBFiles());
 }
 
 } // namespace tserver
@@ -230,7 +230,7 @@ Status RemoteBootstrapServiceImpl::GetDataFilePiece(
     const scoped_refptr<RemoteBootstrapSessionClass>& session,
     uint64_t offset,
     int64_t client_maxlen,
-    string* data,
+    RefCntBuffer* data,
     int64_t* total_data_length,
     RemoteBootstrapErrorPB::Code* error_code) {
 
@@ -287,13 +287,17 @@ void RemoteBootstrapServiceImpl::FetchData(const FetchDataRequestPB* req,
     ResetSessionExpirationUnlocked(session_id);
   }
 
-  session->EnsureRateLimiterIsInitialized();
+  uint64_t rate_limit;
+  {
+    std::lock_guard<std::mutex> lock(session->rate_limiter_mutex());
+    session->EnsureRateLimiterIsInitialized();
+    rate_limit = session->rate_limiter().GetMaxSizeForNextTransmission();
+  }
 
   MAYBE_FAULT(FLAGS_fault_crash_on_handle_rb_fetch_data);
 
   uint64_t offset = req->offset();
-  VLOG(3) << " rate limiter max len: "  << session->rate_limiter().GetMaxSizeForNextTransmission();
-  auto rate_limit = session->rate_limiter().GetMaxSizeForNextTransmission();
+  VLOG(3) << " rate limiter max len: "  << rate_limit;
   int64_t client_maxlen = rate_limit == 0
       ? req->max_length() : std::min(static_cast<uint64_t>(req->max_length()), rate_limit);
   const DataIdPB& data_id = req->data_id();
@@ -302,19 +306,42 @@ void RemoteBootstrapServiceImpl::FetchData(const FetchDataRequestPB* req,
                     error_code, "Invalid DataId");
 
   DataChunkPB* data_chunk = resp->mutable_chunk();
-  string* data = data_chunk->mutable_data();
+  RefCntBuffer data;
   int64_t total_data_length = 0;
-  RPC_RETURN_NOT_OK(GetDataFilePiece(data_id, session, offset, client_maxlen, data,
+  RPC_RETURN_NOT_OK(GetDataFilePiece(data_id, session, offset, client_maxlen, &data,
                                      &total_data_length, &error_code),
                     error_code, "Unable to get piece of data file");
 
   data_chunk->set_total_data_length(total_data_length);
-  session->rate_limiter().UpdateDataSizeAndMaybeSleep(data->size());
+  MonoDelta delay;
+  {
+    // Concurrent fetches of the same session are throttled together, so the session rate limit
+    // holds regardless of the number of chunks the client fetches in parallel. The delay is
+    // computed under the lock, but we sleep after releasing it, so other fetches of the session
+    // are not serialized behind this one.
+    std::lock_guard<std::mutex> lock(session->rate_limiter_mutex());
+    delay = session->rate_limiter().UpdateDataSizeAndGetDelay(data.size());
+  }
+  if (delay.ToMilliseconds() > 0) {
+    SleepFor(delay);
+  }
   data_chunk->set_offset(offset);
 
   // Calculate checksum.
-  uint32_t crc32 = Crc32c(data->data(), data->length());
+  uint32_t crc32 = Crc32c(data.data(), data.size());
   data_chunk->set_crc32(crc32);
+
+  if (req->data_in_sidecar()) {
+    // The chunk was read directly into the sidecar buffer, so it is sent without copying it into
+    // the response protobuf and serializing it once more.
+    data_chunk->set_data("");
+    int sidecar_idx = 0;
+    RPC_RETURN_NOT_OK(context.AddRpcSidecar(std::move(data), &sidecar_idx),
+                      RemoteBootstrapErrorPB::UNKNOWN_ERROR, "Unable to add data sidecar");
+    data_chunk->set_data_sidecar_idx(sidecar_idx);
+  } else {
+    data_chunk->set_data(data.data(), data.size());
+  }
   context.RespondSuccess();
 }
 
@@ -211,7 +211,7 @@ class RemoteBootstrapTest : public YBTabletTest {
   void FetchBlockToFile(const BlockId& block_id,
                         string* path,
                         gscoped_ptr<SequentialFile>* file) {
-    string data;
+    RefCntBuffer data;
     int64_t block_file_size = 0;
     RemoteBootstrapErrorPB::Code error_code;
     ASSERT_OK(session_->GetBlockPiece(block_id, 0, 0, &data, &block_file_size, &error_code));
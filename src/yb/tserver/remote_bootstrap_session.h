@@ -33,6 +33,7 @@
 #define YB_TSERVER_REMOTE_BOOTSTRAP_SESSION_H_
 
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -50,6 +51,7 @@
 #include "yb/util/env_util.h"
 #include "yb/util/net/rate_limiter.h"
 #include "yb/util/locks.h"
+#include "yb/util/ref_cnt_buffer.h"
 #include "yb/util/status.h"
 
 namespace yb {
@@ -122,34 +124,33 @@ class RemoteBootstrapSession : public RefCountedThreadSafe<RemoteBootstrapSessio
 
   // Open block for reading, if it's not already open, and read some of it.
   // If maxlen is 0, we use a system-selected length for the data piece.
-  // *data is set to a std::string containing the data. Ownership of this object
-  // is passed to the caller. A string is used because the RPC interface is
-  // sending data serialized as protobuf and we want to minimize copying.
+  // *data is set to a buffer containing the data. The data is read directly into this buffer,
+  // so it could be sent as an RPC sidecar without being copied again.
   // On error, Status is set to a non-OK value and error_code is filled in.
   //
   // This method is thread-safe.
   CHECKED_STATUS GetBlockPiece(
       const BlockId& block_id, uint64_t offset, int64_t client_maxlen,
-      std::string* data, int64_t* block_file_size, RemoteBootstrapErrorPB::Code* error_code);
+      RefCntBuffer* data, int64_t* block_file_size, RemoteBootstrapErrorPB::Code* error_code);
 
   // Get a piece of a log segment.
   // The behavior and params are very similar to GetBlockPiece(), but this one
   // is only for sending WAL segment files.
   CHECKED_STATUS GetLogSegmentPiece(
       uint64_t segment_seqno, uint64_t offset, int64_t client_maxlen,
-      std::string* data, int64_t* log_file_size, RemoteBootstrapErrorPB::Code* error_code);
+      RefCntBuffer* data, int64_t* log_file_size, RemoteBootstrapErrorPB::Code* error_code);
 
   // Get a piece of a RocksDB checkpoint file.
   CHECKED_STATUS GetRocksDBFilePiece(
       const std::string file_name, uint64_t offset, int64_t client_maxlen,
-      std::string* data, int64_t* log_file_size, RemoteBootstrapErrorPB::Code* error_code);
+      RefCntBuffer* data, int64_t* log_file_size, RemoteBootstrapErrorPB::Code* error_code);
 
   // Get a piece of a RocksDB file.
   // The behavior and params are very similar to GetBlockPiece(), but this one
   // is only for sending rocksdb files.
   CHECKED_STATUS GetFilePiece(
       const std::string path, const std::string file_name, uint64_t offset, int64_t client_maxlen,
-      std::string* data, int64_t* log_file_size, RemoteBootstrapErrorPB::Code* error_code);
+      RefCntBuffer* data, int64_t* log_file_size, RemoteBootstrapErrorPB::Code* error_code);
 
   MonoTime start_time() { return start_time_; }
 
@@ -177,6 +178,10 @@ class RemoteBootstrapSession : public RefCountedThreadSafe<RemoteBootstrapSessio
 
   RateLimiter& rate_limiter() { return rate_limiter_; }
 
+  // Chunks of a session could be fetched concurrently, while RateLimiter is not thread safe.
+  // Rate limiter should be used only while holding this mutex.
+  std::mutex& rate_limiter_mutex() { return rate_limiter_mutex_; }
+
  protected:
   friend class RefCountedThreadSafe<RemoteBootstrapSession>;
 
@@ -244,6 +249,7 @@ class RemoteBootstrapSession : public RefCountedThreadSafe<RemoteBootstrapSessio
   MonoTime start_time_;
 
   // Used to limit the transmission rate.
+  std::mutex rate_limiter_mutex_;
   RateLimiter rate_limiter_;
 
   // Pointer to the counter for of the number of sessions in RemoteBootstrapService. Used to
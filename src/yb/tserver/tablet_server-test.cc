@@ -31,6 +31,7 @@
 //
 
 #include "yb/consensus/log-test-base.h"
+#include "yb/consensus/multi_raft_batcher.h"
 
 #include "yb/gutil/strings/escaping.h"
 #include "yb/gutil/strings/substitute.h"
@@ -49,6 +50,7 @@
 #include "yb/tserver/tablet_server_test_util.h"
 #include "yb/tserver/tserver_admin.proxy.h"
 
+#include "yb/util/async_util.h"
 #include "yb/util/crc.h"
 #include "yb/util/curl_util.h"
 #include "yb/util/url-coding.h"
@@ -79,6 +81,8 @@ DECLARE_int32(metrics_retirement_age_ms);
 DECLARE_string(block_manager);
 DECLARE_string(rpc_bind_addresses);
 DECLARE_bool(disable_clock_sync_error);
+DECLARE_int32(multi_raft_batch_size);
+DECLARE_int32(multi_raft_heartbeat_window_ms);
 
 // Declare these metrics prototypes for simpler unit testing of their behavior.
 METRIC_DECLARE_counter(rows_inserted);
@@ -848,6 +852,87 @@ void CalcTestRowChecksum(uint64_t *out, int32_t key, uint8_t string_field_define
 
 } // namespace
 
+namespace {
+
+// Heartbeat with a stale term, so it is rejected by the tablet leader without side effects.
+consensus::ConsensusRequestPB MakeHeartbeat(const string& tablet_id, const string& dest_uuid) {
+  consensus::ConsensusRequestPB req;
+  req.set_tablet_id(tablet_id);
+  req.set_dest_uuid(dest_uuid);
+  req.set_caller_uuid("fake-leader");
+  req.set_caller_term(0);
+  req.mutable_committed_index()->CopyFrom(consensus::MinimumOpId());
+  return req;
+}
+
+} // namespace
+
+// Errors of one tablet in a MultiRaftUpdateConsensus batch are reported for that tablet only.
+TEST_F(TabletServerTest, TestMultiRaftUpdateConsensusPerTabletErrors) {
+  const auto& uuid = mini_server_->server()->permanent_uuid();
+  consensus::MultiRaftConsensusRequestPB req;
+  *req.add_consensus_request() = MakeHeartbeat(kTabletId, uuid);
+  *req.add_consensus_request() = MakeHeartbeat("no-such-tablet", uuid);
+  *req.add_consensus_request() = MakeHeartbeat(kTabletId, "no-such-server");
+
+  consensus::MultiRaftConsensusResponsePB resp;
+  RpcController controller;
+  ASSERT_OK(consensus_proxy_->MultiRaftUpdateConsensus(req, &resp, &controller));
+  ASSERT_EQ(3, resp.consensus_response_size());
+
+  const auto& tablet_resp = resp.consensus_response(0);
+  ASSERT_FALSE(tablet_resp.has_error()) << tablet_resp.ShortDebugString();
+  ASSERT_GE(tablet_resp.responder_term(), 1);
+  ASSERT_EQ(TabletServerErrorPB::TABLET_NOT_FOUND, resp.consensus_response(1).error().code());
+  ASSERT_EQ(TabletServerErrorPB::WRONG_SERVER_UUID, resp.consensus_response(2).error().code());
+}
+
+// Heartbeats added to the batcher are sent together, and each sender gets its own response.
+TEST_F(TabletServerTest, TestMultiRaftHeartbeatBatcher) {
+  google::FlagSaver flag_saver;
+  constexpr int kBatchSize = 3;
+  FLAGS_multi_raft_batch_size = kBatchSize;
+  // Only a full batch could be sent within the test timeout.
+  FLAGS_multi_raft_heartbeat_window_ms = 600000;
+
+  auto batcher = std::make_shared<consensus::MultiRaftHeartbeatBatcher>(
+      HostPort::FromBoundEndpoint(mini_server_->bound_rpc_addr()), proxy_cache_.get(),
+      client_messenger_);
+  const auto& uuid = mini_server_->server()->permanent_uuid();
+  const std::vector<string> tablet_ids = {kTabletId, "no-such-tablet", kTabletId};
+  std::vector<consensus::ConsensusResponsePB> responses(kBatchSize);
+  std::vector<Status> statuses(kBatchSize);
+  CountDownLatch latch(kBatchSize);
+  for (int i = 0; i != kBatchSize; ++i) {
+    batcher->AddRequestToBatch(
+        MakeHeartbeat(tablet_ids[i], uuid), &responses[i],
+        [&statuses, &latch, i](const Status& status) {
+          statuses[i] = status;
+          latch.CountDown();
+        });
+  }
+  ASSERT_TRUE(latch.WaitFor(MonoDelta::FromSeconds(30)));
+
+  for (int i = 0; i != kBatchSize; ++i) {
+    ASSERT_OK(statuses[i]);
+  }
+  ASSERT_FALSE(responses[0].has_error()) << responses[0].ShortDebugString();
+  ASSERT_EQ(TabletServerErrorPB::TABLET_NOT_FOUND, responses[1].error().code());
+  ASSERT_FALSE(responses[2].has_error()) << responses[2].ShortDebugString();
+
+  // A single heartbeat is sent once the window passes.
+  FLAGS_multi_raft_heartbeat_window_ms = 10;
+  batcher = std::make_shared<consensus::MultiRaftHeartbeatBatcher>(
+      HostPort::FromBoundEndpoint(mini_server_->bound_rpc_addr()), proxy_cache_.get(),
+      client_messenger_);
+  consensus::ConsensusResponsePB response;
+  Synchronizer synchronizer;
+  batcher->AddRequestToBatch(
+      MakeHeartbeat(kTabletId, uuid), &response, synchronizer.AsStdStatusCallback());
+  ASSERT_OK(synchronizer.Wait());
+  ASSERT_FALSE(response.has_error()) << response.ShortDebugString();
+}
+
 // Simple test to check that our checksum scans work as expected.
 TEST_F(TabletServerTest, TestChecksumScan) {
   uint64_t total_crc = 0;
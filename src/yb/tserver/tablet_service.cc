@@ -62,6 +62,7 @@
 #include "yb/tablet/tablet_metrics.h"
 
 #include "yb/tablet/operations/alter_schema_operation.h"
+#include "yb/tablet/operations/split_operation.h"
 #include "yb/tablet/operations/truncate_operation.h"
 #include "yb/tablet/operations/update_txn_operation.h"
 #include "yb/tablet/operations/write_operation.h"
@@ -123,7 +124,8 @@ DEFINE_test_flag(bool, tserver_noop_read_write, false, "Respond NOOP to read/wri
 DEFINE_int32(max_stale_read_bound_time_ms, 0, "If we are allowed to read from followers, "
              "specify the maximum time a follower can be behind by using the last message received "
              "from the leader. If set to zero, a read can be served by a follower regardless of "
-             "when was the last time it received a message from the leader.");
+             "when was the last time it received a message from the leader. A read request can "
+             "override this bound with its own max_staleness_ms.");
 TAG_FLAG(max_stale_read_bound_time_ms, evolving);
 TAG_FLAG(max_stale_read_bound_time_ms, runtime);
 
@@ -140,6 +142,13 @@ DEFINE_test_flag(bool, simulate_time_out_failures, false, "If true, we will rand
                  "as failed to simulate time out failures. The periodic refresh of the lookup "
                  "cache will eventually mark them as available");
 
+DEFINE_test_flag(int32, read_delay_ms_in_tests, 0,
+                 "Delay in milliseconds of each read served by the tablet server with uuid "
+                 "--read_delay_tserver_uuid_in_tests.");
+
+DEFINE_test_flag(string, read_delay_tserver_uuid_in_tests, "",
+                 "Uuid of the tablet server that delays reads by --read_delay_ms_in_tests.");
+
 DECLARE_uint64(max_clock_skew_usec);
 
 namespace yb {
@@ -208,9 +217,63 @@ Status GetTabletRef(const TabletPeerPtr& tablet_peer,
     *error_code = TabletServerErrorPB::TABLET_NOT_RUNNING;
     return STATUS(IllegalState, "Tablet is not running");
   }
+  if (PREDICT_FALSE(tablet_peer->tablet_metadata()->has_been_split())) {
+    *error_code = TabletServerErrorPB::TABLET_SPLIT;
+    return STATUS(IllegalState, "Tablet has been split");
+  }
   return Status::OK();
 }
 
+// Applies a single request of MultiRaftUpdateConsensus. Performs the same checks as
+// UpdateConsensus, but reports errors through the returned status and error_code, since the RPC
+// is responded to once for the whole batch.
+Status UpdateConsensusFromBatch(TabletPeerLookupIf* tablet_manager,
+                                const string& local_uuid,
+                                ConsensusRequestPB* req,
+                                ConsensusResponsePB* resp,
+                                TabletServerErrorPB::Code* error_code) {
+  if (PREDICT_FALSE(req->dest_uuid() != local_uuid)) {
+    *error_code = TabletServerErrorPB::WRONG_SERVER_UUID;
+    return STATUS_FORMAT(InvalidArgument,
+                         "MultiRaftUpdateConsensus: Wrong destination UUID requested. "
+                         "Local UUID: $0. Requested UUID: $1", local_uuid, req->dest_uuid());
+  }
+
+  TabletPeerPtr tablet_peer;
+  Status s = tablet_manager->GetTabletPeer(req->tablet_id(), &tablet_peer);
+  if (PREDICT_FALSE(!s.ok())) {
+    *error_code = s.IsServiceUnavailable() ? TabletServerErrorPB::UNKNOWN_ERROR
+                                           : TabletServerErrorPB::TABLET_NOT_FOUND;
+    return s;
+  }
+  tablet::TabletStatePB state = tablet_peer->state();
+  if (PREDICT_FALSE(state != tablet::RUNNING)) {
+    *error_code = TabletServerErrorPB::TABLET_NOT_RUNNING;
+    return STATUS(IllegalState, "Tablet not RUNNING", tablet::TabletStatePB_Name(state));
+  }
+
+  shared_ptr<Consensus> consensus = tablet_peer->shared_consensus();
+  if (!consensus) {
+    *error_code = TabletServerErrorPB::TABLET_NOT_RUNNING;
+    return STATUS(ServiceUnavailable, "Consensus unavailable. Tablet not running");
+  }
+
+  *error_code = TabletServerErrorPB::UNKNOWN_ERROR;
+  return consensus->Update(req, resp);
+}
+
+// Returns the staleness bound in milliseconds that a follower has to satisfy to serve the read.
+// Zero means that any follower could serve it.
+template<class Req>
+int64_t MaxStaleReadBoundMs(const Req& req) {
+  return FLAGS_max_stale_read_bound_time_ms;
+}
+
+int64_t MaxStaleReadBoundMs(const ReadRequestPB& req) {
+  return req.has_max_staleness_ms() ? static_cast<int64_t>(req.max_staleness_ms())
+                                    : FLAGS_max_stale_read_bound_time_ms;
+}
+
 } // namespace
 
 // Prepares modification operation, checks limits, fetches tablet_peer and tablet etc.
@@ -448,6 +511,59 @@ void TabletServiceAdminImpl::AlterSchema(const AlterSchemaRequestPB* req,
       std::move(operation_state), consensus::LEADER));
 }
 
+void TabletServiceAdminImpl::SplitTablet(const SplitTabletRequestPB* req,
+                                         SplitTabletResponsePB* resp,
+                                         rpc::RpcContext context) {
+  if (!CheckUuidMatchOrRespond(server_->tablet_manager(), "SplitTablet", req, resp, &context)) {
+    return;
+  }
+  DVLOG(3) << "Received Split Tablet RPC: " << req->DebugString();
+
+  server::UpdateClock(*req, server_->Clock());
+
+  TabletPeerPtr tablet_peer;
+  if (!LookupTabletPeerOrRespond(server_->tablet_manager(), req->tablet_id(), resp, &context,
+                                 &tablet_peer)) {
+    return;
+  }
+
+  // The master retries the request until the new tablets are running.
+  if (tablet_peer->tablet_metadata()->has_been_split()) {
+    auto child_ids = tablet_peer->tablet_metadata()->split_child_tablet_ids();
+    if (child_ids.size() != 2 || child_ids[0] != req->new_tablet1_id() ||
+        child_ids[1] != req->new_tablet2_id()) {
+      SetupErrorAndRespond(resp->mutable_error(),
+                           STATUS_FORMAT(IllegalState, "Tablet has been split into $0", child_ids),
+                           TabletServerErrorPB::TABLET_SPLIT, &context);
+      return;
+    }
+    context.RespondSuccess();
+    return;
+  }
+
+  auto tablet = tablet_peer->shared_tablet();
+  if (!tablet) {
+    SetupErrorAndRespond(resp->mutable_error(), STATUS(IllegalState, "Tablet is not running"),
+                         TabletServerErrorPB::TABLET_NOT_RUNNING, &context);
+    return;
+  }
+  if (tablet->split_requested()) {
+    SetupErrorAndRespond(resp->mutable_error(),
+                         STATUS(IllegalState, "Tablet split is already in progress"),
+                         TabletServerErrorPB::ALREADY_IN_PROGRESS, &context);
+    return;
+  }
+
+  auto operation_state = std::make_unique<tablet::SplitOperationState>(tablet.get(), req);
+
+  operation_state->set_completion_callback(
+      MakeRpcOperationCompletionCallback(std::move(context), resp, server_->Clock()));
+
+  // Submit the split op. The RPC will be responded to asynchronously.
+  tablet_peer->Submit(std::make_unique<tablet::SplitOperation>(
+      std::move(operation_state), consensus::LEADER));
+}
+
 void TabletServiceImpl::UpdateTransaction(const UpdateTransactionRequestPB* req,
                                           UpdateTransactionResponsePB* resp,
                                           rpc::RpcContext context) {
@@ -873,20 +989,35 @@ bool TabletServiceImpl::DoGetTabletOrRespond(const Req* req, Resp* resp, rpc::Rp
   } else {
     s = CheckPeerIsLeader(*tablet_peer.get(), &error_code);
 
-    // Peer is not the leader, so check that the time since it last heard from the leader is less
-    // than FLAGS_max_stale_read_bound_time_ms.
+    // Peer is not the leader, so check that the time since it last heard from the leader, and the
+    // age of its safe time, are less than the requested staleness bound.
     if (PREDICT_FALSE(!s.ok())) {
-      if (FLAGS_max_stale_read_bound_time_ms > 0) {
+      const int64_t max_staleness_ms = MaxStaleReadBoundMs(*req);
+      if (max_staleness_ms > 0) {
         shared_ptr <consensus::Consensus> consensus = tablet_peer->shared_consensus();
         if (consensus->TimeSinceLastMessageFromLeader() != MonoTime::kUninitialized) {
           if (MonoTime::Now().GetDeltaSince(
-              consensus->TimeSinceLastMessageFromLeader()).ToMilliseconds() >
-              FLAGS_max_stale_read_bound_time_ms) {
+              consensus->TimeSinceLastMessageFromLeader()).ToMilliseconds() > max_staleness_ms) {
             SetupErrorAndRespond(resp->mutable_error(), STATUS(IllegalState, "Stale follower"),
                                  TabletServerErrorPB::STALE_FOLLOWER, context);
             return false;
-          } else if (PREDICT_FALSE(
-              FLAGS_assert_reads_from_follower_rejected_because_of_staleness)) {
+          }
+          // The follower could hear from the leader and still lag behind it, so also check that
+          // the data it would read from is recent enough.
+          auto follower_tablet = tablet_peer->shared_tablet();
+          if (follower_tablet && server_ && server_->Clock()) {
+            const HybridTime safe_time = follower_tablet->SafeTime(tablet::RequireLease::kFalse);
+            const HybridTime now = server_->Clock()->Now();
+            if (safe_time.AddMilliseconds(max_staleness_ms) < now) {
+              SetupErrorAndRespond(
+                  resp->mutable_error(),
+                  STATUS_FORMAT(IllegalState, "Stale follower, safe time $0 is more than $1 ms "
+                                "behind $2", safe_time, max_staleness_ms, now),
+                  TabletServerErrorPB::STALE_FOLLOWER, context);
+              return false;
+            }
+          }
+          if (PREDICT_FALSE(FLAGS_assert_reads_from_follower_rejected_because_of_staleness)) {
             LOG(FATAL) << "--assert_reads_from_follower_rejected_because_of_staleness is true, but "
                        << "peer " << tablet_peer->permanent_uuid()
                        << " for tablet: " << req->tablet_id()
@@ -953,6 +1084,11 @@ void TabletServiceImpl::Read(const ReadRequestPB* req,
     return;
   }
 
+  if (PREDICT_FALSE(FLAGS_read_delay_ms_in_tests > 0) &&
+      server_->tablet_manager()->NodeInstance().permanent_uuid() ==
+          FLAGS_read_delay_tserver_uuid_in_tests) {
+    SleepFor(MonoDelta::FromMilliseconds(FLAGS_read_delay_ms_in_tests));
+  }
 
   if (server_ && server_->Clock()) {
     server::UpdateClock(*req, server_->Clock());
@@ -1216,6 +1352,28 @@ void ConsensusServiceImpl::UpdateConsensus(const ConsensusRequestPB* req,
   context.RespondSuccess();
 }
 
+void ConsensusServiceImpl::MultiRaftUpdateConsensus(
+    const consensus::MultiRaftConsensusRequestPB* req,
+    consensus::MultiRaftConsensusResponsePB* resp,
+    rpc::RpcContext context) {
+  DVLOG(3) << "Received Batch Consensus Update RPC: " << req->ShortDebugString();
+  const string& local_uuid = tablet_manager_->NodeInstance().permanent_uuid();
+  for (int i = 0; i < req->consensus_request_size(); ++i) {
+    // See UpdateConsensus for why const_cast is used here.
+    auto* consensus_req = const_cast<ConsensusRequestPB*>(&req->consensus_request(i));
+    auto* consensus_resp = resp->add_consensus_response();
+    auto error_code = TabletServerErrorPB::UNKNOWN_ERROR;
+    Status s = UpdateConsensusFromBatch(
+        tablet_manager_, local_uuid, consensus_req, consensus_resp, &error_code);
+    if (PREDICT_FALSE(!s.ok())) {
+      consensus_resp->Clear();
+      StatusToPB(s, consensus_resp->mutable_error()->mutable_status());
+      consensus_resp->mutable_error()->set_code(error_code);
+    }
+  }
+  context.RespondSuccess();
+}
+
 void ConsensusServiceImpl::RequestConsensusVote(const VoteRequestPB* req,
                                                 VoteResponsePB* resp,
                                                 rpc::RpcContext context) {
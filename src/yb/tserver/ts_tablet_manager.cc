@@ -49,9 +49,12 @@
 #include "yb/consensus/log.h"
 #include "yb/consensus/log_anchor_registry.h"
 #include "yb/consensus/metadata.pb.h"
+#include "yb/consensus/multi_raft_batcher.h"
 #include "yb/consensus/opid_util.h"
 #include "yb/consensus/quorum_util.h"
 
+#include "yb/docdb/docdb_rocksdb_util.h"
+
 #include "yb/fs/fs_manager.h"
 
 #include "yb/gutil/strings/substitute.h"
@@ -60,11 +63,14 @@
 #include "yb/master/master.pb.h"
 #include "yb/master/sys_catalog.h"
 
+#include "yb/rocksdb/compaction_scheduler.h"
+#include "yb/rocksdb/env.h"
 #include "yb/rocksdb/memory_monitor.h"
 
 #include "yb/rpc/messenger.h"
 
 #include "yb/tablet/metadata.pb.h"
+#include "yb/tablet/operations/split_operation.h"
 #include "yb/tablet/tablet.h"
 #include "yb/tablet/tablet.pb.h"
 #include "yb/tablet/tablet_bootstrap_if.h"
@@ -85,12 +91,14 @@
 #include "yb/util/mem_tracker.h"
 #include "yb/util/metrics.h"
 #include "yb/util/pb_util.h"
+#include "yb/util/size_literals.h"
 #include "yb/util/stopwatch.h"
 #include "yb/util/trace.h"
 #include "yb/util/tsan_util.h"
 
 using namespace std::literals;
 using namespace std::placeholders;
+using namespace yb::size_literals;
 
 DEFINE_int32(num_tablets_to_open_simultaneously, 0,
              "Number of threads available to open tablets during startup. If this "
@@ -100,6 +108,12 @@ DEFINE_int32(num_tablets_to_open_simultaneously, 0,
              "may make sense to manually tune this.");
 TAG_FLAG(num_tablets_to_open_simultaneously, advanced);
 
+DEFINE_int64(bootstrap_log_read_ahead_memory_limit_bytes, 256_MB,
+             "Limit on the total size of WAL segments read ahead of the replay by all tablets "
+             "bootstrapped concurrently. Segments over the limit are read by the bootstrapping "
+             "thread when they are replayed.");
+TAG_FLAG(bootstrap_log_read_ahead_memory_limit_bytes, advanced);
+
 DEFINE_int32(tablet_start_warn_threshold_ms, 500,
              "If a tablet takes more than this number of millis to start, issue "
              "a warning with a trace.");
@@ -169,6 +183,43 @@ DEFINE_int32(read_pool_max_queue_size, 128,
              "is used to run multiple read operations, that are part of the same tablet rpc, "
              "in parallel.");
 
+DEFINE_bool(enable_work_stealing_pools, false,
+            "If true, the read and apply pools execute tasks on a work stealing executor, with "
+            "a task deque per worker, instead of a single shared task queue. The executor starts "
+            "all of the max threads of the pool as permanent workers, i.e. "
+            "read_pool_max_threads workers for the read pool and a worker per CPU for the apply "
+            "pool, so blocking reads could still use all of them.");
+TAG_FLAG(enable_work_stealing_pools, evolving);
+
+DEFINE_bool(work_stealing_pools_pin_threads, false,
+            "If true, workers of the work stealing read and apply pools are pinned to CPUs.");
+TAG_FLAG(work_stealing_pools_pin_threads, advanced);
+
+DEFINE_bool(enable_compaction_scheduler, true,
+            "If true, automatic compactions of all tablets are queued by a shared scheduler that "
+            "runs compactions of tablets closer to write stall first, instead of submitting them "
+            "to the shared thread pool in the order they were requested.");
+TAG_FLAG(enable_compaction_scheduler, evolving);
+
+DEFINE_int32(compaction_scheduler_max_running_compactions, -1,
+             "Maximum number of compactions run concurrently by the compaction scheduler. -1 to "
+             "use the same value as --rocksdb_max_background_compactions.");
+TAG_FLAG(compaction_scheduler_max_running_compactions, advanced);
+
+DEFINE_int32(compaction_scheduler_max_running_large_compactions, 1,
+             "Maximum number of compactions with input larger than "
+             "--rocksdb_compaction_size_threshold_bytes that the compaction scheduler runs "
+             "concurrently.");
+TAG_FLAG(compaction_scheduler_max_running_large_compactions, advanced);
+
+DEFINE_int32(memtable_insert_pool_max_threads, -1,
+             "Maximum number of threads used to insert parts of large write batches into "
+             "memtables concurrently, when --rocksdb_allow_concurrent_memtable_write is set. "
+             "-1 to use the number of CPUs.");
+TAG_FLAG(memtable_insert_pool_max_threads, advanced);
+
+DECLARE_bool(rocksdb_allow_concurrent_memtable_write);
+
 DEFINE_test_flag(int32, sleep_after_tombstoning_tablet_secs, 0,
                  "Whether we sleep in LogAndTombstone after calling DeleteTabletData.");
 
@@ -301,6 +352,8 @@ TSTabletManager::TSTabletManager(FsManager* fs_manager,
   };
   CHECK_OK(ThreadPoolBuilder("apply")
                .set_metrics(std::move(metrics))
+               .set_work_stealing(FLAGS_enable_work_stealing_pools)
+               .set_pin_threads(FLAGS_work_stealing_pools_pin_threads)
                .Build(&apply_pool_));
 
   // This pool is shared by all replicas hosted by this server.
@@ -329,8 +382,30 @@ TSTabletManager::TSTabletManager(FsManager* fs_manager,
                .set_max_threads(FLAGS_read_pool_max_threads)
                .set_max_queue_size(FLAGS_read_pool_max_queue_size)
                .set_metrics(std::move(read_metrics))
+               .set_work_stealing(FLAGS_enable_work_stealing_pools)
+               .set_pin_threads(FLAGS_work_stealing_pools_pin_threads)
                .Build(&read_pool_));
 
+  if (FLAGS_rocksdb_allow_concurrent_memtable_write) {
+    // Parts are written inline when all threads are busy, instead of waiting in the queue.
+    ThreadPoolBuilder builder("memtable-insert");
+    builder.set_max_queue_size(0);
+    if (FLAGS_memtable_insert_pool_max_threads > 0) {
+      builder.set_max_threads(FLAGS_memtable_insert_pool_max_threads);
+    }
+    std::unique_ptr<ThreadPool> memtable_insert_pool;
+    CHECK_OK(builder.Build(&memtable_insert_pool));
+    tablet_options_.memtable_insert_pool = std::move(memtable_insert_pool);
+  }
+
+  tablet_options_.tablet_splitter = this;
+
+  // Compacts the data that tablets created by a split inherited from their parent, one tablet at a
+  // time, so that the full compactions do not compete with the regular ones.
+  CHECK_OK(ThreadPoolBuilder("post-split-compaction")
+               .set_max_threads(1)
+               .Build(&post_split_compaction_pool_));
+
   int64_t block_cache_size_bytes = FLAGS_db_block_cache_size_bytes;
   int64_t total_ram_avail = MemTracker::GetRootTracker()->limit();
   // Auto-compute size of block cache if asked to.
@@ -350,6 +425,16 @@ TSTabletManager::TSTabletManager(FsManager* fs_manager,
     tablet_options_.block_cache->SetMetrics(server_->metric_entity());
   }
 
+  if (FLAGS_enable_compaction_scheduler) {
+    int max_running_compactions = FLAGS_compaction_scheduler_max_running_compactions;
+    if (max_running_compactions == -1) {
+      max_running_compactions = docdb::GetMaxBackgroundCompactions();
+    }
+    tablet_options_.compaction_scheduler = std::make_shared<rocksdb::CompactionScheduler>(
+        rocksdb::Env::Default(), max_running_compactions,
+        FLAGS_compaction_scheduler_max_running_large_compactions);
+  }
+
   // Calculate memstore_size_bytes
   bool should_count_memory = FLAGS_global_memstore_size_percentage > 0;
   CHECK(FLAGS_global_memstore_size_percentage > 0 && FLAGS_global_memstore_size_percentage <= 100)
@@ -390,6 +475,9 @@ Status TSTabletManager::Init() {
       &server_->options(), server_->metric_entity(), server_->mem_tracker(),
       server_->messenger());
 
+  multi_raft_manager_ = std::make_unique<consensus::MultiRaftManager>(
+      server_->messenger(), &server_->proxy_cache());
+
   // Start the threadpool we'll use to open tablets.
   // This has to be done in Init() instead of the constructor, since the
   // FsManager isn't initialized until this point.
@@ -406,6 +494,11 @@ Status TSTabletManager::Init() {
   RETURN_NOT_OK(ThreadPoolBuilder("tablet-bootstrap")
                 .set_max_threads(max_bootstrap_threads)
                 .Build(&open_tablet_pool_));
+  RETURN_NOT_OK(ThreadPoolBuilder("log-read-ahead")
+                .set_max_threads(max_bootstrap_threads)
+                .Build(&log_read_ahead_pool_));
+  log_read_ahead_mem_tracker_ = MemTracker::FindOrCreateTracker(
+      FLAGS_bootstrap_log_read_ahead_memory_limit_bytes, "log-read-ahead", server_->mem_tracker());
 
   // Search for tablets in the metadata dir.
   vector<string> tablet_ids;
@@ -570,6 +663,153 @@ string LogPrefix(const string& tablet_id, const string& uuid) {
   return "T " + tablet_id + " P " + uuid + ": ";
 }
 
+Status TSTabletManager::ApplyTabletSplit(tablet::SplitOperationState* state) {
+  auto* tablet = state->tablet();
+  const auto& request = *state->request();
+  const auto split_op_id = yb::OpId::FromPB(state->op_id());
+  auto* parent_meta = tablet->metadata();
+  const string kLogPrefix = tserver::LogPrefix(tablet->tablet_id(), fs_manager_->uuid());
+
+  LOG(INFO) << kLogPrefix << "Splitting tablet at " << split_op_id << ": "
+            << request.ShortDebugString();
+
+  // The new tablets share the SST files of this tablet, so everything written before the split
+  // has to be flushed.
+  RETURN_NOT_OK(tablet->Flush(tablet::FlushMode::kSync));
+
+  std::unique_ptr<ConsensusMetadata> parent_cmeta;
+  RETURN_NOT_OK(ConsensusMetadata::Load(
+      fs_manager_, tablet->tablet_id(), fs_manager_->uuid(), &parent_cmeta));
+  RaftConfigPB config = parent_cmeta->committed_config();
+  config.set_opid_index(consensus::kInvalidOpIdIndex);
+
+  PartitionPB partition_pb;
+  parent_meta->partition().ToPB(&partition_pb);
+  partition_pb.set_partition_key_end(request.split_partition_key());
+  Partition partition1;
+  Partition::FromPB(partition_pb, &partition1);
+  partition_pb.set_partition_key_start(request.split_partition_key());
+  partition_pb.set_partition_key_end(parent_meta->partition().partition_key_end());
+  Partition partition2;
+  Partition::FromPB(partition_pb, &partition2);
+
+  RETURN_NOT_OK(CreateSplitChildTablet(
+      tablet, request.new_tablet1_id(), partition1, split_op_id, config));
+  RETURN_NOT_OK(CreateSplitChildTablet(
+      tablet, request.new_tablet2_id(), partition2, split_op_id, config));
+
+  parent_meta->SetSplitChildTabletIds({request.new_tablet1_id(), request.new_tablet2_id()});
+  RETURN_NOT_OK(parent_meta->Flush());
+
+  LOG(INFO) << kLogPrefix << "Tablet has been split into " << request.new_tablet1_id() << " and "
+            << request.new_tablet2_id();
+  return Status::OK();
+}
+
+Status TSTabletManager::CreateSplitChildTablet(
+    tablet::Tablet* parent_tablet, const string& tablet_id, const Partition& partition,
+    const yb::OpId& split_op_id, const RaftConfigPB& config) {
+  const auto* parent_meta = parent_tablet->metadata();
+  const string kLogPrefix = tserver::LogPrefix(tablet_id, fs_manager_->uuid());
+
+  scoped_refptr<TransitionInProgressDeleter> deleter;
+  TabletPeerPtr old_peer;
+  {
+    std::lock_guard<RWMutex> lock(lock_);
+    if (state_ == MANAGER_QUIESCING || state_ == MANAGER_SHUTDOWN) {
+      return STATUS_FORMAT(IllegalState, "Manager is shutting down: $0",
+                           TSTabletManagerStatePB_Name(state_));
+    }
+    if (ContainsKey(transition_in_progress_, tablet_id)) {
+      // The tablet is being opened or remotely bootstrapped from another replica.
+      LOG(INFO) << kLogPrefix << "Tablet created by split is already in transition: "
+                << transition_in_progress_[tablet_id];
+      return Status::OK();
+    }
+    if (LookupTabletUnlocked(tablet_id, &old_peer) &&
+        old_peer->tablet_metadata()->tablet_data_state() == TABLET_DATA_READY) {
+      return Status::OK();
+    }
+    RETURN_NOT_OK(StartTabletStateTransitionUnlocked(tablet_id, "creating split tablet", &deleter));
+  }
+
+  // Clean up the leftovers of a previous attempt that was interrupted by a restart, those are
+  // tombstoned on startup.
+  scoped_refptr<TabletMetadata> old_meta;
+  if (old_peer) {
+    old_meta = old_peer->tablet_metadata();
+    old_peer->Shutdown();
+  } else if (TabletMetadata::Load(fs_manager_, tablet_id, &old_meta).ok()) {
+    if (old_meta->tablet_data_state() == TABLET_DATA_READY) {
+      // Not registered yet during startup, it will be opened by Init().
+      return Status::OK();
+    }
+  }
+  if (old_meta) {
+    LOG(INFO) << kLogPrefix << "Deleting incomplete tablet created by split";
+    RETURN_NOT_OK(DeleteTabletData(old_meta, TABLET_DATA_DELETED, fs_manager_->uuid(),
+                                   yb::OpId()));
+    RETURN_NOT_OK(old_meta->DeleteSuperBlock());
+    UnregisterDataWalDir(old_meta->table_id(), tablet_id, old_meta->table_type(),
+                         old_meta->data_root_dir(), old_meta->wal_root_dir());
+  }
+
+  scoped_refptr<TabletMetadata> meta;
+  string data_root_dir;
+  string wal_root_dir;
+  GetAndRegisterDataAndWalDir(fs_manager_, parent_meta->table_id(), tablet_id,
+                              parent_meta->table_type(), &data_root_dir, &wal_root_dir);
+  Status create_status = TabletMetadata::CreateNew(fs_manager_,
+                                                   parent_meta->table_id(),
+                                                   tablet_id,
+                                                   parent_meta->table_name(),
+                                                   parent_meta->table_type(),
+                                                   parent_meta->schema(),
+                                                   parent_meta->partition_schema(),
+                                                   partition,
+                                                   boost::none /* index_info */,
+                                                   TABLET_DATA_COPYING,
+                                                   &meta,
+                                                   data_root_dir,
+                                                   wal_root_dir);
+  if (!create_status.ok()) {
+    UnregisterDataWalDir(parent_meta->table_id(), tablet_id, parent_meta->table_type(),
+                         data_root_dir, wal_root_dir);
+  }
+  RETURN_NOT_OK_PREPEND(create_status, "Couldn't create tablet metadata");
+  meta->SetSchema(parent_meta->schema(), parent_meta->schema_version());
+  meta->SetIndexMap(IndexMap(parent_meta->index_map()));
+  for (const auto& deleted_col : parent_meta->GetDeletedColumns()) {
+    meta->AddDeletedColumn(deleted_col);
+  }
+  meta->SetSplitOpId(split_op_id);
+  RETURN_NOT_OK(meta->Flush());
+
+  // Share the SST files of the parent tablet using hard links.
+  const auto rocksdb_dir = meta->rocksdb_dir();
+  if (fs_manager_->env()->FileExists(rocksdb_dir)) {
+    RETURN_NOT_OK(fs_manager_->env()->DeleteRecursively(rocksdb_dir));
+  }
+  RETURN_NOT_OK(parent_tablet->CreateCheckpoint(rocksdb_dir));
+
+  // We must persist the consensus metadata to disk before starting a new tablet's TabletPeer and
+  // Consensus implementation. The term of the new tablet starts at the term of the split.
+  std::unique_ptr<ConsensusMetadata> cmeta;
+  RETURN_NOT_OK_PREPEND(ConsensusMetadata::Create(fs_manager_, tablet_id, fs_manager_->uuid(),
+                                                  config, split_op_id.term, &cmeta),
+                        "Unable to create new ConsensusMeta for tablet " + tablet_id);
+
+  meta->set_tablet_data_state(TABLET_DATA_READY);
+  RETURN_NOT_OK(meta->Flush());
+
+  RETURN_NOT_OK(CreateAndRegisterTabletPeer(meta, old_peer ? REPLACEMENT_PEER : NEW_PEER));
+  RETURN_NOT_OK(
+      open_tablet_pool_->SubmitFunc(std::bind(&TSTabletManager::OpenTablet, this, meta, deleter)));
+
+  LOG(INFO) << kLogPrefix << "Created tablet by split of " << parent_meta->tablet_id();
+  return Status::OK();
+}
+
 Status CheckLeaderTermNotLower(
     const string& tablet_id,
     const string& uuid,
@@ -950,7 +1190,9 @@ void TSTabletManager::OpenTablet(const scoped_refptr<TabletMetadata>& meta,
         tablet_peer.get(),
         std::bind(&TSTabletManager::PreserveLocalLeadersOnly, this, _1),
         tablet_peer.get(),
-        append_pool()};
+        append_pool(),
+        log_read_ahead_pool_.get(),
+        log_read_ahead_mem_tracker_};
     s = BootstrapTablet(data, &tablet, &log, &bootstrap_info);
     if (!s.ok()) {
       LOG(ERROR) << kLogPrefix << "Tablet failed to bootstrap: "
@@ -972,7 +1214,8 @@ void TSTabletManager::OpenTablet(const scoped_refptr<TabletMetadata>& meta,
                                     tablet->GetMetricEntity(),
                                     raft_pool(),
                                     tablet_prepare_pool(),
-                                    &server_->rpc_server()->thread_pool());
+                                    &server_->rpc_server()->thread_pool(),
+                                    multi_raft_manager_.get());
 
     if (!s.ok()) {
       LOG(ERROR) << kLogPrefix << "Tablet failed to init: "
@@ -1001,6 +1244,14 @@ void TSTabletManager::OpenTablet(const scoped_refptr<TabletMetadata>& meta,
                    << Trace::CurrentTrace()->DumpToString(true);
     }
   }
+
+  if (tablet->metadata()->has_parent_data()) {
+    s = post_split_compaction_pool_->SubmitFunc([tablet, kLogPrefix]() {
+      auto status = tablet->CompactParentData();
+      LOG_IF(WARNING, !status.ok()) << kLogPrefix << "Failed to compact split tablet: " << status;
+    });
+    LOG_IF(WARNING, !s.ok()) << kLogPrefix << "Failed to schedule split tablet compaction: " << s;
+  }
 }
 
 void TSTabletManager::StartShutdown() {
@@ -1035,6 +1286,9 @@ void TSTabletManager::StartShutdown() {
 
   // Shut down the bootstrap pool, so new tablets are registered after this point.
   open_tablet_pool_->Shutdown();
+  if (log_read_ahead_pool_) {
+    log_read_ahead_pool_->Shutdown();
+  }
 
   // Take a snapshot of the peers list -- that way we don't have to hold
   // on to the lock while shutting them down, which might cause a lock
@@ -1054,6 +1308,10 @@ void TSTabletManager::CompleteShutdown() {
   // Shut down the apply pool.
   apply_pool_->Shutdown();
 
+  if (post_split_compaction_pool_) {
+    post_split_compaction_pool_->Shutdown();
+  }
+
   if (raft_pool_) {
     raft_pool_->Shutdown();
   }
@@ -1063,6 +1321,9 @@ void TSTabletManager::CompleteShutdown() {
   if (append_pool_) {
     append_pool_->Shutdown();
   }
+  if (tablet_options_.memtable_insert_pool) {
+    tablet_options_.memtable_insert_pool->Shutdown();
+  }
 
   {
     std::lock_guard<RWMutex> l(lock_);
@@ -51,6 +51,7 @@
 #include "yb/gutil/macros.h"
 #include "yb/gutil/ref_counted.h"
 #include "yb/tablet/tablet_fwd.h"
+#include "yb/tablet/tablet_splitter.h"
 #include "yb/tserver/tablet_peer_lookup.h"
 #include "yb/tserver/tserver.pb.h"
 #include "yb/tserver/tserver_admin.pb.h"
@@ -69,8 +70,10 @@ class HostPort;
 class Partition;
 class Schema;
 class BackgroundTask;
+class MemTracker;
 
 namespace consensus {
+class MultiRaftManager;
 class RaftConfigPB;
 } // namespace consensus
 
@@ -119,7 +122,7 @@ class TransitionInProgressDeleter;
 // TODO: will also be responsible for keeping the local metadata about
 // which tablets are hosted on this server persistent on disk, as well
 // as re-opening all the tablets at startup, etc.
-class TSTabletManager : public tserver::TabletPeerLookupIf {
+class TSTabletManager : public tserver::TabletPeerLookupIf, public tablet::TabletSplitter {
  public:
     typedef std::vector<std::shared_ptr<tablet::TabletPeer>> TabletPeers;
 
@@ -171,6 +174,11 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
     consensus::RaftConfigPB config,
     std::shared_ptr<tablet::TabletPeer> *tablet_peer);
 
+  // Creates and opens the tablets that take over the halves of the partition of the tablet being
+  // split. The new tablets share the SST files of the split tablet and their logs start after the
+  // split operation.
+  CHECKED_STATUS ApplyTabletSplit(tablet::SplitOperationState* state) override;
+
   // Delete the specified tablet.
   // 'delete_type' must be one of TABLET_DATA_DELETED or TABLET_DATA_TOMBSTONED
   // or else returns Status::IllegalArgument.
@@ -286,6 +294,11 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
 
   MemoryMonitor* memory_monitor() { return tablet_options_.memory_monitor.get(); }
 
+  // Returns nullptr when --enable_compaction_scheduler is not set.
+  rocksdb::CompactionScheduler* compaction_scheduler() {
+    return tablet_options_.compaction_scheduler.get();
+  }
+
   // Flush some tablet if the memstore memory limit is exceeded
   void MaybeFlushTablet();
 
@@ -322,6 +335,12 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
                                             const std::string& reason,
                                             scoped_refptr<TransitionInProgressDeleter>* deleter);
 
+  // Creates a tablet taking over the given part of the partition of the tablet being split, unless
+  // it has been already created.
+  CHECKED_STATUS CreateSplitChildTablet(
+      tablet::Tablet* parent_tablet, const std::string& tablet_id, const Partition& partition,
+      const yb::OpId& split_op_id, const consensus::RaftConfigPB& config);
+
   // Open a tablet meta from the local file system by loading its superblock.
   CHECKED_STATUS OpenTabletMeta(const std::string& tablet_id,
                         scoped_refptr<tablet::TabletMetadata>* metadata);
@@ -440,6 +459,11 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
   // Thread pool used to open the tablets async, whether bootstrap is required or not.
   std::unique_ptr<ThreadPool> open_tablet_pool_;
 
+  // Thread pool and memory tracker for reading log segments ahead of their replay, shared between
+  // all tablets being bootstrapped.
+  std::unique_ptr<ThreadPool> log_read_ahead_pool_;
+  std::shared_ptr<MemTracker> log_read_ahead_mem_tracker_;
+
   // Thread pool for preparing transactions, shared between all tablets.
   std::unique_ptr<ThreadPool> tablet_prepare_pool_;
 
@@ -455,9 +479,15 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
   // Thread pool for read ops, that are run in parallel, shared between all tablets.
   std::unique_ptr<ThreadPool> read_pool_;
 
+  // Thread pool for compacting the data that split tablets inherited from their parent.
+  std::unique_ptr<ThreadPool> post_split_compaction_pool_;
+
   // Used for scheduling flushes
   std::unique_ptr<BackgroundTask> background_task_;
 
+  // Batches heartbeats that tablet leaders on this server send to the same remote server.
+  std::unique_ptr<consensus::MultiRaftManager> multi_raft_manager_;
+
   // For block cache and memory monitor shared across tablets
   tablet::TabletOptions tablet_options_;
 
@@ -46,6 +46,7 @@
 #include "yb/gutil/strings/join.h"
 #include "yb/gutil/strings/numbers.h"
 #include "yb/gutil/strings/substitute.h"
+#include "yb/rocksdb/compaction_scheduler.h"
 #include "yb/server/webui_util.h"
 #include "yb/tablet/maintenance_manager.h"
 #include "yb/tablet/tablet.h"
@@ -112,6 +113,10 @@ Status TabletServerPathHandlers::Register(Webserver* server) {
       "/maintenance-manager", "",
       std::bind(&TabletServerPathHandlers::HandleMaintenanceManagerPage, this, _1, _2),
       true /* styled */, false /* is_on_nav_bar */);
+  server->RegisterPathHandler(
+      "/compactions", "",
+      std::bind(&TabletServerPathHandlers::HandleCompactionsPage, this, _1, _2),
+      true /* styled */, false /* is_on_nav_bar */);
 
   return Status::OK();
 }
@@ -406,6 +411,9 @@ void TabletServerPathHandlers::HandleDashboardsPage(const Webserver::WebRequest&
   *output << GetDashboardLine("maintenance-manager", "Maintenance Manager",
                               "List of operations that are currently running and those "
                               "that are registered.");
+  *output << GetDashboardLine("compactions", "Compactions",
+                              "List of compactions that are running and those that are queued "
+                              "by the compaction scheduler.");
 }
 
 string TabletServerPathHandlers::GetDashboardLine(const std::string& link,
@@ -475,5 +483,32 @@ void TabletServerPathHandlers::HandleMaintenanceManagerPage(const Webserver::Web
   *output << "</table>\n";
 }
 
+void TabletServerPathHandlers::HandleCompactionsPage(const Webserver::WebRequest& req,
+                                                     std::stringstream* output) {
+  auto* scheduler = tserver_->tablet_manager()->compaction_scheduler();
+  if (!scheduler) {
+    *output << "Compaction scheduler is disabled, see --enable_compaction_scheduler\n";
+    return;
+  }
+
+  auto tasks = scheduler->DumpTasks();
+  *output << "<h1>Compaction scheduler</h1>\n";
+  *output << Substitute("<p>Running compactions limit: $0, large compactions limit: $1</p>\n",
+                        scheduler->max_running_compactions(),
+                        scheduler->max_running_large_compactions());
+  *output << "<table class='table table-striped'>\n";
+  *output << "  <tr><th>DB</th><th>State</th><th>Priority</th><th>Large</th>"
+          << "<th>Time since submitted</th></tr>\n";
+  for (const auto& task : tasks) {
+    *output << Substitute("<tr><td>$0</td><td>$1</td><td>$2</td><td>$3</td><td>$4</td></tr>\n",
+                          EscapeForHtmlToString(task.description),
+                          task.running ? "running" : "queued",
+                          task.priority,
+                          task.large ? "yes" : "no",
+                          HumanReadableElapsedTime::ToShortString(task.age_micros / 1e6));
+  }
+  *output << "</table>\n";
+}
+
 }  // namespace tserver
 }  // namespace yb
@@ -60,6 +60,17 @@ TEST(RateLimiter, TestUpdateDataSize) {
   ASSERT_LE(diff, max_allowed_diff);
 }
 
+TEST(RateLimiter, TestUpdateDataSizeAndGetDelay) {
+  RateLimiter rate_limiter([]() { return kRate; });
+  rate_limiter.Init();
+  // Transmissions that are reported before the delay of the previous one passed, as concurrent
+  // fetches do, are delayed one after another.
+  auto first = rate_limiter.UpdateDataSizeAndGetDelay(kRate);
+  auto second = rate_limiter.UpdateDataSizeAndGetDelay(kRate);
+  ASSERT_LE(std::abs(first.ToMilliseconds() - MonoTime::kMillisecondsPerSecond), 100);
+  ASSERT_LE(std::abs(second.ToMilliseconds() - 2 * MonoTime::kMillisecondsPerSecond), 100);
+}
+
 TEST(RateLimiter, TestSendRequest) {
   RateLimiter rate_limiter([]() { return kRate; });
   auto start = MonoTime::Now();
@@ -58,36 +58,55 @@ uint64_t RateLimiter::GetRate() {
 }
 
 void RateLimiter::UpdateDataSizeAndMaybeSleep(uint64_t data_size) {
+  auto delay = UpdateDataSizeAndGetDelay(data_size);
+  if (delay.ToMilliseconds() > 0) {
+    SleepFor(delay);
+  }
+}
+
+MonoDelta RateLimiter::UpdateDataSizeAndGetDelay(uint64_t data_size) {
   auto now = MonoTime::Now();
+  // end_time_ is in the future while the delay returned for a previous transmission has not
+  // passed yet. Then elapsed is negative, and the remaining part of that delay is added to the
+  // delay of this transmission.
   auto elapsed = now.GetDeltaSince(end_time_);
-  end_time_ = now;
   total_bytes_ += data_size;
   UpdateRate();
-  UpdateTimeSlotSizeAndMaybeSleep(data_size, elapsed);
+  auto delay = UpdateTimeSlotSizeAndGetSleepTime(data_size, elapsed);
+  end_time_ = now + delay;
+  return delay;
 }
 
 void RateLimiter::UpdateTimeSlotSizeAndMaybeSleep(uint64_t data_size, MonoDelta elapsed) {
+  auto sleep_time = UpdateTimeSlotSizeAndGetSleepTime(data_size, elapsed);
+  if (sleep_time.ToMilliseconds() > 0) {
+    SleepFor(sleep_time);
+    end_time_ = MonoTime::Now();
+  }
+}
+
+MonoDelta RateLimiter::UpdateTimeSlotSizeAndGetSleepTime(uint64_t data_size, MonoDelta elapsed) {
   if (!active()) {
-    return;
+    return MonoDelta::FromMilliseconds(0);
   }
 
   // If the rate is greater than target_rate_, sleep until both rates are equal.
-  if (MonoTime::kMillisecondsPerSecond * data_size > target_rate_ * elapsed.ToMilliseconds()) {
-    auto sleep_time =
-        MonoTime::kMillisecondsPerSecond * data_size / target_rate_ - elapsed.ToMilliseconds();
+  const int64_t transmission_time_ms =
+      MonoTime::kMillisecondsPerSecond * data_size / target_rate_;
+  if (transmission_time_ms > elapsed.ToMilliseconds()) {
+    auto sleep_time = transmission_time_ms - elapsed.ToMilliseconds();
     VLOG(1) << " target_rate_=" << target_rate_
             << " elapsed=" << elapsed.ToMilliseconds()
             << " received size=" << data_size
             << " and sleeping for=" << sleep_time;
-    SleepFor(MonoDelta::FromMilliseconds(sleep_time));
-    end_time_ = MonoTime::Now();
     // If we slept for more than 80% of time_slot_ms_, reduce the size of this time slot.
-    if (sleep_time > time_slot_ms_ * 80 / 100) {
+    if (static_cast<uint64_t>(sleep_time) > time_slot_ms_ * 80 / 100) {
       time_slot_ms_ = std::max(min_time_slot_, time_slot_ms_ / 2);
     }
-  } else {
-    time_slot_ms_ = std::min(max_time_slot_, time_slot_ms_ * 2);
+    return MonoDelta::FromMilliseconds(sleep_time);
   }
+  time_slot_ms_ = std::min(max_time_slot_, time_slot_ms_ * 2);
+  return MonoDelta::FromMilliseconds(0);
 }
 
 void RateLimiter::UpdateRate() {
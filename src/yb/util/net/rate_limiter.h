@@ -58,6 +58,11 @@ class RateLimiter {
   // than the rate provided by target_rate_updater_.
   void UpdateDataSizeAndMaybeSleep(uint64_t data_size);
 
+  // Same as UpdateDataSizeAndMaybeSleep, but returns the time to sleep instead of sleeping, so
+  // the caller could sleep after releasing the lock that protects this object. Delays of
+  // transmissions that are reported before the previous delay passed add up.
+  MonoDelta UpdateDataSizeAndGetDelay(uint64_t data_size);
+
   void Init();
 
   // We can only have an active rate limiter if the user has provided a function ot update the rate.
@@ -68,6 +73,7 @@ class RateLimiter {
  private:
   void UpdateRate();
   void UpdateTimeSlotSizeAndMaybeSleep(uint64_t data_size, MonoDelta elapsed);
+  MonoDelta UpdateTimeSlotSizeAndGetSleepTime(uint64_t data_size, MonoDelta elapsed);
   uint64_t GetSizeForNextTimeSlot();
 
   bool init_ = false;
@@ -41,6 +41,7 @@
 
 #include <boost/scope_exit.hpp>
 
+#include <gflags/gflags.h>
 #include <glog/logging.h>
 #include <gtest/gtest.h>
 
@@ -48,6 +49,7 @@
 #include "yb/util/barrier.h"
 #include "yb/gutil/bind.h"
 #include "yb/util/countdown_latch.h"
+#include "yb/util/hdr_histogram.h"
 #include "yb/util/metrics.h"
 #include "yb/util/promise.h"
 #include "yb/util/random.h"
@@ -59,6 +61,10 @@
 #include "yb/util/locks.h"
 #include "yb/util/test_util.h"
 
+DEFINE_int32(thread_pool_bench_tasks_per_second, 100000,
+             "Rate at which tasks are submitted in the queue latency benchmark.");
+DEFINE_int32(thread_pool_bench_duration_ms, 2000, "Duration of the queue latency benchmark.");
+
 using std::atomic;
 using std::shared_ptr;
 using std::string;
@@ -828,4 +834,147 @@ TEST_F(TestThreadPool, TestTokenConcurrency) {
                           kSubmitThreads, total_num_tokens_submitted.load());
 }
 
+TEST_F(TestThreadPool, TestWorkStealingTasks) {
+  gscoped_ptr<ThreadPool> thread_pool;
+  ASSERT_OK(ThreadPoolBuilder("test")
+                .set_max_threads(4)
+                .set_work_stealing(true)
+                .Build(&thread_pool));
+
+  constexpr int kNumTasks = 1000;
+  Atomic32 counter(0);
+  for (int i = 0; i != kNumTasks; ++i) {
+    // Tasks submitted from workers go to their own deques and are stolen by other workers.
+    ASSERT_OK(thread_pool->SubmitFunc([&thread_pool, &counter] {
+      ASSERT_OK(thread_pool->SubmitFunc(std::bind(&SimpleTaskMethod, 2, &counter)));
+      SimpleTaskMethod(1, &counter);
+    }));
+  }
+  thread_pool->Wait();
+  ASSERT_EQ(kNumTasks * 3, base::subtle::NoBarrier_Load(&counter));
+
+  // Tokens are not affected by work stealing.
+  auto token = thread_pool->NewToken(ThreadPool::ExecutionMode::SERIAL);
+  ASSERT_OK(token->SubmitFunc(std::bind(&SimpleTaskMethod, 5, &counter)));
+  token->Wait();
+  ASSERT_EQ(kNumTasks * 3 + 5, base::subtle::NoBarrier_Load(&counter));
+
+  thread_pool->Shutdown();
+  Status s = thread_pool->SubmitFunc(&IssueTraceStatement);
+  ASSERT_TRUE(s.IsServiceUnavailable()) << s;
+}
+
+// Blocking tasks could occupy all max_threads workers, not only a worker per CPU.
+TEST_F(TestThreadPool, TestWorkStealingBlockingTasks) {
+  const int kMaxThreads = base::NumCPUs() * 2 + 2;
+  gscoped_ptr<ThreadPool> thread_pool;
+  ASSERT_OK(ThreadPoolBuilder("test")
+                .set_max_threads(kMaxThreads)
+                .set_max_queue_size(0)
+                .set_work_stealing(true)
+                .Build(&thread_pool));
+
+  CountDownLatch started(kMaxThreads);
+  CountDownLatch release(1);
+  for (int i = 0; i != kMaxThreads; ++i) {
+    ASSERT_OK(thread_pool->SubmitFunc([&started, &release] {
+      started.CountDown();
+      release.Wait();
+    }));
+  }
+  ASSERT_TRUE(started.WaitFor(MonoDelta::FromSeconds(10)));
+
+  // All workers are busy and the queue is empty, so the pool is at capacity.
+  Status s = thread_pool->SubmitFunc(&IssueTraceStatement);
+  ASSERT_TRUE(s.IsServiceUnavailable()) << s;
+
+  release.CountDown();
+  thread_pool->Wait();
+}
+
+TEST_F(TestThreadPool, TestWorkStealingTracePropagation) {
+  gscoped_ptr<ThreadPool> thread_pool;
+  ASSERT_OK(ThreadPoolBuilder("test")
+                .set_max_threads(2)
+                .set_work_stealing(true)
+                .set_pin_threads(true)
+                .Build(&thread_pool));
+
+  scoped_refptr<Trace> t(new Trace);
+  {
+    ADOPT_TRACE(t.get());
+    ASSERT_OK(thread_pool->SubmitFunc(&IssueTraceStatement));
+  }
+  thread_pool->Wait();
+  ASSERT_STR_CONTAINS(t->DumpToString(true), "hello from task");
+}
+
+namespace {
+
+// Submits small tasks at --thread_pool_bench_tasks_per_second for --thread_pool_bench_duration_ms
+// and returns the histogram of time that the tasks spent in the queue.
+std::unique_ptr<HdrHistogram> MeasureQueueLatency(bool work_stealing) {
+  constexpr int kSubmitThreads = 4;
+  constexpr int kIntervalUs = 1000;
+
+  gscoped_ptr<ThreadPool> thread_pool;
+  CHECK_OK(ThreadPoolBuilder("bench")
+               .set_min_threads(base::NumCPUs())
+               .set_max_threads(base::NumCPUs())
+               .set_work_stealing(work_stealing)
+               .Build(&thread_pool));
+
+  auto histogram = std::make_unique<HdrHistogram>(1000000, 2);
+  const int tasks_per_interval =
+      std::max(FLAGS_thread_pool_bench_tasks_per_second / (1000000 / kIntervalUs) / kSubmitThreads,
+               1);
+  const auto deadline = MonoTime::Now() +
+                        MonoDelta::FromMilliseconds(FLAGS_thread_pool_bench_duration_ms);
+  std::atomic<int> rejected(0);
+  vector<thread> threads;
+  for (int i = 0; i != kSubmitThreads; ++i) {
+    threads.emplace_back([&thread_pool, &histogram, &rejected, tasks_per_interval, deadline] {
+      auto next = MonoTime::Now();
+      while (next < deadline) {
+        for (int j = 0; j != tasks_per_interval; ++j) {
+          auto submit_time = MonoTime::Now();
+          auto* hist = histogram.get();
+          auto s = thread_pool->SubmitFunc([submit_time, hist] {
+            hist->Increment((MonoTime::Now() - submit_time).ToMicroseconds());
+          });
+          if (!s.ok()) {
+            ++rejected;
+          }
+        }
+        next += MonoDelta::FromMicroseconds(kIntervalUs);
+        auto wait = next - MonoTime::Now();
+        if (wait.ToMicroseconds() > 0) {
+          SleepFor(wait);
+        }
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  thread_pool->Wait();
+  thread_pool->Shutdown();
+  LOG_IF(WARNING, rejected.load() != 0) << "Rejected tasks: " << rejected.load();
+  return histogram;
+}
+
+} // namespace
+
+// Compares queue latency of small tasks between the shared queue and the work stealing executor.
+TEST_F(TestThreadPool, BenchmarkQueueLatency) {
+  for (bool work_stealing : {false, true}) {
+    auto histogram = MeasureQueueLatency(work_stealing);
+    LOG(INFO) << (work_stealing ? "Work stealing" : "Shared queue") << ": "
+              << histogram->TotalCount() << " tasks, queue latency us: p50 "
+              << histogram->ValueAtPercentile(50) << ", p99 "
+              << histogram->ValueAtPercentile(99) << ", p99.9 "
+              << histogram->ValueAtPercentile(99.9) << ", max " << histogram->MaxValue();
+  }
+}
+
 } // namespace yb
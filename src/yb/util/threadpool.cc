@@ -50,6 +50,7 @@
 #include "yb/util/thread.h"
 #include "yb/util/threadpool.h"
 #include "yb/util/trace.h"
+#include "yb/util/work_stealing_executor.h"
 
 namespace yb {
 
@@ -95,6 +96,16 @@ ThreadPoolBuilder& ThreadPoolBuilder::set_metrics(ThreadPoolMetrics metrics) {
   return *this;
 }
 
+ThreadPoolBuilder& ThreadPoolBuilder::set_work_stealing(bool work_stealing) {
+  work_stealing_ = work_stealing;
+  return *this;
+}
+
+ThreadPoolBuilder& ThreadPoolBuilder::set_pin_threads(bool pin_threads) {
+  pin_threads_ = pin_threads;
+  return *this;
+}
+
 ThreadPoolBuilder& ThreadPoolBuilder::set_idle_timeout(const MonoDelta& idle_timeout) {
   idle_timeout_ = idle_timeout;
   return *this;
@@ -304,7 +315,9 @@ ThreadPool::ThreadPool(const ThreadPoolBuilder& builder)
     active_threads_(0),
     total_queued_tasks_(0),
     tokenless_(NewToken(ExecutionMode::CONCURRENT)),
-    metrics_(builder.metrics_) {
+    metrics_(builder.metrics_),
+    work_stealing_(builder.work_stealing_),
+    pin_threads_(builder.pin_threads_) {
 }
 
 ThreadPool::~ThreadPool() {
@@ -321,6 +334,15 @@ Status ThreadPool::Init() {
     return STATUS(NotSupported, "The thread pool is already initialized");
   }
   pool_status_ = Status::OK();
+  if (work_stealing_ && max_threads_ > 0) {
+    work_stealing_executor_ = std::make_unique<WorkStealingExecutor>(
+        name_, max_threads_, max_queue_size_, pin_threads_, metrics_);
+    Status status = work_stealing_executor_->Start();
+    if (!status.ok()) {
+      Shutdown();
+      return status;
+    }
+  }
   for (int i = 0; i < min_threads_; i++) {
     Status status = CreateThreadUnlocked();
     if (!status.ok()) {
@@ -332,6 +354,10 @@ Status ThreadPool::Init() {
 }
 
 void ThreadPool::Shutdown() {
+  if (work_stealing_executor_) {
+    work_stealing_executor_->Shutdown();
+  }
+
   MutexLock unique_lock(lock_);
   CheckNotPoolThreadUnlocked();
 
@@ -431,6 +457,9 @@ Status ThreadPool::SubmitFunc(std::function<void()>&& func) {
 }
 
 Status ThreadPool::Submit(const std::shared_ptr<Runnable>& r) {
+  if (work_stealing_executor_) {
+    return work_stealing_executor_->Submit(r);
+  }
   return DoSubmit(std::move(r), tokenless_.get());
 }
 
@@ -522,6 +551,9 @@ Status ThreadPool::DoSubmit(const std::shared_ptr<Runnable> task, ThreadPoolToke
 }
 
 void ThreadPool::Wait() {
+  if (work_stealing_executor_) {
+    work_stealing_executor_->Wait();
+  }
   MutexLock unique_lock(lock_);
   while ((!queue_.empty()) || (active_threads_ > 0)) {
     idle_cond_.Wait();
@@ -534,6 +566,9 @@ bool ThreadPool::WaitUntil(const MonoTime& until) {
 }
 
 bool ThreadPool::WaitFor(const MonoDelta& delta) {
+  if (work_stealing_executor_ && !work_stealing_executor_->WaitFor(delta)) {
+    return false;
+  }
   MutexLock unique_lock(lock_);
   while ((!queue_.empty()) || (active_threads_ > 0)) {
     if (!idle_cond_.TimedWait(delta)) {
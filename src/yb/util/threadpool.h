@@ -59,6 +59,7 @@ class Thread;
 class ThreadPool;
 class ThreadPoolToken;
 class Trace;
+class WorkStealingExecutor;
 
 class Runnable {
  public:
@@ -117,6 +118,15 @@ struct ThreadPoolMetrics {
 // metrics: Histograms, counters, etc. to update on various threadpool events.
 //    Default: not set.
 //
+// work_stealing: Whether tasks submitted without a token are executed by a WorkStealingExecutor
+//    with max_threads permanent workers, instead of the shared FIFO queue. Workers are created
+//    upfront and never exit, so max_threads tasks could block at the same time, as with the shared
+//    queue. Tasks submitted via tokens always use the shared queue.
+//    Default: false.
+//
+// pin_threads: Whether workers of the work stealing executor are pinned to CPUs.
+//    Default: false.
+//
 class ThreadPoolBuilder {
  public:
   explicit ThreadPoolBuilder(std::string name);
@@ -129,6 +139,8 @@ class ThreadPoolBuilder {
   ThreadPoolBuilder& set_max_queue_size(int max_queue_size);
   ThreadPoolBuilder& set_idle_timeout(const MonoDelta& idle_timeout);
   ThreadPoolBuilder& set_metrics(ThreadPoolMetrics metrics);
+  ThreadPoolBuilder& set_work_stealing(bool work_stealing);
+  ThreadPoolBuilder& set_pin_threads(bool pin_threads);
 
   const std::string& name() const { return name_; }
   int min_threads() const { return min_threads_; }
@@ -148,6 +160,8 @@ class ThreadPoolBuilder {
   int max_queue_size_;
   MonoDelta idle_timeout_;
   ThreadPoolMetrics metrics_;
+  bool work_stealing_ = false;
+  bool pin_threads_ = false;
 
   DISALLOW_COPY_AND_ASSIGN(ThreadPoolBuilder);
 };
@@ -341,6 +355,12 @@ class ThreadPool {
   // Metrics for the entire thread pool.
   const ThreadPoolMetrics metrics_;
 
+  const bool work_stealing_;
+  const bool pin_threads_;
+
+  // Executes tasks submitted without a token, when the pool was built with work stealing.
+  std::unique_ptr<WorkStealingExecutor> work_stealing_executor_;
+
   DISALLOW_COPY_AND_ASSIGN(ThreadPool);
 };
 
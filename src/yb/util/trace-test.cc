@@ -41,6 +41,7 @@
 #include "yb/util/debug/trace_event.h"
 #include "yb/util/debug/trace_event_synthetic_delay.h"
 #include "yb/util/debug/trace_logging.h"
+#include "yb/util/metrics.h"
 #include "yb/util/stopwatch.h"
 #include "yb/util/test_util.h"
 
@@ -52,6 +53,8 @@ using rapidjson::Value;
 using std::string;
 using std::vector;
 
+METRIC_DECLARE_histogram(trace_stage_apply);
+
 namespace yb {
 
 class TraceTest : public YBTest {
@@ -121,6 +124,39 @@ TEST_F(TraceTest, TestChildTrace) {
             XOutDigits(traceA->DumpToString(false)));
 }
 
+TEST_F(TraceTest, TestSampledTraceStages) {
+  FLAGS_enable_tracing = false;
+  MetricRegistry registry;
+  auto entity = METRIC_ENTITY_server.Instantiate(&registry, "test");
+  RegisterTraceStageMetrics(entity);
+  auto histogram = METRIC_trace_stage_apply.Instantiate(entity);
+
+  scoped_refptr<Trace> traceA(new Trace);
+  scoped_refptr<Trace> traceB(new Trace);
+  {
+    // Traces that are not sampled are not adopted while tracing is disabled.
+    ADOPT_TRACE(traceA.get());
+    ASSERT_EQ(nullptr, Trace::CurrentTrace());
+  }
+
+  traceA->set_sampled(true);
+  traceA->AddChildTrace(traceB.get());
+  ASSERT_TRUE(traceB->sampled());
+  {
+    ADOPT_TRACE(traceB.get());
+    ASSERT_EQ(traceB.get(), Trace::CurrentTrace());
+    ScopedTraceStage stage(TraceStage::kApply);
+  }
+  ASSERT_EQ(1U, histogram->TotalCount());
+
+  TraceStageTimer timer(TraceStage::kApply);
+  timer.Start(traceA.get());
+  timer.Finish();
+  // Finish records the stage only once.
+  timer.Finish();
+  ASSERT_EQ(2U, histogram->TotalCount());
+}
+
 static void GenerateTraceEvents(int thread_id,
                                 int num_events) {
   for (int i = 0; i < num_events; i++) {
@@ -45,13 +45,48 @@
 #include "yb/gutil/strings/substitute.h"
 #include "yb/gutil/walltime.h"
 
+#include "yb/util/flag_tags.h"
 #include "yb/util/memory/arena.h"
 #include "yb/util/memory/memory.h"
+#include "yb/util/metrics.h"
 #include "yb/util/object_pool.h"
+#include "yb/util/random_util.h"
 #include "yb/util/size_literals.h"
 
 DEFINE_bool(enable_tracing, false, "Flag to enable/disable tracing across the code.");
 
+DEFINE_double(trace_sampling_rate, 0.001,
+              "Fraction of requests whose traces are sampled. Durations of processing stages of "
+              "sampled requests are recorded to the trace_stage_* histograms, regardless of "
+              "enable_tracing.");
+TAG_FLAG(trace_sampling_rate, advanced);
+TAG_FLAG(trace_sampling_rate, runtime);
+
+#define DEFINE_TRACE_STAGE_HISTOGRAM(name, label, desc) \
+  METRIC_DEFINE_histogram(server, BOOST_PP_CAT(trace_stage_, name), label, \
+                          yb::MetricUnit::kMicroseconds, desc, 60000000LU, 2)
+
+DEFINE_TRACE_STAGE_HISTOGRAM(cql_parse, "Sampled CQL Parse Time",
+                             "Time spent parsing CQL statements of sampled requests.");
+DEFINE_TRACE_STAGE_HISTOGRAM(cql_analyze, "Sampled CQL Analyze Time",
+                             "Time spent analyzing CQL statements of sampled requests.");
+DEFINE_TRACE_STAGE_HISTOGRAM(cql_execute, "Sampled CQL Execute Time",
+                             "Time spent executing CQL statements of sampled requests.");
+DEFINE_TRACE_STAGE_HISTOGRAM(client_batcher, "Sampled Client Batcher Flush Time",
+                             "Time from flush of a client batcher to its completion, for sampled "
+                             "requests.");
+DEFINE_TRACE_STAGE_HISTOGRAM(rpc_queue, "Sampled RPC Queue Time",
+                             "Time sampled incoming RPC calls spend in the service queue.");
+DEFINE_TRACE_STAGE_HISTOGRAM(prepare, "Sampled Prepare Time",
+                             "Time from submission of a sampled operation until it is prepared.");
+DEFINE_TRACE_STAGE_HISTOGRAM(replicate, "Sampled Replication Time",
+                             "Time from preparation of a sampled operation until it is "
+                             "replicated.");
+DEFINE_TRACE_STAGE_HISTOGRAM(apply, "Sampled Apply Time",
+                             "Time spent applying sampled operations.");
+DEFINE_TRACE_STAGE_HISTOGRAM(rocksdb_read, "Sampled Tablet Read Time",
+                             "Time spent reading from RocksDB by sampled read requests.");
+
 namespace yb {
 
 using strings::internal::SubstituteArg;
@@ -156,10 +191,41 @@ int64_t GetCurrentMicrosFast(MonoTime now) {
   return initial_micros_offset + now.GetDeltaSinceMin().ToMicroseconds();
 }
 
+// Indexed by TraceStage. Set once by RegisterTraceStageMetrics, the histograms are never released.
+std::atomic<Histogram*> trace_stage_histograms[kElementsInTraceStage];
+
 } // namespace
 
+void RegisterTraceStageMetrics(const scoped_refptr<MetricEntity>& entity) {
+  static std::once_flag once;
+  std::call_once(once, [&entity] {
+    HistogramPrototype* prototypes[] = {
+      &METRIC_trace_stage_cql_parse,
+      &METRIC_trace_stage_cql_analyze,
+      &METRIC_trace_stage_cql_execute,
+      &METRIC_trace_stage_client_batcher,
+      &METRIC_trace_stage_rpc_queue,
+      &METRIC_trace_stage_prepare,
+      &METRIC_trace_stage_replicate,
+      &METRIC_trace_stage_apply,
+      &METRIC_trace_stage_rocksdb_read,
+    };
+    static_assert(arraysize(prototypes) == kElementsInTraceStage,
+                  "Each trace stage should have a histogram");
+    for (size_t i = 0; i != kElementsInTraceStage; ++i) {
+      auto histogram = prototypes[i]->Instantiate(entity);
+      entity->NeverRetire(histogram);
+      // Histograms could be used by other servers of this process, so they should outlive the
+      // entity.
+      histogram->AddRef();
+      trace_stage_histograms[i].store(histogram.get(), std::memory_order_release);
+    }
+  });
+}
+
 ScopedAdoptTrace::ScopedAdoptTrace(Trace* t)
-    : old_trace_(Trace::threadlocal_trace_), is_enabled_(GetAtomicFlag(&FLAGS_enable_tracing)) {
+    : old_trace_(Trace::threadlocal_trace_),
+      is_enabled_(GetAtomicFlag(&FLAGS_enable_tracing) || (t && t->sampled())) {
   if (is_enabled_) {
     trace_ = t;
     Trace::threadlocal_trace_ = t;
@@ -351,6 +417,9 @@ void Trace::DumpCurrentTrace() {
 
 void Trace::AddChildTrace(Trace* child_trace) {
   CHECK_NOTNULL(child_trace);
+  if (sampled()) {
+    child_trace->set_sampled(true);
+  }
   {
     std::lock_guard<simple_spinlock> l(lock_);
     scoped_refptr<Trace> ptr(child_trace);
@@ -359,6 +428,37 @@ void Trace::AddChildTrace(Trace* child_trace) {
   CHECK(!child_trace->HasOneRef());
 }
 
+void Trace::MaybeSample() {
+  auto rate = GetAtomicFlag(&FLAGS_trace_sampling_rate);
+  if (rate > 0 && RandomActWithProbability(rate)) {
+    set_sampled(true);
+  }
+}
+
+void Trace::RecordStage(TraceStage stage, MonoDelta duration) {
+  auto* histogram = trace_stage_histograms[to_underlying(stage)].load(std::memory_order_acquire);
+  if (histogram) {
+    histogram->Increment(duration.ToMicroseconds());
+  }
+  TRACE_TO(this, "Stage $0 took $1", ToCString(stage), duration.ToString());
+}
+
+void TraceStageTimer::Start(Trace* trace) {
+  if (trace && trace->sampled()) {
+    trace_ = trace;
+    start_ = MonoTime::Now();
+  } else {
+    trace_ = nullptr;
+  }
+}
+
+void TraceStageTimer::Finish() {
+  if (trace_) {
+    trace_->RecordStage(stage_, MonoTime::Now() - start_);
+    trace_ = nullptr;
+  }
+}
+
 PlainTrace::PlainTrace() {
 }
 
@@ -47,8 +47,10 @@
 #include "yb/gutil/threading/thread_collision_warner.h"
 
 #include "yb/util/atomic.h"
+#include "yb/util/enums.h"
 #include "yb/util/locks.h"
 #include "yb/util/memory/arena_fwd.h"
+#include "yb/util/monotime.h"
 
 DECLARE_bool(enable_tracing);
 
@@ -98,10 +100,32 @@ DECLARE_bool(enable_tracing);
     } \
   } while (0)
 
+// Record the duration of a request processing stage, if the current trace is sampled.
+// Example:
+//  TRACE_STAGE(TraceStage::kCqlParse, end_time - begin_time);
+#define TRACE_STAGE(stage, duration) \
+  do { \
+    yb::Trace* _trace = Trace::CurrentTrace(); \
+    if (_trace && _trace->sampled()) { \
+      _trace->RecordStage((stage), (duration)); \
+    } \
+  } while (0)
+
 namespace yb {
 
+class MetricEntity;
 struct TraceEntry;
 
+// Stages of request processing, whose durations are recorded for sampled traces.
+YB_DEFINE_ENUM(TraceStage,
+               (kCqlParse)(kCqlAnalyze)(kCqlExecute)(kClientBatcher)(kRpcQueue)(kPrepare)
+               (kReplicate)(kApply)(kRocksDBRead));
+
+// Instantiates histograms of trace stage durations on the given entity. Stage durations of sampled
+// traces are recorded to the histograms registered by the first call, they are shared by all the
+// servers in the process.
+void RegisterTraceStageMetrics(const scoped_refptr<MetricEntity>& entity);
+
 // A trace for a request or other process. This supports collecting trace entries
 // from a number of threads, and later dumping the results to a stream.
 //
@@ -154,8 +178,26 @@ class Trace : public RefCountedThreadSafe<Trace> {
   std::string DumpToString(bool include_time_deltas) const;
 
   // Attaches the given trace which will get appended at the end when Dumping.
+  // The child trace is sampled if this trace is sampled.
   void AddChildTrace(Trace* child_trace);
 
+  // Sampled traces record durations of request processing stages to the trace stage histograms,
+  // even when tracing is disabled. A trace is sampled with probability --trace_sampling_rate.
+  bool sampled() const {
+    return sampled_.load(std::memory_order_acquire);
+  }
+
+  void set_sampled(bool sampled) {
+    sampled_.store(sampled, std::memory_order_release);
+  }
+
+  // Marks this trace as sampled with probability --trace_sampling_rate.
+  void MaybeSample();
+
+  // Records duration of the stage to the trace stage histograms and, when tracing is enabled, to
+  // this trace.
+  void RecordStage(TraceStage stage, MonoDelta duration);
+
   // Return the current trace attached to this thread, if there is one.
   static Trace* CurrentTrace() {
     return threadlocal_trace_;
@@ -198,11 +240,48 @@ class Trace : public RefCountedThreadSafe<Trace> {
 
   std::vector<scoped_refptr<Trace> > child_traces_;
 
+  std::atomic<bool> sampled_{false};
+
   DISALLOW_COPY_AND_ASSIGN(Trace);
 };
 
 typedef scoped_refptr<Trace> TracePtr;
 
+// Measures duration of a stage that is started and finished on different threads, for example
+// by an asynchronous operation and its callback. The duration is recorded only if the trace
+// passed to Start is sampled.
+class TraceStageTimer {
+ public:
+  explicit TraceStageTimer(TraceStage stage) : stage_(stage) {}
+
+  void Start(Trace* trace = Trace::CurrentTrace());
+
+  // Records the duration since Start, if it was called with a sampled trace.
+  void Finish();
+
+ private:
+  const TraceStage stage_;
+  scoped_refptr<Trace> trace_;
+  MonoTime start_;
+};
+
+// Records duration of the current scope as a stage of the current trace, if it is sampled.
+class ScopedTraceStage {
+ public:
+  explicit ScopedTraceStage(TraceStage stage) : timer_(stage) {
+    timer_.Start();
+  }
+
+  ~ScopedTraceStage() {
+    timer_.Finish();
+  }
+
+ private:
+  TraceStageTimer timer_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScopedTraceStage);
+};
+
 // Adopt a Trace object into the current thread for the duration
 // of this object.
 // This should only be used on the stack (and thus created and destroyed
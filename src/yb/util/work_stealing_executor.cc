@@ -0,0 +1,265 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/util/work_stealing_executor.h"
+
+#include <pthread.h>
+#include <sched.h>
+
+#include "yb/gutil/strings/substitute.h"
+#include "yb/gutil/sysinfo.h"
+
+#include "yb/util/errno.h"
+#include "yb/util/metrics.h"
+#include "yb/util/thread.h"
+#include "yb/util/trace.h"
+
+namespace yb {
+
+namespace {
+
+void PinCurrentThreadToCpu(size_t index) {
+#if defined(__linux__)
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  CPU_SET(index % base::NumCPUs(), &cpu_set);
+  int err = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+  if (err != 0) {
+    LOG(WARNING) << "Failed to pin thread to CPU " << index % base::NumCPUs() << ": "
+                 << ErrnoToString(err);
+  }
+#else
+  LOG(WARNING) << "Pinning threads to CPUs is not supported on this platform";
+#endif
+}
+
+} // namespace
+
+thread_local WorkStealingExecutor::Worker* WorkStealingExecutor::current_worker_ = nullptr;
+
+WorkStealingExecutor::WorkStealingExecutor(
+    std::string name, int num_workers, int max_queue_size, bool pin_threads,
+    ThreadPoolMetrics metrics)
+    : name_(std::move(name)),
+      max_queue_size_(max_queue_size),
+      pin_threads_(pin_threads),
+      metrics_(std::move(metrics)) {
+  CHECK_GT(num_workers, 0);
+  workers_.reserve(num_workers);
+  for (int i = 0; i != num_workers; ++i) {
+    workers_.emplace_back(new Worker);
+    workers_.back()->executor = this;
+    workers_.back()->index = i;
+  }
+}
+
+WorkStealingExecutor::~WorkStealingExecutor() {
+  Shutdown();
+}
+
+Status WorkStealingExecutor::Start() {
+  for (auto& worker : workers_) {
+    auto status = Thread::Create(
+        "thread pool", strings::Substitute("$0 [worker $1]", name_, worker->index),
+        &WorkStealingExecutor::Execute, this, worker.get(), &worker->thread);
+    if (!status.ok()) {
+      Shutdown();
+      return status;
+    }
+  }
+  return Status::OK();
+}
+
+void WorkStealingExecutor::Shutdown() {
+  if (stop_.exchange(true, std::memory_order_acq_rel)) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    not_empty_cond_.notify_all();
+  }
+  for (auto& worker : workers_) {
+    if (worker->thread) {
+      CHECK_NE(worker.get(), current_worker_)
+          << "Worker of " << name_ << " shutting down its own executor";
+      worker->thread->Join();
+    }
+  }
+
+  // Release queued tasks outside of worker locks, since their destructors could take other locks.
+  std::deque<Task> to_release;
+  for (auto& worker : workers_) {
+    std::lock_guard<std::mutex> lock(worker->mutex);
+    queued_tasks_.fetch_sub(worker->tasks.size(), std::memory_order_acq_rel);
+    std::move(worker->tasks.begin(), worker->tasks.end(), std::back_inserter(to_release));
+    worker->tasks.clear();
+  }
+  for (auto& task : to_release) {
+    if (task.trace) {
+      task.trace->Release();
+    }
+  }
+  to_release.clear();
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  idle_cond_.notify_all();
+}
+
+Status WorkStealingExecutor::Submit(std::shared_ptr<Runnable> runnable) {
+  if (PREDICT_FALSE(stop_.load(std::memory_order_acquire))) {
+    return STATUS(ServiceUnavailable, "The pool has been shut down.");
+  }
+
+  // Same capacity check as in ThreadPool, the limit is not exact under concurrent submissions.
+  int queued = queued_tasks_.load(std::memory_order_acquire);
+  int active = active_tasks_.load(std::memory_order_acquire);
+  if (num_workers() - active + max_queue_size_ - queued < 1) {
+    return STATUS(ServiceUnavailable,
+                  strings::Substitute(
+                      "Thread pool is at capacity ($0/$1 tasks running, $2/$3 tasks queued)",
+                      active, num_workers(), queued, max_queue_size_),
+                  "", ESHUTDOWN);
+  }
+
+  Task task;
+  task.runnable = std::move(runnable);
+  task.trace = Trace::CurrentTrace();
+  // The submitting thread could go away, so the task keeps its own reference to the trace.
+  if (task.trace) {
+    task.trace->AddRef();
+  }
+  task.submit_time = MonoTime::Now();
+
+  Worker* worker = current_worker_;
+  if (!worker || worker->executor != this) {
+    worker = workers_[next_worker_.fetch_add(1, std::memory_order_relaxed) % workers_.size()].get();
+  }
+
+  // The counter is incremented before the task is added, so a worker that sees no queued tasks
+  // before going to sleep is guaranteed to be woken up below. Together with the increment of
+  // sleeping_workers_ in Execute it forms a Dekker style handshake, that requires sequential
+  // consistency: either the worker sees the queued task, or we see the sleeping worker.
+  int length_at_submit = queued_tasks_.fetch_add(1, std::memory_order_seq_cst);
+  {
+    std::lock_guard<std::mutex> lock(worker->mutex);
+    worker->tasks.push_back(std::move(task));
+  }
+  if (sleeping_workers_.load(std::memory_order_seq_cst) > 0) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    not_empty_cond_.notify_one();
+  }
+
+  if (metrics_.queue_length_histogram) {
+    metrics_.queue_length_histogram->Increment(length_at_submit);
+  }
+
+  return Status::OK();
+}
+
+void WorkStealingExecutor::Execute(Worker* worker) {
+  current_worker_ = worker;
+  if (pin_threads_) {
+    PinCurrentThreadToCpu(worker->index);
+  }
+
+  Task task;
+  while (!stop_.load(std::memory_order_acquire)) {
+    if (PopTask(worker, &task)) {
+      RunTask(&task);
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    sleeping_workers_.fetch_add(1, std::memory_order_seq_cst);
+    not_empty_cond_.wait(lock, [this] {
+      return stop_.load(std::memory_order_acquire) ||
+             queued_tasks_.load(std::memory_order_seq_cst) > 0;
+    });
+    sleeping_workers_.fetch_sub(1, std::memory_order_acq_rel);
+  }
+
+  current_worker_ = nullptr;
+}
+
+bool WorkStealingExecutor::PopTask(Worker* worker, Task* task) {
+  {
+    std::lock_guard<std::mutex> lock(worker->mutex);
+    if (!worker->tasks.empty()) {
+      *task = std::move(worker->tasks.front());
+      worker->tasks.pop_front();
+      active_tasks_.fetch_add(1, std::memory_order_acq_rel);
+      queued_tasks_.fetch_sub(1, std::memory_order_acq_rel);
+      return true;
+    }
+  }
+
+  for (size_t i = 1; i != workers_.size(); ++i) {
+    auto& victim = *workers_[(worker->index + i) % workers_.size()];
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (!victim.tasks.empty()) {
+      *task = std::move(victim.tasks.back());
+      victim.tasks.pop_back();
+      active_tasks_.fetch_add(1, std::memory_order_acq_rel);
+      queued_tasks_.fetch_sub(1, std::memory_order_acq_rel);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void WorkStealingExecutor::RunTask(Task* task) {
+  {
+    ADOPT_TRACE(task->trace);
+    // Release the reference which was held by the queued task.
+    if (task->trace) {
+      task->trace->Release();
+    }
+
+    MonoTime now = MonoTime::Now();
+    if (metrics_.queue_time_us_histogram) {
+      metrics_.queue_time_us_histogram->Increment((now - task->submit_time).ToMicroseconds());
+    }
+
+    task->runnable->Run();
+
+    if (metrics_.run_time_us_histogram) {
+      metrics_.run_time_us_histogram->Increment((MonoTime::Now() - now).ToMicroseconds());
+    }
+    task->runnable.reset();
+  }
+
+  if (active_tasks_.fetch_sub(1, std::memory_order_acq_rel) == 1 &&
+      queued_tasks_.load(std::memory_order_acquire) == 0) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    idle_cond_.notify_all();
+  }
+}
+
+bool WorkStealingExecutor::IsIdle() const {
+  return queued_tasks_.load(std::memory_order_acquire) == 0 &&
+         active_tasks_.load(std::memory_order_acquire) == 0;
+}
+
+void WorkStealingExecutor::Wait() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  idle_cond_.wait(lock, [this] { return IsIdle(); });
+}
+
+bool WorkStealingExecutor::WaitFor(const MonoDelta& delta) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  return idle_cond_.wait_for(
+      lock, std::chrono::microseconds(delta.ToMicroseconds()), [this] { return IsIdle(); });
+}
+
+} // namespace yb
@@ -0,0 +1,119 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_UTIL_WORK_STEALING_EXECUTOR_H
+#define YB_UTIL_WORK_STEALING_EXECUTOR_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "yb/gutil/ref_counted.h"
+
+#include "yb/util/monotime.h"
+#include "yb/util/status.h"
+#include "yb/util/threadpool.h"
+
+namespace yb {
+
+class Thread;
+class Trace;
+
+// Executes tasks on a fixed set of worker threads, each of them having its own task deque.
+//
+// Tasks submitted from a worker thread are added to the deque of this worker, other tasks are
+// spread over the workers round robin. A worker executes tasks from its own deque in FIFO order,
+// and when it runs out of them, it steals tasks from the back of the deques of other workers. So
+// submission does not contend on a single queue lock, and tasks are still not stuck behind a
+// long running task of a busy worker.
+//
+// Workers could be optionally pinned to CPUs, worker i runs on CPU i modulo number of CPUs.
+//
+// Used as a backend of ThreadPool, see ThreadPoolBuilder::set_work_stealing.
+class WorkStealingExecutor {
+ public:
+  WorkStealingExecutor(std::string name, int num_workers, int max_queue_size, bool pin_threads,
+                       ThreadPoolMetrics metrics);
+
+  ~WorkStealingExecutor();
+
+  CHECKED_STATUS Start();
+
+  // Tasks that are still queued are dropped, running tasks are waited for.
+  void Shutdown();
+
+  // Returns ServiceUnavailable if the executor is shut down or at capacity.
+  CHECKED_STATUS Submit(std::shared_ptr<Runnable> runnable);
+
+  // Waits until all queued and running tasks complete.
+  void Wait();
+
+  // Same as Wait, but returns false if tasks did not complete within delta.
+  bool WaitFor(const MonoDelta& delta);
+
+  int num_workers() const { return static_cast<int>(workers_.size()); }
+
+ private:
+  struct Task {
+    std::shared_ptr<Runnable> runnable;
+    Trace* trace;
+    MonoTime submit_time;
+  };
+
+  struct Worker {
+    WorkStealingExecutor* executor;
+    size_t index;
+    std::mutex mutex;
+    std::deque<Task> tasks;
+    scoped_refptr<Thread> thread;
+  };
+
+  void Execute(Worker* worker);
+
+  // Pops a task from the front of the own deque of worker, or steals one from the back of the
+  // deque of another worker.
+  bool PopTask(Worker* worker, Task* task);
+
+  void RunTask(Task* task);
+
+  bool IsIdle() const;
+
+  // Worker executed by the current thread, if it belongs to a work stealing executor.
+  static thread_local Worker* current_worker_;
+
+  const std::string name_;
+  const int max_queue_size_;
+  const bool pin_threads_;
+  const ThreadPoolMetrics metrics_;
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::atomic<size_t> next_worker_{0};
+
+  std::atomic<bool> stop_{false};
+  std::atomic<int> queued_tasks_{0};
+  std::atomic<int> active_tasks_{0};
+  std::atomic<int> sleeping_workers_{0};
+
+  // Used to put idle workers to sleep and to wait for completion of tasks.
+  std::mutex mutex_;
+  std::condition_variable not_empty_cond_;
+  std::condition_variable idle_cond_;
+};
+
+} // namespace yb
+
+#endif // YB_UTIL_WORK_STEALING_EXECUTOR_H
@@ -22,8 +22,19 @@
 #include "yb/yql/cql/cqlserver/cql_processor.h"
 
 #include "yb/gutil/endian.h"
+#include "yb/gutil/strings/numbers.h"
 #include "yb/gutil/strings/substitute.h"
 
+#include "yb/util/flag_tags.h"
+
+DEFINE_int32(cql_follower_read_max_staleness_ms, 0,
+             "Maximum time in milliseconds a follower could be behind the leader to serve a read "
+             "with consistency level ONE. If set to zero, the tablet server's "
+             "max_stale_read_bound_time_ms is used. This is only the default: a request can "
+             "override it with the \"max_staleness_ms\" entry of its custom payload.");
+TAG_FLAG(cql_follower_read_max_staleness_ms, evolving);
+TAG_FLAG(cql_follower_read_max_staleness_ms, runtime);
+
 namespace yb {
 namespace cqlserver {
 
@@ -148,6 +159,7 @@ Status CQLMessage::QueryParameters::ValidateConsistency() {
       // Here we repurpose cassandra's ONE consistency level to be CONSISTENT_PREFIX for us since
       // that seems to be the most appropriate.
       set_yb_consistency_level(YBConsistencyLevel::CONSISTENT_PREFIX);
+      set_max_staleness_ms(std::max(FLAGS_cql_follower_read_max_staleness_ms, 0));
       break;
     }
     default:
@@ -341,8 +353,14 @@ bool CQLRequest::ParseRequest(
     return false;
   }
 
-  // Parse the request body
-  const Status status = (*request)->ParseBody();
+  // Parse the custom payload that precedes the request body (since V4), then the body itself.
+  Status status;
+  if (header.flags & kCustomPayloadFlag) {
+    status = (*request)->ParseBytesMap(&(*request)->custom_payload_);
+  }
+  if (status.ok()) {
+    status = (*request)->ParseBody();
+  }
   if (!status.ok()) {
     error_response->reset(
         new ErrorResponse(
@@ -362,8 +380,9 @@ bool CQLRequest::ParseRequest(
     return false;
   }
 
-  // Clear and release the body after parsing.
+  // Clear the body after parsing. The data itself is kept, since values refer to it.
   (*request)->body_.clear();
+  (*request)->uncompressed_body_ = std::move(buffer);
 
   return true;
 }
@@ -481,9 +500,9 @@ Status CQLRequest::ParseValue(const bool with_name, Value* value) {
     value->kind = Value::Kind::NOT_NULL;
     if (length > 0) {
       RETURN_NOT_ENOUGH(length);
-      value->value.assign(to_char_ptr(data), kIntSize + length);
+      value->value = Slice(data, kIntSize + length);
       body_.remove_prefix(length);
-      DVLOG(4) << "CQL value bytes " << value->value;
+      DVLOG(4) << "CQL value bytes " << value->value.ToDebugString();
     }
   } else if (VersionIsCompatible(kV4Version)) {
     switch (length) {
@@ -503,10 +522,26 @@ Status CQLRequest::ParseValue(const bool with_name, Value* value) {
   return Status::OK();
 }
 
+Status CQLRequest::ParseMaxStaleness(QueryParameters* params) {
+  const auto it = custom_payload_.find(kMaxStalenessPayloadKey);
+  if (it == custom_payload_.end() ||
+      params->yb_consistency_level() != YBConsistencyLevel::CONSISTENT_PREFIX) {
+    return Status::OK();
+  }
+  int32_t max_staleness_ms = 0;
+  if (!safe_strto32(it->second, &max_staleness_ms) || max_staleness_ms < 0) {
+    return STATUS_SUBSTITUTE(
+        NetworkError, "Invalid $0 in custom payload: $1", kMaxStalenessPayloadKey, it->second);
+  }
+  params->set_max_staleness_ms(max_staleness_ms);
+  return Status::OK();
+}
+
 Status CQLRequest::ParseQueryParameters(QueryParameters* params) {
   DVLOG(4) << "CQL query parameters ...";
   RETURN_NOT_OK(ParseConsistency(&params->consistency));
   RETURN_NOT_OK(params->ValidateConsistency());
+  RETURN_NOT_OK(ParseMaxStaleness(params));
   RETURN_NOT_OK(ParseByte(&params->flags));
   if (params->flags & CQLMessage::QueryParameters::kWithValuesFlag) {
     const bool with_name = (params->flags & CQLMessage::QueryParameters::kWithNamesForValuesFlag);
@@ -872,7 +907,7 @@ void SerializeValue(const CQLMessage::Value& value, faststring* mesg) {
   switch (value.kind) {
     case CQLMessage::Value::Kind::NOT_NULL:
       SerializeInt(value.value.size(), mesg);
-      mesg->append(value.value);
+      mesg->append(value.value.data(), value.value.size());
       return;
     case CQLMessage::Value::Kind::IS_NULL:
       SerializeInt(-1, mesg);
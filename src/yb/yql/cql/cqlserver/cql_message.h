@@ -169,8 +169,10 @@ class CQLMessage {
 
     Kind kind = Kind::NOT_NULL;
     std::string name;
-    std::string value; // As required by QLValue::Deserialize() for CQL, the value includes
-                       // the 4-byte length header, i.e. "<4-byte-length><value>".
+    // As required by QLValue::Deserialize() for CQL, the value includes the 4-byte length header,
+    // i.e. "<4-byte-length><value>". The value is not copied out of the request body, so it is
+    // valid only while the request and the inbound call that owns the serialized request are.
+    Slice value;
   };
 
   // Id of a prepared query for PREPARE, EXECUTE and BATCH requests.
@@ -310,8 +312,21 @@ class CQLRequest : public CQLMessage {
   CHECKED_STATUS ParseValue(bool with_name, Value* value);
   CHECKED_STATUS ParseQueryParameters(QueryParameters* params);
 
+  // Overrides the default follower read staleness bound of a CONSISTENT_PREFIX query with the
+  // one given in the custom payload of the request, if any.
+  CHECKED_STATUS ParseMaxStaleness(QueryParameters* params);
+
  private:
+  // Custom payload entry with the maximum staleness in milliseconds, as a decimal string.
+  static constexpr const char* kMaxStalenessPayloadKey = "max_staleness_ms";
+
   Slice body_;
+
+  // Custom payload of the request (since V4).
+  std::unordered_map<std::string, std::string> custom_payload_;
+
+  // Uncompressed body of a compressed request. Values parsed from the body point into it.
+  std::unique_ptr<uint8_t[]> uncompressed_body_;
 };
 
 // ------------------------------ Individual CQL requests -----------------------------------
@@ -15,6 +15,9 @@
 #include <string>
 #include <vector>
 
+#include <lz4.h>
+#include <snappy.h>
+
 #include "yb/gutil/strings/substitute.h"
 #include "yb/integration-tests/yb_table_test_base.h"
 
@@ -251,5 +254,132 @@ TEST_F(TestCQLService, TestCQLServerEventConst) {
   ASSERT_EQ(0, memcmp(buffer, ptr, kSize));
 }
 
+namespace {
+
+void AppendShort(uint16_t value, string* out) {
+  out->push_back(static_cast<char>(value >> 8));
+  out->push_back(static_cast<char>(value));
+}
+
+void AppendInt(uint32_t value, string* out) {
+  AppendShort(static_cast<uint16_t>(value >> 16), out);
+  AppendShort(static_cast<uint16_t>(value), out);
+}
+
+// Appends [bytes] value and returns its serialized form, i.e. with the 4-byte length header.
+string AppendValue(const string& value, string* out) {
+  string serialized;
+  AppendInt(static_cast<uint32_t>(value.size()), &serialized);
+  serialized += value;
+  *out += serialized;
+  return serialized;
+}
+
+// Builds V4 request frame with the body compressed using the specified scheme.
+string CompressedRequest(
+    CQLMessage::Opcode opcode, const string& body, CQLMessage::CompressionScheme scheme) {
+  string compressed;
+  switch (scheme) {
+    case CQLMessage::CompressionScheme::LZ4: {
+      AppendInt(static_cast<uint32_t>(body.size()), &compressed);
+      string buffer(LZ4_compressBound(static_cast<int>(body.size())), '\0');
+      const int size = LZ4_compress_default(
+          body.data(), &buffer[0], static_cast<int>(body.size()), static_cast<int>(buffer.size()));
+      CHECK_GT(size, 0);
+      compressed.append(buffer.data(), size);
+      break;
+    }
+    case CQLMessage::CompressionScheme::SNAPPY:
+      snappy::Compress(body.data(), body.size(), &compressed);
+      break;
+    case CQLMessage::CompressionScheme::NONE:
+      LOG(FATAL) << "Compression scheme required";
+  }
+  string request;
+  request.push_back(static_cast<char>(CQLMessage::kV4Version));
+  request.push_back(static_cast<char>(CQLMessage::kCompressionFlag));
+  AppendShort(1 /* stream_id */, &request);
+  request.push_back(static_cast<char>(opcode));
+  AppendInt(static_cast<uint32_t>(compressed.size()), &request);
+  return request + compressed;
+}
+
+// Parses the request and overwrites the serialized request, so bind values that still point into
+// it would not match.
+unique_ptr<CQLRequest> ParseAndClobber(string* mesg, CQLMessage::CompressionScheme scheme) {
+  unique_ptr<CQLRequest> request;
+  unique_ptr<CQLResponse> error_response;
+  EXPECT_TRUE(CQLRequest::ParseRequest(Slice(*mesg), scheme, &request, &error_response));
+  EXPECT_EQ(nullptr, error_response);
+  std::fill(mesg->begin(), mesg->end(), '\xff');
+  mesg->clear();
+  mesg->shrink_to_fit();
+  return request;
+}
+
+const std::vector<CQLMessage::CompressionScheme> kCompressionSchemes = {
+    CQLMessage::CompressionScheme::LZ4, CQLMessage::CompressionScheme::SNAPPY };
+
+} // namespace
+
+// Bind values refer to the uncompressed body owned by the request, not to the inbound buffer.
+TEST_F(TestCQLService, CompressedExecuteRequestValues) {
+  for (auto scheme : kCompressionSchemes) {
+    string body;
+    AppendShort(4, &body);
+    body += "abcd"; // query id
+    AppendShort(static_cast<uint16_t>(CQLMessage::Consistency::QUORUM), &body);
+    body.push_back(static_cast<char>(CQLMessage::QueryParameters::kWithValuesFlag));
+    AppendShort(2, &body);
+    const string first = AppendValue("first bind value", &body);
+    const string second = AppendValue(string(100, 'x'), &body);
+
+    auto mesg = CompressedRequest(CQLMessage::Opcode::EXECUTE, body, scheme);
+    auto request = ParseAndClobber(&mesg, scheme);
+    ASSERT_NE(nullptr, request);
+    const auto& execute = static_cast<const ExecuteRequest&>(*request);
+    ASSERT_EQ("abcd", execute.query_id());
+    const auto& values = execute.params().values;
+    ASSERT_EQ(2U, values.size());
+    ASSERT_EQ(first, values[0].value.ToBuffer());
+    ASSERT_EQ(second, values[1].value.ToBuffer());
+  }
+}
+
+TEST_F(TestCQLService, CompressedBatchRequestValues) {
+  for (auto scheme : kCompressionSchemes) {
+    string body;
+    body.push_back(static_cast<char>(BatchRequest::Type::LOGGED));
+    AppendShort(2, &body); // query count
+    std::vector<std::vector<string>> expected(2);
+    for (int i = 0; i != 2; ++i) {
+      body.push_back(1); // prepared
+      AppendShort(4, &body);
+      body += Substitute("id_$0", i);
+      AppendShort(3, &body);
+      for (int j = 0; j != 3; ++j) {
+        expected[i].push_back(AppendValue(Substitute("value_$0_$1", i, j), &body));
+      }
+    }
+    AppendShort(static_cast<uint16_t>(CQLMessage::Consistency::QUORUM), &body);
+    body.push_back(0); // flags
+
+    auto mesg = CompressedRequest(CQLMessage::Opcode::BATCH, body, scheme);
+    auto request = ParseAndClobber(&mesg, scheme);
+    ASSERT_NE(nullptr, request);
+    const auto& queries = static_cast<const BatchRequest&>(*request).queries();
+    ASSERT_EQ(2U, queries.size());
+    for (int i = 0; i != 2; ++i) {
+      ASSERT_TRUE(queries[i].is_prepared);
+      ASSERT_EQ(Substitute("id_$0", i), queries[i].query_id);
+      const auto& values = queries[i].params.values;
+      ASSERT_EQ(3U, values.size());
+      for (int j = 0; j != 3; ++j) {
+        ASSERT_EQ(expected[i][j], values[j].value.ToBuffer());
+      }
+    }
+  }
+}
+
 }  // namespace cqlserver
 }  // namespace yb
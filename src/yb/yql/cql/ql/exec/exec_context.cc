@@ -197,6 +197,24 @@ void TnodeContext::AdvanceToNextPartition(QLReadRequestPB *req) {
   req->clear_max_hash_code();
 }
 
+void TnodeContext::SetPartitionAhead(QLReadRequestPB *req, uint64_t offset) const {
+  uint64_t partition_counter = current_partition_index_ + offset;
+  const int hash_key_size = req->hashed_column_values().size();
+  const int fixed_cols_size = hash_key_size - hash_values_options_->size();
+
+  // Same as in InitializePartition, convert the partition index into positions for each of the
+  // hash columns that have an 'IN' restriction.
+  for (int i = hash_key_size - 1; i >= fixed_cols_size; i--) {
+    const auto& options = (*hash_values_options_)[i - fixed_cols_size];
+    int pos = partition_counter % options.size();
+    *req->mutable_hashed_column_values(i) = options[pos];
+    partition_counter /= options.size();
+  }
+
+  req->clear_hash_code();
+  req->clear_max_hash_code();
+}
+
 bool TnodeContext::HasPendingOperations() const {
   for (const auto& op : ops_) {
     if (!op->response().has_status()) {
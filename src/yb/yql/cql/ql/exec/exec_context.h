@@ -91,6 +91,22 @@ class TnodeContext {
   // this will do, index: 2 -> 3 and hashed_column_values: [1, 3, 4, 6] -> [1, 3, 5, 6].
   void AdvanceToNextPartition(QLReadRequestPB *req);
 
+  // Used for multi-partition selects that read several partitions in parallel.
+  // Updates the hashed column values in a copy of the current partition's request so that it
+  // references the partition 'offset' positions after the current one. The current partition
+  // index is not changed.
+  void SetPartitionAhead(QLReadRequestPB *req, uint64_t offset) const;
+
+  // The number of partitions following the current one that are being read in advance. Their ops
+  // are kept at the end of ops() in partition order.
+  uint64_t prefetched_partitions() const {
+    return prefetched_partitions_;
+  }
+
+  void set_prefetched_partitions(const uint64_t count) {
+    prefetched_partitions_ = count;
+  }
+
   std::vector<std::vector<QLExpressionPB>>& hash_values_options() {
     if (!hash_values_options_) {
       hash_values_options_.emplace();
@@ -126,6 +142,7 @@ class TnodeContext {
   boost::optional<std::vector<std::vector<QLExpressionPB>>> hash_values_options_;
   uint64_t partitions_count_ = 0;
   uint64_t current_partition_index_ = 0;
+  uint64_t prefetched_partitions_ = 0;
 };
 
 // The context for execution of a statement. Inside the statement parse tree, there may be one or
@@ -27,6 +27,16 @@
 #include "yb/util/thread_restrictions.h"
 #include "yb/util/trace.h"
 
+DEFINE_int32(cql_max_prefetch_partitions, 0,
+             "Maximum number of hash partitions of a multi-partition select (i.e. with 'IN' "
+             "condition on hash columns) to read in parallel ahead of the current one. It is "
+             "further bounded by the number of rows still needed for the current page. "
+             "0 disables reading ahead.");
+
+DEFINE_bool(cql_parallel_aggregate_scans, true,
+            "Read all tablets of a table in parallel when evaluating aggregates over a full table "
+            "scan, instead of paging through the tablets one after another.");
+
 namespace yb {
 namespace ql {
 
@@ -75,6 +85,7 @@ void Executor::ExecuteAsync(const ParseTree& parse_tree, const StatementParamete
                             StatementExecutedCallback cb) {
   DCHECK(cb_.is_null()) << "Another execution is in progress.";
   cb_ = std::move(cb);
+  execute_stage_timer_.Start();
   session_->SetReadPoint(client::Restart::kFalse);
   RETURN_STMT_NOT_OK(Execute(parse_tree, params));
   FlushAsync();
@@ -83,6 +94,7 @@ void Executor::ExecuteAsync(const ParseTree& parse_tree, const StatementParamete
 void Executor::ExecuteAsync(const StatementBatch& batch, StatementExecutedCallback cb) {
   DCHECK(cb_.is_null()) << "Another execution is in progress.";
   cb_ = std::move(cb);
+  execute_stage_timer_.Start();
   session_->SetReadPoint(client::Restart::kFalse);
 
   // Table for DML batches, where all statements must modify the same table.
@@ -751,6 +763,7 @@ Status Executor::ExecPTNode(const PTSelectStmt *tnode, TnodeContext* tnode_conte
   // Set the consistency level for the operation. Always use strong consistency for system tables.
   select_op->set_yb_consistency_level(tnode->is_system() ? YBConsistencyLevel::STRONG
                                                          : params.yb_consistency_level());
+  select_op->set_max_staleness_ms(params.max_staleness_ms());
 
   // If we have several hash partitions (i.e. IN condition on hash columns) we initialize the
   // start partition here, and then iteratively scan the rest in FetchMoreRows.
@@ -768,18 +781,152 @@ Status Executor::ExecPTNode(const PTSelectStmt *tnode, TnodeContext* tnode_conte
         YBqlReadOpPtr op(table->NewQLSelect());
         op->mutable_request()->CopyFrom(select_op->request());
         op->set_yb_consistency_level(select_op->yb_consistency_level());
+        op->set_max_staleness_ms(select_op->max_staleness_ms());
         tnode_context->AdvanceToNextPartition(op->mutable_request());
         RETURN_NOT_OK(AddOperation(op, tnode_context));
         select_op = op; // Use new op as base for the next one, if any.
       }
       return Status::OK();
     }
+
+    // Otherwise, read the following partitions in advance, in parallel with the first one. Their
+    // results are used in partition order as long as LIMIT and paging allow.
+    RETURN_NOT_OK(AddOperation(select_op, tnode_context));
+    return PrefetchPartitions(tnode, select_op, tnode_context);
+  }
+
+  if (FLAGS_cql_parallel_aggregate_scans && tnode->is_aggregate() && !tnode->is_system() &&
+      !continue_select && req->hashed_column_values().empty()) {
+    return AddTabletAggregateOperations(tnode, select_op, tnode_context);
   }
 
   // Add the operation.
   return AddOperation(select_op, tnode_context);
 }
 
+Status Executor::AddTabletAggregateOperations(const PTSelectStmt* tnode,
+                                              const YBqlReadOpPtr& select_op,
+                                              TnodeContext* tnode_context) {
+  const QLReadRequestPB& req = select_op->request();
+  const std::vector<string>& partitions = tnode->table()->GetPartitions();
+  if (partitions.size() <= 1) {
+    return AddOperation(select_op, tnode_context);
+  }
+
+  // Restrict each op to the hash range of its tablet, intersected with the token range, if any.
+  // The upper bound (max_hash_code) is inclusive.
+  const uint32_t min_hash_code = req.has_hash_code() ? req.hash_code() : 0;
+  const uint32_t max_hash_code = req.has_max_hash_code() ? req.max_hash_code()
+                                                         : PartitionSchema::kMaxPartitionKey;
+  std::vector<YBqlReadOpPtr> tablet_ops;
+  for (size_t i = 0; i < partitions.size(); i++) {
+    const uint32_t start = std::max<uint32_t>(
+        min_hash_code,
+        partitions[i].empty() ? 0 : PartitionSchema::DecodeMultiColumnHashValue(partitions[i]));
+    const uint32_t end = std::min<uint32_t>(
+        max_hash_code,
+        i + 1 < partitions.size()
+            ? PartitionSchema::DecodeMultiColumnHashValue(partitions[i + 1]) - 1
+            : PartitionSchema::kMaxPartitionKey);
+    if (start > end) {
+      continue;
+    }
+    YBqlReadOpPtr op(tnode->table()->NewQLSelect());
+    op->mutable_request()->CopyFrom(req);
+    op->mutable_request()->set_hash_code(start);
+    op->mutable_request()->set_max_hash_code(end);
+    op->set_yb_consistency_level(select_op->yb_consistency_level());
+    op->set_max_staleness_ms(select_op->max_staleness_ms());
+    tablet_ops.push_back(std::move(op));
+  }
+
+  // If the token range does not overlap any tablet, let the original op return the empty result.
+  if (tablet_ops.empty()) {
+    return AddOperation(select_op, tnode_context);
+  }
+  for (const auto& op : tablet_ops) {
+    RETURN_NOT_OK(AddOperation(op, tnode_context));
+  }
+  return Status::OK();
+}
+
+Status Executor::PrefetchPartitions(const PTSelectStmt* tnode,
+                                    const YBqlReadOpPtr& op,
+                                    TnodeContext* tnode_context) {
+  DCHECK_EQ(tnode_context->prefetched_partitions(), 0);
+  // Aggregates and OFFSET need the partitions to be read one after another.
+  if (FLAGS_cql_max_prefetch_partitions <= 0 || tnode->is_aggregate() || tnode->offset() ||
+      tnode_context->UnreadPartitionsRemaining() <= 1) {
+    return Status::OK();
+  }
+
+  uint64_t count = std::min<uint64_t>(FLAGS_cql_max_prefetch_partitions,
+                                      tnode_context->UnreadPartitionsRemaining() - 1);
+  // Every partition read ahead is used only if the partitions before it do not fill the page or
+  // LIMIT, so reading more partitions than the rows still needed is likely to be wasted.
+  if (op->request().has_limit()) {
+    count = std::min<uint64_t>(count, op->request().limit());
+  }
+  if (count == 0) {
+    return Status::OK();
+  }
+  for (uint64_t offset = 1; offset <= count; offset++) {
+    YBqlReadOpPtr prefetch_op(tnode->table()->NewQLSelect());
+    QLReadRequestPB* req = prefetch_op->mutable_request();
+    req->CopyFrom(op->request());
+    prefetch_op->set_yb_consistency_level(op->yb_consistency_level());
+    prefetch_op->set_max_staleness_ms(op->max_staleness_ms());
+    tnode_context->SetPartitionAhead(req, offset);
+    if (req->has_paging_state()) {
+      // Read the partition from its start.
+      req->mutable_paging_state()->clear_next_partition_key();
+      req->mutable_paging_state()->clear_next_row_key();
+    }
+    RETURN_NOT_OK(AddOperation(prefetch_op, tnode_context));
+  }
+  tnode_context->set_prefetched_partitions(count);
+  return Status::OK();
+}
+
+Result<bool> Executor::UsePrefetchedPartition(const YBqlReadOpPtr& op,
+                                              TnodeContext* tnode_context) {
+  const uint64_t prefetched = tnode_context->prefetched_partitions();
+  if (prefetched == 0) {
+    return false;
+  }
+
+  // If 'op' still has rows to read in its current partition, the next partition is not needed yet.
+  const QLPagingStatePB& paging_state = op->request().paging_state();
+  if (!paging_state.next_partition_key().empty() || !paging_state.next_row_key().empty()) {
+    return false;
+  }
+
+  // The next partition was read with a limit no less than the number of rows still needed now.
+  // Its result can be used only if it does not go past that number, because we cannot resume
+  // reading from the middle of the rows returned.
+  const auto& ops = tnode_context->ops();
+  const YBqlOpPtr& next_op = ops[ops.size() - prefetched];
+  if (next_op->response().status() != QLResponsePB_QLStatus_YQL_STATUS_OK) {
+    return false;
+  }
+  const size_t row_count =
+      VERIFY_RESULT(QLRowBlock::GetRowCount(op->request().client(), next_op->rows_data()));
+  if (row_count > op->request().limit()) {
+    return false;
+  }
+
+  tnode_context->set_prefetched_partitions(prefetched - 1);
+  return true;
+}
+
+void Executor::DiscardPrefetchedPartitions(TnodeContext* tnode_context) {
+  auto& ops = tnode_context->ops();
+  const uint64_t prefetched = tnode_context->prefetched_partitions();
+  DCHECK_LE(prefetched, ops.size());
+  ops.erase(ops.end() - prefetched, ops.end());
+  tnode_context->set_prefetched_partitions(0);
+}
+
 Result<bool> Executor::FetchMoreRows(const PTSelectStmt* tnode,
                                      const YBqlReadOpPtr& op,
                                      TnodeContext* tnode_context,
@@ -1484,13 +1631,32 @@ Result<bool> Executor::ProcessTnodeResults(TnodeContext* tnode_context) {
       DCHECK_EQ(op->type(), YBOperation::Type::QL_READ);
       const auto& read_op = std::static_pointer_cast<YBqlReadOp>(op);
       if (VERIFY_RESULT(FetchMoreRows(select_stmt, read_op, tnode_context, exec_context_))) {
+        // If the next partition has been read in advance already, continue with its op instead.
+        if (VERIFY_RESULT(UsePrefetchedPartition(read_op, tnode_context))) {
+          op_itr = ops.erase(op_itr);
+          continue;
+        }
+        DiscardPrefetchedPartitions(tnode_context);
+
         op->mutable_response()->Clear();
         TRACE("Apply");
         RETURN_NOT_OK(session_->Apply(op));
         has_buffered_ops = true;
+
+        // When starting to read a new partition, read the following ones in advance too. The ops
+        // added have not been executed yet, so they are skipped in this round.
+        const QLPagingStatePB& paging_state = read_op->request().paging_state();
+        if (paging_state.next_partition_key().empty() && paging_state.next_row_key().empty()) {
+          RETURN_NOT_OK(PrefetchPartitions(select_stmt, read_op, tnode_context));
+          if (tnode_context->prefetched_partitions() > 0) {
+            op_itr = ops.end();
+            continue;
+          }
+        }
         op_itr++;
         continue;
       }
+      DiscardPrefetchedPartitions(tnode_context);
     }
 
     // Remove the op that has completed.
@@ -1867,6 +2033,8 @@ void Executor::StatementExecuted(const Status& s) {
     ql_metrics_->num_flushes_to_execute_ql_->Increment(num_flushes_);
   }
 
+  execute_stage_timer_.Finish();
+
   // Clean up and invoke statement-executed callback.
   ExecutedResult::SharedPtr result = s.ok() ? std::move(result_) : nullptr;
   StatementExecutedCallback cb = std::move(cb_);
@@ -42,6 +42,8 @@
 #include "yb/yql/cql/ql/util/statement_params.h"
 #include "yb/yql/cql/ql/util/statement_result.h"
 
+#include "yb/util/trace.h"
+
 namespace yb {
 namespace ql {
 
@@ -189,6 +191,27 @@ class Executor : public QLExprExecutor {
                              TnodeContext* tnode_context,
                              ExecContext* exec_context);
 
+  // For a multi-partition select, issue read ops for the partitions following the one 'op' is
+  // about to read, so that they are fetched in parallel with it.
+  CHECKED_STATUS PrefetchPartitions(const PTSelectStmt* tnode,
+                                    const client::YBqlReadOpPtr& op,
+                                    TnodeContext* tnode_context);
+
+  // Check if 'op' has just advanced to a partition whose result has already been read in advance
+  // and can be used as is. If so, the prefetched op becomes the next op to process.
+  Result<bool> UsePrefetchedPartition(const client::YBqlReadOpPtr& op,
+                                      TnodeContext* tnode_context);
+
+  // Drop the ops of partitions read in advance whose results will not be used.
+  void DiscardPrefetchedPartitions(TnodeContext* tnode_context);
+
+  // For an aggregate select scanning the whole table (or a token range of it), add one read op per
+  // tablet so that the partial aggregates of all tablets are computed in parallel. The partial
+  // results are merged in AggregateResultSets().
+  CHECKED_STATUS AddTabletAggregateOperations(const PTSelectStmt* tnode,
+                                              const client::YBqlReadOpPtr& select_op,
+                                              TnodeContext* tnode_context);
+
   // Aggregate all result sets from all tablet servers to form the requested resultset.
   CHECKED_STATUS AggregateResultSets(const PTSelectStmt* pt_select);
   CHECKED_STATUS EvalCount(const std::shared_ptr<QLRowBlock>& row_block,
@@ -393,6 +416,9 @@ class Executor : public QLExprExecutor {
   // Statement executed callback.
   StatementExecutedCallback cb_;
 
+  // Measures execution of sampled statements, from ExecuteAsync until StatementExecuted.
+  TraceStageTimer execute_stage_timer_{TraceStage::kCqlExecute};
+
   // QLMetrics to keep track of node parsing etc.
   const QLMetrics* ql_metrics_;
 
@@ -30,6 +30,7 @@ using client::YBColumnSchema;
 const std::map<std::string, PTTableProperty::KVProperty> PTTableProperty::kPropertyDataTypes
     = {
     {"bloom_filter_fp_chance", KVProperty::kBloomFilterFpChance},
+    {"bloom_filter_key", KVProperty::kBloomFilterKey},
     {"caching", KVProperty::kCaching},
     {"comment", KVProperty::kComment},
     {"compaction", KVProperty::kCompaction},
@@ -165,6 +166,22 @@ CHECKED_STATUS PTTableProperty::Analyze(SemContext *sem_context) {
             ErrorCode::INVALID_ARGUMENTS);
       }
       break;
+    case KVProperty::kBloomFilterKey:
+      RETURN_SEM_CONTEXT_ERROR_NOT_OK(GetStringValueFromExpr(rhs_, true, table_property_name,
+                                                             &str_val));
+      if (str_val != BloomFilterKey::kHashKey && str_val != BloomFilterKey::kPrimaryKey) {
+        return sem_context->Error(this,
+            Substitute("$0 must be either '$1' or '$2' (got '$3')", table_property_name,
+                       BloomFilterKey::kHashKey, BloomFilterKey::kPrimaryKey, str_val).c_str(),
+            ErrorCode::INVALID_ARGUMENTS);
+      }
+      // Bloom filters are built with the key type the tablet was opened with.
+      if (sem_context->current_alter_table() != nullptr) {
+        return sem_context->Error(this,
+            Substitute("$0 cannot be altered", table_property_name).c_str(),
+            ErrorCode::INVALID_TABLE_PROPERTY);
+      }
+      break;
     case KVProperty::kCrcCheckChance: FALLTHROUGH_INTENDED;
     case KVProperty::kDclocalReadRepairChance: FALLTHROUGH_INTENDED;
     case KVProperty::kReadRepairChance:
@@ -366,6 +383,14 @@ Status PTTableProperty::SetTableProperty(yb::TableProperties *table_property) co
       table_property->SetDefaultTimeToLive(val * MonoTime::kMillisecondsPerSecond);
       break;
     }
+    case KVProperty::kBloomFilterKey: {
+      string val;
+      RETURN_NOT_OK(GetStringValueFromExpr(rhs_, true, table_property_name, &val));
+      table_property->SetBloomFilterKeyType(val == BloomFilterKey::kPrimaryKey
+          ? BloomFilterKeyType::PRIMARY_KEY_BLOOM_FILTER
+          : BloomFilterKeyType::HASHED_KEY_BLOOM_FILTER);
+      break;
+    }
     case KVProperty::kBloomFilterFpChance: FALLTHROUGH_INTENDED;
     case KVProperty::kComment: FALLTHROUGH_INTENDED;
     case KVProperty::kCrcCheckChance: FALLTHROUGH_INTENDED;
@@ -432,6 +457,12 @@ CHECKED_STATUS PTTablePropertyMap::Analyze(SemContext *sem_context) {
       break;
     case PropertyMapType::kCompression:
       RETURN_SEM_CONTEXT_ERROR_NOT_OK(AnalyzeCompression());
+      // SST compression is set up when the tablets are opened.
+      if (sem_context->current_alter_table() != nullptr) {
+        return sem_context->Error(this,
+            Substitute("$0 cannot be altered", lhs_->c_str()).c_str(),
+            ErrorCode::INVALID_TABLE_PROPERTY);
+      }
       break;
     case PropertyMapType::kTransactions:
       RETURN_SEM_CONTEXT_ERROR_NOT_OK(AnalyzeTransactions(sem_context));
@@ -453,10 +484,45 @@ Status PTTablePropertyMap::SetTableProperty(yb::TableProperties *table_property)
   }
   switch (iterator->second) {
     case PropertyMapType::kCaching: FALLTHROUGH_INTENDED;
-    case PropertyMapType::kCompaction: FALLTHROUGH_INTENDED;
-    case PropertyMapType::kCompression:
+    case PropertyMapType::kCompaction:
       LOG(WARNING) << "Ignoring table property " << table_property_name;
       break;
+    case PropertyMapType::kCompression: {
+      string class_name;
+      bool enabled = true;
+      for (const auto& subproperty : map_elements_->node_list()) {
+        string subproperty_name;
+        ToLowerCase(subproperty->lhs()->c_str(), &subproperty_name);
+        auto iter = Compression::kSubpropertyDataTypes.find(subproperty_name);
+        DCHECK(iter != Compression::kSubpropertyDataTypes.end());
+        switch (iter->second) {
+          case Compression::Subproperty::kClass: FALLTHROUGH_INTENDED;
+          case Compression::Subproperty::kSstableCompression:
+            RETURN_NOT_OK(
+                GetStringValueFromExpr(subproperty->rhs(), true, subproperty_name, &class_name));
+            break;
+          case Compression::Subproperty::kEnabled:
+            RETURN_NOT_OK(GetBoolValueFromExpr(subproperty->rhs(), subproperty_name, &enabled));
+            break;
+          case Compression::Subproperty::kChunkLengthKb: FALLTHROUGH_INTENDED;
+          case Compression::Subproperty::kCrcCheckChance:
+            LOG(WARNING) << "Ignoring compression option " << subproperty_name;
+            break;
+        }
+      }
+      if (!enabled) {
+        table_property->SetCompressionType(TableCompressionType::NO_COMPRESSION);
+        break;
+      }
+      auto compression_type = Compression::ClassCompressionType(class_name);
+      if (!compression_type) {
+        LOG(WARNING) << "Ignoring unsupported compression class " << class_name
+                     << ", using the default compression";
+        break;
+      }
+      table_property->SetCompressionType(*compression_type);
+      break;
+    }
     case PropertyMapType::kTransactions:
       for (const auto& subproperty : map_elements_->node_list()) {
         string subproperty_name;
@@ -719,7 +785,6 @@ Status PTTablePropertyMap::AnalyzeCompression() {
   if (class_name.empty() && !has_sstable_compression) {
     return STATUS(InvalidArgument, "Missing sub-option 'class' for the 'compression' option");
   }
-
   for (const auto& subproperty : map_elements_->node_list()) {
     string subproperty_name;
     ToLowerCase(subproperty->lhs()->c_str(), &subproperty_name);
@@ -799,6 +864,25 @@ const std::map<std::string, Compression::Subproperty> Compression::kSubpropertyD
     {"sstable_compression", Compression::Subproperty::kSstableCompression}
 };
 
+const std::map<std::string, TableCompressionType> Compression::kClassCompressionTypes = {
+    {"",                  TableCompressionType::NO_COMPRESSION},
+    {"deflatecompressor", TableCompressionType::ZLIB_COMPRESSION},
+    {"lz4compressor",     TableCompressionType::LZ4_COMPRESSION},
+    {"snappycompressor",  TableCompressionType::SNAPPY_COMPRESSION}
+};
+
+boost::optional<TableCompressionType> Compression::ClassCompressionType(
+    const string& class_name) {
+  const auto short_name_begin = class_name.find_last_of('.');
+  const auto short_name = short_name_begin == string::npos ?
+      class_name : class_name.substr(short_name_begin + 1);
+  auto iter = kClassCompressionTypes.find(short_name);
+  if (iter == kClassCompressionTypes.end()) {
+    return boost::none;
+  }
+  return iter->second;
+}
+
 const std::map<std::string, Compaction::Subproperty> Compaction::kSubpropertyDataTypes = {
     {"base_time_seconds", Compaction::Subproperty::kBaseTimeSeconds},
     {"bucket_high", Compaction::Subproperty::kBucketHigh},
@@ -39,6 +39,7 @@ class PTTableProperty : public PTProperty {
  public:
   enum class KVProperty : int {
     kBloomFilterFpChance,
+    kBloomFilterKey,
     kCaching,
     kComment,
     kCompaction,
@@ -234,6 +235,15 @@ struct Compression {
   };
 
   static const std::map<std::string, Subproperty> kSubpropertyDataTypes;
+
+  // Returns the SST compression for a lowercase Cassandra compressor class name, with or without
+  // the package prefix. An empty name disables compression. Returns none for compressor classes
+  // without an equivalent here (e.g. ZstdCompressor), tables using them get the default.
+  static boost::optional<TableCompressionType> ClassCompressionType(
+      const std::string& class_name);
+
+ private:
+  static const std::map<std::string, TableCompressionType> kClassCompressionTypes;
 };
 
 struct Compaction {
@@ -281,6 +291,13 @@ struct Transactions {
   static const std::map<std::string, Subproperty> kSubpropertyDataTypes;
 };
 
+// Values of the bloom_filter_key property, which selects what part of the primary key the bloom
+// filters of the table are built on.
+struct BloomFilterKey {
+  static constexpr auto kHashKey = "hash_key";
+  static constexpr auto kPrimaryKey = "primary_key";
+};
+
 } // namespace ql
 } // namespace yb
 
@@ -19,6 +19,7 @@
 
 #include "yb/yql/cql/ql/statement.h"
 #include "yb/util/thread_restrictions.h"
+#include "yb/util/trace.h"
 
 METRIC_DEFINE_histogram(
     server, handler_latency_yb_cqlserver_SQLProcessor_ParseRequest,
@@ -137,10 +138,11 @@ Status QLProcessor::Parse(const string& stmt, ParseTree::UniPtr* parse_tree,
   const MonoTime begin_time = MonoTime::Now();
   RETURN_NOT_OK(parser_.Parse(stmt, reparsed, mem_tracker));
   const MonoTime end_time = MonoTime::Now();
+  const MonoDelta elapsed_time = end_time.GetDeltaSince(begin_time);
   if (ql_metrics_ != nullptr) {
-    const MonoDelta elapsed_time = end_time.GetDeltaSince(begin_time);
     ql_metrics_->time_to_parse_ql_query_->Increment(elapsed_time.ToMicroseconds());
   }
+  TRACE_STAGE(TraceStage::kCqlParse, elapsed_time);
   *parse_tree = parser_.Done();
   DCHECK(*parse_tree) << "Parse tree is null";
   return Status::OK();
@@ -151,11 +153,12 @@ Status QLProcessor::Analyze(ParseTree::UniPtr* parse_tree) {
   const MonoTime begin_time = MonoTime::Now();
   const Status s = analyzer_.Analyze(std::move(*parse_tree));
   const MonoTime end_time = MonoTime::Now();
+  const MonoDelta elapsed_time = end_time.GetDeltaSince(begin_time);
   if (ql_metrics_ != nullptr) {
-    const MonoDelta elapsed_time = end_time.GetDeltaSince(begin_time);
     ql_metrics_->time_to_analyze_ql_query_->Increment(elapsed_time.ToMicroseconds());
     ql_metrics_->num_rounds_to_analyze_ql_->Increment(1);
   }
+  TRACE_STAGE(TraceStage::kCqlAnalyze, elapsed_time);
   *parse_tree = analyzer_.Done();
   DCHECK(*parse_tree) << "Parse tree is null";
   return s;
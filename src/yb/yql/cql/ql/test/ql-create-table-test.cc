@@ -181,6 +181,92 @@ TEST_F(TestQLCreateTable, TestQLCreateTableWithTTL) {
   EXPECT_EQ(1000, properties_pb.default_time_to_live());
 }
 
+TEST_F(TestQLCreateTable, TestQLCreateTableWithBloomFilterKey) {
+  // Init the simulated cluster.
+  ASSERT_NO_FATALS(CreateSimulatedCluster());
+
+  // Get an available processor.
+  TestQLProcessor *processor = GetQLProcessor();
+
+  EXEC_INVALID_STMT("CREATE TABLE invalid_bloom_filter_key (h int, r int, v int, "
+                    "PRIMARY KEY((h), r)) WITH bloom_filter_key = 'range_key';");
+  EXEC_VALID_STMT("CREATE TABLE table_with_bloom_filter_key (h int, r int, v int, "
+                  "PRIMARY KEY((h), r)) WITH bloom_filter_key = 'primary_key';");
+  EXEC_INVALID_STMT("ALTER TABLE table_with_bloom_filter_key WITH bloom_filter_key = 'hash_key';");
+
+  // Verify the bloom filter key type was stored in syscatalog table.
+  master::Master *master = cluster_->mini_master()->master();
+  master::CatalogManager *catalog_manager = master->catalog_manager();
+  master::GetTableSchemaRequestPB request_pb;
+  master::GetTableSchemaResponsePB response_pb;
+  request_pb.mutable_table()->mutable_namespace_()->set_name(kDefaultKeyspaceName);
+  request_pb.mutable_table()->set_table_name("table_with_bloom_filter_key");
+  CHECK_OK(catalog_manager->GetTableSchema(&request_pb, &response_pb));
+  EXPECT_EQ(BloomFilterKeyType::PRIMARY_KEY_BLOOM_FILTER,
+            response_pb.schema().table_properties().bloom_filter_key_type());
+
+  // Point gets and partition scans both see the rows.
+  EXEC_VALID_STMT("INSERT INTO table_with_bloom_filter_key (h, r, v) VALUES (1, 1, 10);");
+  EXEC_VALID_STMT("INSERT INTO table_with_bloom_filter_key (h, r, v) VALUES (1, 2, 20);");
+  EXEC_VALID_STMT("SELECT v FROM table_with_bloom_filter_key WHERE h = 1 AND r = 2;");
+  auto row_block = processor->row_block();
+  ASSERT_EQ(1, row_block->row_count());
+  EXPECT_EQ(20, row_block->row(0).column(0).int32_value());
+  EXEC_VALID_STMT("SELECT v FROM table_with_bloom_filter_key WHERE h = 1 AND r = 3;");
+  EXPECT_EQ(0, processor->row_block()->row_count());
+  EXEC_VALID_STMT("SELECT v FROM table_with_bloom_filter_key WHERE h = 1;");
+  EXPECT_EQ(2, processor->row_block()->row_count());
+}
+
+TEST_F(TestQLCreateTable, TestQLCreateTableWithCompression) {
+  // Init the simulated cluster.
+  ASSERT_NO_FATALS(CreateSimulatedCluster());
+
+  // Get an available processor.
+  TestQLProcessor *processor = GetQLProcessor();
+
+  // Compressor classes without an equivalent are accepted and get the default compression.
+  EXEC_VALID_STMT("CREATE TABLE zstd_table (c1 int PRIMARY KEY) WITH "
+                  "compression = {'class' : 'ZstdCompressor'};");
+  EXEC_VALID_STMT("CREATE TABLE lz4_table (c1 int PRIMARY KEY) WITH "
+                  "compression = {'class' : 'org.apache.cassandra.io.compress.LZ4Compressor'};");
+  EXEC_VALID_STMT("CREATE TABLE deflate_table (c1 int PRIMARY KEY) WITH "
+                  "compression = {'sstable_compression' : 'DeflateCompressor'};");
+  EXEC_VALID_STMT("CREATE TABLE uncompressed_table (c1 int PRIMARY KEY) WITH "
+                  "compression = {'class' : 'SnappyCompressor', 'enabled' : false};");
+  EXEC_VALID_STMT("CREATE TABLE default_table (c1 int PRIMARY KEY);");
+
+  // Verify the compression type was stored in syscatalog table.
+  master::CatalogManager *catalog_manager = cluster_->mini_master()->master()->catalog_manager();
+  auto get_table_properties = [catalog_manager](const string& table_name) {
+    master::GetTableSchemaRequestPB request_pb;
+    master::GetTableSchemaResponsePB response_pb;
+    request_pb.mutable_table()->mutable_namespace_()->set_name(kDefaultKeyspaceName);
+    request_pb.mutable_table()->set_table_name(table_name);
+    CHECK_OK(catalog_manager->GetTableSchema(&request_pb, &response_pb));
+    return response_pb.schema().table_properties();
+  };
+  EXPECT_EQ(TableCompressionType::LZ4_COMPRESSION,
+            get_table_properties("lz4_table").compression_type());
+  EXPECT_EQ(TableCompressionType::ZLIB_COMPRESSION,
+            get_table_properties("deflate_table").compression_type());
+  EXPECT_EQ(TableCompressionType::NO_COMPRESSION,
+            get_table_properties("uncompressed_table").compression_type());
+  EXPECT_FALSE(get_table_properties("default_table").has_compression_type());
+  EXPECT_FALSE(get_table_properties("zstd_table").has_compression_type());
+
+  // Compression is set up when the tablets are opened and cannot be changed afterwards.
+  EXEC_INVALID_STMT("ALTER TABLE lz4_table WITH "
+                    "compression = {'class' : 'SnappyCompressor'};");
+  EXPECT_EQ(TableCompressionType::LZ4_COMPRESSION,
+            get_table_properties("lz4_table").compression_type());
+
+  // Tablets open with the table compression.
+  EXEC_VALID_STMT("INSERT INTO lz4_table (c1) VALUES (1);");
+  EXEC_VALID_STMT("SELECT * FROM lz4_table WHERE c1 = 1;");
+  EXPECT_EQ(1, processor->row_block()->row_count());
+}
+
 TEST_F(TestQLCreateTable, TestQLCreateTableWithClusteringOrderBy) {
   // Init the simulated cluster.
   ASSERT_NO_FATALS(CreateSimulatedCluster());
@@ -29,6 +29,8 @@ using std::unique_ptr;
 using std::shared_ptr;
 using strings::Substitute;
 
+DECLARE_int32(cql_max_prefetch_partitions);
+
 namespace yb {
 namespace ql {
 
@@ -840,6 +842,42 @@ TEST_F(TestQLQuery, TestPagingState) {
   }
 }
 
+TEST_F(TestQLQuery, TestInConditionPrefetch) {
+  // Init the simulated cluster.
+  ASSERT_NO_FATALS(CreateSimulatedCluster());
+
+  // Get a processor.
+  TestQLProcessor *processor = GetQLProcessor();
+
+  CHECK_VALID_STMT("CREATE TABLE t (h int, r int, primary key((h), r));");
+
+  // Insert "h" rows for each hash key "h".
+  for (int h = 1; h <= 10; h++) {
+    for (int r = 1; r <= h; r++) {
+      CHECK_VALID_STMT(Substitute("INSERT INTO t (h, r) VALUES ($0, $1);", h, r));
+    }
+  }
+
+  // The same rows and pages are expected whether the partitions are read one after another or
+  // read in advance in parallel.
+  for (int prefetch : {0, 1, 2, 16}) {
+    LOG(INFO) << "Reading with " << prefetch << " partitions prefetched";
+    FLAGS_cql_max_prefetch_partitions = prefetch;
+
+    VerifyPaginationSelect(processor, "SELECT h, r FROM t WHERE h IN (2, 3, 5, 7);", 4,
+        "{ { int32:2, int32:1 }, { int32:2, int32:2 }, { int32:3, int32:1 }, { int32:3, int32:2 } }"
+        "{ { int32:3, int32:3 }, { int32:5, int32:1 }, { int32:5, int32:2 }, { int32:5, int32:3 } }"
+        "{ { int32:5, int32:4 }, { int32:5, int32:5 }, { int32:7, int32:1 }, { int32:7, int32:2 } }"
+        "{ { int32:7, int32:3 }, { int32:7, int32:4 }, { int32:7, int32:5 }, { int32:7, int32:6 } }"
+        "{ { int32:7, int32:7 } }");
+
+    VerifyPaginationSelect(processor, "SELECT h, r FROM t WHERE h IN (2, 3, 5, 7) LIMIT 9;", 4,
+        "{ { int32:2, int32:1 }, { int32:2, int32:2 }, { int32:3, int32:1 }, { int32:3, int32:2 } }"
+        "{ { int32:3, int32:3 }, { int32:5, int32:1 }, { int32:5, int32:2 }, { int32:5, int32:3 } }"
+        "{ { int32:5, int32:4 } }");
+  }
+}
+
 #define RUN_PAGINATION_WITH_DESC_TEST(processor, type, values, rows)                               \
 do {                                                                                               \
   /* Creating the table. */                                                                        \
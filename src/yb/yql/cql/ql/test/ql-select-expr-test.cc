@@ -13,6 +13,8 @@ using std::unique_ptr;
 using std::shared_ptr;
 using strings::Substitute;
 
+DECLARE_bool(cql_parallel_aggregate_scans);
+
 namespace yb {
 namespace ql {
 
@@ -304,6 +306,43 @@ TEST_F(QLTestSelectedExpr, TestAggregateExpr) {
   }
 }
 
+TEST_F(QLTestSelectedExpr, TestParallelAggregateScan) {
+  // Init the simulated cluster.
+  ASSERT_NO_FATALS(CreateSimulatedCluster());
+
+  // Get a processor.
+  TestQLProcessor *processor = GetQLProcessor();
+
+  CHECK_VALID_STMT("CREATE TABLE test_aggr_scan(h int, v int, primary key(h));");
+  static constexpr int kNumRows = 100;
+  for (int i = 1; i <= kNumRows; i++) {
+    CHECK_VALID_STMT(Substitute("INSERT INTO test_aggr_scan(h, v) VALUES($0, $0);", i));
+  }
+
+  // The partial aggregates of the tablets are merged to the same result whether the tablets are
+  // scanned one after another or all in parallel.
+  for (bool parallel : {false, true}) {
+    FLAGS_cql_parallel_aggregate_scans = parallel;
+
+    CHECK_VALID_STMT("SELECT count(*), sum(v), min(v), max(v), avg(v) FROM test_aggr_scan;");
+    std::shared_ptr<QLRowBlock> row_block = processor->row_block();
+    CHECK_EQ(row_block->row_count(), 1);
+    const QLRow& row = row_block->row(0);
+    CHECK_EQ(row.column(0).int64_value(), kNumRows);
+    CHECK_EQ(row.column(1).int32_value(), (1 + kNumRows) * kNumRows / 2);
+    CHECK_EQ(row.column(2).int32_value(), 1);
+    CHECK_EQ(row.column(3).int32_value(), kNumRows);
+    CHECK_EQ(row.column(4).int32_value(), (1 + kNumRows) / 2);
+
+    // Filter out all rows.
+    CHECK_VALID_STMT("SELECT count(*), sum(v) FROM test_aggr_scan WHERE v < 0 ALLOW FILTERING;");
+    row_block = processor->row_block();
+    CHECK_EQ(row_block->row_count(), 1);
+    CHECK_EQ(row_block->row(0).column(0).int64_value(), 0);
+    CHECK_EQ(row_block->row(0).column(1).int32_value(), 0);
+  }
+}
+
 TEST_F(QLTestSelectedExpr, TestQLSelectNumericExpr) {
   // Init the simulated cluster.
   ASSERT_NO_FATALS(CreateSimulatedCluster());
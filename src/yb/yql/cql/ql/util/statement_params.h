@@ -79,6 +79,13 @@ class StatementParameters {
     return yb_consistency_level_;
   }
 
+  // Maximum staleness in milliseconds of a CONSISTENT_PREFIX read served by a follower. Zero means
+  // that the tablet server default is used.
+  uint64_t max_staleness_ms() const { return max_staleness_ms_; }
+  void set_max_staleness_ms(const uint64_t max_staleness_ms) {
+    max_staleness_ms_ = max_staleness_ms;
+  }
+
  protected:
   void set_yb_consistency_level(const YBConsistencyLevel yb_consistency_level) {
     yb_consistency_level_ = yb_consistency_level;
@@ -97,6 +104,9 @@ class StatementParameters {
 
   // Consistency level for YB.
   YBConsistencyLevel yb_consistency_level_;
+
+  // Staleness bound for follower reads.
+  uint64_t max_staleness_ms_ = 0;
 };
 
 } // namespace ql